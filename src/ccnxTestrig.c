@@ -57,6 +57,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <getopt.h>
+#include <errno.h>
+#include <time.h>
+#include <inttypes.h>
+#include <sys/epoll.h>
 
 #include <stdbool.h>
 
@@ -64,6 +68,7 @@
 
 #include <parc/algol/parc_Object.h>
 #include <parc/security/parc_Signer.h>
+#include <parc/security/parc_SecureRandom.h>
 
 #include <ccnx/common/ccnx_Name.h>
 #include <ccnx/common/ccnx_Interest.h>
@@ -77,15 +82,100 @@
 
 #include "ccnxTestrig_Suite.h"
 #include "ccnxTestrig_Reporter.h"
+#include "ccnxTestrig_Dispatcher.h"
+#include "ccnxTestrig_Load.h"
+#include "ccnxTestrig_PacketTemplate.h"
+#include "ccnxTestrig_ScriptLoader.h"
+#include "ccnxTestrig_Capture.h"
+#include "ccnxTestrig_Replay.h"
+#include "ccnxTestrig_Forwarder.h"
+#include "ccnxTestrig_Probe.h"
+#include "ccnxTestrig_Log.h"
+
+#include <parc/algol/parc_LinkedList.h>
 
 #define DEFAULT_PORT 9596
 #define DEFAULT_ADDRESS "localhost"
+#define DEFAULT_QUIESCENCE 20
+#define DRAIN_LIMIT_IN_QUIESCENCE_WINDOWS 100
+#define DEFAULT_LOAD_DURATION 10
+#define NO_RESPONDER -1
+#define PLAN_CACHE_NAME "ccnxTestrig"
+#define DEFAULT_REPLAY_LINKS "ABC"
+#define DEFAULT_NUMBER_OF_LINKS 3
+#define DEFAULT_READY_TIMEOUT 10000
+#define DEFAULT_REPORT_FORMAT "jsonl"
+#define DEFAULT_LOG_LEVEL "info"
+
+// The readiness probe names its pings from this stream, which the streams handed out to the
+// tests never reach, so the number of pings it needs does not change the names of the tests.
+#define PROBE_NAME_STREAM UINT32_MAX
 
 typedef struct {
     CCNxTestrigLinkType linkType;
 
+    // Have a kernel thread poll for the sends of io_uring links.
+    bool submissionPolling;
+
+    // Measure latencies from the kernel receive timestamps of the packets.
+    bool kernelTimestamps;
+
     char *address;
     int port;
+
+    // The number of links, listening on consecutive ports from port.
+    unsigned numberOfLinks;
+
+    // The number of milliseconds without traffic after which the links are considered drained.
+    int quiescence;
+
+    // Run the tests that can share the links concurrently.
+    bool concurrent;
+
+    // Generate Interest load at loadRate per second (0 for open loop) instead of running the tests.
+    bool load;
+    unsigned loadRate;
+    unsigned loadDuration;
+
+    // Payload size of the Content Objects answering the load on link B, or NO_RESPONDER.
+    int responsePayloadSize;
+
+    // Run the scripts in this file or directory instead of the built-in tests, caching their plans in planCache.
+    char *scripts;
+    char *planCache;
+
+    // Record the traffic of every link in this pcapng file.
+    char *capture;
+
+    // Each test result keeps the last packetLogCapacity packets it sent. Older packets are recorded
+    // in packetLogSpill, which writes them to packetLogSpillPath, if it is set.
+    unsigned packetLogCapacity;
+    char *packetLogSpillPath;
+    CCNxTestrigCapture *packetLogSpill;
+
+    // Also write the results to this file, in reportFormat.
+    char *report;
+    CCNxTestrigReporterFormat reportFormat;
+
+    // Send the packets of this capture instead of running the tests, at replaySpeed times the
+    // captured rate (0 for maximum rate). Capture interface i is sent on the i-th link named in
+    // replayLinks, which is a comma-separated list of names, or a string of one-letter names.
+    char *replay;
+    double replaySpeed;
+    char *replayLinks;
+
+    // Run against the in-process forwarder instead of an external one.
+    bool selfTest;
+
+    // Milliseconds to wait for every link to connect and every route to forward, or -1 to wait forever.
+    // Without probe, only the links are waited for.
+    int readyTimeout;
+    bool probe;
+
+    // Every name suffix of the run is derived from the seed. Each name generator gets the next stream.
+    bool seeded;
+    uint64_t seed;
+    uint32_t nameStreams;
 } _CCNxTestrigOptions;
 
 static bool
@@ -94,6 +184,16 @@ _CCNxTestrigOptions_Destructor(_CCNxTestrigOptions **optionsPtr)
     _CCNxTestrigOptions *options = *optionsPtr;
 
     free(options->address);
+    free(options->scripts);
+    free(options->planCache);
+    free(options->capture);
+    free(options->report);
+    free(options->packetLogSpillPath);
+    if (options->packetLogSpill != NULL) {
+        ccnxTestrigCapture_Release(&options->packetLogSpill);
+    }
+    free(options->replay);
+    free(options->replayLinks);
 
     return true;
 }
@@ -106,9 +206,29 @@ parcObject_Override(
 	.destructor = (PARCObjectDestructor *) _CCNxTestrigOptions_Destructor);
 
 struct ccnx_testrig {
-    CCNxTestrigLink *linkA;
-    CCNxTestrigLink *linkB;
-    CCNxTestrigLink *linkC;
+    // Indexed by CCNxTestrigLinkID, so links[0] is unused.
+    size_t numberOfLinks;
+    CCNxTestrigLink **links;
+
+    // Every link is registered in a single epoll set. Only the links that a receive
+    // operation is waiting on are armed for input.
+    int epollDescriptor;
+    PARCBitVector *armedLinks;
+
+    // The number of stale packets discarded on each link by the last drain.
+    size_t *discardedPackets;
+
+    // A view receives from its mailbox, into which the dispatcher delivers the packets it claimed.
+    CCNxTestrigDispatcher *dispatcher;
+    CCNxTestrigMailbox *mailbox;
+
+    // The link receive time of the packet most recently returned by ccnxTestrig_ReceiveFromLinks.
+    uint64_t receiveTime;
+
+    // The registered packet templates, shared by a rig and its views.
+    PARCLinkedList *templates;
+
+    CCNxTestrigNameGenerator *nameGenerator;
 
     _CCNxTestrigOptions *options;
     CCNxTestrigReporter *reporter;
@@ -119,11 +239,29 @@ _ccnxTestrig_Destructor(CCNxTestrig **testrigPtr)
 {
     CCNxTestrig *testrig = *testrigPtr;
 
-    ccnxTestrigLink_Release(&testrig->linkA);
-    ccnxTestrigLink_Release(&testrig->linkB);
-    ccnxTestrigLink_Release(&testrig->linkC);
+    for (CCNxTestrigLinkID id = CCNxTestrigLinkID_LinkA; id <= testrig->numberOfLinks; id++) {
+        if (testrig->links[id] != NULL) {
+            ccnxTestrigLink_Release(&testrig->links[id]);
+        }
+    }
+    free(testrig->links);
+    free(testrig->discardedPackets);
 
+    if (testrig->epollDescriptor >= 0) {
+        close(testrig->epollDescriptor);
+    }
+    parcBitVector_Release(&testrig->armedLinks);
+
+    if (testrig->dispatcher != NULL) {
+        ccnxTestrigDispatcher_Unregister(testrig->dispatcher, testrig->mailbox);
+        ccnxTestrigDispatcher_Release(&testrig->dispatcher);
+        ccnxTestrigMailbox_Release(&testrig->mailbox);
+    }
+
+    parcLinkedList_Release(&testrig->templates);
+    ccnxTestrigNameGenerator_Release(&testrig->nameGenerator);
     _ccnxTestrigOptions_Release(&testrig->options);
+    ccnxTestrigReporter_Release(&testrig->reporter);
 
     return true;
 }
@@ -142,51 +280,174 @@ ccnxTestrig_Create(_CCNxTestrigOptions *options)
 
     if (testrig != NULL) {
         testrig->options = _ccnxTestrigOptions_Acquire(options);
+        testrig->numberOfLinks = options->numberOfLinks;
+        testrig->links = calloc(testrig->numberOfLinks + 1, sizeof(CCNxTestrigLink *));
+        testrig->discardedPackets = calloc(testrig->numberOfLinks + 1, sizeof(size_t));
         testrig->reporter = ccnxTestrigReporter_Create(stdout);
+        testrig->armedLinks = parcBitVector_Create();
+        if ((testrig->epollDescriptor = epoll_create1(0)) < 0) {
+            perror("epoll_create1() failed");
+        }
+        testrig->dispatcher = NULL;
+        testrig->mailbox = NULL;
+        testrig->receiveTime = 0;
+        testrig->templates = parcLinkedList_Create();
+        testrig->nameGenerator = ccnxTestrig_CreateNameGenerator(testrig);
     }
 
     return testrig;
 }
 
+CCNxTestrig *
+ccnxTestrig_CreateView(CCNxTestrig *rig, CCNxTestrigDispatcher *dispatcher)
+{
+    CCNxTestrig *view = parcObject_CreateInstance(CCNxTestrig);
+
+    if (view != NULL) {
+        view->numberOfLinks = rig->numberOfLinks;
+        view->links = calloc(view->numberOfLinks + 1, sizeof(CCNxTestrigLink *));
+        view->discardedPackets = calloc(view->numberOfLinks + 1, sizeof(size_t));
+        for (CCNxTestrigLinkID id = CCNxTestrigLinkID_LinkA; id <= rig->numberOfLinks; id++) {
+            if (rig->links[id] != NULL) {
+                view->links[id] = ccnxTestrigLink_Acquire(rig->links[id]);
+            }
+        }
+
+        view->options = _ccnxTestrigOptions_Acquire(rig->options);
+        view->reporter = ccnxTestrigReporter_Acquire(rig->reporter);
+        view->armedLinks = parcBitVector_Create();
+        view->epollDescriptor = -1;
+
+        view->dispatcher = ccnxTestrigDispatcher_Acquire(dispatcher);
+        view->mailbox = ccnxTestrigMailbox_Create();
+        view->receiveTime = 0;
+        view->templates = parcLinkedList_Acquire(rig->templates);
+        view->nameGenerator = ccnxTestrig_CreateNameGenerator(rig);
+    }
+
+    return view;
+}
+
+void
+ccnxTestrig_ClaimName(CCNxTestrig *rig, const CCNxName *name)
+{
+    if (rig->dispatcher != NULL && name != NULL) {
+        ccnxTestrigDispatcher_Register(rig->dispatcher, name, rig->mailbox);
+    }
+}
+
+void
+ccnxTestrig_RegisterPacketTemplate(CCNxTestrig *rig, CCNxTestrigPacketTemplate *template)
+{
+    parcLinkedList_Append(rig->templates, template);
+}
+
+CCNxTestrigPacketTemplate *
+ccnxTestrig_GetPacketTemplate(CCNxTestrig *rig, const char *name)
+{
+    for (size_t i = 0; i < parcLinkedList_Size(rig->templates); i++) {
+        CCNxTestrigPacketTemplate *template = parcLinkedList_GetAtIndex(rig->templates, i);
+        if (strcmp(ccnxTestrigPacketTemplate_GetName(template), name) == 0) {
+            return template;
+        }
+    }
+    return NULL;
+}
+
+CCNxTestrigNameGenerator *
+ccnxTestrig_GetNameGenerator(CCNxTestrig *rig)
+{
+    return rig->nameGenerator;
+}
+
+CCNxTestrigNameGenerator *
+ccnxTestrig_CreateNameGenerator(CCNxTestrig *rig)
+{
+    uint32_t stream = __atomic_fetch_add(&rig->options->nameStreams, 1, __ATOMIC_RELAXED);
+    return ccnxTestrigNameGenerator_Create(rig->options->seed, stream);
+}
+
 CCNxTestrigReporter *
 ccnxTestrig_GetReporter(CCNxTestrig *rig)
 {
     return rig->reporter;
 }
 
-static CCNxTestrigLink *
-_ccnxTestrig_GetLinkA(CCNxTestrig *rig)
+static void
+_ccnxTestrig_SetLink(CCNxTestrig *rig, CCNxTestrigLinkID linkID, CCNxTestrigLink *link)
+{
+    if (linkID < CCNxTestrigLinkID_LinkA || linkID > rig->numberOfLinks) {
+        return;
+    }
+    rig->links[linkID] = link;
+
+    // Register the link disarmed. It is armed when a receive operation waits on it.
+    struct epoll_event event = { .events = 0, .data.u32 = linkID };
+    if (epoll_ctl(rig->epollDescriptor, EPOLL_CTL_ADD, ccnxTestrigLink_GetDescriptor(link), &event) < 0) {
+        perror("epoll_ctl() failed");
+    }
+}
+
+size_t
+ccnxTestrig_GetPacketLogCapacity(const CCNxTestrig *rig)
 {
-    return rig->linkA;
+    return rig->options->packetLogCapacity;
 }
 
-static CCNxTestrigLink *
-_ccnxTestrig_GetLinkB(CCNxTestrig *rig)
+CCNxTestrigCapture *
+ccnxTestrig_GetPacketLogSpill(const CCNxTestrig *rig)
 {
-    return rig->linkB;
+    return rig->options->packetLogSpill;
 }
 
-static CCNxTestrigLink *
-_ccnxTestrig_GetLinkC(CCNxTestrig *rig)
+size_t
+ccnxTestrig_GetNumberOfLinks(const CCNxTestrig *rig)
 {
-    return rig->linkC;
+    return rig->numberOfLinks;
+}
+
+char *
+ccnxTestrig_FormatLinkName(CCNxTestrigLinkID linkID, char *name)
+{
+    // Bijective base 26, like spreadsheet columns: A to Z, then AA to ZZ, then AAA.
+    char reversed[CCNX_TESTRIG_LINK_NAME_LENGTH];
+    size_t length = 0;
+    for (unsigned id = linkID; id > 0 && length < CCNX_TESTRIG_LINK_NAME_LENGTH - 1; id = (id - 1) / 26) {
+        reversed[length++] = 'A' + (id - 1) % 26;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        name[i] = reversed[length - 1 - i];
+    }
+    name[length] = '\0';
+    return name;
+}
+
+CCNxTestrigLinkID
+ccnxTestrig_ParseLinkName(const char *name)
+{
+    size_t length = strlen(name);
+    if (length == 0 || length >= CCNX_TESTRIG_LINK_NAME_LENGTH - 1) {
+        return CCNxTestrigLinkID_NULL;
+    }
+
+    unsigned id = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (name[i] < 'A' || name[i] > 'Z') {
+            return CCNxTestrigLinkID_NULL;
+        }
+        id = id * 26 + (name[i] - 'A' + 1);
+    }
+    return id;
 }
 
 CCNxTestrigLink *
 ccnxTestrig_GetLinkByID(CCNxTestrig *rig, CCNxTestrigLinkID linkID)
 {
-    switch (linkID) {
-        case CCNxTestrigLinkID_LinkA:
-            return _ccnxTestrig_GetLinkA(rig);
-        case CCNxTestrigLinkID_LinkB:
-            return _ccnxTestrig_GetLinkB(rig);
-        case CCNxTestrigLinkID_LinkC:
-            return _ccnxTestrig_GetLinkC(rig);
-        default:
-        break;
+    if (linkID < CCNxTestrigLinkID_LinkA || linkID > rig->numberOfLinks) {
+        return NULL;
     }
-
-    return NULL;
+    return rig->links[linkID];
 }
 
 PARCBitVector *
@@ -196,40 +457,253 @@ ccnxTestrig_GetLinkVector(CCNxTestrig *rig, CCNxTestrigLinkID linkID, ...)
 
     va_list linkList;
     va_start(linkList, linkID);
-    parcBitVector_Set(vector, linkID);
-    for (CCNxTestrigLinkID id = linkID; id < CCNxTestrigLinkID_NULL; id = va_arg(linkList, CCNxTestrigLinkID)) {
+    for (CCNxTestrigLinkID id = linkID; id != CCNxTestrigLinkID_NULL; id = va_arg(linkList, CCNxTestrigLinkID)) {
         parcBitVector_Set(vector, id);
     }
+    va_end(linkList);
 
     return vector;
 }
 
-void
-ccnxTestrig_FlushLinks(CCNxTestrig *rig)
+uint64_t
+ccnxTestrig_GetTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+uint64_t
+ccnxTestrig_GetDeadline(int timeout)
+{
+    return ccnxTestrig_GetTime() + (uint64_t) timeout * 1000000ULL;
+}
+
+static int
+_ccnxTestrig_RemainingTimeout(uint64_t deadline)
+{
+    uint64_t now = ccnxTestrig_GetTime();
+    if (deadline <= now) {
+        return 0;
+    }
+
+    // Round up so that we never wake up just before the deadline and spin.
+    return (int) ((deadline - now + 999999ULL) / 1000000ULL);
+}
+
+static void
+_ccnxTestrig_SetLinkArmed(CCNxTestrig *rig, CCNxTestrigLinkID id, bool armed)
+{
+    CCNxTestrigLink *link = ccnxTestrig_GetLinkByID(rig, id);
+    if (link == NULL) {
+        return;
+    }
+
+    struct epoll_event event = { .events = armed ? EPOLLIN : 0, .data.u32 = id };
+    if (epoll_ctl(rig->epollDescriptor, EPOLL_CTL_MOD, ccnxTestrigLink_GetDescriptor(link), &event) < 0) {
+        if (errno != ENOENT) { // failed links are no longer registered
+            perror("epoll_ctl() failed");
+        }
+        return;
+    }
+
+    if (armed) {
+        parcBitVector_Set(rig->armedLinks, id);
+    } else {
+        parcBitVector_Clear(rig->armedLinks, id);
+    }
+}
+
+/**
+ * Arm exactly the links of the vector. Only the links that are set in either vector are visited,
+ * so a receive on a few links costs the same however many links the rig has.
+ */
+static void
+_ccnxTestrig_ArmLinks(CCNxTestrig *rig, PARCBitVector *linkVector)
 {
-    for (CCNxTestrigLinkID id = CCNxTestrigLinkID_LinkA; id != CCNxTestrigLinkID_NULL; id++) {
+    for (int id = parcBitVector_NextBitSet(rig->armedLinks, 0); id >= 0; id = parcBitVector_NextBitSet(rig->armedLinks, id + 1)) {
+        if (parcBitVector_Get(linkVector, id) != 1) {
+            _ccnxTestrig_SetLinkArmed(rig, id, false);
+        }
+    }
+    for (int id = parcBitVector_NextBitSet(linkVector, 0); id >= 0; id = parcBitVector_NextBitSet(linkVector, id + 1)) {
+        if (parcBitVector_Get(rig->armedLinks, id) != 1) {
+            _ccnxTestrig_SetLinkArmed(rig, id, true);
+        }
+    }
+}
+
+/**
+ * The link was closed or failed. Stop watching it so that we do not spin on it.
+ */
+static void
+_ccnxTestrig_DropLink(CCNxTestrig *rig, CCNxTestrigLinkID id)
+{
+    CCNxTestrigLink *link = ccnxTestrig_GetLinkByID(rig, id);
+    epoll_ctl(rig->epollDescriptor, EPOLL_CTL_DEL, ccnxTestrigLink_GetDescriptor(link), NULL);
+    parcBitVector_Clear(rig->armedLinks, id);
+    char name[CCNX_TESTRIG_LINK_NAME_LENGTH];
+    ccnxTestrigLog_Warning("Link %s failed and will no longer be read", ccnxTestrig_FormatLinkName(id, name));
+}
+
+PARCBuffer *
+ccnxTestrig_ReceiveFromLinks(CCNxTestrig *rig, PARCBitVector *linkVector, uint64_t deadline, CCNxTestrigLinkID *linkID)
+{
+    if (rig->mailbox != NULL) {
+        return ccnxTestrigMailbox_Receive(rig->mailbox, linkVector, deadline, linkID, &rig->receiveTime);
+    }
+
+    _ccnxTestrig_ArmLinks(rig, linkVector);
+
+    for (;;) {
+        // Packets already reassembled from a TCP stream do not make the socket readable again.
+        for (int id = parcBitVector_NextBitSet(linkVector, 0); id >= 0; id = parcBitVector_NextBitSet(linkVector, id + 1)) {
+            CCNxTestrigLink *link = ccnxTestrig_GetLinkByID(rig, id);
+            if (link != NULL && ccnxTestrigLink_HasPendingPacket(link)) {
+                PARCBuffer *packet = ccnxTestrigLink_ReceiveWithTimeout(link, 0);
+                if (packet != NULL) {
+                    *linkID = id;
+                    rig->receiveTime = ccnxTestrigLink_GetReceiveTime(link);
+                    return packet;
+                }
+            }
+        }
+
+        struct epoll_event event;
+        int res = epoll_wait(rig->epollDescriptor, &event, 1, _ccnxTestrig_RemainingTimeout(deadline));
+        if (res == 0) {
+            return NULL;
+        } else if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("An error occurred while receiving");
+            return NULL;
+        }
+
+        CCNxTestrigLinkID id = event.data.u32;
+        if ((event.events & EPOLLIN) == 0) {
+            _ccnxTestrig_DropLink(rig, id);
+            continue;
+        }
+
         CCNxTestrigLink *link = ccnxTestrig_GetLinkByID(rig, id);
-        PARCBuffer *receiveBuffer = ccnxTestrigLink_ReceiveWithTimeout(link, 100);
-        while (receiveBuffer != NULL) {
-            parcBuffer_Release(&receiveBuffer);
-            receiveBuffer = ccnxTestrigLink_ReceiveWithTimeout(link, 100);
+        PARCBuffer *packet = ccnxTestrigLink_ReceiveWithTimeout(link, 0);
+        if (packet != NULL) {
+            *linkID = id;
+            rig->receiveTime = ccnxTestrigLink_GetReceiveTime(link);
+            return packet;
+        } else if (ccnxTestrigLink_IsClosed(link)) {
+            // A closed TCP socket stays readable, and would otherwise wake us until the deadline.
+            _ccnxTestrig_DropLink(rig, id);
         }
-        if (receiveBuffer != NULL) {
-            parcBuffer_Release(&receiveBuffer);
+    }
+}
+
+int
+ccnxTestrig_GetQuiescence(const CCNxTestrig *rig)
+{
+    return rig->options->quiescence;
+}
+
+uint64_t
+ccnxTestrig_GetReceiveTime(const CCNxTestrig *rig)
+{
+    return rig->receiveTime;
+}
+
+size_t
+ccnxTestrig_DrainLinks(CCNxTestrig *rig)
+{
+    PARCBitVector *allLinks = parcBitVector_Create();
+    for (CCNxTestrigLinkID id = CCNxTestrigLinkID_LinkA; id <= rig->numberOfLinks; id++) {
+        parcBitVector_Set(allLinks, id);
+        rig->discardedPackets[id] = 0;
+    }
+
+    // Every packet that arrives restarts the quiescence window, but a link that never goes
+    // quiet (a forwarder stuck in a loop, say) must not hold the rig here forever.
+    uint64_t limit = ccnxTestrig_GetDeadline(rig->options->quiescence * DRAIN_LIMIT_IN_QUIESCENCE_WINDOWS);
+    size_t discarded = 0;
+    CCNxTestrigLinkID linkID;
+    PARCBuffer *packet;
+    while ((packet = ccnxTestrig_ReceiveFromLinks(rig, allLinks, ccnxTestrig_GetDeadline(rig->options->quiescence), &linkID)) != NULL) {
+        rig->discardedPackets[linkID]++;
+        discarded++;
+        parcBuffer_Release(&packet);
+        if (ccnxTestrig_GetTime() >= limit) {
+            ccnxTestrigLog_Warning("Links were still busy after %d ms, gave up draining them after %zu packet(s)",
+                                   rig->options->quiescence * DRAIN_LIMIT_IN_QUIESCENCE_WINDOWS, discarded);
+            break;
         }
     }
+
+    parcBitVector_Release(&allLinks);
+    return discarded;
 }
 
+size_t
+ccnxTestrig_GetDiscardedPacketCount(CCNxTestrig *rig, CCNxTestrigLinkID linkID)
+{
+    if (linkID < CCNxTestrigLinkID_LinkA || linkID > rig->numberOfLinks) {
+        return 0;
+    }
+    return rig->discardedPackets[linkID];
+}
+
+// The command line is left out of the library that the unit tests link against.
+#ifndef CCNX_TESTRIG_LIBRARY
 void
 showUsage()
 {
-    printf("Usage: ccnxTestrig [-h] [-t (UDP | TCP)] [-a <local address>] [-p <local port>] \n");
+    printf("Usage: ccnxTestrig [-h] [-t (0 | 1 | 2)] [-a <local address>] [-p <local port>] \n");
     printf(" -a       --address           Local IP address (localhost by default)\n");
     printf(" -p       --port              Local IP port (9696 by defualt)\n");
-    printf(" -t       --transport         Transport mechanism (0 = UDP, 1 = TCP)\n");
+    printf(" -t       --transport         Transport mechanism (0 = UDP, 1 = TCP, 2 = UDP through io_uring)\n");
+    printf(" -u       --sqpoll            Have a kernel thread poll for the sends of io_uring links\n");
+    printf(" -K       --kernel-timestamps Measure latencies up to the time the kernel received each packet\n");
+    printf(" -n       --links             Number of links, on consecutive ports (%d by default)\n", DEFAULT_NUMBER_OF_LINKS);
+    printf(" -q       --quiescence        Milliseconds without traffic before links are drained (%d by default)\n", DEFAULT_QUIESCENCE);
+    printf(" -j       --concurrent        Run tests concurrently where possible\n");
+    printf(" -l       --load              Send Interests from link A to link B at the given rate per second (0 = as fast as possible) instead of running the tests\n");
+    printf(" -d       --duration          Seconds to generate load for (%d by default)\n", DEFAULT_LOAD_DURATION);
+    printf(" -s       --respond           Answer the load on link B with Content Objects carrying the given number of payload bytes\n");
+    printf(" -f       --scripts           Run the script file, or the .script files in the directory, instead of the built-in tests\n");
+    printf(" -c       --plan-cache        Directory of the parsed script cache ($XDG_CACHE_HOME/%s or ~/.cache/%s by default)\n", PLAN_CACHE_NAME, PLAN_CACHE_NAME);
+    printf(" -w       --capture           Write the packets of every link to the given pcapng file\n");
+    printf(" -k       --packet-log        Number of sent packets each test result keeps (%d by default)\n", CCNX_TESTRIG_DEFAULT_PACKET_LOG_CAPACITY);
+    printf(" -W       --packet-log-spill  Write the packets pushed out of the test results' packet logs to the given pcapng file\n");
+    printf(" -v       --log-level         Most detailed messages to log: error, warning, info or debug (%s by default)\n", DEFAULT_LOG_LEVEL);
+    printf(" -o       --report            Also write the results to the given file, as they are produced\n");
+    printf(" -F       --report-format     Format of the report file: text, jsonl or junit (%s by default)\n", DEFAULT_REPORT_FORMAT);
+    printf(" -r       --replay            Send the packets of the given pcap or pcapng file instead of running the tests\n");
+    printf(" -x       --replay-speed      Replay at the given multiple of the captured rate (1 by default, 0 = as fast as possible)\n");
+    printf(" -m       --replay-links      Link of each capture interface, in order, with - to skip one (%s by default, or a comma-separated list such as A,B,AA)\n", DEFAULT_REPLAY_LINKS);
+    printf(" -y       --ready-timeout     Milliseconds to wait for the links to connect and the routes to forward (%d by default, -1 = forever)\n", DEFAULT_READY_TIMEOUT);
+    printf(" -P       --no-probe          Do not check that the forwarder forwards the routes of the built-in tests before running them\n");
+    printf(" -T       --self-test         Forward through a built-in forwarder instead of an external one (UDP only)\n");
+    printf(" -S       --seed              Seed of the generated names, to repeat the names of an earlier run\n");
     printf(" -h       --help              Display the help message\n");
 }
 
+/**
+ * The plan cache lives in the user's cache directory, as the XDG base directory specification
+ * places it. Without a home directory, plans are not cached.
+ */
+static char *
+_ccnxTestrig_DefaultPlanCache(void)
+{
+    char *path = NULL;
+    const char *cacheHome = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    if (cacheHome != NULL && cacheHome[0] == '/') {
+        asprintf(&path, "%s/%s", cacheHome, PLAN_CACHE_NAME);
+    } else if (home != NULL && home[0] == '/') {
+        asprintf(&path, "%s/.cache/%s", home, PLAN_CACHE_NAME);
+    }
+    return path;
+}
+
 static _CCNxTestrigOptions *
 _ccnxTestrig_ParseCommandLineOptions(int argc, char **argv)
 {
@@ -237,6 +711,29 @@ _ccnxTestrig_ParseCommandLineOptions(int argc, char **argv)
             { "address",    required_argument,  NULL, 'a'},
             { "port",       required_argument,  NULL, 'p'},
             { "transport",  required_argument,  NULL, 't' },
+            { "sqpoll",     no_argument,        NULL, 'u'},
+            { "kernel-timestamps", no_argument, NULL, 'K'},
+            { "links",      required_argument,  NULL, 'n'},
+            { "quiescence", required_argument,  NULL, 'q'},
+            { "concurrent", no_argument,        NULL, 'j'},
+            { "load",       required_argument,  NULL, 'l'},
+            { "duration",   required_argument,  NULL, 'd'},
+            { "respond",    required_argument,  NULL, 's'},
+            { "seed",       required_argument,  NULL, 'S'},
+            { "scripts",    required_argument,  NULL, 'f'},
+            { "plan-cache", required_argument,  NULL, 'c'},
+            { "capture",    required_argument,  NULL, 'w'},
+            { "packet-log", required_argument,  NULL, 'k'},
+            { "packet-log-spill", required_argument, NULL, 'W'},
+            { "log-level",  required_argument,  NULL, 'v'},
+            { "report",     required_argument,  NULL, 'o'},
+            { "report-format", required_argument, NULL, 'F'},
+            { "replay",     required_argument,  NULL, 'r'},
+            { "replay-speed", required_argument, NULL, 'x'},
+            { "replay-links", required_argument, NULL, 'm'},
+            { "self-test",  no_argument,        NULL, 'T'},
+            { "ready-timeout", required_argument, NULL, 'y'},
+            { "no-probe",   no_argument,        NULL, 'P'},
             { "help",       no_argument,        NULL, 'h'},
             { NULL,         0,                  NULL, 0}
     };
@@ -247,22 +744,140 @@ _ccnxTestrig_ParseCommandLineOptions(int argc, char **argv)
     }
 
     _CCNxTestrigOptions *options = parcObject_CreateInstance(_CCNxTestrigOptions);
+    options->linkType = CCNxTestrigLinkType_UDP;
     options->port = 0;
     options->address = NULL;
+    options->numberOfLinks = DEFAULT_NUMBER_OF_LINKS;
+    options->quiescence = DEFAULT_QUIESCENCE;
+    options->concurrent = false;
+    options->load = false;
+    options->loadRate = 0;
+    options->loadDuration = DEFAULT_LOAD_DURATION;
+    options->responsePayloadSize = NO_RESPONDER;
+    options->seeded = false;
+    options->seed = 0;
+    options->nameStreams = 0;
+    options->scripts = NULL;
+    options->planCache = NULL;
+    options->capture = NULL;
+    options->report = NULL;
+    options->packetLogCapacity = CCNX_TESTRIG_DEFAULT_PACKET_LOG_CAPACITY;
+    options->packetLogSpillPath = NULL;
+    options->packetLogSpill = NULL;
+    options->reportFormat = ccnxTestrigReporter_ParseFormat(DEFAULT_REPORT_FORMAT);
+    options->replay = NULL;
+    options->replaySpeed = 1.0;
+    options->replayLinks = NULL;
+    options->selfTest = false;
+    options->submissionPolling = false;
+    options->kernelTimestamps = false;
+    options->readyTimeout = DEFAULT_READY_TIMEOUT;
+    options->probe = true;
 
     int c;
+    int linkType;
     while (optind < argc) {
-        if ((c = getopt_long(argc, argv, "ht:a:p:", longopts, NULL)) != -1) {
+        if ((c = getopt_long(argc, argv, "hjTPuKt:a:p:n:q:l:d:s:S:f:c:w:k:W:v:o:F:r:x:m:y:", longopts, NULL)) != -1) {
             switch(c) {
                 case 't':
-                    sscanf(optarg, "%zu", (size_t *) &(options->linkType));
+                    if (sscanf(optarg, "%d", &linkType) != 1 || linkType < 0 || linkType >= CCNxTestrigLinkType_Invalid) {
+                        fprintf(stderr, "Error: unknown link type %s\n", optarg);
+                        exit(EXIT_FAILURE);
+                    }
+                    options->linkType = (CCNxTestrigLinkType) linkType;
+                    break;
+                case 'u':
+                    options->submissionPolling = true;
+                    break;
+                case 'K':
+                    options->kernelTimestamps = true;
                     break;
                 case 'a':
                     options->address = malloc(strlen(optarg));
                     strcpy(options->address, optarg);
                     break;
                 case 'p':
-                    sscanf(optarg, "%zu", (size_t *) &(options->port));
+                    sscanf(optarg, "%d", &(options->port));
+                    break;
+                case 'n':
+                    sscanf(optarg, "%u", &(options->numberOfLinks));
+                    break;
+                case 'q':
+                    sscanf(optarg, "%d", &(options->quiescence));
+                    break;
+                case 'j':
+                    options->concurrent = true;
+                    break;
+                case 'l':
+                    options->load = true;
+                    sscanf(optarg, "%u", &(options->loadRate));
+                    break;
+                case 'd':
+                    sscanf(optarg, "%u", &(options->loadDuration));
+                    break;
+                case 's':
+                    sscanf(optarg, "%d", &(options->responsePayloadSize));
+                    break;
+                case 'f':
+                    free(options->scripts);
+                    options->scripts = strdup(optarg);
+                    break;
+                case 'c':
+                    free(options->planCache);
+                    options->planCache = strdup(optarg);
+                    break;
+                case 'w':
+                    free(options->capture);
+                    options->capture = strdup(optarg);
+                    break;
+                case 'k':
+                    sscanf(optarg, "%u", &(options->packetLogCapacity));
+                    break;
+                case 'W':
+                    free(options->packetLogSpillPath);
+                    options->packetLogSpillPath = strdup(optarg);
+                    break;
+                case 'v':
+                    if (ccnxTestrigLog_ParseLevel(optarg) == CCNxTestrigLogLevel_Invalid) {
+                        fprintf(stderr, "Error: unknown log level %s\n", optarg);
+                        exit(EXIT_FAILURE);
+                    }
+                    ccnxTestrigLog_SetLevel(ccnxTestrigLog_ParseLevel(optarg));
+                    break;
+                case 'o':
+                    free(options->report);
+                    options->report = strdup(optarg);
+                    break;
+                case 'F':
+                    options->reportFormat = ccnxTestrigReporter_ParseFormat(optarg);
+                    if (options->reportFormat == CCNxTestrigReporterFormat_Invalid) {
+                        fprintf(stderr, "Error: unknown report format %s\n", optarg);
+                        exit(EXIT_FAILURE);
+                    }
+                    break;
+                case 'r':
+                    free(options->replay);
+                    options->replay = strdup(optarg);
+                    break;
+                case 'x':
+                    options->replaySpeed = strtod(optarg, NULL);
+                    break;
+                case 'm':
+                    free(options->replayLinks);
+                    options->replayLinks = strdup(optarg);
+                    break;
+                case 'T':
+                    options->selfTest = true;
+                    break;
+                case 'y':
+                    sscanf(optarg, "%d", &(options->readyTimeout));
+                    break;
+                case 'P':
+                    options->probe = false;
+                    break;
+                case 'S':
+                    options->seeded = true;
+                    options->seed = strtoull(optarg, NULL, 0);
                     break;
                 case 'h':
                     showUsage();
@@ -277,41 +892,344 @@ _ccnxTestrig_ParseCommandLineOptions(int argc, char **argv)
     if (options->port == 0) {
         options->port = DEFAULT_PORT;
     }
+    if (options->numberOfLinks == 0) {
+        options->numberOfLinks = DEFAULT_NUMBER_OF_LINKS;
+    }
+    if (options->loadDuration == 0) {
+        options->loadDuration = DEFAULT_LOAD_DURATION;
+    }
     if (options->address == NULL) {
         options->address = malloc(strlen(DEFAULT_ADDRESS));
         strcpy(options->address, DEFAULT_ADDRESS);
     }
+    if (options->planCache == NULL) {
+        options->planCache = _ccnxTestrig_DefaultPlanCache();
+    }
+    if (options->replayLinks == NULL) {
+        options->replayLinks = strdup(DEFAULT_REPLAY_LINKS);
+    }
+    if (options->replaySpeed < 0) {
+        options->replaySpeed = 0;
+    }
+    if (options->scripts == NULL && options->replay == NULL && options->numberOfLinks < DEFAULT_NUMBER_OF_LINKS) {
+        printf("The built-in tests use links A to C, using %d links\n", DEFAULT_NUMBER_OF_LINKS);
+        options->numberOfLinks = DEFAULT_NUMBER_OF_LINKS;
+    }
+    // The links listen on consecutive ports, which must all be valid.
+    if (options->port < 0 || (unsigned long) options->port + options->numberOfLinks - 1 > 65535) {
+        fprintf(stderr, "Error: %u links starting at port %d need ports outside 1 to 65535\n", options->numberOfLinks, options->port);
+        exit(EXIT_FAILURE);
+    }
+    if (options->selfTest && options->numberOfLinks > CCNX_TESTRIG_FORWARDER_MAX_FACES) {
+        fprintf(stderr, "Error: the self-test forwarder supports at most %d links\n", CCNX_TESTRIG_FORWARDER_MAX_FACES);
+        exit(EXIT_FAILURE);
+    }
+    if (options->selfTest && options->linkType == CCNxTestrigLinkType_TCP) {
+        printf("The self-test forwarder only supports UDP links, using UDP\n");
+        options->linkType = CCNxTestrigLinkType_UDP;
+    }
+    if (!options->seeded) {
+        PARCSecureRandom *random = parcSecureRandom_Create();
+        PARCBuffer *seedBytes = parcBuffer_Allocate(sizeof(options->seed));
+        parcSecureRandom_NextBytes(random, seedBytes);
+        parcBuffer_Flip(seedBytes);
+        options->seed = parcBuffer_GetUint64(seedBytes);
+        parcBuffer_Release(&seedBytes);
+        parcSecureRandom_Release(&random);
+    }
 
     return options;
 };
 
+// The routes the built-in tests expect of a forwarder under test. The self-test forwarder is configured
+// with them, and the readiness probe checks them. Face i of the self-test forwarder serves link i + 1.
+static const struct {
+    const char *prefix;
+    CCNxTestrigLinkID link;
+} _ccnxTestrig_Routes[] = {
+    { "ccnx:/test/b",  CCNxTestrigLinkID_LinkB },
+    { "ccnx:/test/c",  CCNxTestrigLinkID_LinkC },
+    { "ccnx:/test/bc", CCNxTestrigLinkID_LinkB },
+    { "ccnx:/test/bc", CCNxTestrigLinkID_LinkC },
+    { "ccnx:/test/ab", CCNxTestrigLinkID_LinkA },
+    { "ccnx:/test/ab", CCNxTestrigLinkID_LinkB },
+};
+
+#define NUMBER_OF_ROUTES (sizeof(_ccnxTestrig_Routes) / sizeof(_ccnxTestrig_Routes[0]))
+
+static CCNxTestrigForwarder *
+_ccnxTestrig_StartSelfTestForwarder(int port, CCNxTestrigLink **links, size_t numberOfLinks)
+{
+    CCNxTestrigForwarder *forwarder = ccnxTestrigForwarder_Create(CCNxTestrigLinkType_UDP, "127.0.0.1", port, numberOfLinks);
+    if (forwarder == NULL) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < NUMBER_OF_ROUTES; i++) {
+        ccnxTestrigForwarder_AddRoute(forwarder, _ccnxTestrig_Routes[i].prefix, _ccnxTestrig_Routes[i].link - CCNxTestrigLinkID_LinkA);
+    }
+    for (size_t i = 0; i < numberOfLinks; i++) {
+        ccnxTestrigLink_SetPeer(links[i], ccnxTestrigForwarder_GetFace(forwarder, i));
+    }
+
+    if (!ccnxTestrigForwarder_Start(forwarder)) {
+        ccnxTestrigForwarder_Release(&forwarder);
+    }
+    return forwarder;
+}
+
+static void
+_ccnxTestrig_StopSelfTestForwarder(CCNxTestrigForwarder **forwarderPtr)
+{
+    CCNxTestrigForwarder *forwarder = *forwarderPtr;
+    ccnxTestrigForwarder_Stop(forwarder);
+
+    const CCNxTestrigForwarderStatistics *stats = ccnxTestrigForwarder_GetStatistics(forwarder);
+    printf("Forwarder: %" PRIu64 " Interests received, %" PRIu64 " forwarded, %" PRIu64 " aggregated, %" PRIu64 " dropped, %" PRIu64 " cache hits\n",
+           stats->interestsReceived, stats->interestsForwarded, stats->interestsAggregated, stats->interestsDropped, stats->cacheHits);
+    printf("Forwarder: %" PRIu64 " Content Objects received, %" PRIu64 " forwarded, %" PRIu64 " dropped\n",
+           stats->contentObjectsReceived, stats->contentObjectsForwarded, stats->contentObjectsDropped);
+
+    char *summary = ccnxTestrigHistogram_ToString(ccnxTestrigForwarder_GetProcessingTime(forwarder));
+    printf("Forwarder processing time: %s\n", summary);
+    free(summary);
+
+    ccnxTestrigForwarder_Release(forwarderPtr);
+}
+
+/**
+ * Check that the forwarder forwards every route of the built-in tests, sending the pings of a prefix
+ * from the first link it is not routed to. Packets left over by the probes are drained.
+ */
+static bool
+_ccnxTestrig_ProbeRoutes(CCNxTestrig *rig, int timeout)
+{
+    uint64_t deadline = (timeout < 0) ? UINT64_MAX : ccnxTestrig_GetDeadline(timeout);
+    CCNxTestrigNameGenerator *names = ccnxTestrigNameGenerator_Create(rig->options->seed, PROBE_NAME_STREAM);
+    bool ready = true;
+
+    for (size_t i = 0; ready && i < NUMBER_OF_ROUTES; i++) {
+        const char *prefix = _ccnxTestrig_Routes[i].prefix;
+
+        // Each prefix is probed once, against all of its links.
+        bool probed = false;
+        for (size_t j = 0; j < i; j++) {
+            probed = probed || strcmp(_ccnxTestrig_Routes[j].prefix, prefix) == 0;
+        }
+        if (probed) {
+            continue;
+        }
+
+        PARCBitVector *egress = parcBitVector_Create();
+        for (size_t j = i; j < NUMBER_OF_ROUTES; j++) {
+            if (strcmp(_ccnxTestrig_Routes[j].prefix, prefix) == 0) {
+                parcBitVector_Set(egress, _ccnxTestrig_Routes[j].link);
+            }
+        }
+        CCNxTestrigLinkID ingress = CCNxTestrigLinkID_LinkA;
+        while (parcBitVector_Get(egress, ingress)) {
+            ingress++;
+        }
+
+        char name[CCNX_TESTRIG_LINK_NAME_LENGTH];
+        ready = ccnxTestrigProbe_WaitForRoute(rig, names, prefix, ingress, egress, deadline);
+        if (ready) {
+            printf("Route %s forwarded from link %s\n", prefix, ccnxTestrig_FormatLinkName(ingress, name));
+        } else {
+            fprintf(stderr, "Error: the forwarder did not forward %s from link %s in time\n", prefix, ccnxTestrig_FormatLinkName(ingress, name));
+        }
+        parcBitVector_Release(&egress);
+    }
+
+    ccnxTestrigNameGenerator_Release(&names);
+    ccnxTestrig_DrainLinks(rig);
+    return ready;
+}
+
+/**
+ * Map capture interfaces to links. Links are named one letter per interface, or as a comma-separated
+ * list when they need longer names. A '-', or a link the rig does not have, skips the interface.
+ */
+static CCNxTestrigLinkID *
+_ccnxTestrig_ParseReplayLinks(const char *replayLinks, size_t numberOfLinks, size_t *numberOfInterfaces)
+{
+    char *copy = strdup(replayLinks);
+    bool separated = strchr(copy, ',') != NULL;
+    CCNxTestrigLinkID *links = malloc((strlen(copy) + 1) * sizeof(CCNxTestrigLinkID));
+    size_t count = 0;
+
+    char *save = NULL;
+    char single[2] = { '\0', '\0' };
+    for (char *name = separated ? strtok_r(copy, ",", &save) : copy; name != NULL && *name != '\0';
+         name = separated ? strtok_r(NULL, ",", &save) : name + 1) {
+        if (!separated) {
+            single[0] = *name;
+        }
+        CCNxTestrigLinkID id = ccnxTestrig_ParseLinkName(separated ? name : single);
+        links[count++] = (id <= numberOfLinks) ? id : CCNxTestrigLinkID_NULL;
+    }
+
+    free(copy);
+    *numberOfInterfaces = count;
+    return links;
+}
+
 int
 main(int argc, char** argv)
 {
     // Parse options and create the test rig
     _CCNxTestrigOptions *options = _ccnxTestrig_ParseCommandLineOptions(argc, argv);
 
-    // Open connections to the forwarder
-    int portNumber = options->port;
-    char *address = options->address;
-    CCNxTestrigLink *linkA = ccnxTestrigLink_Listen(options->linkType, address, portNumber++);
-    printf("Link A created at %s:%04d\n", address, portNumber - 1);
-    CCNxTestrigLink *linkB = ccnxTestrigLink_Listen(options->linkType, address, portNumber++);
-    printf("Link B created at %s:%04d\n", address, portNumber - 1);
-    CCNxTestrigLink *linkC = ccnxTestrigLink_Listen(options->linkType, address, portNumber++);
-    printf("Link C created at %s:%04d\n", address, portNumber - 1);
+    // Log from a background thread, so that the tests never wait on the terminal
+    if (ccnxTestrigLog_Start(stdout)) {
+        atexit(ccnxTestrigLog_Stop);
+    }
+
+    // Bind every link before waiting for any, so the forwarder can connect them in any order
+    CCNxTestrigLink **links = calloc(options->numberOfLinks, sizeof(CCNxTestrigLink *));
+    for (unsigned i = 0; i < options->numberOfLinks; i++) {
+        char name[CCNX_TESTRIG_LINK_NAME_LENGTH];
+        links[i] = ccnxTestrigLink_Bind(options->linkType, options->address, options->port + i);
+        if (links[i] == NULL) {
+            fprintf(stderr, "Error: could not bind link %s to %s:%04d\n", ccnxTestrig_FormatLinkName(CCNxTestrigLinkID_LinkA + i, name), options->address, options->port + i);
+            return EXIT_FAILURE;
+        }
+        if (options->submissionPolling && !ccnxTestrigLink_SetSubmissionPolling(links[i], true)) {
+            printf("Link %s sends without submission polling\n", ccnxTestrig_FormatLinkName(CCNxTestrigLinkID_LinkA + i, name));
+        }
+        printf("Link %s created at %s:%04d\n", ccnxTestrig_FormatLinkName(CCNxTestrigLinkID_LinkA + i, name), options->address, options->port + i);
+    }
+
+    printf("Name seed: 0x%016" PRIx64 "\n", options->seed);
+
+    CCNxTestrigForwarder *forwarder = NULL;
+    if (options->selfTest) {
+        forwarder = _ccnxTestrig_StartSelfTestForwarder(options->port, links, options->numberOfLinks);
+        if (forwarder == NULL) {
+            fprintf(stderr, "Error: could not start the self-test forwarder\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!ccnxTestrigLink_AcceptAll(links, options->numberOfLinks, options->readyTimeout)) {
+        for (unsigned i = 0; i < options->numberOfLinks; i++) {
+            char name[CCNX_TESTRIG_LINK_NAME_LENGTH];
+            if (!ccnxTestrigLink_IsConnected(links[i])) {
+                fprintf(stderr, "Error: link %s was not connected in time\n", ccnxTestrig_FormatLinkName(CCNxTestrigLinkID_LinkA + i, name));
+            }
+        }
+        return EXIT_FAILURE;
+    }
 
-    printf("Configure routes on the forwarder...\n");
-    getc(stdin);
+    // Stamp after the accept, so that TCP links stamp on their connected sockets
+    if (options->kernelTimestamps) {
+        bool stamped = true;
+        for (unsigned i = 0; i < options->numberOfLinks; i++) {
+            stamped = ccnxTestrigLink_SetKernelTimestamps(links[i], true) && stamped;
+        }
+
+        // Links that stamp read a different clock than links that do not, so it is all or none.
+        if (!stamped) {
+            fprintf(stderr, "Warning: kernel timestamps are not supported by every link, disabling them\n");
+            for (unsigned i = 0; i < options->numberOfLinks; i++) {
+                ccnxTestrigLink_SetKernelTimestamps(links[i], false);
+            }
+            options->kernelTimestamps = false;
+        }
+    }
 
     // Create the test rig and save the links
     CCNxTestrig *testrig = ccnxTestrig_Create(options);
-    testrig->linkA = linkA;
-    testrig->linkB = linkB;
-    testrig->linkC = linkC;
+    for (unsigned i = 0; i < options->numberOfLinks; i++) {
+        _ccnxTestrig_SetLink(testrig, CCNxTestrigLinkID_LinkA + i, links[i]);
+    }
+
+    // Write the results to the report file as well as the console
+    if (options->report != NULL) {
+        CCNxTestrigReporter *report = ccnxTestrigReporter_Open(options->report, options->reportFormat);
+        if (report == NULL) {
+            fprintf(stderr, "Error: could not create the report %s\n", options->report);
+            return EXIT_FAILURE;
+        }
+        ccnxTestrigReporter_Attach(ccnxTestrig_GetReporter(testrig), report);
+        ccnxTestrigReporter_Release(&report);
+    }
+
+    // Keep the packets the results cannot hold on disk, with one interface per link
+    if (options->packetLogSpillPath != NULL) {
+        options->packetLogSpill = ccnxTestrigCapture_Create(options->packetLogSpillPath, options->numberOfLinks);
+        if (options->packetLogSpill == NULL || !ccnxTestrigCapture_Start(options->packetLogSpill)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Record the traffic of each link on its own capture interface
+    CCNxTestrigCapture *capture = NULL;
+    if (options->capture != NULL) {
+        capture = ccnxTestrigCapture_Create(options->capture, options->numberOfLinks);
+        if (capture == NULL || !ccnxTestrigCapture_Start(capture)) {
+            fprintf(stderr, "Error: could not start the capture %s\n", options->capture);
+            return EXIT_FAILURE;
+        }
+        for (unsigned i = 0; i < options->numberOfLinks; i++) {
+            ccnxTestrigLink_SetCapture(links[i], capture, i);
+        }
+    }
+    free(links);
+
+    // The built-in tests and the load need the routes in place; scripts and replays bring their own names
+    if (options->probe && options->scripts == NULL && options->replay == NULL) {
+        if (!_ccnxTestrig_ProbeRoutes(testrig, options->readyTimeout)) {
+            return EXIT_FAILURE;
+        }
+    }
 
     // Run every test and disply the results
-    ccnxTestrigSuite_RunAll(testrig);
+    size_t failures = 0;
+    if (options->load) {
+        CCNxTestrigResponder *responder = NULL;
+        if (options->responsePayloadSize >= 0) {
+            responder = ccnxTestrigResponder_Create(ccnxTestrig_GetLinkByID(testrig, CCNxTestrigLinkID_LinkB), options->responsePayloadSize);
+        }
+        ccnxTestrigLoad_Run(testrig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_LinkB, options->loadRate, options->loadDuration, responder);
+        if (responder != NULL) {
+            ccnxTestrigResponder_Release(&responder);
+        }
+    } else if (options->replay != NULL) {
+        size_t numberOfInterfaces;
+        CCNxTestrigLinkID *replayLinks = _ccnxTestrig_ParseReplayLinks(options->replayLinks, options->numberOfLinks, &numberOfInterfaces);
+        if (!ccnxTestrigReplay_Run(testrig, options->replay, replayLinks, numberOfInterfaces, options->replaySpeed)) {
+            failures++;
+        }
+        free(replayLinks);
+    } else if (options->scripts != NULL) {
+        PARCLinkedList *scripts = ccnxTestrigScriptLoader_LoadAll(options->scripts, options->planCache, ccnxTestrig_GetNumberOfLinks(testrig));
+        failures = ccnxTestrigSuite_RunScripts(testrig, scripts);
+        parcLinkedList_Release(&scripts);
+    } else if (options->concurrent) {
+        failures = ccnxTestrigSuite_RunAllConcurrently(testrig);
+    } else {
+        failures = ccnxTestrigSuite_RunAll(testrig);
+    }
+
+    ccnxTestrigReporter_Close(ccnxTestrig_GetReporter(testrig));
+
+    if (forwarder != NULL) {
+        _ccnxTestrig_StopSelfTestForwarder(&forwarder);
+    }
+
+    if (capture != NULL) {
+        ccnxTestrigCapture_Stop(capture);
+        printf("Capture written to %s (%" PRIu64 " packets dropped)\n", options->capture, ccnxTestrigCapture_GetDroppedCount(capture));
+        ccnxTestrigCapture_Release(&capture);
+    }
+
+    if (options->packetLogSpill != NULL) {
+        ccnxTestrigCapture_Stop(options->packetLogSpill);
+        printf("Spilled packets written to %s (%" PRIu64 " packets dropped)\n", options->packetLogSpillPath,
+               ccnxTestrigCapture_GetDroppedCount(options->packetLogSpill));
+    }
 
-    return 0;
+    return failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
 }
+#endif // CCNX_TESTRIG_LIBRARY
@@ -55,21 +55,193 @@
 #ifndef ccnx_testrig_h
 #define ccnx_testrig_h
 
+#include <stdint.h>
+
 #include <parc/algol/parc_BitVector.h>
 
+#include <ccnx/common/ccnx_Name.h>
+
 #include "ccnxTestrig_Link.h"
 #include "ccnxTestrig_Reporter.h"
+#include "ccnxTestrig_NameGenerator.h"
 
 struct ccnx_testrig;
 typedef struct ccnx_testrig CCNxTestrig;
 
+struct ccnx_testrig_dispatcher;
+struct ccnx_testrig_packet_template;
+
+/**
+ * Links are numbered from 1 up to the number of links the rig was configured with, and named
+ * A to Z, then AA, AB and so on. The first three links, which the built-in tests use, have
+ * their own identifiers.
+ */
 typedef enum {
+    CCNxTestrigLinkID_NULL = 0x00,
     CCNxTestrigLinkID_LinkA = 0x01,
     CCNxTestrigLinkID_LinkB = 0x02,
-    CCNxTestrigLinkID_LinkC = 0x03,
-    CCNxTestrigLinkID_NULL
+    CCNxTestrigLinkID_LinkC = 0x03
 } CCNxTestrigLinkID;
 
+// Long enough for the name of any link, including the terminating null.
+#define CCNX_TESTRIG_LINK_NAME_LENGTH 8
+
+/**
+ * Increase the number of references to a `CCNxTestrig` instance.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ *
+ * @return The same value as @p rig.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrig *rig = ...
+ *     CCNxTestrig *handle = ccnxTestrig_Acquire(rig);
+ *
+ *     ccnxTestrig_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrig *ccnxTestrig_Acquire(const CCNxTestrig *rig);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrig` instance,
+ * decrementing the reference count for the instance.
+ *
+ * @param [in,out] rigPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrig *handle = ccnxTestrig_Acquire(rig);
+ *
+ *     ccnxTestrig_Release(&handle);
+ * }
+ * @endcode
+ */
+void ccnxTestrig_Release(CCNxTestrig **rigPtr);
+
+/**
+ * Create a view of a `CCNxTestrig` whose packets are delivered by a dispatcher.
+ *
+ * The view shares the links of the rig, so packets are sent as usual. Packets are received
+ * only if their name was claimed through the view by `ccnxTestrig_ClaimName`. This lets
+ * several tests run concurrently over the same links, each with its own view.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ * @param [in] dispatcher A running `CCNxTestrigDispatcher` that reads the links of @p rig.
+ *
+ * @return A newly allocated `CCNxTestrig` that must be freed by `ccnxTestrig_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigDispatcher *dispatcher = ccnxTestrigDispatcher_Create(rig);
+ *     ccnxTestrigDispatcher_Start(dispatcher);
+ *
+ *     CCNxTestrig *view = ccnxTestrig_CreateView(rig, dispatcher);
+ * }
+ * @endcode
+ */
+CCNxTestrig *ccnxTestrig_CreateView(CCNxTestrig *rig, struct ccnx_testrig_dispatcher *dispatcher);
+
+/**
+ * Claim the packets with the given name for the given `CCNxTestrig` view.
+ *
+ * Claiming a name has no effect on a rig that reads its links directly.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ * @param [in] name The name of the packets the view expects to receive.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrig *view = ccnxTestrig_CreateView(rig, dispatcher);
+ *     ccnxTestrig_ClaimName(view, ccnxInterest_GetName(interest));
+ * }
+ * @endcode
+ */
+void ccnxTestrig_ClaimName(CCNxTestrig *rig, const CCNxName *name);
+
+/**
+ * Register a packet template with the rig so that scripts can send from it by name.
+ *
+ * Templates are shared with every view of the rig. They must be registered before any
+ * tests run, since lookups are not synchronized with registration.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ * @param [in] template The `CCNxTestrigPacketTemplate` to register, which the rig acquires.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigPacketTemplate *template = ccnxTestrigPacketTemplate_Create("interest/b", interest);
+ *     ccnxTestrig_RegisterPacketTemplate(rig, template);
+ *     ccnxTestrigPacketTemplate_Release(&template);
+ * }
+ * @endcode
+ */
+void ccnxTestrig_RegisterPacketTemplate(CCNxTestrig *rig, struct ccnx_testrig_packet_template *template);
+
+/**
+ * Retrieve a packet template that was registered with the rig.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ * @param [in] name The name the template was created with.
+ *
+ * @retval The `CCNxTestrigPacketTemplate`, which remains owned by the rig.
+ * @retval NULL if no template of that name is registered.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigPacketTemplate *template = ccnxTestrig_GetPacketTemplate(rig, "interest/b");
+ * }
+ * @endcode
+ */
+struct ccnx_testrig_packet_template *ccnxTestrig_GetPacketTemplate(CCNxTestrig *rig, const char *name);
+
+/**
+ * Retrieve the name generator of the given `CCNxTestrig`.
+ *
+ * A rig and each of its views have their own generator, so a test can draw names without
+ * synchronizing with tests running on other views.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ *
+ * @return The `CCNxTestrigNameGenerator`, which remains owned by the rig.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxName *name = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
+ * }
+ * @endcode
+ */
+CCNxTestrigNameGenerator *ccnxTestrig_GetNameGenerator(CCNxTestrig *rig);
+
+/**
+ * Create a name generator for a new stream of the run.
+ *
+ * Streams are numbered in the order they are created, so a run repeated with the same seed
+ * produces the same names.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ *
+ * @return A new `CCNxTestrigNameGenerator` that must be freed by `ccnxTestrigNameGenerator_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigNameGenerator *generator = ccnxTestrig_CreateNameGenerator(rig);
+ *
+ *     ccnxTestrigNameGenerator_Release(&generator);
+ * }
+ * @endcode
+ */
+CCNxTestrigNameGenerator *ccnxTestrig_CreateNameGenerator(CCNxTestrig *rig);
+
 /**
  * Retrieve the `CCNxTestrigReporter` associated with the given `CCNxTestrig`.
  *
@@ -85,12 +257,70 @@ typedef enum {
  */
 CCNxTestrigReporter *ccnxTestrig_GetReporter(CCNxTestrig *rig);
 
+/**
+ * Retrieve the number of forwarder-under-test links of the given `CCNxTestrig`.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ *
+ * @return The number of links, which are identified by 1 up to this number.
+ *
+ * Example:
+ * @code
+ * {
+ *     for (CCNxTestrigLinkID id = CCNxTestrigLinkID_LinkA; id <= ccnxTestrig_GetNumberOfLinks(rig); id++) {
+ *         CCNxTestrigLink *link = ccnxTestrig_GetLinkByID(rig, id);
+ *     }
+ * }
+ * @endcode
+ */
+size_t ccnxTestrig_GetNumberOfLinks(const CCNxTestrig *rig);
+
+/**
+ * Format the name of a link, such as "A" for `CCNxTestrigLinkID_LinkA` or "AB" for link 28.
+ *
+ * @param [in] linkID The identifier of the link.
+ * @param [out] name A buffer of at least `CCNX_TESTRIG_LINK_NAME_LENGTH` bytes.
+ *
+ * @return The same value as @p name.
+ *
+ * Example:
+ * @code
+ * {
+ *     char name[CCNX_TESTRIG_LINK_NAME_LENGTH];
+ *     printf("Packet received on link %s\n", ccnxTestrig_FormatLinkName(linkID, name));
+ * }
+ * @endcode
+ */
+char *ccnxTestrig_FormatLinkName(CCNxTestrigLinkID linkID, char *name);
+
+/**
+ * Parse the name of a link, as formatted by `ccnxTestrig_FormatLinkName`.
+ *
+ * The name is not checked against the number of links of any rig.
+ *
+ * @param [in] name The name of the link.
+ *
+ * @retval The identifier of the link.
+ * @retval CCNxTestrigLinkID_NULL if @p name is not a link name.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigLinkID linkID = ccnxTestrig_ParseLinkName("AB");
+ * }
+ * @endcode
+ */
+CCNxTestrigLinkID ccnxTestrig_ParseLinkName(const char *name);
+
 /**
  * Retrieve the forwarder link associated with the given identity.
  *
  * @param [in] rig A `CCNxTestrig` instance.
  * @param [in] linkID A CCNxTestrigLinkID corresponding to one of the forwarder-under-test links.
  *
+ * @retval The `CCNxTestrigLink`, which remains owned by the rig.
+ * @retval NULL if the rig has no link of that identity.
+ *
  * Example:
  * @code
  * {
@@ -104,6 +334,8 @@ CCNxTestrigLink *ccnxTestrig_GetLinkByID(CCNxTestrig *rig, CCNxTestrigLinkID lin
 /**
  * Retrieve a bit vector that encodes the links given in the variable argument list.
  *
+ * The list is terminated by `CCNxTestrigLinkID_NULL`. Bit n of the vector is set for link n.
+ *
  * @param [in] rig A `CCNxTestrig` instance.
  * @param [in] linkID A CCNxTestrigLinkID corresponding to one of the forwarder-under-test links.
  * ...
@@ -114,24 +346,182 @@ CCNxTestrigLink *ccnxTestrig_GetLinkByID(CCNxTestrig *rig, CCNxTestrigLinkID lin
  * @code
  * {
  *     CCNxTestrig *rig = ...
- *     PARCBitVector *linkVector = ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA);
+ *     PARCBitVector *linkVector = ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL);
  * }
  * @endcode
  */
 PARCBitVector *ccnxTestrig_GetLinkVector(CCNxTestrig *rig, CCNxTestrigLinkID linkID, ...);
 
 /**
- * Flush all pending messages on each of the testrig links.
+ * Read the monotonic clock that deadlines and latencies are measured with.
+ *
+ * @return The current time in nanoseconds.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t sendTime = ccnxTestrig_GetTime();
+ * }
+ * @endcode
+ */
+uint64_t ccnxTestrig_GetTime(void);
+
+/**
+ * Compute the deadline that lies the given number of milliseconds in the future.
+ *
+ * Deadlines are expressed in nanoseconds of the monotonic clock so that a single
+ * deadline can be shared by several receive operations.
+ *
+ * @param [in] timeout The number of milliseconds until the deadline expires.
+ *
+ * @return The absolute deadline.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t deadline = ccnxTestrig_GetDeadline(1000);
+ * }
+ * @endcode
+ */
+uint64_t ccnxTestrig_GetDeadline(int timeout);
+
+/**
+ * Receive a packet from any of the links in the given link vector.
+ *
+ * All of the links are waited upon at once, so the first packet to arrive on any
+ * of them is returned. The call blocks until a packet is read or the deadline expires.
+ * A deadline that has already expired only returns packets that are pending.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ * @param [in] linkVector The links upon which a packet may be received.
+ * @param [in] deadline The deadline computed by `ccnxTestrig_GetDeadline`.
+ * @param [out] linkID Set to the link on which the packet was received.
+ *
+ * @retval A `PARCBuffer` containing the packet read from the link.
+ * @retval NULL if no packet arrived before the deadline.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrig *rig = ...
+ *     PARCBitVector *linkVector = ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_LinkC, CCNxTestrigLinkID_NULL);
+ *
+ *     CCNxTestrigLinkID linkID;
+ *     PARCBuffer *packet = ccnxTestrig_ReceiveFromLinks(rig, linkVector, ccnxTestrig_GetDeadline(1000), &linkID);
+ * }
+ * @endcode
+ */
+PARCBuffer *ccnxTestrig_ReceiveFromLinks(CCNxTestrig *rig, PARCBitVector *linkVector, uint64_t deadline, CCNxTestrigLinkID *linkID);
+
+/**
+ * Retrieve the quiescence window, the time after which silent links are considered idle.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ *
+ * @return The quiescence window, in milliseconds.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t deadline = ccnxTestrig_GetDeadline(ccnxTestrig_GetQuiescence(rig));
+ * }
+ * @endcode
+ */
+int ccnxTestrig_GetQuiescence(const CCNxTestrig *rig);
+
+/**
+ * Retrieve the time at which the packet most recently returned by `ccnxTestrig_ReceiveFromLinks` arrived on its link.
+ *
+ * The time is taken by the link, from the clock read by `ccnxTestrigLink_GetTime`, so it leaves out
+ * the time the packet then spent in the rig. A view returns the time of its own last packet.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ *
+ * @return The receive time in nanoseconds.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t sendTime = ccnxTestrigLink_GetTime(ccnxTestrig_GetLinkByID(rig, CCNxTestrigLinkID_LinkA));
+ *     ...
+ *     PARCBuffer *packet = ccnxTestrig_ReceiveFromLinks(rig, linkVector, ccnxTestrig_GetDeadline(1000), &linkID);
+ *     uint64_t latency = ccnxTestrig_GetReceiveTime(rig) - sendTime;
+ * }
+ * @endcode
+ */
+uint64_t ccnxTestrig_GetReceiveTime(const CCNxTestrig *rig);
+
+/**
+ * Retrieve the number of sent packets each test result keeps for diagnosis.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ *
+ * @return The capacity of the packet log of each result.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigSuiteTestResult_SetPacketLog(result, ccnxTestrig_GetPacketLogCapacity(rig), ccnxTestrig_GetPacketLogSpill(rig));
+ * }
+ * @endcode
+ */
+size_t ccnxTestrig_GetPacketLogCapacity(const CCNxTestrig *rig);
+
+/**
+ * Retrieve the capture that records the packets pushed out of the packet logs of the test results.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ *
+ * @return The capture, which remains owned by the rig, or NULL if those packets are dropped.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigSuiteTestResult_SetPacketLog(result, ccnxTestrig_GetPacketLogCapacity(rig), ccnxTestrig_GetPacketLogSpill(rig));
+ * }
+ * @endcode
+ */
+CCNxTestrigCapture *ccnxTestrig_GetPacketLogSpill(const CCNxTestrig *rig);
+
+/**
+ * Discard all stale messages pending on each of the testrig links.
+ *
+ * The links are read without blocking for as long as packets keep arriving. The links
+ * are considered quiescent, and the drain completes, once no link has produced a packet
+ * for the configured quiescence window. Links that never go quiet are given up on after
+ * one hundred quiescence windows, with a warning that gives the number of packets drained.
  *
  * @param [in] rig A `CCNxTestrig` instance.
  *
+ * @return The total number of packets that were discarded.
+ *
  * Example:
  * @code
  * {
  *     CCNxTestrig *rig = ...
- *     ccnxTestrig_FlushLinks(rig);
+ *     size_t discarded = ccnxTestrig_DrainLinks(rig);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrig_DrainLinks(CCNxTestrig *rig);
+
+/**
+ * Retrieve the number of packets discarded on a link by the most recent `ccnxTestrig_DrainLinks`.
+ *
+ * @param [in] rig A `CCNxTestrig` instance.
+ * @param [in] linkID A CCNxTestrigLinkID corresponding to one of the forwarder-under-test links.
+ *
+ * @return The number of stale packets discarded on the link.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrig *rig = ...
+ *     ccnxTestrig_DrainLinks(rig);
+ *
+ *     size_t discardedOnLinkA = ccnxTestrig_GetDiscardedPacketCount(rig, CCNxTestrigLinkID_LinkA);
  * }
  * @endcode
  */
-void ccnxTestrig_FlushLinks(CCNxTestrig *rig);
+size_t ccnxTestrig_GetDiscardedPacketCount(CCNxTestrig *rig, CCNxTestrigLinkID linkID);
 #endif // ccnx_testrig_h
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdlib.h>
+
+#include <parc/algol/parc_Object.h>
+
+#include "ccnxTestrig_BufferPool.h"
+
+struct ccnx_testrig_buffer_pool {
+    size_t capacity;
+    size_t bufferSize;
+
+    // The pool owns one reference to each buffer, which owns one reference to its array.
+    PARCBuffer **buffers;
+    size_t cursor;
+
+    size_t highWaterMark;
+    size_t missCount;
+};
+
+static bool
+_ccnxTestrigBufferPool_Destructor(CCNxTestrigBufferPool **poolPtr)
+{
+    CCNxTestrigBufferPool *pool = *poolPtr;
+
+    for (size_t i = 0; i < pool->capacity; i++) {
+        parcBuffer_Release(&pool->buffers[i]);
+    }
+    free(pool->buffers);
+
+    return true;
+}
+
+parcObject_ImplementAcquire(ccnxTestrigBufferPool, CCNxTestrigBufferPool);
+parcObject_ImplementRelease(ccnxTestrigBufferPool, CCNxTestrigBufferPool);
+
+parcObject_Override(
+	CCNxTestrigBufferPool, PARCObject,
+	.destructor = (PARCObjectDestructor *) _ccnxTestrigBufferPool_Destructor);
+
+CCNxTestrigBufferPool *
+ccnxTestrigBufferPool_Create(size_t capacity, size_t bufferSize)
+{
+    CCNxTestrigBufferPool *pool = parcObject_CreateInstance(CCNxTestrigBufferPool);
+
+    if (pool != NULL) {
+        pool->capacity = capacity;
+        pool->bufferSize = bufferSize;
+        pool->buffers = malloc(sizeof(PARCBuffer *) * capacity);
+        for (size_t i = 0; i < capacity; i++) {
+            pool->buffers[i] = parcBuffer_Allocate(bufferSize);
+        }
+        pool->cursor = 0;
+        pool->highWaterMark = 0;
+        pool->missCount = 0;
+    }
+
+    return pool;
+}
+
+/**
+ * A buffer is free when the pool holds the only reference to it and to its bytes. Slices and
+ * duplicates of a buffer, such as those a decoded packet keeps of its fields, share its array
+ * without referencing the buffer itself.
+ */
+static bool
+_ccnxTestrigBufferPool_IsFree(const PARCBuffer *buffer)
+{
+    return parcObject_GetReferenceCount(buffer) == 1 && parcObject_GetReferenceCount(parcBuffer_Array(buffer)) == 1;
+}
+
+/**
+ * Count the buffers in use and raise the high-water mark to the count.
+ */
+static void
+_ccnxTestrigBufferPool_SampleInUse(CCNxTestrigBufferPool *pool)
+{
+    size_t inUse = 0;
+    for (size_t i = 0; i < pool->capacity; i++) {
+        if (!_ccnxTestrigBufferPool_IsFree(pool->buffers[i])) {
+            inUse++;
+        }
+    }
+
+    if (inUse > pool->highWaterMark) {
+        pool->highWaterMark = inUse;
+    }
+}
+
+PARCBuffer *
+ccnxTestrigBufferPool_Get(CCNxTestrigBufferPool *pool)
+{
+    // Buffers are mostly released in the order they were taken, so the buffer at the cursor is
+    // usually free and a get visits a single slot. The buffers in use are counted once per pass
+    // of the cursor over the pool, which adds one slot visit per get.
+    for (size_t visited = 0; visited < pool->capacity; visited++) {
+        PARCBuffer *buffer = pool->buffers[pool->cursor];
+        if (++pool->cursor == pool->capacity) {
+            pool->cursor = 0;
+            _ccnxTestrigBufferPool_SampleInUse(pool);
+        }
+
+        if (_ccnxTestrigBufferPool_IsFree(buffer)) {
+            parcBuffer_Clear(buffer);
+            return parcBuffer_Acquire(buffer);
+        }
+    }
+
+    pool->highWaterMark = pool->capacity;
+    pool->missCount++;
+    return parcBuffer_Allocate(pool->bufferSize);
+}
+
+size_t
+ccnxTestrigBufferPool_GetHighWaterMark(const CCNxTestrigBufferPool *pool)
+{
+    return pool->highWaterMark;
+}
+
+size_t
+ccnxTestrigBufferPool_GetMissCount(const CCNxTestrigBufferPool *pool)
+{
+    return pool->missCount;
+}
+
+size_t
+ccnxTestrigBufferPool_GetCapacity(const CCNxTestrigBufferPool *pool)
+{
+    return pool->capacity;
+}
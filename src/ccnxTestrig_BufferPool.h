@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_BufferPool_h
+#define ccnxTestrig_BufferPool_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <parc/algol/parc_Buffer.h>
+
+struct ccnx_testrig_buffer_pool;
+typedef struct ccnx_testrig_buffer_pool CCNxTestrigBufferPool;
+
+/**
+ * Create a `CCNxTestrigBufferPool` of preallocated, recyclable `PARCBuffer` instances.
+ *
+ * A buffer taken from the pool is returned to it when the last reference held outside
+ * of the pool is released, so packets can be read straight into pool memory and handed
+ * to the rest of the rig without copying. Slices and duplicates of the buffer count as
+ * references, as they share its memory.
+ *
+ * @param [in] capacity The number of buffers in the pool.
+ * @param [in] bufferSize The capacity, in bytes, of each buffer.
+ *
+ * @return A newly allocated `CCNxTestrigBufferPool` that must be freed by `ccnxTestrigBufferPool_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigBufferPool *pool = ccnxTestrigBufferPool_Create(128, 4096);
+ *
+ *     ccnxTestrigBufferPool_Release(&pool);
+ * }
+ * @endcode
+ */
+CCNxTestrigBufferPool *ccnxTestrigBufferPool_Create(size_t capacity, size_t bufferSize);
+
+/**
+ * Increase the number of references to a `CCNxTestrigBufferPool` instance.
+ *
+ * @param [in] pool A `CCNxTestrigBufferPool` instance.
+ *
+ * @return The same value as @p pool.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigBufferPool *handle = ccnxTestrigBufferPool_Acquire(pool);
+ *
+ *     ccnxTestrigBufferPool_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigBufferPool *ccnxTestrigBufferPool_Acquire(const CCNxTestrigBufferPool *pool);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigBufferPool` instance,
+ * decrementing the reference count for the instance.
+ *
+ * Buffers that are still referenced elsewhere remain valid after the pool is freed.
+ *
+ * @param [in,out] poolPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigBufferPool *pool = ccnxTestrigBufferPool_Create(128, 4096);
+ *
+ *     ccnxTestrigBufferPool_Release(&pool);
+ * }
+ * @endcode
+ */
+void ccnxTestrigBufferPool_Release(CCNxTestrigBufferPool **poolPtr);
+
+/**
+ * Take a free buffer from the pool.
+ *
+ * The buffer is cleared, so its position is zero and its limit is its capacity. If every
+ * buffer in the pool is in use, a new buffer is allocated instead and counted as a miss.
+ *
+ * A pool may be used by a single thread at a time, while its buffers may be released from any thread.
+ *
+ * @param [in] pool A `CCNxTestrigBufferPool` instance.
+ *
+ * @return A `PARCBuffer` that must be released by `parcBuffer_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *buffer = ccnxTestrigBufferPool_Get(pool);
+ *     ssize_t length = recv(socket, parcBuffer_Overlay(buffer, 0), parcBuffer_Remaining(buffer), 0);
+ *     parcBuffer_SetLimit(buffer, length);
+ *
+ *     parcBuffer_Release(&buffer);
+ * }
+ * @endcode
+ */
+PARCBuffer *ccnxTestrigBufferPool_Get(CCNxTestrigBufferPool *pool);
+
+/**
+ * Retrieve the largest number of pool buffers that were in use at the same time.
+ *
+ * The buffers in use are counted each time the pool has been cycled through, and the
+ * mark reaches the capacity of the pool as soon as it misses.
+ *
+ * @param [in] pool A `CCNxTestrigBufferPool` instance.
+ *
+ * @return The high-water mark of the pool.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t highWaterMark = ccnxTestrigBufferPool_GetHighWaterMark(pool);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigBufferPool_GetHighWaterMark(const CCNxTestrigBufferPool *pool);
+
+/**
+ * Retrieve the number of buffers that were allocated because the pool was exhausted.
+ *
+ * @param [in] pool A `CCNxTestrigBufferPool` instance.
+ *
+ * @return The number of pool misses.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t misses = ccnxTestrigBufferPool_GetMissCount(pool);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigBufferPool_GetMissCount(const CCNxTestrigBufferPool *pool);
+
+/**
+ * Retrieve the number of buffers in the pool.
+ *
+ * @param [in] pool A `CCNxTestrigBufferPool` instance.
+ *
+ * @return The capacity of the pool.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t capacity = ccnxTestrigBufferPool_GetCapacity(pool);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigBufferPool_GetCapacity(const CCNxTestrigBufferPool *pool);
+#endif // ccnxTestrig_BufferPool_h
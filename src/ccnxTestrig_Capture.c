@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <parc/algol/parc_Object.h>
+
+#include "ccnxTestrig.h"
+#include "ccnxTestrig_Capture.h"
+
+// Packets are truncated to the snapshot length, which covers every packet the rig sends over UDP.
+#define CAPTURE_SNAPLEN 4096
+
+// The number of ring slots. It must be a power of two. With the snapshot length this bounds the ring to about 8MB.
+#define CAPTURE_RING_CAPACITY 2048
+
+#define CAPTURE_WRITE_BUFFER_SIZE (1 << 20)
+
+// How long the writer sleeps when it finds the ring empty.
+#define CAPTURE_IDLE_NANOSECONDS 1000000
+
+#define PCAPNG_SECTION_HEADER_BLOCK 0x0A0D0D0A
+#define PCAPNG_INTERFACE_DESCRIPTION_BLOCK 1
+#define PCAPNG_INTERFACE_STATISTICS_BLOCK 5
+#define PCAPNG_ENHANCED_PACKET_BLOCK 6
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+
+#define PCAPNG_OPTION_END 0
+#define PCAPNG_OPTION_IF_NAME 2
+#define PCAPNG_OPTION_IF_TSRESOL 9
+#define PCAPNG_OPTION_EPB_FLAGS 2
+#define PCAPNG_OPTION_ISB_IFDROP 5
+
+// There is no registered link type for bare CCNx packets.
+#define LINKTYPE_USER0 147
+
+// Block headers, trailers and options around the largest captured packet.
+#define PCAPNG_MAX_BLOCK_SIZE (CAPTURE_SNAPLEN + 64)
+
+typedef struct {
+    // The ring position this slot is ready for, as in Vyukov's bounded queue.
+    size_t sequence;
+    uint64_t timestamp;
+    uint32_t interface;
+    uint32_t direction;
+    uint32_t capturedLength;
+    uint32_t originalLength;
+    uint8_t data[CAPTURE_SNAPLEN];
+} _CCNxTestrigCaptureSlot;
+
+struct ccnx_testrig_capture {
+    FILE *file;
+    char *fileBuffer;
+
+    unsigned numberOfInterfaces;
+    uint64_t *dropped;
+
+    _CCNxTestrigCaptureSlot *slots;
+    size_t tail;
+    size_t head;
+
+    pthread_t writer;
+    bool running;
+    bool started;
+
+    uint8_t block[PCAPNG_MAX_BLOCK_SIZE];
+};
+
+static void _ccnxTestrigCapture_Close(CCNxTestrigCapture *capture);
+
+static bool
+_ccnxTestrigCapture_Destructor(CCNxTestrigCapture **capturePtr)
+{
+    CCNxTestrigCapture *capture = *capturePtr;
+
+    ccnxTestrigCapture_Stop(capture);
+    _ccnxTestrigCapture_Close(capture);
+    free(capture->slots);
+    free(capture->dropped);
+
+    return true;
+}
+
+parcObject_ImplementAcquire(ccnxTestrigCapture, CCNxTestrigCapture);
+parcObject_ImplementRelease(ccnxTestrigCapture, CCNxTestrigCapture);
+
+parcObject_Override(
+	CCNxTestrigCapture, PARCObject,
+	.destructor = (PARCObjectDestructor *) _ccnxTestrigCapture_Destructor);
+
+static size_t
+_ccnxTestrigCapture_Put16(uint8_t *block, size_t offset, uint16_t value)
+{
+    memcpy(block + offset, &value, sizeof(value));
+    return offset + sizeof(value);
+}
+
+static size_t
+_ccnxTestrigCapture_Put32(uint8_t *block, size_t offset, uint32_t value)
+{
+    memcpy(block + offset, &value, sizeof(value));
+    return offset + sizeof(value);
+}
+
+static size_t
+_ccnxTestrigCapture_Put64(uint8_t *block, size_t offset, uint64_t value)
+{
+    memcpy(block + offset, &value, sizeof(value));
+    return offset + sizeof(value);
+}
+
+/**
+ * Append bytes followed by zero padding up to a multiple of four, as pcapng requires for packet data and options.
+ */
+static size_t
+_ccnxTestrigCapture_PutPadded(uint8_t *block, size_t offset, const void *data, size_t length)
+{
+    memcpy(block + offset, data, length);
+    offset += length;
+    while (offset % 4 != 0) {
+        block[offset++] = 0;
+    }
+    return offset;
+}
+
+static size_t
+_ccnxTestrigCapture_PutOption(uint8_t *block, size_t offset, uint16_t code, const void *value, size_t length)
+{
+    offset = _ccnxTestrigCapture_Put16(block, offset, code);
+    offset = _ccnxTestrigCapture_Put16(block, offset, (uint16_t) length);
+    return _ccnxTestrigCapture_PutPadded(block, offset, value, length);
+}
+
+static size_t
+_ccnxTestrigCapture_BeginBlock(uint8_t *block, uint32_t type)
+{
+    size_t offset = _ccnxTestrigCapture_Put32(block, 0, type);
+    // The total length is filled in by _ccnxTestrigCapture_EndBlock.
+    return _ccnxTestrigCapture_Put32(block, offset, 0);
+}
+
+/**
+ * Terminate the options, fill in the block length at both ends, and write the block.
+ */
+static bool
+_ccnxTestrigCapture_EndBlock(CCNxTestrigCapture *capture, size_t offset, bool hasOptions)
+{
+    if (hasOptions) {
+        offset = _ccnxTestrigCapture_Put16(capture->block, offset, PCAPNG_OPTION_END);
+        offset = _ccnxTestrigCapture_Put16(capture->block, offset, 0);
+    }
+    uint32_t length = (uint32_t) (offset + sizeof(uint32_t));
+    _ccnxTestrigCapture_Put32(capture->block, 4, length);
+    _ccnxTestrigCapture_Put32(capture->block, offset, length);
+
+    return fwrite(capture->block, length, 1, capture->file) == 1;
+}
+
+static bool
+_ccnxTestrigCapture_WriteHeader(CCNxTestrigCapture *capture)
+{
+    uint8_t *block = capture->block;
+
+    size_t offset = _ccnxTestrigCapture_BeginBlock(block, PCAPNG_SECTION_HEADER_BLOCK);
+    offset = _ccnxTestrigCapture_Put32(block, offset, PCAPNG_BYTE_ORDER_MAGIC);
+    offset = _ccnxTestrigCapture_Put16(block, offset, 1);
+    offset = _ccnxTestrigCapture_Put16(block, offset, 0);
+    // The section length is not known in advance.
+    offset = _ccnxTestrigCapture_Put64(block, offset, UINT64_MAX);
+    if (!_ccnxTestrigCapture_EndBlock(capture, offset, false)) {
+        return false;
+    }
+
+    for (unsigned i = 0; i < capture->numberOfInterfaces; i++) {
+        char linkName[CCNX_TESTRIG_LINK_NAME_LENGTH];
+        char name[32];
+        snprintf(name, sizeof(name), "link %s", ccnxTestrig_FormatLinkName(CCNxTestrigLinkID_LinkA + i, linkName));
+        uint8_t resolution = 9; // nanoseconds
+
+        offset = _ccnxTestrigCapture_BeginBlock(block, PCAPNG_INTERFACE_DESCRIPTION_BLOCK);
+        offset = _ccnxTestrigCapture_Put16(block, offset, LINKTYPE_USER0);
+        offset = _ccnxTestrigCapture_Put16(block, offset, 0);
+        offset = _ccnxTestrigCapture_Put32(block, offset, CAPTURE_SNAPLEN);
+        offset = _ccnxTestrigCapture_PutOption(block, offset, PCAPNG_OPTION_IF_NAME, name, strlen(name));
+        offset = _ccnxTestrigCapture_PutOption(block, offset, PCAPNG_OPTION_IF_TSRESOL, &resolution, sizeof(resolution));
+        if (!_ccnxTestrigCapture_EndBlock(capture, offset, true)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void
+_ccnxTestrigCapture_WritePacket(CCNxTestrigCapture *capture, const _CCNxTestrigCaptureSlot *slot)
+{
+    uint8_t *block = capture->block;
+    uint32_t flags = slot->direction;
+
+    size_t offset = _ccnxTestrigCapture_BeginBlock(block, PCAPNG_ENHANCED_PACKET_BLOCK);
+    offset = _ccnxTestrigCapture_Put32(block, offset, slot->interface);
+    offset = _ccnxTestrigCapture_Put32(block, offset, (uint32_t) (slot->timestamp >> 32));
+    offset = _ccnxTestrigCapture_Put32(block, offset, (uint32_t) slot->timestamp);
+    offset = _ccnxTestrigCapture_Put32(block, offset, slot->capturedLength);
+    offset = _ccnxTestrigCapture_Put32(block, offset, slot->originalLength);
+    offset = _ccnxTestrigCapture_PutPadded(block, offset, slot->data, slot->capturedLength);
+    offset = _ccnxTestrigCapture_PutOption(block, offset, PCAPNG_OPTION_EPB_FLAGS, &flags, sizeof(flags));
+    _ccnxTestrigCapture_EndBlock(capture, offset, true);
+}
+
+static void
+_ccnxTestrigCapture_WriteStatistics(CCNxTestrigCapture *capture)
+{
+    uint8_t *block = capture->block;
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    uint64_t timestamp = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+
+    for (unsigned i = 0; i < capture->numberOfInterfaces; i++) {
+        uint64_t dropped = __atomic_load_n(&capture->dropped[i], __ATOMIC_RELAXED);
+
+        size_t offset = _ccnxTestrigCapture_BeginBlock(block, PCAPNG_INTERFACE_STATISTICS_BLOCK);
+        offset = _ccnxTestrigCapture_Put32(block, offset, i);
+        offset = _ccnxTestrigCapture_Put32(block, offset, (uint32_t) (timestamp >> 32));
+        offset = _ccnxTestrigCapture_Put32(block, offset, (uint32_t) timestamp);
+        offset = _ccnxTestrigCapture_PutOption(block, offset, PCAPNG_OPTION_ISB_IFDROP, &dropped, sizeof(dropped));
+        _ccnxTestrigCapture_EndBlock(capture, offset, true);
+    }
+}
+
+static void
+_ccnxTestrigCapture_Close(CCNxTestrigCapture *capture)
+{
+    if (capture->file != NULL) {
+        fclose(capture->file);
+        capture->file = NULL;
+    }
+    free(capture->fileBuffer);
+    capture->fileBuffer = NULL;
+}
+
+CCNxTestrigCapture *
+ccnxTestrigCapture_Create(const char *path, unsigned numberOfInterfaces)
+{
+    CCNxTestrigCapture *capture = parcObject_CreateInstance(CCNxTestrigCapture);
+    if (capture == NULL) {
+        return NULL;
+    }
+
+    capture->numberOfInterfaces = numberOfInterfaces;
+    capture->dropped = calloc(numberOfInterfaces, sizeof(uint64_t));
+    capture->slots = malloc(CAPTURE_RING_CAPACITY * sizeof(_CCNxTestrigCaptureSlot));
+    capture->tail = 0;
+    capture->head = 0;
+    capture->running = false;
+    capture->started = false;
+    capture->fileBuffer = malloc(CAPTURE_WRITE_BUFFER_SIZE);
+    capture->file = fopen(path, "wb");
+
+    if (capture->file == NULL || capture->slots == NULL || capture->dropped == NULL || capture->fileBuffer == NULL) {
+        fprintf(stderr, "Error: could not create capture file %s\n", path);
+        ccnxTestrigCapture_Release(&capture);
+        return NULL;
+    }
+    setvbuf(capture->file, capture->fileBuffer, _IOFBF, CAPTURE_WRITE_BUFFER_SIZE);
+
+    for (size_t i = 0; i < CAPTURE_RING_CAPACITY; i++) {
+        capture->slots[i].sequence = i;
+    }
+
+    if (!_ccnxTestrigCapture_WriteHeader(capture)) {
+        fprintf(stderr, "Error: could not write capture file %s\n", path);
+        ccnxTestrigCapture_Release(&capture);
+        return NULL;
+    }
+
+    return capture;
+}
+
+/**
+ * Write every packet that is ready in the ring. Only the writer thread, or `ccnxTestrigCapture_Stop` once
+ * the writer has been joined, may call this.
+ *
+ * @return The number of packets written.
+ */
+static size_t
+_ccnxTestrigCapture_Drain(CCNxTestrigCapture *capture)
+{
+    size_t count = 0;
+
+    while (true) {
+        _CCNxTestrigCaptureSlot *slot = &capture->slots[capture->head & (CAPTURE_RING_CAPACITY - 1)];
+        size_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        if (sequence != capture->head + 1) {
+            break;
+        }
+
+        _ccnxTestrigCapture_WritePacket(capture, slot);
+
+        __atomic_store_n(&slot->sequence, capture->head + CAPTURE_RING_CAPACITY, __ATOMIC_RELEASE);
+        capture->head++;
+        count++;
+    }
+
+    return count;
+}
+
+static void *
+_ccnxTestrigCapture_Writer(void *arg)
+{
+    CCNxTestrigCapture *capture = arg;
+    struct timespec idle = { 0, CAPTURE_IDLE_NANOSECONDS };
+
+    while (__atomic_load_n(&capture->running, __ATOMIC_ACQUIRE)) {
+        if (_ccnxTestrigCapture_Drain(capture) == 0) {
+            nanosleep(&idle, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+bool
+ccnxTestrigCapture_Start(CCNxTestrigCapture *capture)
+{
+    if (capture->started) {
+        return true;
+    }
+
+    capture->running = true;
+    if (pthread_create(&capture->writer, NULL, _ccnxTestrigCapture_Writer, capture) != 0) {
+        capture->running = false;
+        fprintf(stderr, "Error: could not start the capture writer\n");
+        return false;
+    }
+    capture->started = true;
+
+    return true;
+}
+
+void
+ccnxTestrigCapture_Stop(CCNxTestrigCapture *capture)
+{
+    if (!capture->started) {
+        return;
+    }
+
+    __atomic_store_n(&capture->running, false, __ATOMIC_RELEASE);
+    pthread_join(capture->writer, NULL);
+    capture->started = false;
+
+    _ccnxTestrigCapture_Drain(capture);
+    _ccnxTestrigCapture_WriteStatistics(capture);
+    _ccnxTestrigCapture_Close(capture);
+}
+
+void
+ccnxTestrigCapture_Record(CCNxTestrigCapture *capture, unsigned interface, CCNxTestrigCaptureDirection direction, const PARCBuffer *packet)
+{
+    if (interface >= capture->numberOfInterfaces) {
+        return;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    // Claim a slot. A slot whose sequence is behind the claimed position still holds an unwritten packet,
+    // so the ring is full and the packet is dropped rather than waiting for the writer.
+    _CCNxTestrigCaptureSlot *slot;
+    size_t position = __atomic_load_n(&capture->tail, __ATOMIC_RELAXED);
+    while (true) {
+        slot = &capture->slots[position & (CAPTURE_RING_CAPACITY - 1)];
+        size_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        intptr_t difference = (intptr_t) sequence - (intptr_t) position;
+
+        if (difference == 0) {
+            if (__atomic_compare_exchange_n(&capture->tail, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            __atomic_fetch_add(&capture->dropped[interface], 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            position = __atomic_load_n(&capture->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    size_t length = parcBuffer_Remaining(packet);
+    size_t captured = length < CAPTURE_SNAPLEN ? length : CAPTURE_SNAPLEN;
+
+    slot->timestamp = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+    slot->interface = interface;
+    slot->direction = direction;
+    slot->capturedLength = (uint32_t) captured;
+    slot->originalLength = (uint32_t) length;
+    memcpy(slot->data, parcBuffer_Overlay((PARCBuffer *) packet, 0), captured);
+
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+}
+
+uint64_t
+ccnxTestrigCapture_GetDroppedCount(const CCNxTestrigCapture *capture)
+{
+    uint64_t total = 0;
+    for (unsigned i = 0; i < capture->numberOfInterfaces; i++) {
+        total += __atomic_load_n(&capture->dropped[i], __ATOMIC_RELAXED);
+    }
+    return total;
+}
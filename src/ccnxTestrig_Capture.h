@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_Capture_h
+#define ccnxTestrig_Capture_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <parc/algol/parc_Buffer.h>
+
+struct ccnx_testrig_capture;
+typedef struct ccnx_testrig_capture CCNxTestrigCapture;
+
+/**
+ * The direction of a captured packet, as seen from the rig.
+ */
+typedef enum {
+    CCNxTestrigCaptureDirection_Inbound = 1,
+    CCNxTestrigCaptureDirection_Outbound = 2
+} CCNxTestrigCaptureDirection;
+
+/**
+ * Create a `CCNxTestrigCapture` that writes packets to a pcapng file, with one interface per link.
+ *
+ * Recording a packet copies it into a bounded lock-free ring, from which a background thread
+ * writes it to the file. When the ring is full the packet is dropped and counted rather than
+ * delaying the caller. Packets longer than the snapshot length are truncated. The interfaces
+ * use the LINKTYPE_USER0 link type, since there is no link type for bare CCNx packets.
+ *
+ * @param [in] path The path of the pcapng file to create.
+ * @param [in] numberOfInterfaces The number of links, which are named "link A", "link B" and so on.
+ *
+ * @retval A newly allocated `CCNxTestrigCapture` that must be freed by `ccnxTestrigCapture_Release`.
+ * @retval NULL if the file could not be created.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigCapture *capture = ccnxTestrigCapture_Create("testrig.pcapng", 3);
+ *
+ *     ccnxTestrigCapture_Release(&capture);
+ * }
+ * @endcode
+ */
+CCNxTestrigCapture *ccnxTestrigCapture_Create(const char *path, unsigned numberOfInterfaces);
+
+/**
+ * Increase the number of references to a `CCNxTestrigCapture` instance.
+ *
+ * @param [in] capture A `CCNxTestrigCapture` instance.
+ *
+ * @return The same value as @p capture.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigCapture *handle = ccnxTestrigCapture_Acquire(capture);
+ *
+ *     ccnxTestrigCapture_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigCapture *ccnxTestrigCapture_Acquire(const CCNxTestrigCapture *capture);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigCapture` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The capture must be stopped before the last reference is released.
+ *
+ * @param [in,out] capturePtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigCapture *capture = ccnxTestrigCapture_Create("testrig.pcapng", 3);
+ *
+ *     ccnxTestrigCapture_Release(&capture);
+ * }
+ * @endcode
+ */
+void ccnxTestrigCapture_Release(CCNxTestrigCapture **capturePtr);
+
+/**
+ * Start the thread that writes the recorded packets to the file.
+ *
+ * @param [in] capture A `CCNxTestrigCapture` instance.
+ *
+ * @return true if the writer thread was started.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigCapture *capture = ccnxTestrigCapture_Create("testrig.pcapng", 3);
+ *     ccnxTestrigCapture_Start(capture);
+ * }
+ * @endcode
+ */
+bool ccnxTestrigCapture_Start(CCNxTestrigCapture *capture);
+
+/**
+ * Write the packets still in the ring, stop the writer thread and close the file.
+ *
+ * The number of packets dropped on each interface is written to the file as interface statistics.
+ *
+ * @param [in] capture A `CCNxTestrigCapture` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigCapture_Start(capture);
+ *     ...
+ *     ccnxTestrigCapture_Stop(capture);
+ * }
+ * @endcode
+ */
+void ccnxTestrigCapture_Stop(CCNxTestrigCapture *capture);
+
+/**
+ * Record a packet sent or received on one of the interfaces.
+ *
+ * The bytes between the position and the limit of the buffer are copied, so the buffer may be
+ * reused as soon as the call returns. The call never blocks and may be made from any thread.
+ *
+ * @param [in] capture A `CCNxTestrigCapture` instance.
+ * @param [in] interface The index of the link, starting at 0 for link A.
+ * @param [in] direction Whether the packet was received or sent.
+ * @param [in] packet The packet.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigCapture_Record(capture, 0, CCNxTestrigCaptureDirection_Outbound, packet);
+ * }
+ * @endcode
+ */
+void ccnxTestrigCapture_Record(CCNxTestrigCapture *capture, unsigned interface, CCNxTestrigCaptureDirection direction, const PARCBuffer *packet);
+
+/**
+ * Retrieve the number of packets that were dropped because the ring was full.
+ *
+ * @param [in] capture A `CCNxTestrigCapture` instance.
+ *
+ * @return The number of dropped packets, over all interfaces.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t dropped = ccnxTestrigCapture_GetDroppedCount(capture);
+ * }
+ * @endcode
+ */
+uint64_t ccnxTestrigCapture_GetDroppedCount(const CCNxTestrigCapture *capture);
+#endif // ccnxTestrig_Capture_h
@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+#include <parc/algol/parc_Object.h>
+
+#include <ccnx/transport/common/transport_MetaMessage.h>
+
+#include "ccnxTestrig_Dispatcher.h"
+#include "ccnxTestrig_PacketUtility.h"
+
+// The number of packets a mailbox holds before further deliveries are dropped.
+#define MAILBOX_CAPACITY 64
+
+// The number of milliseconds the dispatcher waits for packets before checking whether it was stopped.
+#define DISPATCH_INTERVAL 50
+
+typedef struct {
+    CCNxTestrigLinkID linkID;
+    PARCBuffer *packet;
+    uint64_t receiveTime;
+} _CCNxTestrigMailboxEntry;
+
+struct ccnx_testrig_mailbox {
+    pthread_mutex_t lock;
+    pthread_cond_t arrival;
+
+    _CCNxTestrigMailboxEntry entries[MAILBOX_CAPACITY];
+    size_t numberOfEntries;
+};
+
+static bool
+_ccnxTestrigMailbox_Destructor(CCNxTestrigMailbox **mailboxPtr)
+{
+    CCNxTestrigMailbox *mailbox = *mailboxPtr;
+
+    for (size_t i = 0; i < mailbox->numberOfEntries; i++) {
+        parcBuffer_Release(&mailbox->entries[i].packet);
+    }
+    pthread_cond_destroy(&mailbox->arrival);
+    pthread_mutex_destroy(&mailbox->lock);
+
+    return true;
+}
+
+parcObject_ImplementAcquire(ccnxTestrigMailbox, CCNxTestrigMailbox);
+parcObject_ImplementRelease(ccnxTestrigMailbox, CCNxTestrigMailbox);
+
+parcObject_Override(
+	CCNxTestrigMailbox, PARCObject,
+	.destructor = (PARCObjectDestructor *) _ccnxTestrigMailbox_Destructor);
+
+CCNxTestrigMailbox *
+ccnxTestrigMailbox_Create(void)
+{
+    CCNxTestrigMailbox *mailbox = parcObject_CreateInstance(CCNxTestrigMailbox);
+
+    if (mailbox != NULL) {
+        pthread_mutex_init(&mailbox->lock, NULL);
+
+        // Deadlines are taken from the monotonic clock, so the condition must wait on it too.
+        pthread_condattr_t attributes;
+        pthread_condattr_init(&attributes);
+        pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+        pthread_cond_init(&mailbox->arrival, &attributes);
+        pthread_condattr_destroy(&attributes);
+
+        mailbox->numberOfEntries = 0;
+    }
+
+    return mailbox;
+}
+
+/**
+ * @return false if the mailbox was full and the packet was dropped.
+ */
+static bool
+_ccnxTestrigMailbox_Deliver(CCNxTestrigMailbox *mailbox, CCNxTestrigLinkID linkID, PARCBuffer *packet, uint64_t receiveTime)
+{
+    pthread_mutex_lock(&mailbox->lock);
+    bool delivered = mailbox->numberOfEntries < MAILBOX_CAPACITY;
+    if (delivered) {
+        mailbox->entries[mailbox->numberOfEntries].linkID = linkID;
+        mailbox->entries[mailbox->numberOfEntries].packet = parcBuffer_Acquire(packet);
+        mailbox->entries[mailbox->numberOfEntries].receiveTime = receiveTime;
+        mailbox->numberOfEntries++;
+        pthread_cond_broadcast(&mailbox->arrival);
+    }
+    pthread_mutex_unlock(&mailbox->lock);
+    return delivered;
+}
+
+static PARCBuffer *
+_ccnxTestrigMailbox_Take(CCNxTestrigMailbox *mailbox, PARCBitVector *linkVector, CCNxTestrigLinkID *linkID, uint64_t *receiveTime)
+{
+    for (size_t i = 0; i < mailbox->numberOfEntries; i++) {
+        if (parcBitVector_Get(linkVector, mailbox->entries[i].linkID) == 1) {
+            PARCBuffer *packet = mailbox->entries[i].packet;
+            *linkID = mailbox->entries[i].linkID;
+            *receiveTime = mailbox->entries[i].receiveTime;
+
+            // Keep the remaining packets in arrival order.
+            memmove(&mailbox->entries[i], &mailbox->entries[i + 1], (mailbox->numberOfEntries - i - 1) * sizeof(_CCNxTestrigMailboxEntry));
+            mailbox->numberOfEntries--;
+            return packet;
+        }
+    }
+    return NULL;
+}
+
+PARCBuffer *
+ccnxTestrigMailbox_Receive(CCNxTestrigMailbox *mailbox, PARCBitVector *linkVector, uint64_t deadline, CCNxTestrigLinkID *linkID,
+                           uint64_t *receiveTime)
+{
+    struct timespec expiry = {
+        .tv_sec = deadline / 1000000000ULL,
+        .tv_nsec = deadline % 1000000000ULL
+    };
+
+    pthread_mutex_lock(&mailbox->lock);
+    PARCBuffer *packet = _ccnxTestrigMailbox_Take(mailbox, linkVector, linkID, receiveTime);
+    while (packet == NULL) {
+        if (pthread_cond_timedwait(&mailbox->arrival, &mailbox->lock, &expiry) == ETIMEDOUT) {
+            packet = _ccnxTestrigMailbox_Take(mailbox, linkVector, linkID, receiveTime);
+            break;
+        }
+        packet = _ccnxTestrigMailbox_Take(mailbox, linkVector, linkID, receiveTime);
+    }
+    pthread_mutex_unlock(&mailbox->lock);
+
+    return packet;
+}
+
+typedef struct {
+    CCNxName *name;
+    CCNxTestrigMailbox *mailbox;
+} _CCNxTestrigDispatcherEntry;
+
+struct ccnx_testrig_dispatcher {
+    CCNxTestrig *rig;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    bool running;
+
+    // The registered names. The set of concurrently running tests is small, so a linear search suffices.
+    _CCNxTestrigDispatcherEntry *entries;
+    size_t numberOfEntries;
+    size_t capacity;
+
+    size_t numberOfDiscardedPackets;
+};
+
+static bool
+_ccnxTestrigDispatcher_Destructor(CCNxTestrigDispatcher **dispatcherPtr)
+{
+    CCNxTestrigDispatcher *dispatcher = *dispatcherPtr;
+
+    for (size_t i = 0; i < dispatcher->numberOfEntries; i++) {
+        ccnxName_Release(&dispatcher->entries[i].name);
+        ccnxTestrigMailbox_Release(&dispatcher->entries[i].mailbox);
+    }
+    free(dispatcher->entries);
+    pthread_mutex_destroy(&dispatcher->lock);
+    ccnxTestrig_Release(&dispatcher->rig);
+
+    return true;
+}
+
+parcObject_ImplementAcquire(ccnxTestrigDispatcher, CCNxTestrigDispatcher);
+parcObject_ImplementRelease(ccnxTestrigDispatcher, CCNxTestrigDispatcher);
+
+parcObject_Override(
+	CCNxTestrigDispatcher, PARCObject,
+	.destructor = (PARCObjectDestructor *) _ccnxTestrigDispatcher_Destructor);
+
+CCNxTestrigDispatcher *
+ccnxTestrigDispatcher_Create(CCNxTestrig *rig)
+{
+    CCNxTestrigDispatcher *dispatcher = parcObject_CreateInstance(CCNxTestrigDispatcher);
+
+    if (dispatcher != NULL) {
+        dispatcher->rig = ccnxTestrig_Acquire(rig);
+        pthread_mutex_init(&dispatcher->lock, NULL);
+        dispatcher->running = false;
+        dispatcher->entries = NULL;
+        dispatcher->numberOfEntries = 0;
+        dispatcher->capacity = 0;
+        dispatcher->numberOfDiscardedPackets = 0;
+    }
+
+    return dispatcher;
+}
+
+static CCNxTestrigMailbox *
+_ccnxTestrigDispatcher_Lookup(CCNxTestrigDispatcher *dispatcher, const CCNxName *name)
+{
+    for (size_t i = 0; i < dispatcher->numberOfEntries; i++) {
+        if (ccnxName_Equals(dispatcher->entries[i].name, name)) {
+            return dispatcher->entries[i].mailbox;
+        }
+    }
+    return NULL;
+}
+
+static void
+_ccnxTestrigDispatcher_Dispatch(CCNxTestrigDispatcher *dispatcher, CCNxTestrigLinkID linkID, PARCBuffer *packet, uint64_t receiveTime)
+{
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromWireFormatBuffer(packet);
+    const CCNxName *name = message == NULL ? NULL : ccnxTestrigPacketUtility_GetName(message);
+
+    pthread_mutex_lock(&dispatcher->lock);
+    CCNxTestrigMailbox *mailbox = name == NULL ? NULL : _ccnxTestrigDispatcher_Lookup(dispatcher, name);
+    if (mailbox == NULL || !_ccnxTestrigMailbox_Deliver(mailbox, linkID, packet, receiveTime)) {
+        // The count is read without the lock, while the tests are still running.
+        __atomic_fetch_add(&dispatcher->numberOfDiscardedPackets, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&dispatcher->lock);
+
+    if (message != NULL) {
+        ccnxMetaMessage_Release(&message);
+    }
+}
+
+static bool
+_ccnxTestrigDispatcher_IsRunning(CCNxTestrigDispatcher *dispatcher)
+{
+    pthread_mutex_lock(&dispatcher->lock);
+    bool running = dispatcher->running;
+    pthread_mutex_unlock(&dispatcher->lock);
+    return running;
+}
+
+static void *
+_ccnxTestrigDispatcher_Run(void *arg)
+{
+    CCNxTestrigDispatcher *dispatcher = arg;
+
+    PARCBitVector *allLinks = parcBitVector_Create();
+    for (CCNxTestrigLinkID id = CCNxTestrigLinkID_LinkA; id <= ccnxTestrig_GetNumberOfLinks(dispatcher->rig); id++) {
+        parcBitVector_Set(allLinks, id);
+    }
+
+    while (_ccnxTestrigDispatcher_IsRunning(dispatcher)) {
+        CCNxTestrigLinkID linkID;
+        PARCBuffer *packet = ccnxTestrig_ReceiveFromLinks(dispatcher->rig, allLinks, ccnxTestrig_GetDeadline(DISPATCH_INTERVAL), &linkID);
+        if (packet != NULL) {
+            _ccnxTestrigDispatcher_Dispatch(dispatcher, linkID, packet, ccnxTestrig_GetReceiveTime(dispatcher->rig));
+            parcBuffer_Release(&packet);
+        }
+    }
+
+    parcBitVector_Release(&allLinks);
+    return NULL;
+}
+
+bool
+ccnxTestrigDispatcher_Start(CCNxTestrigDispatcher *dispatcher)
+{
+    dispatcher->running = true;
+    if (pthread_create(&dispatcher->thread, NULL, _ccnxTestrigDispatcher_Run, dispatcher) != 0) {
+        perror("pthread_create() failed");
+        dispatcher->running = false;
+        return false;
+    }
+    return true;
+}
+
+void
+ccnxTestrigDispatcher_Stop(CCNxTestrigDispatcher *dispatcher)
+{
+    if (!_ccnxTestrigDispatcher_IsRunning(dispatcher)) {
+        return;
+    }
+
+    pthread_mutex_lock(&dispatcher->lock);
+    dispatcher->running = false;
+    pthread_mutex_unlock(&dispatcher->lock);
+
+    pthread_join(dispatcher->thread, NULL);
+}
+
+void
+ccnxTestrigDispatcher_Register(CCNxTestrigDispatcher *dispatcher, const CCNxName *name, CCNxTestrigMailbox *mailbox)
+{
+    pthread_mutex_lock(&dispatcher->lock);
+    if (_ccnxTestrigDispatcher_Lookup(dispatcher, name) == NULL) {
+        if (dispatcher->numberOfEntries == dispatcher->capacity) {
+            dispatcher->capacity = dispatcher->capacity == 0 ? 16 : dispatcher->capacity * 2;
+            dispatcher->entries = realloc(dispatcher->entries, dispatcher->capacity * sizeof(_CCNxTestrigDispatcherEntry));
+        }
+        dispatcher->entries[dispatcher->numberOfEntries].name = ccnxName_Acquire(name);
+        dispatcher->entries[dispatcher->numberOfEntries].mailbox = ccnxTestrigMailbox_Acquire(mailbox);
+        dispatcher->numberOfEntries++;
+    }
+    pthread_mutex_unlock(&dispatcher->lock);
+}
+
+void
+ccnxTestrigDispatcher_Unregister(CCNxTestrigDispatcher *dispatcher, CCNxTestrigMailbox *mailbox)
+{
+    pthread_mutex_lock(&dispatcher->lock);
+    size_t kept = 0;
+    for (size_t i = 0; i < dispatcher->numberOfEntries; i++) {
+        if (dispatcher->entries[i].mailbox == mailbox) {
+            ccnxName_Release(&dispatcher->entries[i].name);
+            ccnxTestrigMailbox_Release(&dispatcher->entries[i].mailbox);
+        } else {
+            dispatcher->entries[kept++] = dispatcher->entries[i];
+        }
+    }
+    dispatcher->numberOfEntries = kept;
+    pthread_mutex_unlock(&dispatcher->lock);
+}
+
+size_t
+ccnxTestrigDispatcher_GetDiscardedPacketCount(const CCNxTestrigDispatcher *dispatcher)
+{
+    return __atomic_load_n(&dispatcher->numberOfDiscardedPackets, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_Dispatcher_h
+#define ccnxTestrig_Dispatcher_h
+
+#include <parc/algol/parc_Buffer.h>
+#include <parc/algol/parc_BitVector.h>
+
+#include <ccnx/common/ccnx_Name.h>
+
+#include "ccnxTestrig.h"
+
+struct ccnx_testrig_dispatcher;
+typedef struct ccnx_testrig_dispatcher CCNxTestrigDispatcher;
+
+struct ccnx_testrig_mailbox;
+typedef struct ccnx_testrig_mailbox CCNxTestrigMailbox;
+
+/**
+ * Create a `CCNxTestrigDispatcher` that demultiplexes the packets received on the links
+ * of the given `CCNxTestrig`.
+ *
+ * Once started, the dispatcher reads every link on a background thread and delivers each
+ * packet to the mailbox that has registered the packet's name. Packets that no mailbox
+ * has registered are discarded and counted.
+ *
+ * @param [in] rig The `CCNxTestrig` whose links are read.
+ *
+ * @return A newly allocated `CCNxTestrigDispatcher` that must be freed by `ccnxTestrigDispatcher_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrig *rig = ...
+ *     CCNxTestrigDispatcher *dispatcher = ccnxTestrigDispatcher_Create(rig);
+ *
+ *     ccnxTestrigDispatcher_Release(&dispatcher);
+ * }
+ * @endcode
+ */
+CCNxTestrigDispatcher *ccnxTestrigDispatcher_Create(CCNxTestrig *rig);
+
+/**
+ * Increase the number of references to a `CCNxTestrigDispatcher` instance.
+ *
+ * @param [in] dispatcher A `CCNxTestrigDispatcher` instance.
+ *
+ * @return The same value as @p dispatcher.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigDispatcher *handle = ccnxTestrigDispatcher_Acquire(dispatcher);
+ *
+ *     ccnxTestrigDispatcher_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigDispatcher *ccnxTestrigDispatcher_Acquire(const CCNxTestrigDispatcher *dispatcher);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigDispatcher` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The dispatcher must be stopped before the last reference is released.
+ *
+ * @param [in,out] dispatcherPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigDispatcher *dispatcher = ccnxTestrigDispatcher_Create(rig);
+ *
+ *     ccnxTestrigDispatcher_Release(&dispatcher);
+ * }
+ * @endcode
+ */
+void ccnxTestrigDispatcher_Release(CCNxTestrigDispatcher **dispatcherPtr);
+
+/**
+ * Start reading the links and delivering packets on a background thread.
+ *
+ * @param [in] dispatcher A `CCNxTestrigDispatcher` instance.
+ *
+ * @return true if the dispatcher thread was started.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigDispatcher *dispatcher = ccnxTestrigDispatcher_Create(rig);
+ *     ccnxTestrigDispatcher_Start(dispatcher);
+ * }
+ * @endcode
+ */
+bool ccnxTestrigDispatcher_Start(CCNxTestrigDispatcher *dispatcher);
+
+/**
+ * Stop the dispatcher thread and wait for it to exit.
+ *
+ * @param [in] dispatcher A `CCNxTestrigDispatcher` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigDispatcher_Start(dispatcher);
+ *     ...
+ *     ccnxTestrigDispatcher_Stop(dispatcher);
+ * }
+ * @endcode
+ */
+void ccnxTestrigDispatcher_Stop(CCNxTestrigDispatcher *dispatcher);
+
+/**
+ * Deliver every packet received with the given name to the given mailbox.
+ *
+ * @param [in] dispatcher A `CCNxTestrigDispatcher` instance.
+ * @param [in] name The exact name of the packets to deliver.
+ * @param [in] mailbox The `CCNxTestrigMailbox` that owns the name.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigMailbox *mailbox = ccnxTestrigMailbox_Create();
+ *     ccnxTestrigDispatcher_Register(dispatcher, name, mailbox);
+ * }
+ * @endcode
+ */
+void ccnxTestrigDispatcher_Register(CCNxTestrigDispatcher *dispatcher, const CCNxName *name, CCNxTestrigMailbox *mailbox);
+
+/**
+ * Remove every name registered for the given mailbox.
+ *
+ * @param [in] dispatcher A `CCNxTestrigDispatcher` instance.
+ * @param [in] mailbox The `CCNxTestrigMailbox` to unregister.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigDispatcher_Register(dispatcher, name, mailbox);
+ *     ...
+ *     ccnxTestrigDispatcher_Unregister(dispatcher, mailbox);
+ * }
+ * @endcode
+ */
+void ccnxTestrigDispatcher_Unregister(CCNxTestrigDispatcher *dispatcher, CCNxTestrigMailbox *mailbox);
+
+/**
+ * Retrieve the number of received packets that no mailbox had registered, or that arrived
+ * at a full mailbox.
+ *
+ * @param [in] dispatcher A `CCNxTestrigDispatcher` instance.
+ *
+ * @return The number of discarded packets.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t discarded = ccnxTestrigDispatcher_GetDiscardedPacketCount(dispatcher);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigDispatcher_GetDiscardedPacketCount(const CCNxTestrigDispatcher *dispatcher);
+
+/**
+ * Create an empty `CCNxTestrigMailbox`.
+ *
+ * A mailbox holds the packets that a `CCNxTestrigDispatcher` delivered to one test, along
+ * with the link each packet was received on.
+ *
+ * @return A newly allocated `CCNxTestrigMailbox` that must be freed by `ccnxTestrigMailbox_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigMailbox *mailbox = ccnxTestrigMailbox_Create();
+ *
+ *     ccnxTestrigMailbox_Release(&mailbox);
+ * }
+ * @endcode
+ */
+CCNxTestrigMailbox *ccnxTestrigMailbox_Create(void);
+
+/**
+ * Increase the number of references to a `CCNxTestrigMailbox` instance.
+ *
+ * @param [in] mailbox A `CCNxTestrigMailbox` instance.
+ *
+ * @return The same value as @p mailbox.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigMailbox *handle = ccnxTestrigMailbox_Acquire(mailbox);
+ *
+ *     ccnxTestrigMailbox_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigMailbox *ccnxTestrigMailbox_Acquire(const CCNxTestrigMailbox *mailbox);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigMailbox` instance,
+ * decrementing the reference count for the instance.
+ *
+ * @param [in,out] mailboxPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigMailbox *mailbox = ccnxTestrigMailbox_Create();
+ *
+ *     ccnxTestrigMailbox_Release(&mailbox);
+ * }
+ * @endcode
+ */
+void ccnxTestrigMailbox_Release(CCNxTestrigMailbox **mailboxPtr);
+
+/**
+ * Receive a packet that was delivered to the mailbox from any of the links in the given vector.
+ *
+ * Packets delivered from other links are left in the mailbox. The call blocks until a
+ * matching packet is delivered or the deadline expires.
+ *
+ * @param [in] mailbox A `CCNxTestrigMailbox` instance.
+ * @param [in] linkVector The links upon which a packet may be received.
+ * @param [in] deadline The deadline computed by `ccnxTestrig_GetDeadline`.
+ * @param [out] linkID Set to the link on which the packet was received.
+ * @param [out] receiveTime Set to the time at which the packet arrived on its link.
+ *
+ * @retval A `PARCBuffer` containing the packet.
+ * @retval NULL if no matching packet was delivered before the deadline.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigLinkID linkID;
+ *     uint64_t receiveTime;
+ *     PARCBuffer *packet = ccnxTestrigMailbox_Receive(mailbox, linkVector, ccnxTestrig_GetDeadline(1000), &linkID, &receiveTime);
+ * }
+ * @endcode
+ */
+PARCBuffer *ccnxTestrigMailbox_Receive(CCNxTestrigMailbox *mailbox, PARCBitVector *linkVector, uint64_t deadline, CCNxTestrigLinkID *linkID,
+                                       uint64_t *receiveTime);
+#endif // ccnxTestrig_Dispatcher_h
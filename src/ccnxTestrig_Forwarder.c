@@ -0,0 +1,867 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <poll.h>
+#include <time.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/security/parc_CryptoHasher.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/common/ccnx_Interest.h>
+
+#include "ccnxTestrig_Forwarder.h"
+#include "ccnxTestrig_PacketUtility.h"
+
+// The number of packets read from a face at once.
+#define FORWARDER_BATCH_SIZE 32
+
+// The number of milliseconds the forwarder waits for packets before checking whether it was stopped.
+#define FORWARDER_INTERVAL 50
+
+// PIT hash buckets, and the number of pending Interests beyond which new ones are dropped.
+#define FORWARDER_PIT_BUCKETS 4096
+#define FORWARDER_PIT_CAPACITY 65536
+
+// Content store slots. Each name maps to one slot, and a new object replaces the one in it.
+#define FORWARDER_CS_CAPACITY 1024
+
+#define FORWARDER_DEFAULT_LIFETIME 4000
+#define SHA256_LENGTH 32
+
+#define NSEC_PER_MSEC 1000000ULL
+#define NSEC_PER_SEC 1000000000ULL
+
+// Fixed header packet types.
+#define PACKET_TYPE_INTEREST 0
+#define PACKET_TYPE_CONTENT_OBJECT 1
+
+// TLV types of the hop-by-hop headers, the message, and the validation section.
+#define T_INTEREST_LIFETIME 0x0001
+#define T_NAME 0x0000
+#define T_KEYID_RESTRICTION 0x0002
+#define T_OBJECT_HASH_RESTRICTION 0x0003
+#define T_VALIDATION_ALGORITHM 0x0003
+#define T_KEYID 0x0009
+
+/**
+ * The fields of a wire-format packet that forwarding depends on. The pointers refer into the packet.
+ */
+typedef struct {
+    uint8_t packetType;
+    size_t length;
+    size_t messageOffset;
+
+    // The whole Name TLV, or NULL for a nameless Content Object.
+    const uint8_t *name;
+    size_t nameLength;
+
+    // Interest restrictions, or the KeyId of a Content Object's validation algorithm.
+    const uint8_t *keyId;
+    size_t keyIdLength;
+    const uint8_t *objectHash;
+    size_t objectHashLength;
+
+    uint64_t lifetime;
+} _CCNxTestrigForwarderPacket;
+
+typedef struct _ccnx_testrig_forwarder_pit_entry {
+    struct _ccnx_testrig_forwarder_pit_entry *next;
+    uint64_t hash;
+    uint64_t expiry;
+
+    // Bit i is set for face i.
+    uint32_t inFaces;
+    uint32_t outFaces;
+
+    size_t nameLength;
+    size_t keyIdLength;
+    size_t objectHashLength;
+    // The name, KeyId restriction and hash restriction, one after the other.
+    uint8_t bytes[];
+} _CCNxTestrigForwarderPitEntry;
+
+typedef struct {
+    // The value of the prefix's Name TLV, which is a byte prefix of every name under it.
+    uint8_t *prefix;
+    size_t prefixLength;
+    uint32_t faces;
+} _CCNxTestrigForwarderRoute;
+
+typedef struct {
+    uint64_t hash;
+    PARCBuffer *contentObject;
+} _CCNxTestrigForwarderCacheSlot;
+
+struct ccnx_testrig_forwarder {
+    CCNxTestrigLink *faces[CCNX_TESTRIG_FORWARDER_MAX_FACES];
+    size_t numberOfFaces;
+
+    _CCNxTestrigForwarderRoute *routes;
+    size_t numberOfRoutes;
+
+    _CCNxTestrigForwarderPitEntry *pit[FORWARDER_PIT_BUCKETS];
+    size_t pitSize;
+    uint64_t nextExpiry;
+
+    _CCNxTestrigForwarderCacheSlot cache[FORWARDER_CS_CAPACITY];
+
+    PARCCryptoHasher *hasher;
+
+    pthread_t thread;
+    bool running;
+    bool stopRequested;
+
+    CCNxTestrigForwarderStatistics statistics;
+    CCNxTestrigHistogram *processingTime;
+};
+
+static void
+_ccnxTestrigForwarder_ClearPit(CCNxTestrigForwarder *forwarder)
+{
+    for (size_t i = 0; i < FORWARDER_PIT_BUCKETS; i++) {
+        while (forwarder->pit[i] != NULL) {
+            _CCNxTestrigForwarderPitEntry *entry = forwarder->pit[i];
+            forwarder->pit[i] = entry->next;
+            free(entry);
+        }
+    }
+    forwarder->pitSize = 0;
+}
+
+static bool
+_ccnxTestrigForwarder_Destructor(CCNxTestrigForwarder **forwarderPtr)
+{
+    CCNxTestrigForwarder *forwarder = *forwarderPtr;
+
+    ccnxTestrigForwarder_Stop(forwarder);
+
+    for (size_t i = 0; i < forwarder->numberOfFaces; i++) {
+        ccnxTestrigLink_Close(forwarder->faces[i]);
+        ccnxTestrigLink_Release(&forwarder->faces[i]);
+    }
+    for (size_t i = 0; i < forwarder->numberOfRoutes; i++) {
+        free(forwarder->routes[i].prefix);
+    }
+    free(forwarder->routes);
+
+    _ccnxTestrigForwarder_ClearPit(forwarder);
+    for (size_t i = 0; i < FORWARDER_CS_CAPACITY; i++) {
+        if (forwarder->cache[i].contentObject != NULL) {
+            parcBuffer_Release(&forwarder->cache[i].contentObject);
+        }
+    }
+
+    if (forwarder->hasher != NULL) {
+        parcCryptoHasher_Release(&forwarder->hasher);
+    }
+    ccnxTestrigHistogram_Release(&forwarder->processingTime);
+
+    return true;
+}
+
+parcObject_ImplementAcquire(ccnxTestrigForwarder, CCNxTestrigForwarder);
+parcObject_ImplementRelease(ccnxTestrigForwarder, CCNxTestrigForwarder);
+
+parcObject_Override(
+	CCNxTestrigForwarder, PARCObject,
+	.destructor = (PARCObjectDestructor *) _ccnxTestrigForwarder_Destructor);
+
+CCNxTestrigForwarder *
+ccnxTestrigForwarder_Create(CCNxTestrigLinkType type, char *address, int port, size_t numberOfFaces)
+{
+    if (numberOfFaces > CCNX_TESTRIG_FORWARDER_MAX_FACES) {
+        fprintf(stderr, "Error: the forwarder supports at most %d faces\n", CCNX_TESTRIG_FORWARDER_MAX_FACES);
+        return NULL;
+    }
+
+    CCNxTestrigForwarder *forwarder = parcObject_CreateInstance(CCNxTestrigForwarder);
+
+    if (forwarder != NULL) {
+        forwarder->numberOfFaces = 0;
+        forwarder->routes = NULL;
+        forwarder->numberOfRoutes = 0;
+        memset(forwarder->pit, 0, sizeof(forwarder->pit));
+        forwarder->pitSize = 0;
+        forwarder->nextExpiry = 0;
+        memset(forwarder->cache, 0, sizeof(forwarder->cache));
+        forwarder->hasher = parcCryptoHasher_Create(PARCCryptoHashType_SHA256);
+        forwarder->running = false;
+        forwarder->stopRequested = false;
+        memset(&forwarder->statistics, 0, sizeof(forwarder->statistics));
+        forwarder->processingTime = ccnxTestrigHistogram_Create();
+
+        for (size_t i = 0; i < numberOfFaces; i++) {
+            CCNxTestrigLink *face = ccnxTestrigLink_Connect(type, address, port + (int) i);
+            if (face == NULL) {
+                ccnxTestrigForwarder_Release(&forwarder);
+                return NULL;
+            }
+            forwarder->faces[forwarder->numberOfFaces++] = face;
+        }
+    }
+
+    return forwarder;
+}
+
+static uint64_t
+_ccnxTestrigForwarder_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+}
+
+static size_t
+_readUint16(const uint8_t *bytes)
+{
+    return ((size_t) bytes[0] << 8) | bytes[1];
+}
+
+/**
+ * FNV-1a over the Name TLV.
+ */
+static uint64_t
+_ccnxTestrigForwarder_HashName(const uint8_t *name, size_t length)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ name[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static bool
+_ccnxTestrigForwarder_Equal(const uint8_t *a, size_t aLength, const uint8_t *b, size_t bLength)
+{
+    return aLength == bLength && (aLength == 0 || memcmp(a, b, aLength) == 0);
+}
+
+/**
+ * Find the KeyId in the validation algorithm that follows the message TLV of a Content Object.
+ */
+static void
+_ccnxTestrigForwarder_ParseValidation(const uint8_t *bytes, size_t offset, size_t end, _CCNxTestrigForwarderPacket *packet)
+{
+    if (offset + 4 > end || _readUint16(bytes + offset) != T_VALIDATION_ALGORITHM) {
+        return;
+    }
+    size_t algorithmEnd = offset + 4 + _readUint16(bytes + offset + 2);
+    if (algorithmEnd > end) {
+        return;
+    }
+
+    // The validation algorithm holds a single TLV naming the algorithm, whose value holds the KeyId.
+    offset += 4;
+    if (offset + 4 > algorithmEnd) {
+        return;
+    }
+    size_t dependentEnd = offset + 4 + _readUint16(bytes + offset + 2);
+    if (dependentEnd > algorithmEnd) {
+        return;
+    }
+
+    for (offset += 4; offset + 4 <= dependentEnd; offset += 4 + _readUint16(bytes + offset + 2)) {
+        size_t length = _readUint16(bytes + offset + 2);
+        if (offset + 4 + length > dependentEnd) {
+            return;
+        }
+        if (_readUint16(bytes + offset) == T_KEYID) {
+            packet->keyId = bytes + offset + 4;
+            packet->keyIdLength = length;
+            return;
+        }
+    }
+}
+
+static bool
+_ccnxTestrigForwarder_Parse(const uint8_t *bytes, size_t length, _CCNxTestrigForwarderPacket *packet)
+{
+    memset(packet, 0, sizeof(*packet));
+
+    // Fixed header: version, packet type, packet length (2), hop limit, return code, reserved, header length.
+    if (length < 8 || _readUint16(bytes + 2) > length || bytes[7] < 8) {
+        return false;
+    }
+    packet->packetType = bytes[1];
+    packet->length = _readUint16(bytes + 2);
+    packet->lifetime = FORWARDER_DEFAULT_LIFETIME;
+
+    size_t headerLength = bytes[7];
+    if (headerLength + 4 > packet->length) {
+        return false;
+    }
+
+    for (size_t offset = 8; offset + 4 <= headerLength; offset += 4 + _readUint16(bytes + offset + 2)) {
+        size_t fieldLength = _readUint16(bytes + offset + 2);
+        if (offset + 4 + fieldLength > headerLength) {
+            return false;
+        }
+        if (_readUint16(bytes + offset) == T_INTEREST_LIFETIME && fieldLength <= 8) {
+            packet->lifetime = 0;
+            for (size_t i = 0; i < fieldLength; i++) {
+                packet->lifetime = (packet->lifetime << 8) | bytes[offset + 4 + i];
+            }
+        }
+    }
+
+    packet->messageOffset = headerLength;
+    size_t messageEnd = headerLength + 4 + _readUint16(bytes + headerLength + 2);
+    if (messageEnd > packet->length) {
+        return false;
+    }
+
+    bool isInterest = packet->packetType == PACKET_TYPE_INTEREST;
+    for (size_t offset = headerLength + 4; offset + 4 <= messageEnd; offset += 4 + _readUint16(bytes + offset + 2)) {
+        size_t fieldLength = _readUint16(bytes + offset + 2);
+        if (offset + 4 + fieldLength > messageEnd) {
+            return false;
+        }
+        switch (_readUint16(bytes + offset)) {
+            case T_NAME:
+                packet->name = bytes + offset;
+                packet->nameLength = 4 + fieldLength;
+                break;
+            case T_KEYID_RESTRICTION:
+                if (isInterest) {
+                    packet->keyId = bytes + offset + 4;
+                    packet->keyIdLength = fieldLength;
+                }
+                break;
+            case T_OBJECT_HASH_RESTRICTION:
+                if (isInterest) {
+                    packet->objectHash = bytes + offset + 4;
+                    packet->objectHashLength = fieldLength;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (packet->packetType == PACKET_TYPE_CONTENT_OBJECT) {
+        _ccnxTestrigForwarder_ParseValidation(bytes, messageEnd, packet->length, packet);
+    }
+
+    return true;
+}
+
+/**
+ * The SHA-256 of a Content Object from its message TLV to the end of the packet, as Interests restrict it.
+ */
+static bool
+_ccnxTestrigForwarder_HashContentObject(CCNxTestrigForwarder *forwarder, const uint8_t *bytes, const _CCNxTestrigForwarderPacket *packet,
+                                        uint8_t digest[SHA256_LENGTH])
+{
+    parcCryptoHasher_Init(forwarder->hasher);
+    parcCryptoHasher_UpdateBytes(forwarder->hasher, bytes + packet->messageOffset, packet->length - packet->messageOffset);
+    PARCCryptoHash *hash = parcCryptoHasher_Finalize(forwarder->hasher);
+
+    PARCBuffer *value = parcCryptoHash_GetDigest(hash);
+    bool valid = parcBuffer_Remaining(value) == SHA256_LENGTH;
+    if (valid) {
+        memcpy(digest, parcBuffer_Overlay(value, 0), SHA256_LENGTH);
+    }
+    parcCryptoHash_Release(&hash);
+
+    return valid;
+}
+
+/**
+ * The Content Object and its hash, which is computed the first time a restriction needs it.
+ */
+typedef struct {
+    const uint8_t *bytes;
+    _CCNxTestrigForwarderPacket packet;
+    bool hashed;
+    bool hashValid;
+    uint8_t hash[SHA256_LENGTH];
+} _CCNxTestrigForwarderContentObject;
+
+static bool
+_ccnxTestrigForwarder_Satisfies(CCNxTestrigForwarder *forwarder, const uint8_t *keyId, size_t keyIdLength,
+                                const uint8_t *objectHash, size_t objectHashLength, _CCNxTestrigForwarderContentObject *content)
+{
+    if (keyIdLength > 0 && !_ccnxTestrigForwarder_Equal(keyId, keyIdLength, content->packet.keyId, content->packet.keyIdLength)) {
+        return false;
+    }
+    if (objectHashLength > 0) {
+        if (!content->hashed) {
+            content->hashValid = _ccnxTestrigForwarder_HashContentObject(forwarder, content->bytes, &content->packet, content->hash);
+            content->hashed = true;
+        }
+        return content->hashValid && _ccnxTestrigForwarder_Equal(objectHash, objectHashLength, content->hash, SHA256_LENGTH);
+    }
+    return true;
+}
+
+static const uint8_t *
+_ccnxTestrigForwarderPitEntry_KeyId(const _CCNxTestrigForwarderPitEntry *entry)
+{
+    return entry->bytes + entry->nameLength;
+}
+
+static const uint8_t *
+_ccnxTestrigForwarderPitEntry_ObjectHash(const _CCNxTestrigForwarderPitEntry *entry)
+{
+    return entry->bytes + entry->nameLength + entry->keyIdLength;
+}
+
+static _CCNxTestrigForwarderPitEntry **
+_ccnxTestrigForwarder_FindPitEntry(CCNxTestrigForwarder *forwarder, uint64_t hash, const _CCNxTestrigForwarderPacket *interest)
+{
+    _CCNxTestrigForwarderPitEntry **link = &forwarder->pit[hash & (FORWARDER_PIT_BUCKETS - 1)];
+    for (; *link != NULL; link = &(*link)->next) {
+        _CCNxTestrigForwarderPitEntry *entry = *link;
+        if (entry->hash == hash
+            && _ccnxTestrigForwarder_Equal(entry->bytes, entry->nameLength, interest->name, interest->nameLength)
+            && _ccnxTestrigForwarder_Equal(_ccnxTestrigForwarderPitEntry_KeyId(entry), entry->keyIdLength, interest->keyId, interest->keyIdLength)
+            && _ccnxTestrigForwarder_Equal(_ccnxTestrigForwarderPitEntry_ObjectHash(entry), entry->objectHashLength,
+                                           interest->objectHash, interest->objectHashLength)) {
+            return link;
+        }
+    }
+    return link;
+}
+
+static _CCNxTestrigForwarderPitEntry *
+_ccnxTestrigForwarder_AddPitEntry(CCNxTestrigForwarder *forwarder, _CCNxTestrigForwarderPitEntry **link, uint64_t hash,
+                                  const _CCNxTestrigForwarderPacket *interest)
+{
+    if (forwarder->pitSize >= FORWARDER_PIT_CAPACITY) {
+        return NULL;
+    }
+
+    size_t length = interest->nameLength + interest->keyIdLength + interest->objectHashLength;
+    _CCNxTestrigForwarderPitEntry *entry = malloc(sizeof(_CCNxTestrigForwarderPitEntry) + length);
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    entry->next = NULL;
+    entry->hash = hash;
+    entry->inFaces = 0;
+    entry->outFaces = 0;
+    entry->nameLength = interest->nameLength;
+    entry->keyIdLength = interest->keyIdLength;
+    entry->objectHashLength = interest->objectHashLength;
+    memcpy(entry->bytes, interest->name, interest->nameLength);
+    if (interest->keyIdLength > 0) {
+        memcpy(entry->bytes + interest->nameLength, interest->keyId, interest->keyIdLength);
+    }
+    if (interest->objectHashLength > 0) {
+        memcpy(entry->bytes + interest->nameLength + interest->keyIdLength, interest->objectHash, interest->objectHashLength);
+    }
+
+    *link = entry;
+    forwarder->pitSize++;
+    return entry;
+}
+
+static void
+_ccnxTestrigForwarder_RemovePitEntry(CCNxTestrigForwarder *forwarder, _CCNxTestrigForwarderPitEntry **link)
+{
+    _CCNxTestrigForwarderPitEntry *entry = *link;
+    *link = entry->next;
+    free(entry);
+    forwarder->pitSize--;
+}
+
+static void
+_ccnxTestrigForwarder_ExpirePit(CCNxTestrigForwarder *forwarder, uint64_t now)
+{
+    for (size_t i = 0; i < FORWARDER_PIT_BUCKETS; i++) {
+        _CCNxTestrigForwarderPitEntry **link = &forwarder->pit[i];
+        while (*link != NULL) {
+            if ((*link)->expiry <= now) {
+                _ccnxTestrigForwarder_RemovePitEntry(forwarder, link);
+            } else {
+                link = &(*link)->next;
+            }
+        }
+    }
+}
+
+/**
+ * Find the faces of the longest prefix in the FIB that matches the Name TLV.
+ */
+static uint32_t
+_ccnxTestrigForwarder_Lookup(const CCNxTestrigForwarder *forwarder, const uint8_t *name, size_t nameLength)
+{
+    const uint8_t *value = name + 4;
+    size_t valueLength = nameLength - 4;
+
+    // Prefixes are whole name segments, so a byte prefix of the name always ends on a segment boundary.
+    const _CCNxTestrigForwarderRoute *best = NULL;
+    for (size_t i = 0; i < forwarder->numberOfRoutes; i++) {
+        const _CCNxTestrigForwarderRoute *route = &forwarder->routes[i];
+        if (route->prefixLength <= valueLength && memcmp(route->prefix, value, route->prefixLength) == 0
+            && (best == NULL || route->prefixLength > best->prefixLength)) {
+            best = route;
+        }
+    }
+    return best == NULL ? 0 : best->faces;
+}
+
+static size_t
+_ccnxTestrigForwarder_LowestFace(uint32_t faces)
+{
+    return (size_t) __builtin_ctz(faces);
+}
+
+static void
+_ccnxTestrigForwarder_SendToFaces(CCNxTestrigForwarder *forwarder, PARCBuffer *packet, uint32_t faces)
+{
+    for (size_t face = 0; face < forwarder->numberOfFaces; face++) {
+        if (faces & (1U << face)) {
+            ccnxTestrigLink_Send(forwarder->faces[face], packet);
+        }
+    }
+}
+
+static void
+_ccnxTestrigForwarder_ReceiveInterest(CCNxTestrigForwarder *forwarder, size_t face, PARCBuffer *buffer, const _CCNxTestrigForwarderPacket *interest,
+                                      uint64_t now)
+{
+    forwarder->statistics.interestsReceived++;
+    uint8_t *bytes = parcBuffer_Overlay(buffer, 0);
+    uint64_t hash = _ccnxTestrigForwarder_HashName(interest->name, interest->nameLength);
+
+    // Answer from the content store when the cached object satisfies the restrictions.
+    _CCNxTestrigForwarderCacheSlot *slot = &forwarder->cache[hash & (FORWARDER_CS_CAPACITY - 1)];
+    if (slot->contentObject != NULL && slot->hash == hash) {
+        _CCNxTestrigForwarderContentObject cached = { .bytes = parcBuffer_Overlay(slot->contentObject, 0), .hashed = false };
+        if (_ccnxTestrigForwarder_Parse(cached.bytes, parcBuffer_Remaining(slot->contentObject), &cached.packet)
+            && _ccnxTestrigForwarder_Equal(cached.packet.name, cached.packet.nameLength, interest->name, interest->nameLength)
+            && _ccnxTestrigForwarder_Satisfies(forwarder, interest->keyId, interest->keyIdLength, interest->objectHash, interest->objectHashLength, &cached)) {
+            ccnxTestrigLink_Send(forwarder->faces[face], slot->contentObject);
+            forwarder->statistics.cacheHits++;
+            return;
+        }
+    }
+
+    // Aggregate with a pending Interest from another face. A retransmission from the same face is forwarded again.
+    _CCNxTestrigForwarderPitEntry **link = _ccnxTestrigForwarder_FindPitEntry(forwarder, hash, interest);
+    _CCNxTestrigForwarderPitEntry *entry = *link;
+    if (entry != NULL && entry->expiry <= now) {
+        _ccnxTestrigForwarder_RemovePitEntry(forwarder, link);
+        link = _ccnxTestrigForwarder_FindPitEntry(forwarder, hash, interest);
+        entry = NULL;
+    }
+    uint64_t expiry = now + interest->lifetime * NSEC_PER_MSEC;
+    if (entry != NULL && !(entry->inFaces & (1U << face))) {
+        entry->inFaces |= 1U << face;
+        if (expiry > entry->expiry) {
+            entry->expiry = expiry;
+        }
+        forwarder->statistics.interestsAggregated++;
+        return;
+    }
+
+    uint32_t nextHops = _ccnxTestrigForwarder_Lookup(forwarder, interest->name, interest->nameLength) & ~(1U << face);
+    if (nextHops == 0 || bytes[4] == 0) {
+        forwarder->statistics.interestsDropped++;
+        return;
+    }
+
+    if (entry == NULL) {
+        entry = _ccnxTestrigForwarder_AddPitEntry(forwarder, link, hash, interest);
+        if (entry == NULL) {
+            forwarder->statistics.interestsDropped++;
+            return;
+        }
+    }
+    size_t outFace = _ccnxTestrigForwarder_LowestFace(nextHops);
+    entry->inFaces |= 1U << face;
+    entry->outFaces |= 1U << outFace;
+    if (expiry > entry->expiry) {
+        entry->expiry = expiry;
+    }
+    if (entry->expiry < forwarder->nextExpiry || forwarder->nextExpiry == 0) {
+        forwarder->nextExpiry = entry->expiry;
+    }
+
+    bytes[4]--;
+    if (ccnxTestrigLink_Send(forwarder->faces[outFace], buffer) >= 0) {
+        forwarder->statistics.interestsForwarded++;
+        ccnxTestrigHistogram_Record(forwarder->processingTime, _ccnxTestrigForwarder_Now() - now);
+    }
+}
+
+static void
+_ccnxTestrigForwarder_Cache(CCNxTestrigForwarder *forwarder, uint64_t hash, PARCBuffer *buffer)
+{
+    _CCNxTestrigForwarderCacheSlot *slot = &forwarder->cache[hash & (FORWARDER_CS_CAPACITY - 1)];
+    if (slot->contentObject != NULL) {
+        parcBuffer_Release(&slot->contentObject);
+    }
+
+    // The received buffer belongs to the face's pool, so the cache keeps a copy.
+    size_t length = parcBuffer_Remaining(buffer);
+    slot->contentObject = parcBuffer_Allocate(length);
+    parcBuffer_PutArray(slot->contentObject, length, parcBuffer_Overlay(buffer, 0));
+    parcBuffer_Flip(slot->contentObject);
+    slot->hash = hash;
+}
+
+static void
+_ccnxTestrigForwarder_ReceiveContentObject(CCNxTestrigForwarder *forwarder, size_t face, PARCBuffer *buffer, const _CCNxTestrigForwarderPacket *packet,
+                                           uint64_t now)
+{
+    forwarder->statistics.contentObjectsReceived++;
+
+    _CCNxTestrigForwarderContentObject content = { .bytes = parcBuffer_Overlay(buffer, 0), .packet = *packet, .hashed = false };
+    uint64_t hash = packet->name != NULL ? _ccnxTestrigForwarder_HashName(packet->name, packet->nameLength) : 0;
+
+    // A named object can only satisfy entries in its name's bucket. A nameless one can satisfy any
+    // entry that restricts the object hash, so every bucket is searched; the PIT is small here.
+    size_t first = packet->name != NULL ? (hash & (FORWARDER_PIT_BUCKETS - 1)) : 0;
+    size_t last = packet->name != NULL ? first + 1 : FORWARDER_PIT_BUCKETS;
+
+    uint32_t faces = 0;
+    for (size_t bucket = first; bucket < last; bucket++) {
+        _CCNxTestrigForwarderPitEntry **link = &forwarder->pit[bucket];
+        while (*link != NULL) {
+            _CCNxTestrigForwarderPitEntry *entry = *link;
+            bool named = packet->name != NULL
+                ? entry->hash == hash && _ccnxTestrigForwarder_Equal(entry->bytes, entry->nameLength, packet->name, packet->nameLength)
+                : entry->objectHashLength > 0;
+
+            // Only the faces the Interest was forwarded to may answer it.
+            if (named && entry->expiry > now && (entry->outFaces & (1U << face))
+                && _ccnxTestrigForwarder_Satisfies(forwarder, _ccnxTestrigForwarderPitEntry_KeyId(entry), entry->keyIdLength,
+                                                   _ccnxTestrigForwarderPitEntry_ObjectHash(entry), entry->objectHashLength, &content)) {
+                faces |= entry->inFaces;
+                _ccnxTestrigForwarder_RemovePitEntry(forwarder, link);
+            } else {
+                link = &entry->next;
+            }
+        }
+    }
+
+    faces &= ~(1U << face);
+    if (faces == 0) {
+        forwarder->statistics.contentObjectsDropped++;
+        return;
+    }
+
+    _ccnxTestrigForwarder_SendToFaces(forwarder, buffer, faces);
+    forwarder->statistics.contentObjectsForwarded++;
+    ccnxTestrigHistogram_Record(forwarder->processingTime, _ccnxTestrigForwarder_Now() - now);
+
+    if (packet->name != NULL) {
+        _ccnxTestrigForwarder_Cache(forwarder, hash, buffer);
+    }
+}
+
+static void
+_ccnxTestrigForwarder_Receive(CCNxTestrigForwarder *forwarder, size_t face, PARCBuffer *buffer)
+{
+    uint64_t now = _ccnxTestrigForwarder_Now();
+
+    _CCNxTestrigForwarderPacket packet;
+    if (!_ccnxTestrigForwarder_Parse(parcBuffer_Overlay(buffer, 0), parcBuffer_Remaining(buffer), &packet)) {
+        return;
+    }
+
+    if (packet.packetType == PACKET_TYPE_INTEREST) {
+        if (packet.name == NULL) {
+            forwarder->statistics.interestsReceived++;
+            forwarder->statistics.interestsDropped++;
+        } else {
+            _ccnxTestrigForwarder_ReceiveInterest(forwarder, face, buffer, &packet, now);
+        }
+    } else if (packet.packetType == PACKET_TYPE_CONTENT_OBJECT) {
+        _ccnxTestrigForwarder_ReceiveContentObject(forwarder, face, buffer, &packet, now);
+    }
+}
+
+static void *
+_ccnxTestrigForwarder_Run(void *arg)
+{
+    CCNxTestrigForwarder *forwarder = arg;
+    PARCBuffer *received[FORWARDER_BATCH_SIZE];
+    struct pollfd fds[CCNX_TESTRIG_FORWARDER_MAX_FACES];
+
+    for (size_t i = 0; i < forwarder->numberOfFaces; i++) {
+        fds[i].fd = ccnxTestrigLink_GetDescriptor(forwarder->faces[i]);
+        fds[i].events = POLLIN;
+    }
+
+    while (!__atomic_load_n(&forwarder->stopRequested, __ATOMIC_ACQUIRE)) {
+        int ready = poll(fds, forwarder->numberOfFaces, FORWARDER_INTERVAL);
+
+        for (size_t face = 0; ready > 0 && face < forwarder->numberOfFaces; face++) {
+            if (!(fds[face].revents & POLLIN) && !ccnxTestrigLink_HasPendingPacket(forwarder->faces[face])) {
+                continue;
+            }
+            size_t count = ccnxTestrigLink_ReceiveBatch(forwarder->faces[face], received, NULL, FORWARDER_BATCH_SIZE, 0);
+            for (size_t i = 0; i < count; i++) {
+                _ccnxTestrigForwarder_Receive(forwarder, face, received[i]);
+                parcBuffer_Release(&received[i]);
+            }
+        }
+
+        uint64_t now = _ccnxTestrigForwarder_Now();
+        if (forwarder->nextExpiry != 0 && forwarder->nextExpiry <= now) {
+            _ccnxTestrigForwarder_ExpirePit(forwarder, now);
+            // Sweep again within a second rather than tracking the earliest remaining entry.
+            forwarder->nextExpiry = forwarder->pitSize > 0 ? now + NSEC_PER_SEC : 0;
+        }
+    }
+
+    return NULL;
+}
+
+bool
+ccnxTestrigForwarder_AddRoute(CCNxTestrigForwarder *forwarder, const char *prefix, size_t face)
+{
+    if (face >= forwarder->numberOfFaces) {
+        return false;
+    }
+
+    // Encode an Interest for the prefix to find the wire form of its name.
+    CCNxName *name = ccnxName_CreateFromCString(prefix);
+    if (name == NULL) {
+        return false;
+    }
+    CCNxInterest *interest = ccnxInterest_Create(name, FORWARDER_DEFAULT_LIFETIME, NULL, NULL);
+    PARCBuffer *encoded = ccnxTestrigPacketUtility_EncodePacket(interest);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+
+    size_t messageOffset, nameOffset, nameLength;
+    const uint8_t *bytes = parcBuffer_Overlay(encoded, 0);
+    if (!ccnxTestrigPacketUtility_FindWireName(bytes, parcBuffer_Remaining(encoded), &messageOffset, &nameOffset, &nameLength)) {
+        parcBuffer_Release(&encoded);
+        return false;
+    }
+    const uint8_t *value = bytes + nameOffset + 4;
+    size_t valueLength = nameLength - 4;
+
+    for (size_t i = 0; i < forwarder->numberOfRoutes; i++) {
+        _CCNxTestrigForwarderRoute *route = &forwarder->routes[i];
+        if (_ccnxTestrigForwarder_Equal(route->prefix, route->prefixLength, value, valueLength)) {
+            route->faces |= 1U << face;
+            parcBuffer_Release(&encoded);
+            return true;
+        }
+    }
+
+    _CCNxTestrigForwarderRoute *routes = realloc(forwarder->routes, (forwarder->numberOfRoutes + 1) * sizeof(_CCNxTestrigForwarderRoute));
+    if (routes == NULL) {
+        parcBuffer_Release(&encoded);
+        return false;
+    }
+    forwarder->routes = routes;
+
+    _CCNxTestrigForwarderRoute *route = &forwarder->routes[forwarder->numberOfRoutes++];
+    route->prefix = malloc(valueLength > 0 ? valueLength : 1);
+    memcpy(route->prefix, value, valueLength);
+    route->prefixLength = valueLength;
+    route->faces = 1U << face;
+
+    parcBuffer_Release(&encoded);
+    return true;
+}
+
+CCNxTestrigLink *
+ccnxTestrigForwarder_GetFace(const CCNxTestrigForwarder *forwarder, size_t face)
+{
+    return face < forwarder->numberOfFaces ? forwarder->faces[face] : NULL;
+}
+
+bool
+ccnxTestrigForwarder_Start(CCNxTestrigForwarder *forwarder)
+{
+    if (forwarder->running) {
+        return true;
+    }
+
+    forwarder->stopRequested = false;
+    if (pthread_create(&forwarder->thread, NULL, _ccnxTestrigForwarder_Run, forwarder) != 0) {
+        perror("Unable to start the forwarder");
+        return false;
+    }
+    forwarder->running = true;
+    return true;
+}
+
+void
+ccnxTestrigForwarder_Stop(CCNxTestrigForwarder *forwarder)
+{
+    if (!forwarder->running) {
+        return;
+    }
+
+    __atomic_store_n(&forwarder->stopRequested, true, __ATOMIC_RELEASE);
+    pthread_join(forwarder->thread, NULL);
+    forwarder->running = false;
+}
+
+const CCNxTestrigForwarderStatistics *
+ccnxTestrigForwarder_GetStatistics(const CCNxTestrigForwarder *forwarder)
+{
+    return &forwarder->statistics;
+}
+
+const CCNxTestrigHistogram *
+ccnxTestrigForwarder_GetProcessingTime(const CCNxTestrigForwarder *forwarder)
+{
+    return forwarder->processingTime;
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_Forwarder_h
+#define ccnxTestrig_Forwarder_h
+
+#include "ccnxTestrig_Link.h"
+#include "ccnxTestrig_Histogram.h"
+
+// Faces are tracked in 32-bit masks, in the routes and the PIT.
+#define CCNX_TESTRIG_FORWARDER_MAX_FACES 32
+
+struct ccnx_testrig_forwarder;
+typedef struct ccnx_testrig_forwarder CCNxTestrigForwarder;
+
+/**
+ * The packet counters of a `CCNxTestrigForwarder`.
+ */
+typedef struct {
+    uint64_t interestsReceived;
+    uint64_t interestsForwarded;
+    uint64_t interestsAggregated;
+    // Interests without a route, out of hops, or refused by a full PIT.
+    uint64_t interestsDropped;
+    uint64_t contentObjectsReceived;
+    uint64_t contentObjectsForwarded;
+    // Content Objects that no pending Interest asked for.
+    uint64_t contentObjectsDropped;
+    uint64_t cacheHits;
+} CCNxTestrigForwarderStatistics;
+
+/**
+ * Create a minimal in-process CCNx forwarder, so that the rig can be exercised without an external forwarder.
+ *
+ * The forwarder has one face per rig link. Face i connects to @p port + i, where the rig listens for
+ * link A, B, C and so on. It implements longest-prefix match on the FIB, PIT aggregation with KeyId
+ * and Content Object hash restrictions, and a small direct-mapped content store. It works on the
+ * wire format and never decodes packets into dictionaries, so its own per-packet cost stays small
+ * and can be measured separately from the rig.
+ *
+ * @param [in] type The link type of the faces. Only UDP faces can be paired with listening rig links.
+ * @param [in] address The address of the rig.
+ * @param [in] port The port of the rig's first link.
+ * @param [in] numberOfFaces The number of faces, at most `CCNX_TESTRIG_FORWARDER_MAX_FACES`.
+ *
+ * @return A newly allocated `CCNxTestrigForwarder` that must be freed by `ccnxTestrigForwarder_Release`, or NULL.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigForwarder *forwarder = ccnxTestrigForwarder_Create(CCNxTestrigLinkType_UDP, "127.0.0.1", 9696, 3);
+ *
+ *     ccnxTestrigForwarder_Release(&forwarder);
+ * }
+ * @endcode
+ */
+CCNxTestrigForwarder *ccnxTestrigForwarder_Create(CCNxTestrigLinkType type, char *address, int port, size_t numberOfFaces);
+
+/**
+ * Increase the number of references to a `CCNxTestrigForwarder` instance.
+ *
+ * @param [in] forwarder A `CCNxTestrigForwarder` instance.
+ *
+ * @return The same value as @p forwarder.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigForwarder *handle = ccnxTestrigForwarder_Acquire(forwarder);
+ *
+ *     ccnxTestrigForwarder_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigForwarder *ccnxTestrigForwarder_Acquire(const CCNxTestrigForwarder *forwarder);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigForwarder` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The forwarder must be stopped before the last reference is released.
+ *
+ * @param [in,out] forwarderPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigForwarder *forwarder = ccnxTestrigForwarder_Create(CCNxTestrigLinkType_UDP, "127.0.0.1", 9696, 3);
+ *
+ *     ccnxTestrigForwarder_Release(&forwarder);
+ * }
+ * @endcode
+ */
+void ccnxTestrigForwarder_Release(CCNxTestrigForwarder **forwarderPtr);
+
+/**
+ * Add a FIB entry sending Interests under @p prefix to a face.
+ *
+ * A prefix may be routed to several faces. An Interest is forwarded to the lowest-numbered face
+ * of its longest matching prefix, other than the face it arrived on.
+ *
+ * @param [in] forwarder A `CCNxTestrigForwarder` instance.
+ * @param [in] prefix The URI of the prefix, such as "ccnx:/test/b".
+ * @param [in] face The index of the face, where 0 faces link A.
+ *
+ * @return true if the route was added.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigForwarder_AddRoute(forwarder, "ccnx:/test/b", 1);
+ * }
+ * @endcode
+ */
+bool ccnxTestrigForwarder_AddRoute(CCNxTestrigForwarder *forwarder, const char *prefix, size_t face);
+
+/**
+ * Retrieve one of the faces of a `CCNxTestrigForwarder`.
+ *
+ * @param [in] forwarder A `CCNxTestrigForwarder` instance.
+ * @param [in] face The index of the face.
+ *
+ * @return The link of the face, which remains owned by the forwarder.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigLink_SetPeer(linkA, ccnxTestrigForwarder_GetFace(forwarder, 0));
+ * }
+ * @endcode
+ */
+CCNxTestrigLink *ccnxTestrigForwarder_GetFace(const CCNxTestrigForwarder *forwarder, size_t face);
+
+/**
+ * Start forwarding on a background thread.
+ *
+ * @param [in] forwarder A `CCNxTestrigForwarder` instance.
+ *
+ * @return true if the forwarding thread was started.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigForwarder_Start(forwarder);
+ * }
+ * @endcode
+ */
+bool ccnxTestrigForwarder_Start(CCNxTestrigForwarder *forwarder);
+
+/**
+ * Stop forwarding and wait for the forwarding thread to exit.
+ *
+ * @param [in] forwarder A `CCNxTestrigForwarder` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigForwarder_Stop(forwarder);
+ * }
+ * @endcode
+ */
+void ccnxTestrigForwarder_Stop(CCNxTestrigForwarder *forwarder);
+
+/**
+ * Retrieve the packet counters of a `CCNxTestrigForwarder`. They are only stable once it is stopped.
+ *
+ * @param [in] forwarder A `CCNxTestrigForwarder` instance.
+ *
+ * @return The statistics of the forwarder, which remain owned by it.
+ *
+ * Example:
+ * @code
+ * {
+ *     const CCNxTestrigForwarderStatistics *stats = ccnxTestrigForwarder_GetStatistics(forwarder);
+ *     printf("%" PRIu64 " Interests aggregated\n", stats->interestsAggregated);
+ * }
+ * @endcode
+ */
+const CCNxTestrigForwarderStatistics *ccnxTestrigForwarder_GetStatistics(const CCNxTestrigForwarder *forwarder);
+
+/**
+ * Retrieve the time the forwarder spent on each packet it forwarded, from receipt to send, in nanoseconds.
+ *
+ * Subtracting this from the latency the rig measures leaves the rig's own per-packet overhead.
+ * It is only stable once the forwarder is stopped.
+ *
+ * @param [in] forwarder A `CCNxTestrigForwarder` instance.
+ *
+ * @return The histogram of processing times, which remains owned by the forwarder.
+ *
+ * Example:
+ * @code
+ * {
+ *     char *summary = ccnxTestrigHistogram_ToString(ccnxTestrigForwarder_GetProcessingTime(forwarder));
+ *     printf("Forwarder: %s\n", summary);
+ *     free(summary);
+ * }
+ * @endcode
+ */
+const CCNxTestrigHistogram *ccnxTestrigForwarder_GetProcessingTime(const CCNxTestrigForwarder *forwarder);
+#endif // ccnxTestrig_Forwarder_h
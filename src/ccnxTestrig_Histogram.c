@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <parc/algol/parc_Object.h>
+
+#include "ccnxTestrig_Histogram.h"
+
+// Each power of two above SUB_BUCKET_COUNT is split into SUB_BUCKET_HALF_COUNT sub-buckets.
+#define SUB_BUCKET_BITS 7
+#define SUB_BUCKET_COUNT (1 << SUB_BUCKET_BITS)
+#define SUB_BUCKET_HALF_COUNT (SUB_BUCKET_COUNT / 2)
+
+// Values are tracked up to 2^40 ns, a little over 18 minutes.
+#define MAX_VALUE_BITS 40
+#define MAX_VALUE ((1ULL << MAX_VALUE_BITS) - 1)
+#define BUCKET_COUNT (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1)
+#define COUNTS_LENGTH ((BUCKET_COUNT + 1) * SUB_BUCKET_HALF_COUNT)
+
+struct ccnx_testrig_histogram {
+    uint64_t totalCount;
+    uint64_t max;
+    uint64_t counts[COUNTS_LENGTH];
+};
+
+static bool
+_ccnxTestrigHistogram_Destructor(CCNxTestrigHistogram **histogramPtr)
+{
+    return true;
+}
+
+parcObject_ImplementAcquire(ccnxTestrigHistogram, CCNxTestrigHistogram);
+parcObject_ImplementRelease(ccnxTestrigHistogram, CCNxTestrigHistogram);
+
+parcObject_Override(
+	CCNxTestrigHistogram, PARCObject,
+	.destructor = (PARCObjectDestructor *) _ccnxTestrigHistogram_Destructor);
+
+CCNxTestrigHistogram *
+ccnxTestrigHistogram_Create(void)
+{
+    CCNxTestrigHistogram *histogram = parcObject_CreateInstance(CCNxTestrigHistogram);
+
+    if (histogram != NULL) {
+        histogram->totalCount = 0;
+        histogram->max = 0;
+        memset(histogram->counts, 0, sizeof(histogram->counts));
+    }
+
+    return histogram;
+}
+
+static size_t
+_ccnxTestrigHistogram_IndexOf(uint64_t value)
+{
+    if (value < SUB_BUCKET_COUNT) {
+        return (size_t) value;
+    }
+
+    // The bucket is how far the value must be shifted to fit in the top half of the sub-buckets.
+    unsigned bucket = (63 - __builtin_clzll(value)) - (SUB_BUCKET_BITS - 1);
+    return bucket * SUB_BUCKET_HALF_COUNT + (size_t) (value >> bucket);
+}
+
+static uint64_t
+_ccnxTestrigHistogram_HighestEquivalentValue(size_t index)
+{
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+
+    unsigned bucket = index / SUB_BUCKET_HALF_COUNT - 1;
+    uint64_t subBucket = index - bucket * SUB_BUCKET_HALF_COUNT;
+    return ((subBucket + 1) << bucket) - 1;
+}
+
+void
+ccnxTestrigHistogram_Record(CCNxTestrigHistogram *histogram, uint64_t value)
+{
+    if (value > MAX_VALUE) {
+        value = MAX_VALUE;
+    }
+
+    histogram->counts[_ccnxTestrigHistogram_IndexOf(value)]++;
+    histogram->totalCount++;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+void
+ccnxTestrigHistogram_Merge(CCNxTestrigHistogram *histogram, const CCNxTestrigHistogram *other)
+{
+    for (size_t i = 0; i < COUNTS_LENGTH; i++) {
+        histogram->counts[i] += other->counts[i];
+    }
+    histogram->totalCount += other->totalCount;
+    if (other->max > histogram->max) {
+        histogram->max = other->max;
+    }
+}
+
+uint64_t
+ccnxTestrigHistogram_GetCount(const CCNxTestrigHistogram *histogram)
+{
+    return histogram->totalCount;
+}
+
+uint64_t
+ccnxTestrigHistogram_GetValueAtPercentile(const CCNxTestrigHistogram *histogram, double percentile)
+{
+    if (histogram->totalCount == 0) {
+        return 0;
+    }
+
+    uint64_t target = (uint64_t) ((percentile / 100.0) * histogram->totalCount + 0.5);
+    if (target < 1) {
+        target = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < COUNTS_LENGTH; i++) {
+        seen += histogram->counts[i];
+        if (seen >= target) {
+            uint64_t value = _ccnxTestrigHistogram_HighestEquivalentValue(i);
+            return value < histogram->max ? value : histogram->max;
+        }
+    }
+
+    return histogram->max;
+}
+
+uint64_t
+ccnxTestrigHistogram_GetMax(const CCNxTestrigHistogram *histogram)
+{
+    return histogram->max;
+}
+
+size_t
+ccnxTestrigHistogram_GetMemoryUsage(const CCNxTestrigHistogram *histogram)
+{
+    return sizeof(CCNxTestrigHistogram);
+}
+
+char *
+ccnxTestrigHistogram_ToString(const CCNxTestrigHistogram *histogram)
+{
+    char *result = NULL;
+    asprintf(&result, "n=%llu p50=%.1fus p90=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus",
+             (unsigned long long) histogram->totalCount,
+             ccnxTestrigHistogram_GetValueAtPercentile(histogram, 50.0) / 1000.0,
+             ccnxTestrigHistogram_GetValueAtPercentile(histogram, 90.0) / 1000.0,
+             ccnxTestrigHistogram_GetValueAtPercentile(histogram, 99.0) / 1000.0,
+             ccnxTestrigHistogram_GetValueAtPercentile(histogram, 99.9) / 1000.0,
+             ccnxTestrigHistogram_GetMax(histogram) / 1000.0);
+    return result;
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_Histogram_h
+#define ccnxTestrig_Histogram_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+struct ccnx_testrig_histogram;
+typedef struct ccnx_testrig_histogram CCNxTestrigHistogram;
+
+/**
+ * Create an empty `CCNxTestrigHistogram` of nanosecond latencies.
+ *
+ * The histogram is log-linear, in the style of HdrHistogram: every power of two is split
+ * into 64 equal sub-buckets, so any recorded value is reproduced to within about 1.5%
+ * from one nanosecond up to roughly 18 minutes. Recording is constant time and the
+ * histogram has a fixed size regardless of the number of values.
+ *
+ * @return A newly allocated `CCNxTestrigHistogram` that must be freed by `ccnxTestrigHistogram_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigHistogram *histogram = ccnxTestrigHistogram_Create();
+ *
+ *     ccnxTestrigHistogram_Release(&histogram);
+ * }
+ * @endcode
+ */
+CCNxTestrigHistogram *ccnxTestrigHistogram_Create(void);
+
+/**
+ * Increase the number of references to a `CCNxTestrigHistogram` instance.
+ *
+ * @param [in] histogram A `CCNxTestrigHistogram` instance.
+ *
+ * @return The same value as @p histogram.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigHistogram *handle = ccnxTestrigHistogram_Acquire(histogram);
+ *
+ *     ccnxTestrigHistogram_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigHistogram *ccnxTestrigHistogram_Acquire(const CCNxTestrigHistogram *histogram);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigHistogram` instance,
+ * decrementing the reference count for the instance.
+ *
+ * @param [in,out] histogramPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigHistogram *histogram = ccnxTestrigHistogram_Create();
+ *
+ *     ccnxTestrigHistogram_Release(&histogram);
+ * }
+ * @endcode
+ */
+void ccnxTestrigHistogram_Release(CCNxTestrigHistogram **histogramPtr);
+
+/**
+ * Record a value in the histogram.
+ *
+ * @param [in] histogram A `CCNxTestrigHistogram` instance.
+ * @param [in] value The value, in nanoseconds. Larger values than the histogram covers are recorded as its maximum.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigHistogram_Record(histogram, receiveTime - sendTime);
+ * }
+ * @endcode
+ */
+void ccnxTestrigHistogram_Record(CCNxTestrigHistogram *histogram, uint64_t value);
+
+/**
+ * Add every value recorded in one histogram to another.
+ *
+ * @param [in] histogram The `CCNxTestrigHistogram` to add to.
+ * @param [in] other The `CCNxTestrigHistogram` whose values are added.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigHistogram_Merge(total, testHistogram);
+ * }
+ * @endcode
+ */
+void ccnxTestrigHistogram_Merge(CCNxTestrigHistogram *histogram, const CCNxTestrigHistogram *other);
+
+/**
+ * Retrieve the number of values recorded in the histogram.
+ *
+ * @param [in] histogram A `CCNxTestrigHistogram` instance.
+ *
+ * @return The number of recorded values.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (ccnxTestrigHistogram_GetCount(histogram) > 0) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+uint64_t ccnxTestrigHistogram_GetCount(const CCNxTestrigHistogram *histogram);
+
+/**
+ * Retrieve the value below which the given percentage of the recorded values fall.
+ *
+ * @param [in] histogram A `CCNxTestrigHistogram` instance.
+ * @param [in] percentile The percentile, between 0 and 100.
+ *
+ * @return The highest value equivalent to the percentile's bucket, or 0 if the histogram is empty.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t p99 = ccnxTestrigHistogram_GetValueAtPercentile(histogram, 99.0);
+ * }
+ * @endcode
+ */
+uint64_t ccnxTestrigHistogram_GetValueAtPercentile(const CCNxTestrigHistogram *histogram, double percentile);
+
+/**
+ * Retrieve the largest value recorded in the histogram.
+ *
+ * @param [in] histogram A `CCNxTestrigHistogram` instance.
+ *
+ * @return The exact maximum, or 0 if the histogram is empty.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t max = ccnxTestrigHistogram_GetMax(histogram);
+ * }
+ * @endcode
+ */
+uint64_t ccnxTestrigHistogram_GetMax(const CCNxTestrigHistogram *histogram);
+
+/**
+ * Retrieve the number of bytes the histogram occupies, which is the same for every histogram.
+ *
+ * @param [in] histogram A `CCNxTestrigHistogram` instance.
+ *
+ * @return The number of bytes.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t bytes = ccnxTestrigHistogram_GetMemoryUsage(histogram);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigHistogram_GetMemoryUsage(const CCNxTestrigHistogram *histogram);
+
+/**
+ * Produce a one-line summary of the histogram: its count and its p50, p90, p99, p99.9 and max in microseconds.
+ *
+ * @param [in] histogram A `CCNxTestrigHistogram` instance.
+ *
+ * @return A nul-terminated string that must be freed with `free`.
+ *
+ * Example:
+ * @code
+ * {
+ *     char *summary = ccnxTestrigHistogram_ToString(histogram);
+ *     printf("%s\n", summary);
+ *     free(summary);
+ * }
+ * @endcode
+ */
+char *ccnxTestrigHistogram_ToString(const CCNxTestrigHistogram *histogram);
+#endif // ccnxTestrig_Histogram_h
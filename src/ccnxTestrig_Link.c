@@ -52,7 +52,9 @@
  * intellectual property used by its contributions to this software. You may
  * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
  */
- #include <unistd.h>
+#define _GNU_SOURCE // recvmmsg() and sendmmsg()
+
+#include <unistd.h>
 #include <netdb.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -62,19 +64,42 @@
 #include <errno.h>
 #include <stdbool.h>
 #include <poll.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <pthread.h>
 
 #include <parc/algol/parc_Object.h>
 
-#include "ccnxTestrig_link.h"
+#include "ccnxTestrig_Link.h"
+#include "ccnxTestrig_BufferPool.h"
+#include "ccnxTestrig_URing.h"
+#include "ccnxTestrig_Log.h"
 
 #define MTU 4096
 #define MAX_NUMBER_OF_TCP_CONNECTIONS 3
+#define DEFAULT_BATCH_SIZE 32
+#define MAX_BATCH_SIZE 1024
+
+// The CCNx fixed header carries a 16-bit packet length at offset 2.
+#define FIXED_HEADER_LENGTH 8
+#define MAX_PACKET_LENGTH 65535
+
+// Room for one partially received packet and a full packet behind it.
+#define STREAM_CAPACITY (2 * MAX_PACKET_LENGTH)
+
+// Receive buffers per link: several default batches plus the packets a test may hold on to.
+#define RECEIVE_POOL_CAPACITY 256
+
+// Room for the SCM_TIMESTAMPNS control message of a received packet.
+#define TIMESTAMP_CONTROL_LENGTH CMSG_SPACE(sizeof(struct timespec))
 
 struct ccnx_testrig_link {
     CCNxTestrigLinkType type;
 
     PARCBuffer *(*receiveFunction)(CCNxTestrigLink *, int);
     int (*sendFunction)(CCNxTestrigLink *, PARCBuffer *);
+    size_t (*receiveBatchFunction)(CCNxTestrigLink *, PARCBuffer **, uint64_t *, size_t, int);
+    size_t (*sendBatchFunction)(CCNxTestrigLink *, PARCBuffer **, size_t);
 
     int port;
     int socket;
@@ -84,6 +109,37 @@ struct ccnx_testrig_link {
     int targetSocket;
     struct sockaddr_in targetAddress;
     unsigned int targetAddressLength;
+
+    size_t batchSize;
+    CCNxTestrigBufferPool *receivePool;
+
+    // TCP bytes that have been read but not yet emitted as packets, in [streamStart, streamEnd).
+    uint8_t *stream;
+    size_t streamStart;
+    size_t streamEnd;
+    CCNxTestrigLinkStatistics statistics;
+
+    // When set, every packet sent or received is recorded on this capture interface.
+    CCNxTestrigCapture *capture;
+    unsigned captureInterface;
+
+    // The rings of an io_uring link, which replace the socket calls of a UDP link.
+    CCNxTestrigURing *ring;
+
+    // With kernel timestamps, packets are stamped by the kernel when they arrive, on the realtime
+    // clock. Otherwise they are stamped on the monotonic clock when the receive call returns.
+    bool kernelTimestamps;
+    uint64_t receiveTime;
+
+    // The time of the last read from the TCP stream, which every packet extracted from it carries.
+    uint64_t streamTime;
+
+    // Set once the peer of a TCP link has closed the connection or it has failed.
+    bool closed;
+
+    // Held while sending, so that concurrent senders neither interleave the bytes of their packets
+    // on a TCP stream nor race on the send statistics, and while the target address is changed.
+    pthread_mutex_t sendLock;
 };
 
 static bool
@@ -91,6 +147,15 @@ _ccnxTestrigLink_Destructor(CCNxTestrigLink **linkPtr)
 {
     CCNxTestrigLink *link = *linkPtr;
     // TODO
+    ccnxTestrigBufferPool_Release(&link->receivePool);
+    free(link->stream);
+    if (link->capture != NULL) {
+        ccnxTestrigCapture_Release(&link->capture);
+    }
+    if (link->ring != NULL) {
+        ccnxTestrigURing_Release(&link->ring);
+    }
+    pthread_mutex_destroy(&link->sendLock);
     return true;
 }
 
@@ -101,6 +166,49 @@ parcObject_Override(
 	CCNxTestrigLink, PARCObject,
 	.destructor = (PARCObjectDestructor *) _ccnxTestrigLink_Destructor);
 
+/**
+ * Make the sender of a received datagram the target of the link's sends. Only the receiving
+ * thread writes the target, so it reads it unlocked, but it changes it under the send lock.
+ */
+static void
+_link_SetTarget(CCNxTestrigLink *link, const struct sockaddr_in *address, socklen_t addressLength)
+{
+    if (addressLength == link->targetAddressLength && memcmp(address, &link->targetAddress, addressLength) == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&link->sendLock);
+    link->targetAddress = *address;
+    link->targetAddressLength = addressLength;
+    pthread_mutex_unlock(&link->sendLock);
+}
+
+static uint64_t
+_link_Time(const CCNxTestrigLink *link)
+{
+    struct timespec now;
+    clock_gettime(link->kernelTimestamps ? CLOCK_REALTIME : CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * Return the kernel timestamp of a received message, or the current time if it carries none.
+ */
+static uint64_t
+_link_ReceiveTime(const CCNxTestrigLink *link, struct msghdr *message)
+{
+    if (link->kernelTimestamps) {
+        for (struct cmsghdr *header = CMSG_FIRSTHDR(message); header != NULL; header = CMSG_NXTHDR(message, header)) {
+            if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_TIMESTAMPNS) {
+                struct timespec stamp;
+                memcpy(&stamp, CMSG_DATA(header), sizeof(stamp));
+                return (uint64_t) stamp.tv_sec * 1000000000ULL + stamp.tv_nsec;
+            }
+        }
+    }
+    return _link_Time(link);
+}
+
 static PARCBuffer *
 _udp_receive(CCNxTestrigLink *link, int timeout)
 {
@@ -115,17 +223,31 @@ _udp_receive(CCNxTestrigLink *link, int timeout)
         perror("An error occurred while receiving");
         return NULL;
     } else {
-        uint8_t buffer[MTU];
-        int numBytesReceived = recvfrom(link->socket, buffer, MTU, 0, (struct sockaddr *) &(link->targetAddress), &(link->targetAddressLength));
+        PARCBuffer *result = ccnxTestrigBufferPool_Get(link->receivePool);
+        struct iovec vector = { .iov_base = parcBuffer_Overlay(result, 0), .iov_len = MTU };
+        uint8_t control[TIMESTAMP_CONTROL_LENGTH];
+        struct sockaddr_in address;
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_name = &address;
+        message.msg_namelen = sizeof(address);
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        int numBytesReceived = recvmsg(link->socket, &message, 0);
         if (numBytesReceived < 0) {
-            fprintf(stderr, "recvfrom() failed");
+            ccnxTestrigLog_Warning("recvmsg() failed on the link on port %d: %s", link->port, strerror(errno));
+            parcBuffer_Release(&result);
             return NULL;
         }
+        _link_SetTarget(link, &address, message.msg_namelen);
+        link->receiveTime = _link_ReceiveTime(link, &message);
+        link->statistics.packetsReceived++;
+        link->statistics.receiveCalls++;
 
-        PARCBuffer *result = parcBuffer_Allocate(numBytesReceived);
-        parcBuffer_PutArray(result, numBytesReceived, buffer);
-        parcBuffer_Flip(result);
-
+        parcBuffer_SetLimit(result, numBytesReceived);
         return result;
     }
 }
@@ -134,36 +256,331 @@ static int
 _udp_send(CCNxTestrigLink *link, PARCBuffer *buffer)
 {
     size_t length = parcBuffer_Remaining(buffer);
-    uint8_t *bufferOverlay = parcBuffer_Overlay(buffer, length);
+    uint8_t *bufferOverlay = parcBuffer_Overlay(buffer, 0);
     int val = sendto(link->socket, bufferOverlay, length, 0,
         (struct sockaddr *) &link->targetAddress, link->targetAddressLength);
 
-    printf("sent %d bytes\n", val);
+    if (val >= 0) {
+        link->statistics.packetsSent++;
+        link->statistics.sendCalls++;
+    }
     return val;
 }
 
-static PARCBuffer *
-_tcp_receive(CCNxTestrigLink *link, int timeout)
+static int
+_udp_wait(CCNxTestrigLink *link, int timeout)
 {
     struct pollfd fd;
-    fd.fd = link->targetSocket;
+    fd.fd = link->socket;
     fd.events = POLLIN;
     int res = poll(&fd, 1, timeout);
+    if (res == -1) {
+        perror("An error occurred while receiving");
+    }
+    return res;
+}
 
-    if (res == 0) {
+static size_t
+_udp_receive_batch(CCNxTestrigLink *link, PARCBuffer **buffers, uint64_t *receiveTimes, size_t count, int timeout)
+{
+    if (_udp_wait(link, timeout) <= 0) {
+        return 0;
+    }
+
+    struct mmsghdr messages[link->batchSize];
+    struct iovec vectors[link->batchSize];
+    struct sockaddr_in addresses[link->batchSize];
+    uint8_t controls[link->batchSize][TIMESTAMP_CONTROL_LENGTH];
+    PARCBuffer *slots[link->batchSize];
+
+    size_t numReceived = 0;
+    while (numReceived < count) {
+        size_t batch = count - numReceived;
+        if (batch > link->batchSize) {
+            batch = link->batchSize;
+        }
+
+        for (size_t i = 0; i < batch; i++) {
+            slots[i] = ccnxTestrigBufferPool_Get(link->receivePool);
+            vectors[i].iov_base = parcBuffer_Overlay(slots[i], 0);
+            vectors[i].iov_len = MTU;
+            memset(&messages[i], 0, sizeof(messages[i]));
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+            messages[i].msg_hdr.msg_control = controls[i];
+            messages[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+        }
+
+        int res = recvmmsg(link->socket, messages, batch, MSG_DONTWAIT, NULL);
+        if (res < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                perror("recvmmsg() failed");
+            }
+            res = 0;
+        } else {
+            link->statistics.receiveCalls++;
+            link->statistics.packetsReceived += res;
+        }
+
+        for (size_t i = 0; i < batch; i++) {
+            if (i < (size_t) res) {
+                parcBuffer_SetLimit(slots[i], messages[i].msg_len);
+                if (receiveTimes != NULL) {
+                    // Every datagram of the batch carries its own kernel timestamp.
+                    receiveTimes[numReceived] = _link_ReceiveTime(link, &messages[i].msg_hdr);
+                }
+                buffers[numReceived++] = slots[i];
+            } else {
+                parcBuffer_Release(&slots[i]);
+            }
+        }
+
+        if (res > 0) {
+            _link_SetTarget(link, &addresses[res - 1], messages[res - 1].msg_hdr.msg_namelen);
+            link->receiveTime = _link_ReceiveTime(link, &messages[res - 1].msg_hdr);
+        }
+
+        // A short batch means the socket queue is empty, so don't pay for another call.
+        if ((size_t) res < batch) {
+            break;
+        }
+    }
+
+    return numReceived;
+}
+
+static size_t
+_udp_send_batch(CCNxTestrigLink *link, PARCBuffer **buffers, size_t count)
+{
+    struct mmsghdr messages[link->batchSize];
+    struct iovec vectors[link->batchSize];
+
+    size_t numSent = 0;
+    while (numSent < count) {
+        size_t batch = count - numSent;
+        if (batch > link->batchSize) {
+            batch = link->batchSize;
+        }
+
+        for (size_t i = 0; i < batch; i++) {
+            PARCBuffer *buffer = buffers[numSent + i];
+            size_t length = parcBuffer_Remaining(buffer);
+            vectors[i].iov_base = parcBuffer_Overlay(buffer, 0);
+            vectors[i].iov_len = length;
+            memset(&messages[i], 0, sizeof(messages[i]));
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = &link->targetAddress;
+            messages[i].msg_hdr.msg_namelen = link->targetAddressLength;
+        }
+
+        int res = sendmmsg(link->socket, messages, batch, 0);
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("sendmmsg() failed");
+            break;
+        }
+        link->statistics.sendCalls++;
+        link->statistics.packetsSent += res;
+        numSent += res;
+    }
+
+    return numSent;
+}
+
+static PARCBuffer *
+_uring_receive(CCNxTestrigLink *link, int timeout)
+{
+    PARCBuffer *result = ccnxTestrigBufferPool_Get(link->receivePool);
+    uint64_t kernelTime;
+    struct sockaddr_in address;
+    ssize_t numBytesReceived = ccnxTestrigURing_Receive(link->ring, parcBuffer_Overlay(result, 0), MTU, &address,
+                                                        &kernelTime, timeout, &link->statistics.receiveCalls);
+    if (numBytesReceived < 0) {
+        parcBuffer_Release(&result);
         return NULL;
-    } else if (res == -1) {
-        perror("An error occurred while receiving");
+    }
+    _link_SetTarget(link, &address, sizeof(address));
+    link->receiveTime = (link->kernelTimestamps && kernelTime != 0) ? kernelTime : _link_Time(link);
+    link->statistics.packetsReceived++;
+
+    parcBuffer_SetLimit(result, numBytesReceived);
+    return result;
+}
+
+static int
+_uring_send(CCNxTestrigLink *link, PARCBuffer *buffer)
+{
+    if (ccnxTestrigURing_SendBatch(link->ring, &buffer, 1, &link->targetAddress, &link->statistics.sendCalls) == 0) {
+        return -1;
+    }
+    link->statistics.packetsSent++;
+    return (int) parcBuffer_Remaining(buffer);
+}
+
+static size_t
+_uring_receive_batch(CCNxTestrigLink *link, PARCBuffer **buffers, uint64_t *receiveTimes, size_t count, int timeout)
+{
+    // Datagrams already received into the provided buffers are reaped without further calls.
+    size_t numReceived = 0;
+    while (numReceived < count) {
+        PARCBuffer *buffer = _uring_receive(link, numReceived == 0 ? timeout : 0);
+        if (buffer == NULL) {
+            break;
+        }
+        if (receiveTimes != NULL) {
+            receiveTimes[numReceived] = link->receiveTime;
+        }
+        buffers[numReceived++] = buffer;
+    }
+    return numReceived;
+}
+
+static size_t
+_uring_send_batch(CCNxTestrigLink *link, PARCBuffer **buffers, size_t count)
+{
+    size_t numSent = ccnxTestrigURing_SendBatch(link->ring, buffers, count, &link->targetAddress, &link->statistics.sendCalls);
+    link->statistics.packetsSent += numSent;
+    return numSent;
+}
+
+static uint64_t
+_link_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * Return the next complete packet buffered from the TCP stream, or NULL if the
+ * stream does not hold one yet.
+ */
+static PARCBuffer *
+_tcp_extract_packet(CCNxTestrigLink *link)
+{
+    size_t available = link->streamEnd - link->streamStart;
+    if (available < FIXED_HEADER_LENGTH) {
         return NULL;
+    }
+
+    uint8_t *header = link->stream + link->streamStart;
+    size_t packetLength = ((size_t) header[2] << 8) | header[3];
+    if (packetLength < FIXED_HEADER_LENGTH) {
+        // There is no way to find the next packet boundary, so drop everything buffered.
+        ccnxTestrigLog_Warning("Invalid packet length %zu on TCP link, discarding %zu buffered bytes", packetLength, available);
+        link->streamStart = link->streamEnd = 0;
+        return NULL;
+    }
+    if (available < packetLength) {
+        return NULL;
+    }
+
+    PARCBuffer *result;
+    if (packetLength <= MTU) {
+        result = ccnxTestrigBufferPool_Get(link->receivePool);
     } else {
-        uint8_t buffer[MTU];
-        int recvMsgSize = recv(link->targetSocket, buffer, MTU, 0);
+        result = parcBuffer_Allocate(packetLength);
+    }
+    memcpy(parcBuffer_Overlay(result, 0), header, packetLength);
+    parcBuffer_SetLimit(result, packetLength);
+    link->receiveTime = link->streamTime;
 
-        PARCBuffer *result = parcBuffer_Allocate(recvMsgSize);
-        parcBuffer_PutArray(result, recvMsgSize, buffer);
-        parcBuffer_Flip(result);
+    link->streamStart += packetLength;
+    if (link->streamStart == link->streamEnd) {
+        link->streamStart = link->streamEnd = 0;
+    }
+    link->statistics.packetsReceived++;
 
-        return result;
+    return result;
+}
+
+/**
+ * Read whatever the socket has into the stream buffer.
+ *
+ * @return false if the connection was closed or failed.
+ */
+static bool
+_tcp_fill_stream(CCNxTestrigLink *link)
+{
+    if (link->stream == NULL) {
+        link->stream = malloc(STREAM_CAPACITY);
+        link->streamStart = link->streamEnd = 0;
+    }
+
+    // Move the partial packet to the front so a maximum sized packet always fits.
+    if (link->streamStart > 0 && STREAM_CAPACITY - link->streamEnd < MAX_PACKET_LENGTH) {
+        memmove(link->stream, link->stream + link->streamStart, link->streamEnd - link->streamStart);
+        link->streamEnd -= link->streamStart;
+        link->streamStart = 0;
+    }
+
+    struct iovec vector = { .iov_base = link->stream + link->streamEnd, .iov_len = STREAM_CAPACITY - link->streamEnd };
+    uint8_t control[TIMESTAMP_CONTROL_LENGTH];
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t numBytesReceived = recvmsg(link->targetSocket, &message, MSG_DONTWAIT);
+    if (numBytesReceived == 0) {
+        ccnxTestrigLog_Warning("TCP link closed by peer");
+        link->closed = true;
+        return false;
+    } else if (numBytesReceived < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return true;
+        }
+        perror("recvmsg() failed");
+        link->closed = true;
+        return false;
+    }
+
+    link->streamTime = _link_ReceiveTime(link, &message);
+    link->streamEnd += numBytesReceived;
+    link->statistics.receiveCalls++;
+    return true;
+}
+
+static PARCBuffer *
+_tcp_receive(CCNxTestrigLink *link, int timeout)
+{
+    uint64_t deadline = timeout < 0 ? 0 : _link_Now() + (uint64_t) timeout * 1000000ULL;
+
+    for (;;) {
+        PARCBuffer *result = _tcp_extract_packet(link);
+        if (result != NULL) {
+            return result;
+        }
+
+        int remaining = -1;
+        if (timeout >= 0) {
+            uint64_t now = _link_Now();
+            remaining = now >= deadline ? 0 : (int) ((deadline - now + 999999) / 1000000);
+        }
+
+        struct pollfd fd;
+        fd.fd = link->targetSocket;
+        fd.events = POLLIN;
+        int res = poll(&fd, 1, remaining);
+
+        if (res == 0) {
+            return NULL;
+        } else if (res == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("An error occurred while receiving");
+            return NULL;
+        } else if (!_tcp_fill_stream(link)) {
+            return NULL;
+        }
     }
 }
 
@@ -171,8 +588,94 @@ static int
 _tcp_send(CCNxTestrigLink *link, PARCBuffer *buffer)
 {
     size_t length = parcBuffer_Remaining(buffer);
-    uint8_t *bufferOverlay = parcBuffer_Overlay(buffer, length);
-    int numSent = send(link->targetSocket, bufferOverlay, length, 0);
+    uint8_t *bufferOverlay = parcBuffer_Overlay(buffer, 0);
+
+    // A short write would leave the peer with half a packet, so keep writing until it is all out.
+    size_t numSent = 0;
+    while (numSent < length) {
+        ssize_t res = send(link->targetSocket, bufferOverlay + numSent, length - numSent, 0);
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        link->statistics.sendCalls++;
+        numSent += res;
+    }
+    link->statistics.packetsSent++;
+    return (int) numSent;
+}
+
+static size_t
+_tcp_receive_batch(CCNxTestrigLink *link, PARCBuffer **buffers, uint64_t *receiveTimes, size_t count, int timeout)
+{
+    // One recv() usually fills the stream with several packets, which are then emitted without further calls.
+    size_t numReceived = 0;
+    while (numReceived < count) {
+        PARCBuffer *buffer = _tcp_receive(link, numReceived == 0 ? timeout : 0);
+        if (buffer == NULL) {
+            break;
+        }
+        if (receiveTimes != NULL) {
+            receiveTimes[numReceived] = link->receiveTime;
+        }
+        buffers[numReceived++] = buffer;
+    }
+    return numReceived;
+}
+
+static size_t
+_tcp_send_batch(CCNxTestrigLink *link, PARCBuffer **buffers, size_t count)
+{
+    struct iovec vectors[link->batchSize];
+
+    size_t numSent = 0;
+    while (numSent < count) {
+        size_t batch = count - numSent;
+        if (batch > link->batchSize) {
+            batch = link->batchSize;
+        }
+
+        size_t total = 0;
+        for (size_t i = 0; i < batch; i++) {
+            PARCBuffer *buffer = buffers[numSent + i];
+            vectors[i].iov_base = parcBuffer_Overlay(buffer, 0);
+            vectors[i].iov_len = parcBuffer_Remaining(buffer);
+            total += vectors[i].iov_len;
+        }
+
+        // The packets are framed by their fixed headers, so one gathered write keeps them intact.
+        ssize_t written = writev(link->targetSocket, vectors, batch);
+        if (written < 0) {
+            perror("writev() failed");
+            break;
+        }
+        link->statistics.sendCalls++;
+
+        // Finish a short write so the stream never ends in the middle of a packet.
+        size_t index = 0;
+        size_t remaining = total - written;
+        while (remaining > 0) {
+            while ((size_t) written >= vectors[index].iov_len) {
+                written -= vectors[index].iov_len;
+                index++;
+            }
+            vectors[index].iov_base = (uint8_t *) vectors[index].iov_base + written;
+            vectors[index].iov_len -= written;
+
+            written = writev(link->targetSocket, &vectors[index], batch - index);
+            if (written < 0) {
+                perror("writev() failed");
+                return numSent;
+            }
+            link->statistics.sendCalls++;
+            remaining -= written;
+        }
+        link->statistics.packetsSent += batch;
+        numSent += batch;
+    }
+
     return numSent;
 }
 
@@ -184,7 +687,23 @@ _create_link()
     if (link != NULL) {
         link->port = 0;
         link->socket = 0;
+        link->targetSocket = -1;
+        memset(&link->targetAddress, 0, sizeof(link->targetAddress));
         link->hostAddress = NULL;
+        link->batchSize = DEFAULT_BATCH_SIZE;
+        link->receivePool = ccnxTestrigBufferPool_Create(RECEIVE_POOL_CAPACITY, MTU);
+        link->stream = NULL;
+        link->streamStart = 0;
+        link->streamEnd = 0;
+        memset(&link->statistics, 0, sizeof(link->statistics));
+        link->capture = NULL;
+        link->captureInterface = 0;
+        link->ring = NULL;
+        link->kernelTimestamps = false;
+        link->receiveTime = 0;
+        link->streamTime = 0;
+        link->closed = false;
+        pthread_mutex_init(&link->sendLock, NULL);
     }
 
     return link;
@@ -199,6 +718,8 @@ _create_udp_ccnxTestrigLink_listener(char *address, int port)
     link->port = port;
     link->receiveFunction = _udp_receive;
     link->sendFunction = _udp_send;
+    link->receiveBatchFunction = _udp_receive_batch;
+    link->sendBatchFunction = _udp_send_batch;
     link->targetAddressLength = sizeof(link->targetAddress);
 
     if ((link->socket = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
@@ -219,7 +740,7 @@ _create_udp_ccnxTestrigLink_listener(char *address, int port)
         fprintf(stderr, "bind() failed");
     }
 
-    printf("Accepted!\n");
+    ccnxTestrigLog_Info("Accepted!");
 
     return link;
 }
@@ -234,6 +755,8 @@ _create_tcp_ccnxTestrigLink_listener(char *address, int port)
     link->targetAddressLength = sizeof(link->targetAddress);
     link->receiveFunction = _tcp_receive;
     link->sendFunction = _tcp_send;
+    link->receiveBatchFunction = _tcp_receive_batch;
+    link->sendBatchFunction = _tcp_send_batch;
 
     if ((link->socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP)) < 0) {
         fprintf(stderr, "socket() failed");
@@ -257,13 +780,20 @@ _create_tcp_ccnxTestrigLink_listener(char *address, int port)
         fprintf(stderr, "listen() failed");
     }
 
+    return link;
+}
+
+static bool
+_tcp_accept(CCNxTestrigLink *link)
+{
+    link->targetAddressLength = sizeof(link->targetAddress);
     if ((link->targetSocket = accept(link->socket, (struct sockaddr *) &(link->targetAddress), &link->targetAddressLength)) < 0) {
-        fprintf(stderr, "accept() failed");
+        perror("accept() failed");
+        return false;
     }
 
-    printf("Accepted!\n");
-
-    return link;
+    ccnxTestrigLog_Info("Accepted!");
+    return true;
 }
 
 static CCNxTestrigLink *
@@ -276,6 +806,8 @@ _create_udp_link(char *address, int port)
     link->targetAddressLength = sizeof(link->targetAddress);
     link->receiveFunction = _udp_receive;
     link->sendFunction = _udp_send;
+    link->receiveBatchFunction = _udp_receive_batch;
+    link->sendBatchFunction = _udp_send_batch;
 
     if ((link->socket = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
         fprintf(stderr, "socket() failed");
@@ -286,6 +818,15 @@ _create_udp_link(char *address, int port)
     link->targetAddress.sin_addr.s_addr = inet_addr(address);
     link->targetAddress.sin_port = htons(link->port);
 
+    // Bind an ephemeral port now rather than on the first send, so that a peer can be pointed at it.
+    memset(&(link->sourceAddress), 0, sizeof(link->sourceAddress));
+    link->sourceAddress.sin_family = AF_INET;
+    link->sourceAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+    link->sourceAddress.sin_port = 0;
+    if (bind(link->socket, (struct sockaddr *) &(link->sourceAddress), sizeof(link->sourceAddress)) < 0) {
+        fprintf(stderr, "bind() failed");
+    }
+
     return link;
 }
 
@@ -299,6 +840,8 @@ _create_tcp_link(char *address, int port)
     link->targetAddressLength = sizeof(link->targetAddress);
     link->receiveFunction = _tcp_receive;
     link->sendFunction = _tcp_send;
+    link->receiveBatchFunction = _tcp_receive_batch;
+    link->sendBatchFunction = _tcp_send_batch;
 
     if ((link->socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP)) < 0) {
         fprintf(stderr, "socket() failed");
@@ -322,20 +865,131 @@ _create_tcp_link(char *address, int port)
     return link;
 }
 
+/**
+ * Move a UDP link onto io_uring. The socket stays as it is, only the calls that move packets change.
+ */
+static CCNxTestrigLink *
+_convert_to_uring_link(CCNxTestrigLink *link)
+{
+    if (link == NULL) {
+        return NULL;
+    }
+    if (link->type != CCNxTestrigLinkType_UDP) {
+        fprintf(stderr, "Error: only UDP links can move onto io_uring, not the link on port %d\n", link->port);
+        close(link->socket);
+        ccnxTestrigLink_Release(&link);
+        return NULL;
+    }
+
+    link->ring = ccnxTestrigURing_Create(link->socket, MTU);
+    if (link->ring == NULL) {
+        fprintf(stderr, "Error: io_uring is not available for the link on port %d\n", link->port);
+        close(link->socket);
+        ccnxTestrigLink_Release(&link);
+        return NULL;
+    }
+
+    link->type = CCNxTestrigLinkType_URing;
+    link->receiveFunction = _uring_receive;
+    link->sendFunction = _uring_send;
+    link->receiveBatchFunction = _uring_receive_batch;
+    link->sendBatchFunction = _uring_send_batch;
+    return link;
+}
+
 CCNxTestrigLink *
-ccnxTestrigLink_Listen(CCNxTestrigLinkType type, char *address, int port)
+ccnxTestrigLink_Bind(CCNxTestrigLinkType type, char *address, int port)
 {
     switch (type) {
         case CCNxTestrigLinkType_UDP:
             return _create_udp_ccnxTestrigLink_listener(address, port);
         case CCNxTestrigLinkType_TCP:
             return _create_tcp_ccnxTestrigLink_listener(address, port);
+        case CCNxTestrigLinkType_URing:
+            return _convert_to_uring_link(_create_udp_ccnxTestrigLink_listener(address, port));
         default:
             fprintf(stderr, "Error: invalid LinkType specified: %d", type);
             return NULL;
     }
 }
 
+CCNxTestrigLink *
+ccnxTestrigLink_Listen(CCNxTestrigLinkType type, char *address, int port)
+{
+    CCNxTestrigLink *link = ccnxTestrigLink_Bind(type, address, port);
+    if (link != NULL) {
+        ccnxTestrigLink_AcceptAll(&link, 1, -1);
+    }
+    return link;
+}
+
+bool
+ccnxTestrigLink_AcceptAll(CCNxTestrigLink **links, size_t numberOfLinks, int timeout)
+{
+    uint64_t deadline = timeout < 0 ? 0 : _link_Now() + (uint64_t) timeout * 1000000ULL;
+    struct pollfd *fds = calloc(numberOfLinks, sizeof(struct pollfd));
+    CCNxTestrigLink **waiting = calloc(numberOfLinks, sizeof(CCNxTestrigLink *));
+    bool accepted = false;
+
+    for (;;) {
+        size_t numberWaiting = 0;
+        for (size_t i = 0; i < numberOfLinks; i++) {
+            if (links[i]->type == CCNxTestrigLinkType_TCP && !ccnxTestrigLink_IsConnected(links[i])) {
+                fds[numberWaiting].fd = links[i]->socket;
+                fds[numberWaiting].events = POLLIN;
+                waiting[numberWaiting++] = links[i];
+            }
+        }
+        if (numberWaiting == 0) {
+            accepted = true;
+            break;
+        }
+
+        int remaining = -1;
+        if (timeout >= 0) {
+            uint64_t now = _link_Now();
+            if (now >= deadline) {
+                break;
+            }
+            remaining = (int) ((deadline - now + 999999) / 1000000);
+        }
+
+        int res = poll(fds, numberWaiting, remaining);
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("An error occurred while accepting");
+            break;
+        }
+
+        bool failed = false;
+        for (size_t i = 0; i < numberWaiting && !failed; i++) {
+            if (fds[i].revents & POLLIN) {
+                failed = !_tcp_accept(waiting[i]);
+            } else if (fds[i].revents != 0) {
+                failed = true;
+            }
+        }
+        if (failed) {
+            break;
+        }
+    }
+
+    free(waiting);
+    free(fds);
+    return accepted;
+}
+
+bool
+ccnxTestrigLink_IsConnected(const CCNxTestrigLink *link)
+{
+    if (link->type == CCNxTestrigLinkType_TCP) {
+        return link->targetSocket >= 0;
+    }
+    return link->targetAddress.sin_family == AF_INET;
+}
+
 CCNxTestrigLink *
 ccnxTestrigLink_Connect(CCNxTestrigLinkType type, char *address, int port)
 {
@@ -344,35 +998,207 @@ ccnxTestrigLink_Connect(CCNxTestrigLinkType type, char *address, int port)
             return _create_udp_link(address, port);
         case CCNxTestrigLinkType_TCP:
             return _create_tcp_link(address, port);
+        case CCNxTestrigLinkType_URing:
+            return _convert_to_uring_link(_create_udp_link(address, port));
         default:
             fprintf(stderr, "Error: invalid LinkType specified: %d", type);
             return NULL;
     }
 }
 
+static void
+_ccnxTestrigLink_Capture(CCNxTestrigLink *link, CCNxTestrigCaptureDirection direction, PARCBuffer **buffers, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        ccnxTestrigCapture_Record(link->capture, link->captureInterface, direction, buffers[i]);
+    }
+}
+
 PARCBuffer *
 ccnxTestrigLink_Receive(CCNxTestrigLink *link)
 {
-    return link->receiveFunction(link, -1);
+    return ccnxTestrigLink_ReceiveWithTimeout(link, -1);
 }
 
 PARCBuffer *
 ccnxTestrigLink_ReceiveWithTimeout(CCNxTestrigLink *link, int timeout)
 {
-    return link->receiveFunction(link, timeout);
+    PARCBuffer *buffer = link->receiveFunction(link, timeout);
+    if (buffer != NULL) {
+        ccnxTestrigLog_Debug("Link on port %d received %zu bytes", link->port, parcBuffer_Remaining(buffer));
+    }
+    if (link->capture != NULL && buffer != NULL) {
+        _ccnxTestrigLink_Capture(link, CCNxTestrigCaptureDirection_Inbound, &buffer, 1);
+    }
+    return buffer;
+}
+
+int
+ccnxTestrigLink_GetDescriptor(const CCNxTestrigLink *link)
+{
+    if (link->ring != NULL) {
+        return ccnxTestrigURing_GetDescriptor(link->ring);
+    }
+    return link->type == CCNxTestrigLinkType_TCP ? link->targetSocket : link->socket;
+}
+
+bool
+ccnxTestrigLink_IsClosed(const CCNxTestrigLink *link)
+{
+    return link->closed;
 }
 
 int
 ccnxTestrigLink_Send(CCNxTestrigLink *link, PARCBuffer *buffer)
 {
-    return link->sendFunction(link, buffer);
+    // The tests that run concurrently share the links.
+    pthread_mutex_lock(&link->sendLock);
+    int result = link->sendFunction(link, buffer);
+    if (link->capture != NULL && result >= 0) {
+        _ccnxTestrigLink_Capture(link, CCNxTestrigCaptureDirection_Outbound, &buffer, 1);
+    }
+    pthread_mutex_unlock(&link->sendLock);
+    ccnxTestrigLog_Debug("Link on port %d sent %d bytes", link->port, result);
+    return result;
+}
+
+size_t
+ccnxTestrigLink_SendBatch(CCNxTestrigLink *link, PARCBuffer **buffers, size_t count)
+{
+    pthread_mutex_lock(&link->sendLock);
+    size_t sent = link->sendBatchFunction(link, buffers, count);
+    if (link->capture != NULL) {
+        _ccnxTestrigLink_Capture(link, CCNxTestrigCaptureDirection_Outbound, buffers, sent);
+    }
+    pthread_mutex_unlock(&link->sendLock);
+    return sent;
+}
+
+size_t
+ccnxTestrigLink_ReceiveBatch(CCNxTestrigLink *link, PARCBuffer **buffers, uint64_t *receiveTimes, size_t count, int timeout)
+{
+    size_t received = link->receiveBatchFunction(link, buffers, receiveTimes, count, timeout);
+    if (link->capture != NULL) {
+        _ccnxTestrigLink_Capture(link, CCNxTestrigCaptureDirection_Inbound, buffers, received);
+    }
+    return received;
+}
+
+void
+ccnxTestrigLink_SetCapture(CCNxTestrigLink *link, CCNxTestrigCapture *capture, unsigned interface)
+{
+    if (link->capture != NULL) {
+        ccnxTestrigCapture_Release(&link->capture);
+    }
+    link->capture = capture == NULL ? NULL : ccnxTestrigCapture_Acquire(capture);
+    link->captureInterface = interface;
+}
+
+void
+ccnxTestrigLink_SetBatchSize(CCNxTestrigLink *link, size_t batchSize)
+{
+    if (batchSize < 1) {
+        batchSize = 1;
+    } else if (batchSize > MAX_BATCH_SIZE) {
+        batchSize = MAX_BATCH_SIZE;
+    }
+    link->batchSize = batchSize;
+}
+
+const CCNxTestrigLinkStatistics *
+ccnxTestrigLink_GetStatistics(const CCNxTestrigLink *link)
+{
+    return &link->statistics;
+}
+
+bool
+ccnxTestrigLink_HasPendingPacket(const CCNxTestrigLink *link)
+{
+    if (link->ring != NULL) {
+        return ccnxTestrigURing_HasPendingDatagram(link->ring);
+    }
+
+    size_t available = link->streamEnd - link->streamStart;
+    if (available < FIXED_HEADER_LENGTH) {
+        return false;
+    }
+    // A malformed length is reported true as well, so that the next receive discards it.
+    size_t packetLength = ((size_t) link->stream[link->streamStart + 2] << 8) | link->stream[link->streamStart + 3];
+    return available >= packetLength;
+}
+
+void
+ccnxTestrigLink_SetPeer(CCNxTestrigLink *link, const CCNxTestrigLink *peer)
+{
+    if (link->type == CCNxTestrigLinkType_TCP || peer->type == CCNxTestrigLinkType_TCP) {
+        return;
+    }
+
+    struct sockaddr_in address;
+    socklen_t addressLength = sizeof(address);
+    if (getsockname(peer->socket, (struct sockaddr *) &address, &addressLength) < 0) {
+        perror("getsockname() failed");
+        return;
+    }
+    if (address.sin_addr.s_addr == htonl(INADDR_ANY)) {
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    }
+
+    _link_SetTarget(link, &address, addressLength);
+}
+
+const CCNxTestrigBufferPool *
+ccnxTestrigLink_GetReceivePool(const CCNxTestrigLink *link)
+{
+    return link->receivePool;
+}
+
+bool
+ccnxTestrigLink_SetKernelTimestamps(CCNxTestrigLink *link, bool enabled)
+{
+    // An accepted TCP socket only inherits the option if the listener had it before the accept, so set both.
+    int on = enabled ? 1 : 0;
+    bool result = setsockopt(link->socket, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) == 0;
+    if (link->targetSocket >= 0 && link->targetSocket != link->socket) {
+        result = setsockopt(link->targetSocket, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) == 0 && result;
+    }
+    if (!result) {
+        perror("setsockopt(SO_TIMESTAMPNS) failed");
+    }
+    link->kernelTimestamps = enabled && result;
+    return result;
+}
+
+uint64_t
+ccnxTestrigLink_GetTime(const CCNxTestrigLink *link)
+{
+    return _link_Time(link);
+}
+
+uint64_t
+ccnxTestrigLink_GetReceiveTime(const CCNxTestrigLink *link)
+{
+    return link->receiveTime;
+}
+
+bool
+ccnxTestrigLink_SetSubmissionPolling(CCNxTestrigLink *link, bool enabled)
+{
+    if (link->ring == NULL) {
+        return false;
+    }
+    return ccnxTestrigURing_SetSubmissionPolling(link->ring, enabled);
 }
 
 void
 ccnxTestrigLink_Close(CCNxTestrigLink *link)
 {
+    // The rings hold the socket as a registered file, so it is only closed once they are gone.
+    if (link->ring != NULL) {
+        ccnxTestrigURing_Release(&link->ring);
+    }
     close(link->socket);
-    if (link->socket != link->targetSocket) {
+    if (link->targetSocket >= 0 && link->socket != link->targetSocket) {
         close(link->targetSocket);
     }
 }
@@ -59,22 +59,45 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <sys/types.h>
 
 #include <parc/algol/parc_Buffer.h>
 
+#include "ccnxTestrig_BufferPool.h"
+#include "ccnxTestrig_Capture.h"
+
 struct ccnx_testrig_link;
 typedef struct ccnx_testrig_link CCNxTestrigLink;
 
 /**
  * The set of available link types.
+ *
+ * `CCNxTestrigLinkType_URing` links are UDP links that move their packets through io_uring:
+ * datagrams are received by a multishot receive into buffers registered with the kernel,
+ * and sends are submitted in batches, so far fewer system calls are made per packet.
  */
 typedef enum {
     CCNxTestrigLinkType_UDP = 0,
     CCNxTestrigLinkType_TCP = 1,
+    CCNxTestrigLinkType_URing = 2,
     CCNxTestrigLinkType_Invalid = 3
 } CCNxTestrigLinkType;
 
+/**
+ * Counters of the packets moved by a link and of the system calls that moved them.
+ *
+ * Dividing the packet counts by the call counts gives the number of packets per
+ * system call, which shows whether batching is effective.
+ */
+typedef struct {
+    uint64_t packetsSent;
+    uint64_t sendCalls;
+    uint64_t packetsReceived;
+    uint64_t receiveCalls;
+} CCNxTestrigLinkStatistics;
+
 /**
  * Increase the number of references to a `CCNxTestrigLink` instance.
  *
@@ -144,6 +167,75 @@ void ccnxTestrigLink_Release(CCNxTestrigLink **linkPtr);
  */
 CCNxTestrigLink *ccnxTestrigLink_Listen(CCNxTestrigLinkType type, char *address, int port);
 
+/**
+ * Create a new link listening at the specified address and port, without waiting for the peer.
+ *
+ * A UDP link is ready to receive at once. A TCP link is bound and listening, and becomes
+ * usable once `ccnxTestrigLink_AcceptAll` has accepted its peer's connection.
+ *
+ * @param [in] type The type of link.
+ * @param [in] address The address of the link.
+ * @param [in] port The port of the link.
+ *
+ * @return A newly allocated `CCNxTestrigLink` that must be freed by `ccnxTestrigLink_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigLink *link = ccnxTestrigLink_Bind(CCNxTestrigLinkType_TCP, "localhost", 9696);
+ *     ccnxTestrigLink_AcceptAll(&link, 1, 5000);
+ *
+ *     ccnxTestrigLink_Release(&link);
+ * }
+ * @endcode
+ */
+CCNxTestrigLink *ccnxTestrigLink_Bind(CCNxTestrigLinkType type, char *address, int port);
+
+/**
+ * Accept the connections of the peers of the given links, in whatever order the peers connect.
+ *
+ * Links that are already connected, and UDP links, are skipped.
+ *
+ * @param [in] links The links created by `ccnxTestrigLink_Bind`.
+ * @param [in] numberOfLinks The number of links.
+ * @param [in] timeout The number of milliseconds to wait for all of the peers, or -1 to wait forever.
+ *
+ * @retval true if every link is connected.
+ * @retval false if a peer did not connect before the timeout.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigLink *links[] = { linkA, linkB, linkC };
+ *     if (!ccnxTestrigLink_AcceptAll(links, 3, 10000)) {
+ *         fprintf(stderr, "The forwarder did not connect\n");
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxTestrigLink_AcceptAll(CCNxTestrigLink **links, size_t numberOfLinks, int timeout);
+
+/**
+ * Determine whether a link can send to its peer.
+ *
+ * A TCP listener is connected once its peer's connection has been accepted. A UDP listener
+ * is connected once it has received a packet, or been given its peer by `ccnxTestrigLink_SetPeer`.
+ *
+ * @param [in] link A `CCNxTestrigLink` instance.
+ *
+ * @return true if the link knows its peer.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (!ccnxTestrigLink_IsConnected(link)) {
+ *         printf("Waiting for the forwarder\n");
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxTestrigLink_IsConnected(const CCNxTestrigLink *link);
+
 /**
  * Create a new link by connecting to another entity at the address and port given.
  * The `type` parameter determines the link protocol to be used.
@@ -211,6 +303,51 @@ PARCBuffer *ccnxTestrigLink_Receive(CCNxTestrigLink *link);
  */
 PARCBuffer *ccnxTestrigLink_ReceiveWithTimeout(CCNxTestrigLink *link, int timeout);
 
+/**
+ * Retrieve the file descriptor from which packets on the specified `CCNxTestrigLink` are read.
+ *
+ * The descriptor can be used to wait for packets on several links at once. It remains
+ * owned by the link and must not be closed by the caller.
+ *
+ * @param [in] link A `CCNxTestrigLink` instance.
+ *
+ * @return The descriptor that becomes readable when a packet is available on the link.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigLink *link = ccnxTestrigLink_Connect(CCNxTestrigLinkType_UDP, "localhost", 9696);
+ *
+ *     struct pollfd fd = { .fd = ccnxTestrigLink_GetDescriptor(link), .events = POLLIN };
+ *
+ *     ccnxTestrigLink_Release(&link);
+ * }
+ * @endcode
+ */
+int ccnxTestrigLink_GetDescriptor(const CCNxTestrigLink *link);
+
+/**
+ * Determine if the connection of the specified `CCNxTestrigLink` was closed by its peer or failed.
+ *
+ * The socket of a closed TCP link stays readable, so callers that wait on its descriptor
+ * must stop doing so once a receive returns nothing and this is true.
+ *
+ * @param [in] link A `CCNxTestrigLink` instance.
+ *
+ * @return true if no more packets will be received on the link.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *packet = ccnxTestrigLink_ReceiveWithTimeout(link, 0);
+ *     if (packet == NULL && ccnxTestrigLink_IsClosed(link)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxTestrigLink_IsClosed(const CCNxTestrigLink *link);
+
 /**
  * Send a packet on the specified `CCNxTestrigLink`.
  *
@@ -233,6 +370,265 @@ PARCBuffer *ccnxTestrigLink_ReceiveWithTimeout(CCNxTestrigLink *link, int timeou
  */
 int ccnxTestrigLink_Send(CCNxTestrigLink *link, PARCBuffer *buffer);
 
+/**
+ * Send several packets on the specified `CCNxTestrigLink` with as few system calls as possible.
+ *
+ * UDP links hand up to the configured batch size of packets to the kernel per call.
+ *
+ * @param [in] link The link on which to send the packets.
+ * @param [in] buffers The wire-encoded packets to send.
+ * @param [in] count The number of packets in @p buffers.
+ *
+ * @return The number of packets sent, which is less than @p count if an error occurred.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigLink *link = ccnxTestrigLink_Connect(CCNxTestrigLinkType_UDP, "localhost", 9696);
+ *     PARCBuffer *packets[16] = ...
+ *
+ *     size_t sent = ccnxTestrigLink_SendBatch(link, packets, 16);
+ *
+ *     ccnxTestrigLink_Release(&link);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigLink_SendBatch(CCNxTestrigLink *link, PARCBuffer **buffers, size_t count);
+
+/**
+ * Receive several packets from the specified `CCNxTestrigLink` with as few system calls as possible.
+ *
+ * The call waits up to @p timeout milliseconds for the first packet, and then returns the
+ * packets that are pending on the link without waiting any further.
+ *
+ * The receive time of each packet is stored in @p receiveTimes, on the clock of
+ * `ccnxTestrigLink_GetTime`. With kernel timestamps, every packet of the batch carries the
+ * time the kernel received it. `ccnxTestrigLink_GetReceiveTime` returns that of the last packet.
+ *
+ * @param [in] link The link from which to receive the packets.
+ * @param [out] buffers Filled with the `PARCBuffer` packets read from the link.
+ * @param [out] receiveTimes Filled with the receive time of each packet, or NULL.
+ * @param [in] count The capacity of @p buffers.
+ * @param [in] timeout The number of milliseconds to wait for the first packet.
+ *
+ * @return The number of packets stored in @p buffers, each of which must be released.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigLink *link = ccnxTestrigLink_Connect(CCNxTestrigLinkType_UDP, "localhost", 9696);
+ *     PARCBuffer *packets[16];
+ *     uint64_t receiveTimes[16];
+ *
+ *     size_t received = ccnxTestrigLink_ReceiveBatch(link, packets, receiveTimes, 16, 1000);
+ *
+ *     ccnxTestrigLink_Release(&link);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigLink_ReceiveBatch(CCNxTestrigLink *link, PARCBuffer **buffers, uint64_t *receiveTimes, size_t count, int timeout);
+
+/**
+ * Set the maximum number of packets handed to the kernel in a single system call.
+ *
+ * @param [in] link A `CCNxTestrigLink` instance.
+ * @param [in] batchSize The number of packets per call, between 1 and 1024.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigLink *link = ccnxTestrigLink_Connect(CCNxTestrigLinkType_UDP, "localhost", 9696);
+ *     ccnxTestrigLink_SetBatchSize(link, 64);
+ * }
+ * @endcode
+ */
+void ccnxTestrigLink_SetBatchSize(CCNxTestrigLink *link, size_t batchSize);
+
+/**
+ * Record every packet sent or received on the specified `CCNxTestrigLink` in a capture.
+ *
+ * Packets are recorded by `ccnxTestrigLink_Send`, `ccnxTestrigLink_SendBatch` and the receive functions,
+ * after the system call has completed, so that capturing does not delay the packets themselves.
+ *
+ * @param [in] link A `CCNxTestrigLink` instance.
+ * @param [in] capture The capture to record to, or NULL to stop recording.
+ * @param [in] interface The capture interface of this link.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigCapture *capture = ccnxTestrigCapture_Create("testrig.pcapng", 1);
+ *     ccnxTestrigLink_SetCapture(link, capture, 0);
+ * }
+ * @endcode
+ */
+void ccnxTestrigLink_SetCapture(CCNxTestrigLink *link, CCNxTestrigCapture *capture, unsigned interface);
+
+/**
+ * Direct the packets sent on a UDP `CCNxTestrigLink` to the local socket of another link in the same process.
+ *
+ * A listening UDP link learns its peer from the first packet it receives. This lets it send first,
+ * which an in-process forwarder needs. It has no effect on TCP links.
+ *
+ * @param [in] link The `CCNxTestrigLink` whose peer is set.
+ * @param [in] peer The `CCNxTestrigLink` that should receive the packets sent on @p link.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigLink *link = ccnxTestrigLink_Listen(CCNxTestrigLinkType_UDP, "127.0.0.1", 9696);
+ *     CCNxTestrigLink *face = ccnxTestrigLink_Connect(CCNxTestrigLinkType_UDP, "127.0.0.1", 9696);
+ *     ccnxTestrigLink_SetPeer(link, face);
+ * }
+ * @endcode
+ */
+void ccnxTestrigLink_SetPeer(CCNxTestrigLink *link, const CCNxTestrigLink *peer);
+
+/**
+ * Retrieve the packet and system call counters of the specified `CCNxTestrigLink`.
+ *
+ * @param [in] link A `CCNxTestrigLink` instance.
+ *
+ * @return The statistics of the link, which remain owned by the link.
+ *
+ * Example:
+ * @code
+ * {
+ *     const CCNxTestrigLinkStatistics *stats = ccnxTestrigLink_GetStatistics(link);
+ *     double packetsPerCall = (double) stats->packetsSent / stats->sendCalls;
+ * }
+ * @endcode
+ */
+const CCNxTestrigLinkStatistics *ccnxTestrigLink_GetStatistics(const CCNxTestrigLink *link);
+
+/**
+ * Determine if the specified `CCNxTestrigLink` has already read a complete packet that has not been received.
+ *
+ * A TCP link reads whatever the stream holds and reassembles packets from it using the
+ * length in each packet's fixed header, so packets can be waiting in the link even though
+ * its socket is no longer readable. Callers that wait on the descriptor of a link must
+ * check this first.
+ *
+ * @param [in] link A `CCNxTestrigLink` instance.
+ *
+ * @return true if the next receive will return a packet without reading the socket.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (ccnxTestrigLink_HasPendingPacket(link)) {
+ *         PARCBuffer *packet = ccnxTestrigLink_ReceiveWithTimeout(link, 0);
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxTestrigLink_HasPendingPacket(const CCNxTestrigLink *link);
+
+/**
+ * Retrieve the pool that the specified `CCNxTestrigLink` receives packets into.
+ *
+ * Received packets are read directly into pool buffers, which return to the pool when
+ * released. The pool's high-water mark shows how many packets were held at once.
+ *
+ * @param [in] link A `CCNxTestrigLink` instance.
+ *
+ * @return The receive pool of the link, which remains owned by the link.
+ *
+ * Example:
+ * @code
+ * {
+ *     const CCNxTestrigBufferPool *pool = ccnxTestrigLink_GetReceivePool(link);
+ *     size_t highWaterMark = ccnxTestrigBufferPool_GetHighWaterMark(pool);
+ * }
+ * @endcode
+ */
+const CCNxTestrigBufferPool *ccnxTestrigLink_GetReceivePool(const CCNxTestrigLink *link);
+
+/**
+ * Have the kernel stamp every packet the link receives with its arrival time.
+ *
+ * Without kernel timestamps, a packet is stamped when the receive call that read it returns,
+ * which adds the wakeup of the rig to every latency. With them, packets carry the time the
+ * kernel received them, and `ccnxTestrigLink_GetTime` reads the realtime clock the kernel stamps
+ * with instead of the monotonic clock, so send and receive times stay comparable. All links of a
+ * rig should use the same setting. Packets read from a TCP stream carry the timestamp of the read.
+ *
+ * @param [in] link A `CCNxTestrigLink` instance.
+ * @param [in] enabled Whether the kernel stamps received packets.
+ *
+ * @return true if the setting was applied, false if the socket does not support it.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigLink *link = ccnxTestrigLink_Listen(CCNxTestrigLinkType_UDP, "localhost", 9696);
+ *     ccnxTestrigLink_SetKernelTimestamps(link, true);
+ * }
+ * @endcode
+ */
+bool ccnxTestrigLink_SetKernelTimestamps(CCNxTestrigLink *link, bool enabled);
+
+/**
+ * Read the clock that the link stamps received packets with, in nanoseconds.
+ *
+ * Taking the send time of a packet from this clock, right before sending it, makes it comparable
+ * with the receive time of the packet on another link.
+ *
+ * @param [in] link A `CCNxTestrigLink` instance.
+ *
+ * @return The current time of the link's clock.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t sendTime = ccnxTestrigLink_GetTime(link);
+ *     ccnxTestrigLink_Send(link, packet);
+ * }
+ * @endcode
+ */
+uint64_t ccnxTestrigLink_GetTime(const CCNxTestrigLink *link);
+
+/**
+ * Retrieve the receive time of the packet most recently returned by the link.
+ *
+ * After a batch receive, this is the receive time of the last packet of the batch.
+ *
+ * @param [in] link A `CCNxTestrigLink` instance.
+ *
+ * @return The receive time, in nanoseconds of the clock read by `ccnxTestrigLink_GetTime`.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *packet = ccnxTestrigLink_Receive(link);
+ *     uint64_t latency = ccnxTestrigLink_GetReceiveTime(link) - sendTime;
+ * }
+ * @endcode
+ */
+uint64_t ccnxTestrigLink_GetReceiveTime(const CCNxTestrigLink *link);
+
+/**
+ * Have a kernel thread poll for the sends of an io_uring link, so that sending makes no system calls.
+ *
+ * The thread sleeps after a short idle period, and the next send wakes it with a system call.
+ * No other thread may send on the link while polling is changed.
+ *
+ * @param [in] link A `CCNxTestrigLink` of type `CCNxTestrigLinkType_URing`.
+ * @param [in] enabled Whether the sends are polled.
+ *
+ * @retval true if polling was changed as requested.
+ * @retval false if the link does not use io_uring, or polling is not available.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigLink *link = ccnxTestrigLink_Bind(CCNxTestrigLinkType_URing, "localhost", 9696);
+ *     ccnxTestrigLink_SetSubmissionPolling(link, true);
+ * }
+ * @endcode
+ */
+bool ccnxTestrigLink_SetSubmissionPolling(CCNxTestrigLink *link, bool enabled);
+
 /**
  * Close the specified `CCNxTestrigLink`.
  *
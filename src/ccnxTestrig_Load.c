@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/common/ccnx_Interest.h>
+
+#include "ccnxTestrig_Load.h"
+#include "ccnxTestrig_PacketUtility.h"
+#include "ccnxTestrig_PacketTemplate.h"
+#include "ccnxTestrig_Responder.h"
+
+#define LOAD_PREFIX "ccnx:/test/b"
+#define LOAD_INTEREST_LIFETIME 4000
+
+// The number of hex characters that make the name of each Interest unique.
+#define LOAD_SUFFIX_LENGTH 16
+
+// The number of packets handed to a link at once.
+#define LOAD_BATCH_SIZE 32
+
+// The number of milliseconds without forwarded Interests after which a finished run stops counting.
+#define LOAD_RECEIVE_INTERVAL 100
+
+#define NSEC_PER_SEC 1000000000ULL
+
+typedef struct {
+    CCNxTestrigLink *link;
+    CCNxTestrigPacketTemplate *template;
+    CCNxTestrigNameGenerator *names;
+    unsigned rate;
+    uint64_t start;
+    uint64_t end;
+
+    // Written by the sending thread and read by the reporting thread.
+    uint64_t packetsSent;
+    uint64_t bytesSent;
+} _CCNxTestrigLoadSender;
+
+typedef struct {
+    uint64_t time;
+    uint64_t packetsSent;
+    uint64_t bytesSent;
+    uint64_t packetsForwarded;
+    uint64_t packetsSatisfied;
+} _CCNxTestrigLoadSample;
+
+static uint64_t
+_ccnxTestrigLoad_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+}
+
+/**
+ * Encode the Interest that every load packet is patched from. Its last name segment is replaced
+ * by a unique suffix for each packet, otherwise the forwarder aggregates the Interests in its PIT.
+ */
+static CCNxTestrigPacketTemplate *
+_ccnxTestrigLoad_CreateTemplate(CCNxTestrigNameGenerator *names)
+{
+    char placeholder[LOAD_SUFFIX_LENGTH + 1];
+    memset(placeholder, '0', LOAD_SUFFIX_LENGTH);
+    placeholder[LOAD_SUFFIX_LENGTH] = '\0';
+
+    CCNxName *prefix = ccnxTestrigNameGenerator_CreateName(names, LOAD_PREFIX);
+    CCNxName *name = ccnxName_ComposeNAME(prefix, placeholder);
+    CCNxInterest *interest = ccnxInterest_Create(name, LOAD_INTEREST_LIFETIME, NULL, NULL);
+
+    CCNxTestrigPacketTemplate *template = ccnxTestrigPacketTemplate_Create("load", interest);
+
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    ccnxName_Release(&prefix);
+
+    return template;
+}
+
+static void
+_ccnxTestrigLoadSender_Release(_CCNxTestrigLoadSender *sender)
+{
+    if (sender->template != NULL) {
+        ccnxTestrigPacketTemplate_Release(&sender->template);
+    }
+    ccnxTestrigNameGenerator_Release(&sender->names);
+}
+
+static PARCBuffer *
+_ccnxTestrigLoad_CreateInterest(_CCNxTestrigLoadSender *sender)
+{
+    char suffix[LOAD_SUFFIX_LENGTH];
+    ccnxTestrigNameGenerator_NextSuffix(sender->names, suffix, LOAD_SUFFIX_LENGTH);
+    return ccnxTestrigPacketTemplate_Instantiate(sender->template, (const uint8_t *) suffix);
+}
+
+static void *
+_ccnxTestrigLoad_Send(void *arg)
+{
+    _CCNxTestrigLoadSender *sender = arg;
+    uint64_t interval = sender->rate > 0 ? NSEC_PER_SEC / sender->rate : 0;
+
+    PARCBuffer *batch[LOAD_BATCH_SIZE];
+    uint64_t sequence = 0;
+
+    for (uint64_t now = _ccnxTestrigLoad_Now(); now < sender->end; now = _ccnxTestrigLoad_Now()) {
+        size_t count = LOAD_BATCH_SIZE;
+
+        if (interval > 0) {
+            // Send everything that is due, so a late wakeup catches up instead of lowering the rate.
+            uint64_t due = (now - sender->start) / interval + 1;
+            if (due <= sequence) {
+                uint64_t next = sender->start + sequence * interval;
+                struct timespec wakeup = { .tv_sec = next / NSEC_PER_SEC, .tv_nsec = next % NSEC_PER_SEC };
+                clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL);
+                continue;
+            }
+            if (due - sequence < count) {
+                count = due - sequence;
+            }
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            batch[i] = _ccnxTestrigLoad_CreateInterest(sender);
+        }
+
+        size_t sent = ccnxTestrigLink_SendBatch(sender->link, batch, count);
+
+        uint64_t bytes = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (i < sent) {
+                bytes += parcBuffer_Remaining(batch[i]);
+            }
+            parcBuffer_Release(&batch[i]);
+        }
+
+        // Packets the link refused still use up their slot in the schedule; they show up as loss.
+        sequence += count;
+        __atomic_add_fetch(&sender->packetsSent, count, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&sender->bytesSent, bytes, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+static _CCNxTestrigLoadSample
+_ccnxTestrigLoad_Sample(_CCNxTestrigLoadSender *sender, const CCNxTestrigResponder *responder, uint64_t packetsReceived)
+{
+    _CCNxTestrigLoadSample sample;
+    sample.time = _ccnxTestrigLoad_Now();
+    sample.packetsSent = __atomic_load_n(&sender->packetsSent, __ATOMIC_RELAXED);
+    sample.bytesSent = __atomic_load_n(&sender->bytesSent, __ATOMIC_RELAXED);
+
+    // With a responder, the producer link belongs to it and the consumer link carries the answers.
+    if (responder != NULL) {
+        sample.packetsForwarded = ccnxTestrigResponder_GetInterestCount(responder);
+        sample.packetsSatisfied = packetsReceived;
+    } else {
+        sample.packetsForwarded = packetsReceived;
+        sample.packetsSatisfied = 0;
+    }
+    return sample;
+}
+
+static void
+_ccnxTestrigLoad_Report(CCNxTestrigReporter *reporter, const char *label, bool responding,
+                        const _CCNxTestrigLoadSample *from, const _CCNxTestrigLoadSample *to)
+{
+    double seconds = (double) (to->time - from->time) / NSEC_PER_SEC;
+    uint64_t sent = to->packetsSent - from->packetsSent;
+    uint64_t forwarded = to->packetsForwarded - from->packetsForwarded;
+    uint64_t satisfied = to->packetsSatisfied - from->packetsSatisfied;
+
+    // Interests in flight at the end of an interval are counted in the next one, so clamp at zero.
+    double loss = (sent > forwarded) ? 100.0 * (sent - forwarded) / sent : 0.0;
+
+    char *message = NULL;
+    asprintf(&message, "%s sent %.0f pps (%.2f Mbps), forwarded %.0f pps, loss %.2f%%",
+             label,
+             sent / seconds,
+             (to->bytesSent - from->bytesSent) * 8 / seconds / 1000000,
+             forwarded / seconds,
+             loss);
+    if (responding) {
+        char *extended = NULL;
+        asprintf(&extended, "%s, satisfied %.0f pps", message, satisfied / seconds);
+        free(message);
+        message = extended;
+    }
+    ccnxTestrigReporter_Report(reporter, message);
+    free(message);
+}
+
+/**
+ * Report the packets a link moved during the run and the system calls it took, which tells the link types apart.
+ */
+static void
+_ccnxTestrigLoad_ReportLink(CCNxTestrigReporter *reporter, CCNxTestrigLinkID linkID, const CCNxTestrigLink *link,
+                            const CCNxTestrigLinkStatistics *from)
+{
+    const CCNxTestrigLinkStatistics *to = ccnxTestrigLink_GetStatistics(link);
+    uint64_t sent = to->packetsSent - from->packetsSent;
+    uint64_t sendCalls = to->sendCalls - from->sendCalls;
+    uint64_t received = to->packetsReceived - from->packetsReceived;
+    uint64_t receiveCalls = to->receiveCalls - from->receiveCalls;
+
+    char name[CCNX_TESTRIG_LINK_NAME_LENGTH];
+    char *message = NULL;
+    asprintf(&message, "Link %s: sent %" PRIu64 " packets in %" PRIu64 " calls (%.2f per call), received %" PRIu64 " packets in %" PRIu64 " calls (%.2f per call)",
+             ccnxTestrig_FormatLinkName(linkID, name),
+             sent, sendCalls, sendCalls > 0 ? (double) sent / sendCalls : 0.0,
+             received, receiveCalls, receiveCalls > 0 ? (double) received / receiveCalls : 0.0);
+    ccnxTestrigReporter_Report(reporter, message);
+    free(message);
+}
+
+void
+ccnxTestrigLoad_Run(CCNxTestrig *rig, CCNxTestrigLinkID consumerLink, CCNxTestrigLinkID producerLink, unsigned rate, unsigned duration,
+                    CCNxTestrigResponder *responder)
+{
+    CCNxTestrigReporter *reporter = ccnxTestrig_GetReporter(rig);
+    CCNxTestrigLink *counted = ccnxTestrig_GetLinkByID(rig, responder != NULL ? consumerLink : producerLink);
+
+    _CCNxTestrigLoadSender sender;
+    sender.link = ccnxTestrig_GetLinkByID(rig, consumerLink);
+    sender.names = ccnxTestrig_CreateNameGenerator(rig);
+    sender.template = _ccnxTestrigLoad_CreateTemplate(sender.names);
+    sender.rate = rate;
+    sender.start = _ccnxTestrigLoad_Now();
+    sender.end = sender.start + duration * NSEC_PER_SEC;
+    sender.packetsSent = 0;
+    sender.bytesSent = 0;
+
+    CCNxTestrigLink *producer = ccnxTestrig_GetLinkByID(rig, producerLink);
+    CCNxTestrigLinkStatistics consumerStatistics = *ccnxTestrigLink_GetStatistics(sender.link);
+    CCNxTestrigLinkStatistics producerStatistics = *ccnxTestrigLink_GetStatistics(producer);
+
+    if (sender.template == NULL || (responder != NULL && !ccnxTestrigResponder_Start(responder))) {
+        _ccnxTestrigLoadSender_Release(&sender);
+        return;
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, _ccnxTestrigLoad_Send, &sender) != 0) {
+        perror("Unable to start the load generator");
+        if (responder != NULL) {
+            ccnxTestrigResponder_Stop(responder);
+        }
+        _ccnxTestrigLoadSender_Release(&sender);
+        return;
+    }
+
+    uint64_t packetsReceived = 0;
+    _CCNxTestrigLoadSample first = _ccnxTestrigLoad_Sample(&sender, responder, 0);
+    first.time = sender.start;
+    _CCNxTestrigLoadSample previous = first;
+
+    unsigned second = 0;
+    PARCBuffer *received[LOAD_BATCH_SIZE];
+    for (;;) {
+        size_t count = ccnxTestrigLink_ReceiveBatch(counted, received, NULL, LOAD_BATCH_SIZE, LOAD_RECEIVE_INTERVAL);
+        for (size_t i = 0; i < count; i++) {
+            parcBuffer_Release(&received[i]);
+        }
+        packetsReceived += count;
+
+        uint64_t now = _ccnxTestrigLoad_Now();
+        if (now < sender.end && now >= previous.time + NSEC_PER_SEC) {
+            _CCNxTestrigLoadSample sample = _ccnxTestrigLoad_Sample(&sender, responder, packetsReceived);
+            char label[16];
+            snprintf(label, sizeof(label), "[%4us]", ++second);
+            _ccnxTestrigLoad_Report(reporter, label, responder != NULL, &previous, &sample);
+            previous = sample;
+        } else if (now >= sender.end && count == 0) {
+            break;
+        }
+    }
+
+    pthread_join(thread, NULL);
+    if (responder != NULL) {
+        ccnxTestrigResponder_Stop(responder);
+    }
+
+    // The summary covers the whole run, including the Interests that arrived after the last send.
+    _CCNxTestrigLoadSample last = _ccnxTestrigLoad_Sample(&sender, responder, packetsReceived);
+    last.time = sender.end;
+    _ccnxTestrigLoad_Report(reporter, "Total:", responder != NULL, &first, &last);
+    _ccnxTestrigLoad_ReportLink(reporter, consumerLink, sender.link, &consumerStatistics);
+    _ccnxTestrigLoad_ReportLink(reporter, producerLink, producer, &producerStatistics);
+
+    _ccnxTestrigLoadSender_Release(&sender);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_Load_h
+#define ccnxTestrig_Load_h
+
+#include "ccnxTestrig.h"
+#include "ccnxTestrig_Responder.h"
+
+/**
+ * Drive a sustained stream of Interests through the forwarder and report its throughput.
+ *
+ * Interests for unique names under "ccnx:/test/b" are sent on the consumer link, either at
+ * @p rate Interests per second or, if @p rate is zero, as fast as the link accepts them.
+ * The Interests that the forwarder delivers on the producer link are counted, and the sent
+ * and forwarded packets per second, the offered Mbps, and the loss are reported once per
+ * second and summarized at the end of the run.
+ *
+ * If a @p responder is given, it runs on the producer link for the duration of the load and
+ * answers every forwarded Interest. The Interests it receives are counted as forwarded, and
+ * the Content Objects that reach the consumer link are reported as satisfied.
+ *
+ * @param [in] rig The `CCNxTestrig` whose links carry the load.
+ * @param [in] consumerLink The link on which the Interests are sent.
+ * @param [in] producerLink The link on which the forwarded Interests are counted.
+ * @param [in] rate The number of Interests per second, or 0 for open-loop maximum.
+ * @param [in] duration The number of seconds to send for.
+ * @param [in] responder A `CCNxTestrigResponder` for the producer link, or NULL to only count the Interests.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrig *rig = ...
+ *
+ *     // 100k Interests per second from link A, forwarded to link B, for ten seconds.
+ *     ccnxTestrigLoad_Run(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_LinkB, 100000, 10, NULL);
+ * }
+ * @endcode
+ */
+void ccnxTestrigLoad_Run(CCNxTestrig *rig, CCNxTestrigLinkID consumerLink, CCNxTestrigLinkID producerLink, unsigned rate, unsigned duration,
+                         CCNxTestrigResponder *responder);
+#endif // ccnxTestrig_Load_h
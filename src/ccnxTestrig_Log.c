@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "ccnxTestrig_Log.h"
+
+// Each thread buffers this many messages, of up to LOG_MESSAGE_LENGTH - 1 characters each.
+#define LOG_RING_CAPACITY 256
+#define LOG_MESSAGE_LENGTH 240
+
+// How long the writer sleeps when no thread has logged anything.
+#define LOG_IDLE_NANOSECONDS (10 * 1000 * 1000)
+
+typedef struct {
+    char message[LOG_MESSAGE_LENGTH];
+} _CCNxTestrigLogRecord;
+
+/**
+ * The messages of one thread. Only that thread advances tail, and only the writer advances head.
+ */
+typedef struct _ccnx_testrig_log_ring {
+    size_t head;
+    size_t tail;
+    _CCNxTestrigLogRecord records[LOG_RING_CAPACITY];
+
+    // The rings are never freed, so the writer can follow this list without a lock.
+    struct _ccnx_testrig_log_ring *next;
+} _CCNxTestrigLogRing;
+
+CCNxTestrigLogLevel ccnxTestrigLog_CurrentLevel = CCNxTestrigLogLevel_Info;
+
+static FILE *_ccnxTestrigLog_Output = NULL;
+static bool _ccnxTestrigLog_Started = false;
+static bool _ccnxTestrigLog_Running = false;
+static pthread_t _ccnxTestrigLog_Writer;
+
+// The number of threads between checking that the log is started and publishing their message.
+// The last drain waits for it to reach zero, so no message is left behind in a ring.
+static unsigned _ccnxTestrigLog_Writers = 0;
+static uint64_t _ccnxTestrigLog_Dropped = 0;
+
+static _CCNxTestrigLogRing *_ccnxTestrigLog_Rings = NULL;
+static __thread _CCNxTestrigLogRing *_ccnxTestrigLog_ThreadRing = NULL;
+
+static const char *_ccnxTestrigLog_LevelNames[] = { "error", "warning", "info", "debug" };
+
+static FILE *
+_ccnxTestrigLog_GetOutput(void)
+{
+    return _ccnxTestrigLog_Output != NULL ? _ccnxTestrigLog_Output : stderr;
+}
+
+/**
+ * Return the ring of the calling thread, creating and publishing it on the first call.
+ */
+static _CCNxTestrigLogRing *
+_ccnxTestrigLog_GetThreadRing(void)
+{
+    if (_ccnxTestrigLog_ThreadRing == NULL) {
+        _CCNxTestrigLogRing *ring = calloc(1, sizeof(_CCNxTestrigLogRing));
+        if (ring == NULL) {
+            return NULL;
+        }
+
+        ring->next = __atomic_load_n(&_ccnxTestrigLog_Rings, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&_ccnxTestrigLog_Rings, &ring->next, ring, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+        _ccnxTestrigLog_ThreadRing = ring;
+    }
+    return _ccnxTestrigLog_ThreadRing;
+}
+
+/**
+ * Write the buffered messages of every thread.
+ *
+ * @return The number of messages written.
+ */
+static size_t
+_ccnxTestrigLog_Drain(void)
+{
+    FILE *output = _ccnxTestrigLog_GetOutput();
+    size_t count = 0;
+
+    for (_CCNxTestrigLogRing *ring = __atomic_load_n(&_ccnxTestrigLog_Rings, __ATOMIC_ACQUIRE); ring != NULL; ring = ring->next) {
+        size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        for (size_t head = ring->head; head != tail; head++) {
+            fputs(ring->records[head % LOG_RING_CAPACITY].message, output);
+            fputc('\n', output);
+            count++;
+        }
+        __atomic_store_n(&ring->head, tail, __ATOMIC_RELEASE);
+    }
+
+    if (count > 0) {
+        fflush(output);
+    }
+    return count;
+}
+
+static void *
+_ccnxTestrigLog_WriterThread(void *arg)
+{
+    struct timespec idle = { 0, LOG_IDLE_NANOSECONDS };
+
+    while (__atomic_load_n(&_ccnxTestrigLog_Running, __ATOMIC_ACQUIRE)) {
+        if (_ccnxTestrigLog_Drain() == 0) {
+            nanosleep(&idle, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+void
+ccnxTestrigLog_SetLevel(CCNxTestrigLogLevel level)
+{
+    ccnxTestrigLog_CurrentLevel = level;
+}
+
+CCNxTestrigLogLevel
+ccnxTestrigLog_ParseLevel(const char *name)
+{
+    for (CCNxTestrigLogLevel level = CCNxTestrigLogLevel_Error; level < CCNxTestrigLogLevel_Invalid; level++) {
+        if (strcmp(name, _ccnxTestrigLog_LevelNames[level]) == 0) {
+            return level;
+        }
+    }
+    return CCNxTestrigLogLevel_Invalid;
+}
+
+bool
+ccnxTestrigLog_Start(FILE *output)
+{
+    if (_ccnxTestrigLog_Started) {
+        return true;
+    }
+
+    _ccnxTestrigLog_Output = output;
+    _ccnxTestrigLog_Running = true;
+    if (pthread_create(&_ccnxTestrigLog_Writer, NULL, _ccnxTestrigLog_WriterThread, NULL) != 0) {
+        _ccnxTestrigLog_Running = false;
+        fprintf(stderr, "Error: could not start the log writer\n");
+        return false;
+    }
+    __atomic_store_n(&_ccnxTestrigLog_Started, true, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+void
+ccnxTestrigLog_Stop(void)
+{
+    if (!_ccnxTestrigLog_Started) {
+        return;
+    }
+
+    // From here on messages are written as they are logged. Those that saw the log started are
+    // waited for, so that the last drain finds them in their rings.
+    __atomic_store_n(&_ccnxTestrigLog_Started, false, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&_ccnxTestrigLog_Writers, __ATOMIC_SEQ_CST) > 0) {
+        sched_yield();
+    }
+    __atomic_store_n(&_ccnxTestrigLog_Running, false, __ATOMIC_RELEASE);
+    pthread_join(_ccnxTestrigLog_Writer, NULL);
+    _ccnxTestrigLog_Drain();
+
+    uint64_t dropped = ccnxTestrigLog_GetDroppedCount();
+    if (dropped > 0) {
+        fprintf(_ccnxTestrigLog_GetOutput(), "%llu log messages were dropped\n", (unsigned long long) dropped);
+    }
+}
+
+uint64_t
+ccnxTestrigLog_GetDroppedCount(void)
+{
+    return __atomic_load_n(&_ccnxTestrigLog_Dropped, __ATOMIC_RELAXED);
+}
+
+void
+ccnxTestrigLog_Write(CCNxTestrigLogLevel level, const char *format, ...)
+{
+    va_list arguments;
+    va_start(arguments, format);
+
+    // Every message starts with its level, so the output can be filtered by level.
+    const char *levelName = _ccnxTestrigLog_LevelNames[level];
+
+    _CCNxTestrigLogRing *ring = NULL;
+    __atomic_fetch_add(&_ccnxTestrigLog_Writers, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&_ccnxTestrigLog_Started, __ATOMIC_SEQ_CST)) {
+        ring = _ccnxTestrigLog_GetThreadRing();
+    }
+
+    if (ring == NULL) {
+        __atomic_fetch_sub(&_ccnxTestrigLog_Writers, 1, __ATOMIC_SEQ_CST);
+        FILE *output = _ccnxTestrigLog_GetOutput();
+        flockfile(output);
+        fprintf(output, "[%s] ", levelName);
+        vfprintf(output, format, arguments);
+        fputc('\n', output);
+        funlockfile(output);
+    } else {
+        if (ring->tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == LOG_RING_CAPACITY) {
+            __atomic_fetch_add(&_ccnxTestrigLog_Dropped, 1, __ATOMIC_RELAXED);
+        } else {
+            _CCNxTestrigLogRecord *record = &ring->records[ring->tail % LOG_RING_CAPACITY];
+            int prefixLength = snprintf(record->message, LOG_MESSAGE_LENGTH, "[%s] ", levelName);
+            vsnprintf(record->message + prefixLength, LOG_MESSAGE_LENGTH - prefixLength, format, arguments);
+            __atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_RELEASE);
+        }
+        __atomic_fetch_sub(&_ccnxTestrigLog_Writers, 1, __ATOMIC_SEQ_CST);
+    }
+
+    va_end(arguments);
+}
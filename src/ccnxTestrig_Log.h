@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_Log_h
+#define ccnxTestrig_Log_h
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// The levels, as numbers so the preprocessor and the build can name them.
+#define CCNX_TESTRIG_LOG_ERROR 0
+#define CCNX_TESTRIG_LOG_WARNING 1
+#define CCNX_TESTRIG_LOG_INFO 2
+#define CCNX_TESTRIG_LOG_DEBUG 3
+
+// Log sites more detailed than this level are compiled out entirely.
+#ifndef CCNX_TESTRIG_LOG_COMPILED_LEVEL
+#define CCNX_TESTRIG_LOG_COMPILED_LEVEL CCNX_TESTRIG_LOG_INFO
+#endif
+
+typedef enum {
+    CCNxTestrigLogLevel_Error = CCNX_TESTRIG_LOG_ERROR,
+    CCNxTestrigLogLevel_Warning = CCNX_TESTRIG_LOG_WARNING,
+    CCNxTestrigLogLevel_Info = CCNX_TESTRIG_LOG_INFO,
+    CCNxTestrigLogLevel_Debug = CCNX_TESTRIG_LOG_DEBUG,
+    CCNxTestrigLogLevel_Invalid = 4
+} CCNxTestrigLogLevel;
+
+// The most detailed level that is written. Read by every log site, so it is not behind a function.
+extern CCNxTestrigLogLevel ccnxTestrigLog_CurrentLevel;
+
+/**
+ * Log a message at the given level, if the level is compiled in and enabled.
+ *
+ * A disabled site costs one comparison, and a site above `CCNX_TESTRIG_LOG_COMPILED_LEVEL`
+ * costs nothing, as its arguments are not even evaluated.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigLog(CCNxTestrigLogLevel_Info, "Running test %d", i);
+ * }
+ * @endcode
+ */
+#define ccnxTestrigLog(level, ...) \
+    do { \
+        if ((level) <= CCNX_TESTRIG_LOG_COMPILED_LEVEL && (level) <= ccnxTestrigLog_CurrentLevel) { \
+            ccnxTestrigLog_Write((level), __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define ccnxTestrigLog_Error(...) ccnxTestrigLog(CCNxTestrigLogLevel_Error, __VA_ARGS__)
+#define ccnxTestrigLog_Warning(...) ccnxTestrigLog(CCNxTestrigLogLevel_Warning, __VA_ARGS__)
+#define ccnxTestrigLog_Info(...) ccnxTestrigLog(CCNxTestrigLogLevel_Info, __VA_ARGS__)
+#define ccnxTestrigLog_Debug(...) ccnxTestrigLog(CCNxTestrigLogLevel_Debug, __VA_ARGS__)
+
+/**
+ * Set the most detailed level that is written.
+ *
+ * @param [in] level The level. Levels above `CCNX_TESTRIG_LOG_COMPILED_LEVEL` are accepted, but their sites are not compiled in.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigLog_SetLevel(CCNxTestrigLogLevel_Warning);
+ * }
+ * @endcode
+ */
+void ccnxTestrigLog_SetLevel(CCNxTestrigLogLevel level);
+
+/**
+ * Parse the name of a level: "error", "warning", "info" or "debug".
+ *
+ * @param [in] name The name of the level.
+ *
+ * @return The level, or `CCNxTestrigLogLevel_Invalid` if the name is not known.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigLogLevel level = ccnxTestrigLog_ParseLevel("debug");
+ * }
+ * @endcode
+ */
+CCNxTestrigLogLevel ccnxTestrigLog_ParseLevel(const char *name);
+
+/**
+ * Start writing the log from a background thread.
+ *
+ * Until the log is started, and after it is stopped, messages are written as they are logged.
+ * While it is started, each thread formats its messages into a buffer of its own, without
+ * taking a lock or making a system call, and the background thread writes the buffers out.
+ * A message that finds its thread's buffer full is dropped and counted rather than waited for.
+ * Every message is written on a line of its own, prefixed with its level, such as "[warning] ".
+ *
+ * @param [in] output The FILE to which the log is written.
+ *
+ * @return true if the background thread was started.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigLog_Start(stderr);
+ *     ...
+ *     ccnxTestrigLog_Stop();
+ * }
+ * @endcode
+ */
+bool ccnxTestrigLog_Start(FILE *output);
+
+/**
+ * Write out every buffered message and stop the background thread.
+ *
+ * Threads that were logging into their buffers when the log was stopped are waited for, so
+ * their messages are written too. Messages logged afterwards are written as they are logged.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigLog_Stop();
+ * }
+ * @endcode
+ */
+void ccnxTestrigLog_Stop(void);
+
+/**
+ * Retrieve the number of messages dropped because their thread's buffer was full.
+ *
+ * @return The number of dropped messages.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t dropped = ccnxTestrigLog_GetDroppedCount();
+ * }
+ * @endcode
+ */
+uint64_t ccnxTestrigLog_GetDroppedCount(void);
+
+/**
+ * Log a message, regardless of the current level. Use the `ccnxTestrigLog` macros instead,
+ * so that disabled messages are not formatted.
+ *
+ * @param [in] level The level of the message.
+ * @param [in] format A printf format, without a trailing newline.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigLog_Write(CCNxTestrigLogLevel_Error, "Link %s failed", name);
+ * }
+ * @endcode
+ */
+void ccnxTestrigLog_Write(CCNxTestrigLogLevel level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+#endif // ccnxTestrig_Log_h
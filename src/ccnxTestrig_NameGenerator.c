@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <parc/algol/parc_Object.h>
+
+#include "ccnxTestrig_NameGenerator.h"
+
+// The number of hex characters in the suffix of a created name.
+#define NAME_SUFFIX_LENGTH 32
+
+// The low bits of the generated word hold the counter, the high bits the stream ID.
+#define COUNTER_BITS 40
+
+#define GOLDEN_GAMMA 0x9e3779b97f4a7c15ULL
+
+struct ccnx_testrig_name_generator {
+    uint64_t seed;
+    uint64_t stream;
+    uint64_t counter;
+
+    // The last prefix used to create a name, kept so that it is parsed only once.
+    char *prefixURI;
+    CCNxName *prefix;
+
+    char suffix[NAME_SUFFIX_LENGTH + 1];
+};
+
+static bool
+_ccnxTestrigNameGenerator_Destructor(CCNxTestrigNameGenerator **generatorPtr)
+{
+    CCNxTestrigNameGenerator *generator = *generatorPtr;
+
+    free(generator->prefixURI);
+    if (generator->prefix != NULL) {
+        ccnxName_Release(&generator->prefix);
+    }
+
+    return true;
+}
+
+parcObject_ImplementAcquire(ccnxTestrigNameGenerator, CCNxTestrigNameGenerator);
+parcObject_ImplementRelease(ccnxTestrigNameGenerator, CCNxTestrigNameGenerator);
+
+parcObject_Override(
+	CCNxTestrigNameGenerator, PARCObject,
+	.destructor = (PARCObjectDestructor *) _ccnxTestrigNameGenerator_Destructor);
+
+CCNxTestrigNameGenerator *
+ccnxTestrigNameGenerator_Create(uint64_t seed, uint32_t streamID)
+{
+    CCNxTestrigNameGenerator *generator = parcObject_CreateInstance(CCNxTestrigNameGenerator);
+
+    if (generator != NULL) {
+        generator->seed = seed;
+        generator->stream = (uint64_t) streamID << COUNTER_BITS;
+        generator->counter = 0;
+        generator->prefixURI = NULL;
+        generator->prefix = NULL;
+    }
+
+    return generator;
+}
+
+/**
+ * The SplitMix64 finalizer. It is a bijection, so distinct inputs always give distinct outputs.
+ */
+static uint64_t
+_ccnxTestrigNameGenerator_Mix(uint64_t value)
+{
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+void
+ccnxTestrigNameGenerator_NextSuffix(CCNxTestrigNameGenerator *generator, char *suffix, size_t length)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    // The first 16 characters encode the stream and counter, which is what makes the suffix unique.
+    // Longer suffixes are padded from the same value.
+    uint64_t word = generator->stream | (generator->counter++ & ((1ULL << COUNTER_BITS) - 1));
+    uint64_t unique = _ccnxTestrigNameGenerator_Mix(word ^ generator->seed);
+
+    uint64_t value = unique;
+    for (size_t i = 0; i < length; i++) {
+        if (i > 0 && i % 16 == 0) {
+            value = _ccnxTestrigNameGenerator_Mix(unique + (i / 16) * GOLDEN_GAMMA);
+        }
+        suffix[i] = hex[(value >> (60 - 4 * (i % 16))) & 0xf];
+    }
+}
+
+CCNxName *
+ccnxTestrigNameGenerator_CreateName(CCNxTestrigNameGenerator *generator, const char *prefix)
+{
+    if (generator->prefixURI == NULL || strcmp(generator->prefixURI, prefix) != 0) {
+        free(generator->prefixURI);
+        if (generator->prefix != NULL) {
+            ccnxName_Release(&generator->prefix);
+        }
+        generator->prefixURI = strdup(prefix);
+        generator->prefix = ccnxName_CreateFromCString(prefix);
+    }
+
+    ccnxTestrigNameGenerator_NextSuffix(generator, generator->suffix, NAME_SUFFIX_LENGTH);
+    generator->suffix[NAME_SUFFIX_LENGTH] = '\0';
+
+    return ccnxName_ComposeNAME(generator->prefix, generator->suffix);
+}
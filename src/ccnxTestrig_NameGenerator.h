@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_NameGenerator_h
+#define ccnxTestrig_NameGenerator_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <ccnx/common/ccnx_Name.h>
+
+struct ccnx_testrig_name_generator;
+typedef struct ccnx_testrig_name_generator CCNxTestrigNameGenerator;
+
+/**
+ * Create a `CCNxTestrigNameGenerator` that produces unique name suffixes for one stream.
+ *
+ * Each suffix is derived from the seed, the stream ID and a counter, so generators created
+ * with the same seed and stream ID produce the same sequence of suffixes, and generators
+ * with distinct stream IDs never produce the same suffix. A generator is not synchronized:
+ * every thread that needs names must use its own stream.
+ *
+ * @param [in] seed The seed shared by every generator of a run.
+ * @param [in] streamID The stream, unique within a run, that this generator produces.
+ *
+ * @return A newly allocated `CCNxTestrigNameGenerator` that must be freed by `ccnxTestrigNameGenerator_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigNameGenerator *generator = ccnxTestrigNameGenerator_Create(seed, 1);
+ *
+ *     ccnxTestrigNameGenerator_Release(&generator);
+ * }
+ * @endcode
+ */
+CCNxTestrigNameGenerator *ccnxTestrigNameGenerator_Create(uint64_t seed, uint32_t streamID);
+
+/**
+ * Increase the number of references to a `CCNxTestrigNameGenerator` instance.
+ *
+ * @param [in] generator A `CCNxTestrigNameGenerator` instance.
+ *
+ * @return The same value as @p generator.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigNameGenerator *handle = ccnxTestrigNameGenerator_Acquire(generator);
+ *
+ *     ccnxTestrigNameGenerator_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigNameGenerator *ccnxTestrigNameGenerator_Acquire(const CCNxTestrigNameGenerator *generator);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigNameGenerator` instance,
+ * decrementing the reference count for the instance.
+ *
+ * @param [in,out] generatorPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigNameGenerator *generator = ccnxTestrigNameGenerator_Create(seed, 1);
+ *
+ *     ccnxTestrigNameGenerator_Release(&generator);
+ * }
+ * @endcode
+ */
+void ccnxTestrigNameGenerator_Release(CCNxTestrigNameGenerator **generatorPtr);
+
+/**
+ * Write the next suffix of the stream into the given buffer as lowercase hex characters.
+ *
+ * No terminating NUL is written, so the suffix can be written straight into an encoded name.
+ * Suffixes of at least 16 characters are unique within a run; shorter suffixes are truncated
+ * and may repeat.
+ *
+ * @param [in] generator A `CCNxTestrigNameGenerator` instance.
+ * @param [out] suffix The buffer that receives the suffix.
+ * @param [in] length The number of characters to write.
+ *
+ * Example:
+ * @code
+ * {
+ *     char suffix[32];
+ *     ccnxTestrigNameGenerator_NextSuffix(generator, suffix, sizeof(suffix));
+ * }
+ * @endcode
+ */
+void ccnxTestrigNameGenerator_NextSuffix(CCNxTestrigNameGenerator *generator, char *suffix, size_t length);
+
+/**
+ * Create a name that is unique within the run by appending the next suffix of the stream to a prefix.
+ *
+ * @param [in] generator A `CCNxTestrigNameGenerator` instance.
+ * @param [in] prefix The URI of the prefix, such as "ccnx:/test/b".
+ *
+ * @return A new `CCNxName` that must be released by `ccnxName_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxName *name = ccnxTestrigNameGenerator_CreateName(generator, "ccnx:/test/b");
+ *
+ *     ccnxName_Release(&name);
+ * }
+ * @endcode
+ */
+CCNxName *ccnxTestrigNameGenerator_CreateName(CCNxTestrigNameGenerator *generator, const char *prefix);
+#endif // ccnxTestrig_NameGenerator_h
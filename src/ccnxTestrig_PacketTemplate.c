@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <parc/algol/parc_Object.h>
+
+#include "ccnxTestrig_PacketTemplate.h"
+#include "ccnxTestrig_PacketUtility.h"
+
+struct ccnx_testrig_packet_template {
+    char *name;
+    bool isInterest;
+
+    PARCBuffer *wireFormat;
+    size_t suffixOffset;
+    size_t suffixLength;
+
+    // The packet name without its suffix.
+    CCNxName *prefix;
+};
+
+static bool
+_ccnxTestrigPacketTemplate_Destructor(CCNxTestrigPacketTemplate **templatePtr)
+{
+    CCNxTestrigPacketTemplate *template = *templatePtr;
+
+    free(template->name);
+    if (template->wireFormat != NULL) {
+        parcBuffer_Release(&template->wireFormat);
+    }
+    if (template->prefix != NULL) {
+        ccnxName_Release(&template->prefix);
+    }
+
+    return true;
+}
+
+parcObject_ImplementAcquire(ccnxTestrigPacketTemplate, CCNxTestrigPacketTemplate);
+parcObject_ImplementRelease(ccnxTestrigPacketTemplate, CCNxTestrigPacketTemplate);
+
+parcObject_Override(
+	CCNxTestrigPacketTemplate, PARCObject,
+	.destructor = (PARCObjectDestructor *) _ccnxTestrigPacketTemplate_Destructor);
+
+static size_t
+_readUint16(const uint8_t *bytes)
+{
+    return ((size_t) bytes[0] << 8) | bytes[1];
+}
+
+/**
+ * Find the value of the last segment of the Name TLV at the given offset.
+ */
+static bool
+_ccnxTestrigPacketTemplate_FindSuffix(const uint8_t *packet, size_t nameOffset, size_t nameLength, size_t *suffixOffset, size_t *suffixLength)
+{
+    size_t end = nameOffset + nameLength;
+    bool found = false;
+
+    for (size_t offset = nameOffset + 4; offset + 4 <= end; offset += 4 + _readUint16(packet + offset + 2)) {
+        *suffixOffset = offset + 4;
+        *suffixLength = _readUint16(packet + offset + 2);
+        found = true;
+    }
+
+    return found && *suffixOffset + *suffixLength <= end;
+}
+
+CCNxTestrigPacketTemplate *
+ccnxTestrigPacketTemplate_Create(const char *name, CCNxTlvDictionary *packet)
+{
+    const CCNxName *packetName = ccnxTestrigPacketUtility_GetName(packet);
+    if (packetName == NULL || ccnxName_GetSegmentCount(packetName) == 0) {
+        fprintf(stderr, "Error: template %s needs a named packet\n", name);
+        return NULL;
+    }
+
+    CCNxTestrigPacketTemplate *template = parcObject_CreateInstance(CCNxTestrigPacketTemplate);
+    if (template == NULL) {
+        return NULL;
+    }
+
+    template->name = strdup(name);
+    template->isInterest = ccnxTlvDictionary_IsInterest(packet);
+    template->wireFormat = ccnxTestrigPacketUtility_EncodePacket(packet);
+    template->prefix = ccnxName_Trim(ccnxName_Copy(packetName), 1);
+
+    const uint8_t *bytes = parcBuffer_Overlay(template->wireFormat, 0);
+    size_t length = parcBuffer_Remaining(template->wireFormat);
+
+    size_t messageOffset, nameOffset, nameLength;
+    if (!ccnxTestrigPacketUtility_FindWireName(bytes, length, &messageOffset, &nameOffset, &nameLength)
+        || !_ccnxTestrigPacketTemplate_FindSuffix(bytes, nameOffset, nameLength, &template->suffixOffset, &template->suffixLength)) {
+        fprintf(stderr, "Error: template %s could not locate its name suffix\n", name);
+        ccnxTestrigPacketTemplate_Release(&template);
+        return NULL;
+    }
+
+    // Anything after the message TLV is a validation section that a new suffix would invalidate.
+    if (messageOffset + 4 + _readUint16(bytes + messageOffset + 2) != length) {
+        fprintf(stderr, "Error: template %s carries a validation section\n", name);
+        ccnxTestrigPacketTemplate_Release(&template);
+        return NULL;
+    }
+
+    return template;
+}
+
+const char *
+ccnxTestrigPacketTemplate_GetName(const CCNxTestrigPacketTemplate *template)
+{
+    return template->name;
+}
+
+size_t
+ccnxTestrigPacketTemplate_GetSuffixLength(const CCNxTestrigPacketTemplate *template)
+{
+    return template->suffixLength;
+}
+
+bool
+ccnxTestrigPacketTemplate_IsInterest(const CCNxTestrigPacketTemplate *template)
+{
+    return template->isInterest;
+}
+
+PARCBuffer *
+ccnxTestrigPacketTemplate_Instantiate(const CCNxTestrigPacketTemplate *template, const uint8_t *suffix)
+{
+    size_t length = parcBuffer_Remaining(template->wireFormat);
+    PARCBuffer *packet = parcBuffer_Allocate(length);
+
+    uint8_t *bytes = parcBuffer_Overlay(packet, 0);
+    memcpy(bytes, parcBuffer_Overlay(template->wireFormat, 0), length);
+    memcpy(bytes + template->suffixOffset, suffix, template->suffixLength);
+
+    return packet;
+}
+
+CCNxName *
+ccnxTestrigPacketTemplate_CreateName(const CCNxTestrigPacketTemplate *template, const char *suffix)
+{
+    return ccnxName_ComposeNAME(template->prefix, suffix);
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_PacketTemplate_h
+#define ccnxTestrig_PacketTemplate_h
+
+#include <stdint.h>
+
+#include <parc/algol/parc_Buffer.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/transport/common/transport_MetaMessage.h>
+
+struct ccnx_testrig_packet_template;
+typedef struct ccnx_testrig_packet_template CCNxTestrigPacketTemplate;
+
+/**
+ * Create a `CCNxTestrigPacketTemplate` from an Interest or Content Object.
+ *
+ * The packet is encoded to its wire format once, and the offset and length of the last
+ * segment of its name are recorded. That segment is the name suffix: new packets are
+ * produced by copying the wire format and overwriting the suffix bytes, without going
+ * through the TLV encoder again.
+ *
+ * Overwriting the suffix would invalidate a signature or checksum, so packets that carry
+ * a validation section cannot be used as templates.
+ *
+ * @param [in] name The name under which the template is registered with a `CCNxTestrig`.
+ * @param [in] packet The Interest or Content Object whose last name segment is the suffix.
+ *
+ * @retval A newly allocated `CCNxTestrigPacketTemplate` that must be freed by `ccnxTestrigPacketTemplate_Release`.
+ * @retval NULL if the packet has no name or carries a validation section.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxName *name = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
+ *     CCNxInterest *interest = ccnxInterest_Create(name, 1000, NULL, NULL);
+ *     CCNxTestrigPacketTemplate *template = ccnxTestrigPacketTemplate_Create("interest/b", interest);
+ *
+ *     ccnxTestrigPacketTemplate_Release(&template);
+ * }
+ * @endcode
+ */
+CCNxTestrigPacketTemplate *ccnxTestrigPacketTemplate_Create(const char *name, CCNxTlvDictionary *packet);
+
+/**
+ * Increase the number of references to a `CCNxTestrigPacketTemplate` instance.
+ *
+ * @param [in] template A `CCNxTestrigPacketTemplate` instance.
+ *
+ * @return The same value as @p template.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigPacketTemplate *handle = ccnxTestrigPacketTemplate_Acquire(template);
+ *
+ *     ccnxTestrigPacketTemplate_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigPacketTemplate *ccnxTestrigPacketTemplate_Acquire(const CCNxTestrigPacketTemplate *template);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigPacketTemplate` instance,
+ * decrementing the reference count for the instance.
+ *
+ * @param [in,out] templatePtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigPacketTemplate *template = ccnxTestrigPacketTemplate_Create("interest/b", interest);
+ *
+ *     ccnxTestrigPacketTemplate_Release(&template);
+ * }
+ * @endcode
+ */
+void ccnxTestrigPacketTemplate_Release(CCNxTestrigPacketTemplate **templatePtr);
+
+/**
+ * Retrieve the name under which the template is registered.
+ *
+ * @param [in] template A `CCNxTestrigPacketTemplate` instance.
+ *
+ * @return The nul-terminated name, which remains owned by the template.
+ *
+ * Example:
+ * @code
+ * {
+ *     const char *name = ccnxTestrigPacketTemplate_GetName(template);
+ * }
+ * @endcode
+ */
+const char *ccnxTestrigPacketTemplate_GetName(const CCNxTestrigPacketTemplate *template);
+
+/**
+ * Retrieve the number of bytes in the name suffix of the template.
+ *
+ * Every suffix passed to `ccnxTestrigPacketTemplate_Instantiate` must have this length.
+ *
+ * @param [in] template A `CCNxTestrigPacketTemplate` instance.
+ *
+ * @return The length of the suffix.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t suffixLength = ccnxTestrigPacketTemplate_GetSuffixLength(template);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigPacketTemplate_GetSuffixLength(const CCNxTestrigPacketTemplate *template);
+
+/**
+ * Determine if the template was made from an Interest.
+ *
+ * @param [in] template A `CCNxTestrigPacketTemplate` instance.
+ *
+ * @return true if the template is an Interest, false if it is a Content Object.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (ccnxTestrigPacketTemplate_IsInterest(template)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxTestrigPacketTemplate_IsInterest(const CCNxTestrigPacketTemplate *template);
+
+/**
+ * Produce a wire-encoded packet from the template with the given name suffix.
+ *
+ * @param [in] template A `CCNxTestrigPacketTemplate` instance.
+ * @param [in] suffix `ccnxTestrigPacketTemplate_GetSuffixLength` bytes that replace the name suffix.
+ *
+ * @return A new `PARCBuffer` containing the packet, which must be released by `parcBuffer_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *packet = ccnxTestrigPacketTemplate_Instantiate(template, (const uint8_t *) suffix);
+ *     ccnxTestrigLink_Send(link, packet);
+ *     parcBuffer_Release(&packet);
+ * }
+ * @endcode
+ */
+PARCBuffer *ccnxTestrigPacketTemplate_Instantiate(const CCNxTestrigPacketTemplate *template, const uint8_t *suffix);
+
+/**
+ * Create the name carried by the packets instantiated with the given suffix.
+ *
+ * @param [in] template A `CCNxTestrigPacketTemplate` instance.
+ * @param [in] suffix A nul-terminated suffix of `ccnxTestrigPacketTemplate_GetSuffixLength` characters.
+ *
+ * @return A new `CCNxName` that must be released by `ccnxName_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxName *name = ccnxTestrigPacketTemplate_CreateName(template, suffix);
+ *     ccnxTestrig_ClaimName(rig, name);
+ *     ccnxName_Release(&name);
+ * }
+ * @endcode
+ */
+CCNxName *ccnxTestrigPacketTemplate_CreateName(const CCNxTestrigPacketTemplate *template, const char *suffix);
+#endif // ccnxTestrig_PacketTemplate_h
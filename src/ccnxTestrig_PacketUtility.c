@@ -57,6 +57,50 @@
 
 #include <ccnx/common/codec/ccnxCodec_TlvPacket.h>
 
+#include <parc/algol/parc_Memory.h>
+
+// The fixed header: version, packet type, packet length (2), hop limit, return code, reserved, header length.
+#define FIXED_HEADER_LENGTH 8
+#define PACKET_TYPE_INTEREST 0
+
+// The TLV types the wire diff needs to know about.
+#define TLV_MESSAGE_INTEREST 0x0001
+#define TLV_MESSAGE_CONTENT_OBJECT 0x0002
+#define TLV_MESSAGE_MANIFEST 0x0006
+#define TLV_VALIDATION_ALGORITHM 0x0003
+#define TLV_VALIDATION_PAYLOAD 0x0004
+#define TLV_NAME 0x0000
+#define TLV_PAYLOAD 0x0001
+#define TLV_INTEREST_KEYID_RESTRICTION 0x0002
+#define TLV_INTEREST_HASH_RESTRICTION 0x0003
+#define TLV_MANIFEST_HASH_GROUP 0x0007
+
+// Returned by _diffField for divergences outside the message fields.
+#define DIFF_FIELD_VALIDATION 0x10000
+#define DIFF_FIELD_OTHER 0x10001
+
+static bool
+_isMessageType(uint16_t type)
+{
+    return type == TLV_MESSAGE_INTEREST || type == TLV_MESSAGE_CONTENT_OBJECT || type == TLV_MESSAGE_MANIFEST;
+}
+
+/**
+ * Return the type of the message field in which a divergence lies, DIFF_FIELD_VALIDATION if
+ * it lies in the validation TLVs, or DIFF_FIELD_OTHER.
+ */
+static uint32_t
+_diffField(const CCNxTestrigWireDiff *diff)
+{
+    if (diff->depth >= 2 && _isMessageType(diff->path[0])) {
+        return diff->path[1];
+    }
+    if (diff->depth >= 1 && (diff->path[0] == TLV_VALIDATION_ALGORITHM || diff->path[0] == TLV_VALIDATION_PAYLOAD)) {
+        return DIFF_FIELD_VALIDATION;
+    }
+    return DIFF_FIELD_OTHER;
+}
+
 static CCNxInterestFieldError
 _validInterestPair(CCNxInterest *egress, CCNxInterest *ingress)
 {
@@ -83,41 +127,154 @@ _validInterestPair(CCNxInterest *egress, CCNxInterest *ingress)
     return CCNxInterestFieldError_None;
 }
 
+static CCNxInterestFieldError
+_validInterestWire(const CCNxTestrigWireDiff *diff)
+{
+    if (diff == NULL) {
+        return CCNxInterestFieldError_None;
+    }
+
+    switch (_diffField(diff)) {
+        case TLV_NAME:
+            return CCNxInterestFieldError_Name;
+        case TLV_PAYLOAD:
+            return CCNxInterestFieldError_Payload;
+        case TLV_INTEREST_KEYID_RESTRICTION:
+            return CCNxInterestFieldError_KeyIdRestriction;
+        case TLV_INTEREST_HASH_RESTRICTION:
+            return CCNxInterestFieldError_ContentObjectHashRestriction;
+        case DIFF_FIELD_VALIDATION:
+            return CCNxInterestFieldError_Validation;
+        default:
+            return CCNxInterestFieldError_Other;
+    }
+}
+
 static CCNxContentObjectFieldError
-_validContentPair(CCNxContentObject *egress, CCNxContentObject *ingress)
+_validContentPair(const CCNxTestrigWireDiff *diff)
 {
-    return CCNxContentObjectFieldError_None;
+    if (diff == NULL) {
+        return CCNxContentObjectFieldError_None;
+    }
+
+    switch (_diffField(diff)) {
+        case TLV_NAME:
+            return CCNxContentObjectFieldError_Name;
+        case TLV_PAYLOAD:
+            return CCNxContentObjectFieldError_Payload;
+        case DIFF_FIELD_VALIDATION:
+            return CCNxContentObjectFieldError_Validation;
+        default:
+            return CCNxContentObjectFieldError_Other;
+    }
 }
 
 static CCNxManifestFieldError
-_validManifestPair(CCNxManifest *egress, CCNxManifest *ingress)
+_validManifestPair(const CCNxTestrigWireDiff *diff)
+{
+    if (diff == NULL) {
+        return CCNxManifestFieldError_None;
+    }
+
+    switch (_diffField(diff)) {
+        case TLV_NAME:
+            return CCNxManifestFieldError_Name;
+        case TLV_PAYLOAD:
+        case TLV_MANIFEST_HASH_GROUP:
+            return CCNxManifestFieldError_Payload;
+        case DIFF_FIELD_VALIDATION:
+            return CCNxManifestFieldError_Validation;
+        default:
+            return CCNxManifestFieldError_Other;
+    }
+}
+
+static const char *_interestFieldNames[] = {
+    "name", "lifetime", "hop limit", "KeyId restriction", "content object hash restriction",
+    "payload", "validation", "message"
+};
+
+static const char *_contentObjectFieldNames[] = {
+    "name", "payload", "validation", "message"
+};
+
+static const char *_manifestFieldNames[] = {
+    "name", "payload", "validation", "message"
+};
+
+/**
+ * Return the wire format of a packet. A packet decoded from the wire keeps the buffer it came
+ * from, while one built from its fields has to be encoded.
+ */
+static PARCBuffer *
+_acquireWireFormat(CCNxTlvDictionary *packet)
 {
-    return CCNxManifestFieldError_None;
+    PARCBuffer *wireFormat = ccnxWireFormatMessage_GetWireFormatBuffer(packet);
+    if (wireFormat == NULL) {
+        return ccnxTestrigPacketUtility_EncodePacket(packet);
+    }
+
+    wireFormat = parcBuffer_Duplicate(wireFormat);
+    parcBuffer_Rewind(wireFormat);
+    return wireFormat;
+}
+
+static CCNxTestrigSuiteTestResult *
+_failField(CCNxTestrigSuiteTestResult *result, const char *packetType, const char *field, const CCNxTestrigWireDiff *diff)
+{
+    char path[CCNX_TESTRIG_WIRE_DIFF_MAX_DEPTH * 7 + 1] = "";
+    size_t used = 0;
+    for (size_t i = 0; i < diff->depth; i++) {
+        used += snprintf(path + used, sizeof(path) - used, "%s0x%04X", (i == 0) ? "" : "/", diff->path[i]);
+    }
+
+    char *reason = NULL;
+    if (diff->depth == 0) {
+        asprintf(&reason, "The %s %s was incorrect: the fixed header differs at offset %zu", packetType, field, diff->offset);
+    } else {
+        asprintf(&reason, "The %s %s was incorrect: TLV %s differs at offset %zu", packetType, field, path, diff->offset);
+    }
+    result = ccnxTestrigSuiteTestResult_SetFail(result, reason);
+    free(reason);
+    return result;
 }
 
 CCNxTestrigSuiteTestResult *
 ccnxTestrigPacketUtility_IsValidPacketPair(CCNxTlvDictionary *sent, CCNxMetaMessage *received, CCNxTestrigSuiteTestResult *result)
 {
-    // XXX: stringify the error conditions for more meaningful outputs
+    PARCBuffer *sentWireFormat = _acquireWireFormat(sent);
+    PARCBuffer *receivedWireFormat = _acquireWireFormat(received);
+
+    CCNxTestrigWireDiff diff;
+    const CCNxTestrigWireDiff *divergence = NULL;
+    if (ccnxTestrigPacketUtility_DiffWire(sentWireFormat, receivedWireFormat, &diff)) {
+        divergence = &diff;
+    }
+
+    parcBuffer_Release(&receivedWireFormat);
+    parcBuffer_Release(&sentWireFormat);
 
     if (ccnxTlvDictionary_IsInterest(sent)) {
+        // The hop limit and lifetime live in the headers, so they are checked on the decoded packets.
         CCNxInterest *receivedInterest = ccnxMetaMessage_GetInterest(received);
         CCNxInterestFieldError error = _validInterestPair(sent, receivedInterest);
         if (error != CCNxInterestFieldError_None) {
             char *reason = NULL;
-            asprintf(&reason, "An interest field was incorrect: %d", error);
+            asprintf(&reason, "The interest %s was incorrect", _interestFieldNames[error]);
             result = ccnxTestrigSuiteTestResult_SetFail(result, reason);
             free(reason);
+        } else if ((error = _validInterestWire(divergence)) != CCNxInterestFieldError_None) {
+            result = _failField(result, "interest", _interestFieldNames[error], divergence);
         }
     } else if (ccnxTlvDictionary_IsContentObject(sent)) {
-        CCNxContentObject *receivedContent = ccnxMetaMessage_GetContentObject(received);
-        if (_validContentPair(sent, received) != CCNxContentObjectFieldError_None) {
-            result = ccnxTestrigSuiteTestResult_SetFail(result, "A content object field was incorrect");
+        CCNxContentObjectFieldError error = _validContentPair(divergence);
+        if (error != CCNxContentObjectFieldError_None) {
+            result = _failField(result, "content object", _contentObjectFieldNames[error], divergence);
         }
     } else if (ccnxTlvDictionary_IsManifest(sent)) {
-        CCNxManifest *receivedManifest = ccnxMetaMessage_GetManifest(received);
-        if (_validManifestPair(sent, receivedManifest) != CCNxManifestFieldError_None) {
-            result = ccnxTestrigSuiteTestResult_SetFail(result, "A manifest field was incorrect.");
+        CCNxManifestFieldError error = _validManifestPair(divergence);
+        if (error != CCNxManifestFieldError_None) {
+            result = _failField(result, "manifest", _manifestFieldNames[error], divergence);
         }
     } else {
         ccnxTestrigSuiteTestResult_SetFail(result, "The sent and received packet pair did not have the same message type.");
@@ -166,3 +323,208 @@ ccnxTestrigPacketUtility_ComputeMessageHash(CCNxTlvDictionary *dictionary)
 
     return digest;
 }
+
+const CCNxName *
+ccnxTestrigPacketUtility_GetName(CCNxTlvDictionary *dictionary)
+{
+    if (ccnxTlvDictionary_IsInterest(dictionary)) {
+        return ccnxInterest_GetName(dictionary);
+    } else if (ccnxTlvDictionary_IsContentObject(dictionary)) {
+        return ccnxContentObject_GetName(dictionary);
+    } else if (ccnxTlvDictionary_IsManifest(dictionary)) {
+        return ccnxManifest_GetName(dictionary);
+    }
+    return NULL;
+}
+
+static size_t
+_readUint16(const uint8_t *bytes)
+{
+    return ((size_t) bytes[0] << 8) | bytes[1];
+}
+
+bool
+ccnxTestrigPacketUtility_FindWireName(const uint8_t *packet, size_t length, size_t *messageOffset, size_t *nameOffset, size_t *nameLength)
+{
+    // Fixed header: version, packet type, packet length (2), hop limit, return code, reserved, header length.
+    if (length < FIXED_HEADER_LENGTH || _readUint16(packet + 2) > length) {
+        return false;
+    }
+    length = _readUint16(packet + 2);
+
+    size_t offset = packet[7];
+    if (offset + 4 > length) {
+        return false;
+    }
+    *messageOffset = offset;
+
+    size_t end = offset + 4 + _readUint16(packet + offset + 2);
+    if (end > length) {
+        return false;
+    }
+
+    for (offset += 4; offset + 4 <= end; offset += 4 + _readUint16(packet + offset + 2)) {
+        if (_readUint16(packet + offset) == 0x0000) {
+            *nameOffset = offset;
+            *nameLength = 4 + _readUint16(packet + offset + 2);
+            return offset + *nameLength <= end;
+        }
+    }
+
+    return false;
+}
+
+bool
+ccnxTestrigPacketUtility_IsForwardedCopy(PARCBuffer *sent, PARCBuffer *received)
+{
+    size_t length = parcBuffer_Remaining(sent);
+    if (length < FIXED_HEADER_LENGTH || parcBuffer_Remaining(received) != length) {
+        return false;
+    }
+
+    const uint8_t *egress = parcBuffer_Overlay(sent, 0);
+    const uint8_t *ingress = parcBuffer_Overlay(received, 0);
+
+    // Version, packet type and packet length.
+    if (memcmp(egress, ingress, 4) != 0) {
+        return false;
+    }
+
+    // The hop limit is byte 4. The return code and reserved bytes that follow it are not compared.
+    if (egress[1] == PACKET_TYPE_INTEREST && ingress[4] + 1 != egress[4]) {
+        return false;
+    }
+
+    // The header length, and everything after the fixed header. memcmp compares whole vectors at a
+    // time, so this costs a fraction of decoding either packet.
+    return memcmp(egress + 7, ingress + 7, length - 7) == 0;
+}
+
+/**
+ * Return the offset of the first byte at which two equally long values differ. Blocks are
+ * compared with memcmp, so only the block holding the difference is scanned byte by byte.
+ */
+static size_t
+_firstDifference(const uint8_t *egress, const uint8_t *ingress, size_t length)
+{
+    const size_t blockLength = 256;
+
+    size_t offset = 0;
+    while (offset + blockLength < length && memcmp(egress + offset, ingress + offset, blockLength) == 0) {
+        offset += blockLength;
+    }
+    while (offset < length && egress[offset] == ingress[offset]) {
+        offset++;
+    }
+    return offset;
+}
+
+/**
+ * The message, its Name and the validation algorithm hold TLVs of their own; everything else
+ * is compared as an opaque value.
+ */
+static bool
+_isContainer(const CCNxTestrigWireDiff *diff, size_t depth, uint16_t type)
+{
+    if (depth == 0) {
+        return _isMessageType(type) || type == TLV_VALIDATION_ALGORITHM;
+    }
+    if (depth == 1) {
+        return (_isMessageType(diff->path[0]) && type == TLV_NAME) || diff->path[0] == TLV_VALIDATION_ALGORITHM;
+    }
+    return false;
+}
+
+/**
+ * Walk the TLVs in [egressOffset, egressEnd) and [ingressOffset, ingressEnd) side by side,
+ * stopping at the first divergence. Returns true with @p diff set if one was found.
+ */
+static bool
+_diffTlvs(const uint8_t *egress, size_t egressOffset, size_t egressEnd,
+          const uint8_t *ingress, size_t ingressOffset, size_t ingressEnd,
+          size_t depth, CCNxTestrigWireDiff *diff)
+{
+    while (egressOffset < egressEnd || ingressOffset < ingressEnd) {
+        diff->depth = depth;
+        diff->offset = ingressOffset;
+
+        bool egressHasTlv = egressOffset + 4 <= egressEnd;
+        bool ingressHasTlv = ingressOffset + 4 <= ingressEnd;
+        if (!egressHasTlv && !ingressHasTlv) {
+            // Trailing bytes too short to be a TLV on both sides.
+            size_t egressLength = egressEnd - egressOffset;
+            if (egressLength != ingressEnd - ingressOffset) {
+                return true;
+            }
+            diff->offset = ingressOffset + _firstDifference(egress + egressOffset, ingress + ingressOffset, egressLength);
+            return diff->offset < ingressEnd;
+        }
+
+        uint16_t egressType = egressHasTlv ? _readUint16(egress + egressOffset) : 0;
+        uint16_t ingressType = ingressHasTlv ? _readUint16(ingress + ingressOffset) : 0;
+        if (depth < CCNX_TESTRIG_WIRE_DIFF_MAX_DEPTH) {
+            diff->path[depth] = egressHasTlv ? egressType : ingressType;
+            diff->depth = depth + 1;
+        }
+        if (!egressHasTlv || !ingressHasTlv || egressType != ingressType) {
+            return true;
+        }
+
+        size_t egressValue = egressOffset + 4;
+        size_t ingressValue = ingressOffset + 4;
+        size_t egressLength = _readUint16(egress + egressOffset + 2);
+        size_t ingressLength = _readUint16(ingress + ingressOffset + 2);
+        if (egressValue + egressLength > egressEnd || ingressValue + ingressLength > ingressEnd) {
+            return true;
+        }
+
+        if (depth + 1 < CCNX_TESTRIG_WIRE_DIFF_MAX_DEPTH && _isContainer(diff, depth, egressType)) {
+            if (_diffTlvs(egress, egressValue, egressValue + egressLength,
+                          ingress, ingressValue, ingressValue + ingressLength, depth + 1, diff)) {
+                return true;
+            }
+        } else if (egressLength != ingressLength) {
+            return true;
+        } else if (memcmp(egress + egressValue, ingress + ingressValue, egressLength) != 0) {
+            diff->offset = ingressValue + _firstDifference(egress + egressValue, ingress + ingressValue, egressLength);
+            return true;
+        }
+
+        egressOffset = egressValue + egressLength;
+        ingressOffset = ingressValue + ingressLength;
+    }
+
+    return false;
+}
+
+bool
+ccnxTestrigPacketUtility_DiffWire(PARCBuffer *sent, PARCBuffer *received, CCNxTestrigWireDiff *diff)
+{
+    diff->depth = 0;
+    diff->offset = 0;
+
+    size_t egressLength = parcBuffer_Remaining(sent);
+    size_t ingressLength = parcBuffer_Remaining(received);
+    if (egressLength < FIXED_HEADER_LENGTH || ingressLength < FIXED_HEADER_LENGTH) {
+        return true;
+    }
+
+    const uint8_t *egress = parcBuffer_Overlay(sent, 0);
+    const uint8_t *ingress = parcBuffer_Overlay(received, 0);
+
+    if (egress[1] != ingress[1]) {
+        diff->offset = 1;
+        return true;
+    }
+
+    // Trust the packet lengths only as far as the buffers reach.
+    size_t egressEnd = _readUint16(egress + 2);
+    size_t ingressEnd = _readUint16(ingress + 2);
+    if (egressEnd > egressLength || ingressEnd > ingressLength || egress[7] > egressEnd || ingress[7] > ingressEnd) {
+        diff->offset = 2;
+        return true;
+    }
+
+    // The per-hop headers between the fixed header and the message are skipped.
+    return _diffTlvs(egress, egress[7], egressEnd, ingress, ingress[7], ingressEnd, 0, diff);
+}
@@ -60,34 +60,60 @@
 #include <ccnx/transport/common/transport_MetaMessage.h>
 #include <ccnx/transport/common/transport_Message.h>
 
+#include <stdint.h>
+
 typedef enum {
     CCNxInterestFieldError_Name,
     CCNxInterestFieldError_Lifetime,
     CCNxInterestFieldError_HopLimit,
     CCNxInterestFieldError_KeyIdRestriction,
     CCNxInterestFieldError_ContentObjectHashRestriction,
+    CCNxInterestFieldError_Payload,
+    CCNxInterestFieldError_Validation,
+    CCNxInterestFieldError_Other,
     CCNxInterestFieldError_None
 } CCNxInterestFieldError;
 
 typedef enum {
     CCNxContentObjectFieldError_Name,
     CCNxContentObjectFieldError_Payload,
+    CCNxContentObjectFieldError_Validation,
+    CCNxContentObjectFieldError_Other,
     CCNxContentObjectFieldError_None
 } CCNxContentObjectFieldError;
 
 typedef enum {
     CCNxManifestFieldError_Name,
     CCNxManifestFieldError_Payload,
+    CCNxManifestFieldError_Validation,
+    CCNxManifestFieldError_Other,
     CCNxManifestFieldError_None
 } CCNxManifestFieldError;
 
+#define CCNX_TESTRIG_WIRE_DIFF_MAX_DEPTH 4
+
+/**
+ * The first point at which two wire-encoded packets diverge.
+ */
+typedef struct {
+    // The TLV types leading to the divergent TLV, outermost first.
+    uint16_t path[CCNX_TESTRIG_WIRE_DIFF_MAX_DEPTH];
+    size_t depth;
+
+    // The offset of the first divergent byte in the received packet.
+    size_t offset;
+} CCNxTestrigWireDiff;
+
 /**
  * Determine if the "packet pair" is valid. The sent packet will be that
  * which was sent to the forwarder and the received packet is that which was
  * received from the forwarder.
  *
  * The forwarder is expected to make some modifications to the packet, e.g., by
- * decrementing the hop count. This function checks those conditions.
+ * decrementing the hop count. This function checks those conditions, and then compares
+ * the message and validation TLVs of the two packets with `ccnxTestrigPacketUtility_DiffWire`.
+ * A failure names the field that differs and, when it was found on the wire, its TLV path
+ * and offset.
  *
  * @param [in] sent The `CCNxTlvDictionary` sent packet
  * @param [in] received The `CCNxTlvDictionary` received packet
@@ -144,4 +170,107 @@ PARCBuffer *ccnxTestrigPacketUtility_EncodePacket(CCNxTlvDictionary *packetDicti
  * @endcode
  */
 PARCBuffer *ccnxTestrigPacketUtility_ComputeMessageHash(CCNxTlvDictionary *dictionary);
+
+/**
+ * Retrieve the name carried by a packet.
+ *
+ * @param [in] packetDictionary An Interest, Content Object, or Manifest `CCNxTlvDictionary`.
+ *
+ * @retval The `CCNxName` of the packet, which is owned by the packet.
+ * @retval NULL if the packet is nameless.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTlvDictionary *message = ...
+ *
+ *     const CCNxName *name = ccnxTestrigPacketUtility_GetName(message);
+ * }
+ * @endcode
+ */
+const CCNxName *ccnxTestrigPacketUtility_GetName(CCNxTlvDictionary *packetDictionary);
+
+/**
+ * Locate the Name TLV of a wire-encoded Interest or Content Object without decoding the packet.
+ *
+ * The fixed header gives the offset of the message TLV, and the Name is found among the
+ * TLVs nested in the message. Bounds are checked against @p length throughout.
+ *
+ * @param [in] packet The wire-encoded packet, starting with its fixed header.
+ * @param [in] length The number of bytes in @p packet.
+ * @param [out] messageOffset Set to the offset of the message TLV.
+ * @param [out] nameOffset Set to the offset of the Name TLV.
+ * @param [out] nameLength Set to the length of the Name TLV, including its type and length fields.
+ *
+ * @return true if the packet is well formed and carries a Name.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t messageOffset, nameOffset, nameLength;
+ *     if (ccnxTestrigPacketUtility_FindWireName(parcBuffer_Overlay(packet, 0), parcBuffer_Remaining(packet),
+ *                                               &messageOffset, &nameOffset, &nameLength)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxTestrigPacketUtility_FindWireName(const uint8_t *packet, size_t length, size_t *messageOffset, size_t *nameOffset, size_t *nameLength);
+
+/**
+ * Determine if a received packet is a forwarded copy of a sent packet, by comparing their wire encodings.
+ *
+ * Everything after the fixed header, that is the per-hop headers, the message and its validation,
+ * must be byte for byte identical. In the fixed header the version, packet type, length and header
+ * length must match, the hop limit of an Interest must have been decremented by one, and the hop
+ * limit of other packets, the return code and the reserved byte are ignored, as forwarders may
+ * rewrite them. A pair that is accepted would also pass `ccnxTestrigPacketUtility_IsValidPacketPair`.
+ * A pair that is not may still be valid, for example when a forwarder rewrote a per-hop header,
+ * so it must then be decoded to be judged.
+ *
+ * @param [in] sent The wire-encoded packet that was sent.
+ * @param [in] received The wire-encoded packet that was received.
+ *
+ * @return true if @p received is a faithful forwarded copy of @p sent.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (!ccnxTestrigPacketUtility_IsForwardedCopy(sentBuffer, receiveBuffer)) {
+ *         CCNxMetaMessage *message = ccnxMetaMessage_CreateFromWireFormatBuffer(receiveBuffer);
+ *         result = ccnxTestrigPacketUtility_IsValidPacketPair(sentPacket, message, result);
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxTestrigPacketUtility_IsForwardedCopy(PARCBuffer *sent, PARCBuffer *received);
+
+/**
+ * Find the first TLV at which two wire-encoded packets diverge, without decoding either.
+ *
+ * The packet types in the fixed headers must match. The per-hop headers are not compared, as
+ * forwarders may rewrite them. The message and validation TLVs are walked side by side, type by
+ * type: the message, its Name and the validation algorithm are descended into, and every other
+ * TLV is compared with `memcmp`, so large payloads cost no more than a pass over their bytes.
+ * A TLV present in one packet and not the other, or one that runs past its enclosing TLV, is
+ * reported as divergent.
+ *
+ * @param [in] sent The wire-encoded packet that was sent.
+ * @param [in] received The wire-encoded packet that was received.
+ * @param [out] diff Set to the path and offset of the first divergence, if there is one.
+ *                   A depth of zero means the fixed headers differ or are malformed.
+ *
+ * @return true if the packets diverge.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigWireDiff diff;
+ *     if (ccnxTestrigPacketUtility_DiffWire(sentBuffer, receiveBuffer, &diff)) {
+ *         printf("The packets differ at offset %zu\n", diff.offset);
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxTestrigPacketUtility_DiffWire(PARCBuffer *sent, PARCBuffer *received, CCNxTestrigWireDiff *diff);
 #endif // ccnxTestrig_PacketUtility_h
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/common/ccnx_Interest.h>
+
+#include "ccnxTestrig_Probe.h"
+#include "ccnxTestrig_PacketUtility.h"
+
+// Milliseconds between pings, which is also their lifetime.
+#define PROBE_INTERVAL 100
+
+#define PACKET_TYPE_INTEREST 0
+
+/**
+ * Encode an Interest for the name and return its wire format, with the offset and length of its Name TLV.
+ */
+static PARCBuffer *
+_ccnxTestrigProbe_Encode(const CCNxName *name, size_t *nameOffset, size_t *nameLength)
+{
+    CCNxInterest *interest = ccnxInterest_Create(name, PROBE_INTERVAL, NULL, NULL);
+    PARCBuffer *encoded = ccnxTestrigPacketUtility_EncodePacket(interest);
+    ccnxInterest_Release(&interest);
+
+    size_t messageOffset;
+    if (!ccnxTestrigPacketUtility_FindWireName(parcBuffer_Overlay(encoded, 0), parcBuffer_Remaining(encoded), &messageOffset, nameOffset, nameLength)) {
+        parcBuffer_Release(&encoded);
+    }
+    return encoded;
+}
+
+/**
+ * Determine whether a packet is an Interest whose name starts with the components of the prefix,
+ * given as the value of its Name TLV.
+ */
+static bool
+_ccnxTestrigProbe_IsPing(PARCBuffer *packet, const uint8_t *prefix, size_t prefixLength)
+{
+    const uint8_t *bytes = parcBuffer_Overlay(packet, 0);
+    size_t length = parcBuffer_Remaining(packet);
+    size_t messageOffset, nameOffset, nameLength;
+    if (length < 2 || bytes[1] != PACKET_TYPE_INTEREST
+        || !ccnxTestrigPacketUtility_FindWireName(bytes, length, &messageOffset, &nameOffset, &nameLength)) {
+        return false;
+    }
+    return nameLength - 4 >= prefixLength && memcmp(bytes + nameOffset + 4, prefix, prefixLength) == 0;
+}
+
+bool
+ccnxTestrigProbe_WaitForRoute(CCNxTestrig *rig, CCNxTestrigNameGenerator *names, const char *prefix, CCNxTestrigLinkID ingressLink, PARCBitVector *egressLinks, uint64_t deadline)
+{
+    CCNxTestrigLink *link = ccnxTestrig_GetLinkByID(rig, ingressLink);
+    CCNxName *prefixName = ccnxName_CreateFromCString(prefix);
+    if (link == NULL || prefixName == NULL) {
+        if (prefixName != NULL) {
+            ccnxName_Release(&prefixName);
+        }
+        return false;
+    }
+
+    // Names are compared component by component on the wire, so ccnx:/test/b does not match ccnx:/test/bc.
+    size_t nameOffset, nameLength;
+    PARCBuffer *encodedPrefix = _ccnxTestrigProbe_Encode(prefixName, &nameOffset, &nameLength);
+    ccnxName_Release(&prefixName);
+    if (encodedPrefix == NULL) {
+        return false;
+    }
+    const uint8_t *prefixValue = (const uint8_t *) parcBuffer_Overlay(encodedPrefix, 0) + nameOffset + 4;
+    size_t prefixLength = nameLength - 4;
+
+    bool forwarded = false;
+    while (!forwarded && ccnxTestrig_GetTime() < deadline) {
+        // A link whose peer is not known yet cannot send, but keep listening in case the forwarder is just slow.
+        if (ccnxTestrigLink_IsConnected(link)) {
+            CCNxName *name = ccnxTestrigNameGenerator_CreateName(names, prefix);
+            PARCBuffer *ping = _ccnxTestrigProbe_Encode(name, &nameOffset, &nameLength);
+            ccnxName_Release(&name);
+            if (ping != NULL) {
+                ccnxTestrigLink_Send(link, ping);
+                parcBuffer_Release(&ping);
+            }
+        }
+
+        uint64_t retry = ccnxTestrig_GetDeadline(PROBE_INTERVAL);
+        if (retry > deadline) {
+            retry = deadline;
+        }
+
+        // Any ping of this prefix will do, including a late one from an earlier attempt.
+        CCNxTestrigLinkID linkID;
+        PARCBuffer *packet;
+        while (!forwarded && (packet = ccnxTestrig_ReceiveFromLinks(rig, egressLinks, retry, &linkID)) != NULL) {
+            forwarded = _ccnxTestrigProbe_IsPing(packet, prefixValue, prefixLength);
+            parcBuffer_Release(&packet);
+        }
+    }
+
+    parcBuffer_Release(&encodedPrefix);
+    return forwarded;
+}
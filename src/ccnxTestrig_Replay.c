@@ -0,0 +1,580 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ccnxTestrig_Replay.h"
+#include "ccnxTestrig_Histogram.h"
+
+#define NSEC_PER_SEC 1000000000ULL
+
+// Pages behind the read position are handed back to the kernel after this many bytes.
+#define REPLAY_RELEASE_INTERVAL (16 << 20)
+
+#define PCAP_MAGIC_MICROSECONDS 0xA1B2C3D4
+#define PCAP_MAGIC_NANOSECONDS 0xA1B23C4D
+#define PCAP_FILE_HEADER_LENGTH 24
+#define PCAP_RECORD_HEADER_LENGTH 16
+
+#define PCAPNG_SECTION_HEADER_BLOCK 0x0A0D0D0A
+#define PCAPNG_INTERFACE_DESCRIPTION_BLOCK 1
+#define PCAPNG_SIMPLE_PACKET_BLOCK 3
+#define PCAPNG_ENHANCED_PACKET_BLOCK 6
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+#define PCAPNG_OPTION_IF_TSRESOL 9
+
+// Interfaces beyond this number in one pcapng section are skipped.
+#define REPLAY_MAX_INTERFACES 64
+
+#define LINKTYPE_NULL 0
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_RAW 101
+#define LINKTYPE_LINUX_SLL 113
+#define LINKTYPE_USER0 147
+#define LINKTYPE_IPV4 228
+#define LINKTYPE_IPV6 229
+
+#define ETHERTYPE_IPV4 0x0800
+#define ETHERTYPE_IPV6 0x86DD
+#define ETHERTYPE_VLAN 0x8100
+#define IPPROTO_UDP_NUMBER 17
+
+typedef struct {
+    uint32_t linkType;
+
+    // Timestamps are in units of numerator / denominator nanoseconds.
+    uint64_t numerator;
+    uint64_t denominator;
+} _CCNxTestrigReplayInterface;
+
+typedef struct {
+    const uint8_t *map;
+    size_t length;
+    size_t offset;
+    size_t released;
+
+    bool pcapng;
+    bool swapped;
+    bool malformed;
+
+    _CCNxTestrigReplayInterface interfaces[REPLAY_MAX_INTERFACES];
+    size_t numberOfInterfaces;
+
+    // The timestamp of the previous packet, for blocks that have none.
+    uint64_t timestamp;
+} _CCNxTestrigReplayReader;
+
+typedef struct {
+    uint32_t interface;
+    uint64_t timestamp;
+    const uint8_t *data;
+    size_t capturedLength;
+    size_t originalLength;
+} _CCNxTestrigReplayPacket;
+
+static uint64_t
+_ccnxTestrigReplay_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+}
+
+static uint16_t
+_ccnxTestrigReplayReader_Get16(const _CCNxTestrigReplayReader *reader, size_t offset)
+{
+    uint16_t value;
+    memcpy(&value, reader->map + offset, sizeof(value));
+    return reader->swapped ? __builtin_bswap16(value) : value;
+}
+
+static uint32_t
+_ccnxTestrigReplayReader_Get32(const _CCNxTestrigReplayReader *reader, size_t offset)
+{
+    uint32_t value;
+    memcpy(&value, reader->map + offset, sizeof(value));
+    return reader->swapped ? __builtin_bswap32(value) : value;
+}
+
+static uint64_t
+_ccnxTestrigReplayInterface_ToNanoseconds(const _CCNxTestrigReplayInterface *interface, uint64_t ticks)
+{
+    return (uint64_t) ((unsigned __int128) ticks * interface->numerator / interface->denominator);
+}
+
+/**
+ * Set the timestamp units of an interface from the value of an if_tsresol option: a power of ten,
+ * or a power of two when the high bit is set.
+ */
+static void
+_ccnxTestrigReplayInterface_SetResolution(_CCNxTestrigReplayInterface *interface, uint8_t resolution)
+{
+    uint8_t exponent = resolution & 0x7F;
+
+    interface->numerator = NSEC_PER_SEC;
+    interface->denominator = 1;
+    if (resolution & 0x80) {
+        if (exponent < 64) {
+            interface->denominator = 1ULL << exponent;
+        }
+    } else {
+        for (uint8_t i = 0; i < exponent && i < 19; i++) {
+            interface->denominator *= 10;
+        }
+    }
+}
+
+static bool
+_ccnxTestrigReplayReader_Open(_CCNxTestrigReplayReader *reader, const char *path)
+{
+    memset(reader, 0, sizeof(*reader));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size < PCAP_FILE_HEADER_LENGTH) {
+        fprintf(stderr, "Error: %s is not a capture file\n", path);
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror(path);
+        return false;
+    }
+    madvise(map, status.st_size, MADV_SEQUENTIAL);
+
+    reader->map = map;
+    reader->length = status.st_size;
+
+    uint32_t magic;
+    memcpy(&magic, reader->map, sizeof(magic));
+
+    if (magic == PCAPNG_SECTION_HEADER_BLOCK) {
+        // The section header is parsed as the first block.
+        reader->pcapng = true;
+        return true;
+    }
+
+    _CCNxTestrigReplayInterface *interface = &reader->interfaces[0];
+    if (magic == PCAP_MAGIC_MICROSECONDS || magic == PCAP_MAGIC_NANOSECONDS) {
+        reader->swapped = false;
+    } else if (__builtin_bswap32(magic) == PCAP_MAGIC_MICROSECONDS || __builtin_bswap32(magic) == PCAP_MAGIC_NANOSECONDS) {
+        reader->swapped = true;
+        magic = __builtin_bswap32(magic);
+    } else {
+        fprintf(stderr, "Error: %s is not a pcap or pcapng file\n", path);
+        munmap((void *) reader->map, reader->length);
+        return false;
+    }
+
+    // Classic pcap files have a single interface, and timestamps are split into seconds and fractions.
+    _ccnxTestrigReplayInterface_SetResolution(interface, magic == PCAP_MAGIC_NANOSECONDS ? 9 : 6);
+    interface->linkType = _ccnxTestrigReplayReader_Get32(reader, 20) & 0xFFFF;
+    reader->numberOfInterfaces = 1;
+    reader->offset = PCAP_FILE_HEADER_LENGTH;
+
+    return true;
+}
+
+static void
+_ccnxTestrigReplayReader_Close(_CCNxTestrigReplayReader *reader)
+{
+    munmap((void *) reader->map, reader->length);
+}
+
+/**
+ * Return the pages that have already been read, so that replaying a large capture does not fill memory.
+ */
+static void
+_ccnxTestrigReplayReader_Release(_CCNxTestrigReplayReader *reader)
+{
+    size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    size_t end = reader->offset & ~(pageSize - 1);
+
+    if (end >= reader->released + REPLAY_RELEASE_INTERVAL) {
+        madvise((void *) (reader->map + reader->released), end - reader->released, MADV_DONTNEED);
+        reader->released = end;
+    }
+}
+
+static bool
+_ccnxTestrigReplayReader_NextPcap(_CCNxTestrigReplayReader *reader, _CCNxTestrigReplayPacket *packet)
+{
+    if (reader->length - reader->offset < PCAP_RECORD_HEADER_LENGTH) {
+        return false;
+    }
+
+    size_t offset = reader->offset;
+    uint64_t seconds = _ccnxTestrigReplayReader_Get32(reader, offset);
+    uint64_t fraction = _ccnxTestrigReplayReader_Get32(reader, offset + 4);
+    uint32_t capturedLength = _ccnxTestrigReplayReader_Get32(reader, offset + 8);
+    uint32_t originalLength = _ccnxTestrigReplayReader_Get32(reader, offset + 12);
+
+    if (capturedLength > reader->length - offset - PCAP_RECORD_HEADER_LENGTH) {
+        reader->malformed = true;
+        return false;
+    }
+
+    packet->interface = 0;
+    packet->timestamp = seconds * NSEC_PER_SEC + _ccnxTestrigReplayInterface_ToNanoseconds(&reader->interfaces[0], fraction);
+    packet->data = reader->map + offset + PCAP_RECORD_HEADER_LENGTH;
+    packet->capturedLength = capturedLength;
+    packet->originalLength = originalLength;
+
+    reader->offset = offset + PCAP_RECORD_HEADER_LENGTH + capturedLength;
+    return true;
+}
+
+static void
+_ccnxTestrigReplayReader_AddInterface(_CCNxTestrigReplayReader *reader, size_t offset, size_t blockLength)
+{
+    if (reader->numberOfInterfaces >= REPLAY_MAX_INTERFACES || blockLength < 20) {
+        reader->numberOfInterfaces++;
+        return;
+    }
+
+    _CCNxTestrigReplayInterface *interface = &reader->interfaces[reader->numberOfInterfaces++];
+    interface->linkType = _ccnxTestrigReplayReader_Get16(reader, offset + 8);
+    _ccnxTestrigReplayInterface_SetResolution(interface, 6);
+
+    size_t option = offset + 16;
+    size_t end = offset + blockLength - 4;
+    while (option + 4 <= end) {
+        uint16_t code = _ccnxTestrigReplayReader_Get16(reader, option);
+        uint16_t length = _ccnxTestrigReplayReader_Get16(reader, option + 2);
+        if (code == 0 || option + 4 + length > end) {
+            break;
+        }
+        if (code == PCAPNG_OPTION_IF_TSRESOL && length == 1) {
+            _ccnxTestrigReplayInterface_SetResolution(interface, reader->map[option + 4]);
+        }
+        option += 4 + ((length + 3) & ~3U);
+    }
+}
+
+static bool
+_ccnxTestrigReplayReader_NextPcapng(_CCNxTestrigReplayReader *reader, _CCNxTestrigReplayPacket *packet)
+{
+    while (reader->length - reader->offset >= 12) {
+        size_t offset = reader->offset;
+
+        uint32_t type;
+        memcpy(&type, reader->map + offset, sizeof(type));
+        if (type == PCAPNG_SECTION_HEADER_BLOCK) {
+            // Each section declares its own byte order and interfaces.
+            uint32_t magic;
+            memcpy(&magic, reader->map + offset + 8, sizeof(magic));
+            if (magic != PCAPNG_BYTE_ORDER_MAGIC && __builtin_bswap32(magic) != PCAPNG_BYTE_ORDER_MAGIC) {
+                reader->malformed = true;
+                return false;
+            }
+            reader->swapped = magic != PCAPNG_BYTE_ORDER_MAGIC;
+            reader->numberOfInterfaces = 0;
+        } else {
+            type = _ccnxTestrigReplayReader_Get32(reader, offset);
+        }
+
+        uint32_t blockLength = _ccnxTestrigReplayReader_Get32(reader, offset + 4);
+        if (blockLength < 12 || blockLength % 4 != 0 || blockLength > reader->length - offset) {
+            reader->malformed = true;
+            return false;
+        }
+        reader->offset = offset + blockLength;
+
+        if (type == PCAPNG_INTERFACE_DESCRIPTION_BLOCK) {
+            _ccnxTestrigReplayReader_AddInterface(reader, offset, blockLength);
+        } else if (type == PCAPNG_ENHANCED_PACKET_BLOCK && blockLength >= 32) {
+            packet->interface = _ccnxTestrigReplayReader_Get32(reader, offset + 8);
+            uint64_t ticks = ((uint64_t) _ccnxTestrigReplayReader_Get32(reader, offset + 12) << 32) | _ccnxTestrigReplayReader_Get32(reader, offset + 16);
+            packet->capturedLength = _ccnxTestrigReplayReader_Get32(reader, offset + 20);
+            packet->originalLength = _ccnxTestrigReplayReader_Get32(reader, offset + 24);
+            packet->data = reader->map + offset + 28;
+
+            if (packet->capturedLength > blockLength - 32) {
+                reader->malformed = true;
+                return false;
+            }
+            if (packet->interface < reader->numberOfInterfaces && packet->interface < REPLAY_MAX_INTERFACES) {
+                reader->timestamp = _ccnxTestrigReplayInterface_ToNanoseconds(&reader->interfaces[packet->interface], ticks);
+            }
+            packet->timestamp = reader->timestamp;
+            return true;
+        } else if (type == PCAPNG_SIMPLE_PACKET_BLOCK && blockLength >= 16) {
+            // Simple packets are on the first interface and carry no timestamp.
+            packet->interface = 0;
+            packet->timestamp = reader->timestamp;
+            packet->originalLength = _ccnxTestrigReplayReader_Get32(reader, offset + 8);
+            packet->capturedLength = packet->originalLength < blockLength - 16 ? packet->originalLength : blockLength - 16;
+            packet->data = reader->map + offset + 12;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool
+_ccnxTestrigReplayReader_Next(_CCNxTestrigReplayReader *reader, _CCNxTestrigReplayPacket *packet)
+{
+    _ccnxTestrigReplayReader_Release(reader);
+    return reader->pcapng ? _ccnxTestrigReplayReader_NextPcapng(reader, packet) : _ccnxTestrigReplayReader_NextPcap(reader, packet);
+}
+
+/**
+ * Find the UDP payload of an IPv4 or IPv6 packet. Fragments and IPv6 extension headers are not followed.
+ */
+static const uint8_t *
+_ccnxTestrigReplay_UDPPayload(const uint8_t *ip, size_t length, size_t *payloadLength)
+{
+    size_t headerLength;
+
+    if (length >= 20 && (ip[0] >> 4) == 4) {
+        headerLength = (ip[0] & 0x0F) * 4;
+        bool fragment = ((ip[6] & 0x3F) | ip[7]) != 0;
+        if (ip[9] != IPPROTO_UDP_NUMBER || fragment || headerLength < 20) {
+            return NULL;
+        }
+    } else if (length >= 40 && (ip[0] >> 4) == 6) {
+        headerLength = 40;
+        if (ip[6] != IPPROTO_UDP_NUMBER) {
+            return NULL;
+        }
+    } else {
+        return NULL;
+    }
+
+    if (length < headerLength + 8) {
+        return NULL;
+    }
+    const uint8_t *udp = ip + headerLength;
+    size_t udpLength = ((size_t) udp[4] << 8) | udp[5];
+    if (udpLength < 8 || udpLength > length - headerLength) {
+        return NULL;
+    }
+
+    *payloadLength = udpLength - 8;
+    return udp + 8;
+}
+
+/**
+ * Find the CCNx packet in a captured frame, or return NULL if the frame does not carry one.
+ */
+static const uint8_t *
+_ccnxTestrigReplay_Payload(uint32_t linkType, const uint8_t *frame, size_t length, size_t *payloadLength)
+{
+    switch (linkType) {
+        case LINKTYPE_USER0:
+            *payloadLength = length;
+            return frame;
+        case LINKTYPE_RAW:
+        case LINKTYPE_IPV4:
+        case LINKTYPE_IPV6:
+            return _ccnxTestrigReplay_UDPPayload(frame, length, payloadLength);
+        case LINKTYPE_NULL:
+            // The 4-byte address family is in the byte order of the capturing host; the IP version is enough.
+            return length < 4 ? NULL : _ccnxTestrigReplay_UDPPayload(frame + 4, length - 4, payloadLength);
+        case LINKTYPE_LINUX_SLL:
+            return length < 16 ? NULL : _ccnxTestrigReplay_UDPPayload(frame + 16, length - 16, payloadLength);
+        case LINKTYPE_ETHERNET: {
+            size_t offset = 12;
+            if (length >= offset + 2 && (((uint16_t) frame[offset] << 8) | frame[offset + 1]) == ETHERTYPE_VLAN) {
+                offset += 4;
+            }
+            if (length < offset + 2) {
+                return NULL;
+            }
+            uint16_t etherType = ((uint16_t) frame[offset] << 8) | frame[offset + 1];
+            if (etherType != ETHERTYPE_IPV4 && etherType != ETHERTYPE_IPV6) {
+                return NULL;
+            }
+            return _ccnxTestrigReplay_UDPPayload(frame + offset + 2, length - offset - 2, payloadLength);
+        }
+        default:
+            return NULL;
+    }
+}
+
+static CCNxTestrigLink *
+_ccnxTestrigReplay_LinkOf(CCNxTestrig *rig, const CCNxTestrigLinkID *links, size_t numberOfLinks, uint32_t interface)
+{
+    if (interface >= numberOfLinks || links[interface] == CCNxTestrigLinkID_NULL) {
+        return NULL;
+    }
+    return ccnxTestrig_GetLinkByID(rig, links[interface]);
+}
+
+bool
+ccnxTestrigReplay_Run(CCNxTestrig *rig, const char *path, const CCNxTestrigLinkID *links, size_t numberOfLinks, double speed)
+{
+    _CCNxTestrigReplayReader reader;
+    if (!_ccnxTestrigReplayReader_Open(&reader, path)) {
+        return false;
+    }
+
+    CCNxTestrigReporter *reporter = ccnxTestrig_GetReporter(rig);
+    CCNxTestrigHistogram *drift = ccnxTestrigHistogram_Create();
+
+    uint64_t packetsSent = 0;
+    uint64_t bytesSent = 0;
+    uint64_t packetsSkipped = 0;
+    uint64_t sendFailures = 0;
+
+    uint64_t firstTimestamp = 0;
+    uint64_t lastTimestamp = 0;
+    bool first = true;
+
+    uint64_t start = _ccnxTestrigReplay_Now();
+    _CCNxTestrigReplayPacket packet;
+    while (_ccnxTestrigReplayReader_Next(&reader, &packet)) {
+        CCNxTestrigLink *link = _ccnxTestrigReplay_LinkOf(rig, links, numberOfLinks, packet.interface);
+        bool described = packet.interface < reader.numberOfInterfaces && packet.interface < REPLAY_MAX_INTERFACES;
+
+        size_t length = 0;
+        const uint8_t *payload = NULL;
+        if (link != NULL && described && packet.capturedLength == packet.originalLength) {
+            payload = _ccnxTestrigReplay_Payload(reader.interfaces[packet.interface].linkType, packet.data, packet.capturedLength, &length);
+        }
+        if (payload == NULL || length == 0) {
+            packetsSkipped++;
+            continue;
+        }
+
+        if (first) {
+            firstTimestamp = packet.timestamp;
+            first = false;
+        }
+        // Captures merged from several interfaces may step backwards; such packets are sent right away.
+        uint64_t offset = packet.timestamp > firstTimestamp ? packet.timestamp - firstTimestamp : 0;
+        if (packet.timestamp > lastTimestamp) {
+            lastTimestamp = packet.timestamp;
+        }
+
+        uint64_t due = start;
+        if (speed > 0) {
+            due = start + (uint64_t) (offset / speed);
+            if (due > _ccnxTestrigReplay_Now()) {
+                struct timespec wakeup = { .tv_sec = due / NSEC_PER_SEC, .tv_nsec = due % NSEC_PER_SEC };
+                clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL);
+            }
+        }
+
+        // The link only reads the packet, so it is sent straight from the mapped file.
+        PARCBuffer *buffer = parcBuffer_Wrap((void *) payload, length, 0, length);
+        uint64_t now = _ccnxTestrigReplay_Now();
+        if (speed > 0) {
+            ccnxTestrigHistogram_Record(drift, now > due ? now - due : 0);
+        }
+        if (ccnxTestrigLink_Send(link, buffer) >= 0) {
+            packetsSent++;
+            bytesSent += length;
+        } else {
+            sendFailures++;
+        }
+        parcBuffer_Release(&buffer);
+    }
+    uint64_t end = _ccnxTestrigReplay_Now();
+
+    if (reader.malformed) {
+        fprintf(stderr, "Warning: %s is truncated or malformed at offset %zu\n", path, reader.offset);
+    }
+    _ccnxTestrigReplayReader_Close(&reader);
+
+    double seconds = (double) (end - start) / NSEC_PER_SEC;
+    double captureSeconds = first ? 0.0 : (double) (lastTimestamp - firstTimestamp) / NSEC_PER_SEC;
+
+    char *message = NULL;
+    asprintf(&message, "Replayed %" PRIu64 " packets (%" PRIu64 " bytes) in %.3fs: %.0f pps, %.2f Mbps",
+             packetsSent, bytesSent, seconds,
+             seconds > 0 ? packetsSent / seconds : 0.0,
+             seconds > 0 ? bytesSent * 8 / seconds / 1000000 : 0.0);
+    ccnxTestrigReporter_Report(reporter, message);
+    free(message);
+
+    asprintf(&message, "Skipped %" PRIu64 " packets (unmapped, truncated or not CCNx over UDP), %" PRIu64 " send failures",
+             packetsSkipped, sendFailures);
+    ccnxTestrigReporter_Report(reporter, message);
+    free(message);
+
+    if (speed > 0) {
+        double target = captureSeconds / speed;
+        asprintf(&message, "Capture spans %.3fs, scheduled for %.3fs at %gx, finished %+.3fs from schedule",
+                 captureSeconds, target, speed, seconds - target);
+        ccnxTestrigReporter_Report(reporter, message);
+        free(message);
+
+        char *summary = ccnxTestrigHistogram_ToString(drift);
+        asprintf(&message, "Send lateness: %s", summary);
+        ccnxTestrigReporter_Report(reporter, message);
+        free(summary);
+        free(message);
+    }
+
+    ccnxTestrigHistogram_Release(&drift);
+    return true;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_Replay_h
+#define ccnxTestrig_Replay_h
+
+#include "ccnxTestrig.h"
+
+/**
+ * Send the packets of a pcap or pcapng capture through the links of the rig and report how faithfully it was replayed.
+ *
+ * Each capture interface is mapped to a link: packets captured on interface i are sent on
+ * @p links[i]. Packets on interfaces beyond @p numberOfLinks, or mapped to `CCNxTestrigLinkID_NULL`,
+ * are skipped. Captures of bare CCNx packets (LINKTYPE_USER0, as written by `ccnxTestrigCapture`)
+ * are replayed as they are; from Ethernet, Linux cooked and raw IP captures the UDP payload is
+ * replayed and other packets are skipped.
+ *
+ * With a @p speed greater than zero, each packet is sent when its offset from the first packet of
+ * the capture, divided by @p speed, has elapsed, so 1 keeps the original timing and 10 replays ten
+ * times as fast. With a @p speed of zero the packets are sent as fast as the links accept them.
+ *
+ * The file is mapped into memory and read once from start to end, so captures larger than memory
+ * can be replayed. At the end the achieved packet and bit rates are reported, along with how late
+ * the packets were sent compared to their schedule.
+ *
+ * @param [in] rig The `CCNxTestrig` whose links carry the packets.
+ * @param [in] path The pcap or pcapng file.
+ * @param [in] links The link of each capture interface.
+ * @param [in] numberOfLinks The number of entries in @p links.
+ * @param [in] speed The replay speed relative to the capture, or 0 for maximum rate.
+ *
+ * @return true if the capture was replayed, false if it could not be read.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrig *rig = ...
+ *
+ *     // Interface 0 on link A and interface 1 on link B, twice as fast as captured.
+ *     CCNxTestrigLinkID links[] = { CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_LinkB };
+ *     ccnxTestrigReplay_Run(rig, "forwarder.pcapng", links, 2, 2.0);
+ * }
+ * @endcode
+ */
+bool ccnxTestrigReplay_Run(CCNxTestrig *rig, const char *path, const CCNxTestrigLinkID *links, size_t numberOfLinks, double speed);
+#endif // ccnxTestrig_Replay_h
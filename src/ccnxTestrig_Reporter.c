@@ -56,18 +56,288 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "ccnxTestrig_Reporter.h"
 #include <parc/algol/parc_Object.h>
 
+// Records are written through a buffer of this size, so a long run costs one write per buffer.
+#define REPORT_BUFFER_SIZE (64 * 1024)
+
+/**
+ * The functions that write the records of one format.
+ */
+typedef struct {
+    void (*begin)(FILE *fp);
+    void (*message)(FILE *fp, const char *message);
+    void (*test)(FILE *fp, const CCNxTestrigReporterTest *test);
+    void (*end)(FILE *fp);
+} _CCNxTestrigReporterBackend;
+
 struct ccnx_testrig_reporter {
     FILE *fp;
+    const _CCNxTestrigReporterBackend *backend;
+
+    // The reporter opened fp, into buffer, and closes it.
+    bool ownsFile;
+    char *buffer;
+    bool closed;
+
+    // Records from concurrent tests are written one at a time.
+    pthread_mutex_t mutex;
+
+    // The reporter that everything reported to this one is forwarded to, or NULL.
+    CCNxTestrigReporter *next;
+};
+
+static void
+_ccnxTestrigReporter_WriteNothing(FILE *fp)
+{
+}
+
+static void
+_ccnxTestrigReporter_WriteJSONString(FILE *fp, const char *string)
+{
+    fputc('"', fp);
+    for (const unsigned char *c = (const unsigned char *) string; *c != '\0'; c++) {
+        switch (*c) {
+            case '"':
+                fputs("\\\"", fp);
+                break;
+            case '\\':
+                fputs("\\\\", fp);
+                break;
+            case '\n':
+                fputs("\\n", fp);
+                break;
+            case '\t':
+                fputs("\\t", fp);
+                break;
+            default:
+                if (*c < 0x20) {
+                    fprintf(fp, "\\u%04x", *c);
+                } else {
+                    fputc(*c, fp);
+                }
+                break;
+        }
+    }
+    fputc('"', fp);
+}
+
+static void
+_ccnxTestrigReporter_WriteXMLText(FILE *fp, const char *string)
+{
+    for (const unsigned char *c = (const unsigned char *) string; *c != '\0'; c++) {
+        switch (*c) {
+            case '&':
+                fputs("&amp;", fp);
+                break;
+            case '<':
+                fputs("&lt;", fp);
+                break;
+            case '>':
+                fputs("&gt;", fp);
+                break;
+            case '"':
+                fputs("&quot;", fp);
+                break;
+            default:
+                // XML 1.0 cannot carry the other control characters at all.
+                if (*c >= 0x20 || *c == '\n' || *c == '\t') {
+                    fputc(*c, fp);
+                }
+                break;
+        }
+    }
+}
+
+static bool
+_ccnxTestrigReporter_HasLatency(const CCNxTestrigReporterTest *test)
+{
+    return test->latency != NULL && ccnxTestrigHistogram_GetCount(test->latency) > 0;
+}
+
+// Text
+
+static void
+_ccnxTestrigReporter_TextMessage(FILE *fp, const char *message)
+{
+    fprintf(fp, "%s\n", message);
+}
+
+static void
+_ccnxTestrigReporter_TextTest(FILE *fp, const CCNxTestrigReporterTest *test)
+{
+    if (test->passed) {
+        fprintf(fp, "Test %s PASS\n", test->testCase);
+    } else {
+        fprintf(fp, "Test %s FAIL: %s\n", test->testCase, test->reason);
+    }
+
+    if (_ccnxTestrigReporter_HasLatency(test)) {
+        char *summary = ccnxTestrigHistogram_ToString(test->latency);
+        fprintf(fp, "Test %s latency: %s\n", test->testCase, summary);
+        free(summary);
+    }
+}
+
+static const _CCNxTestrigReporterBackend _ccnxTestrigReporter_Text = {
+    .begin = _ccnxTestrigReporter_WriteNothing,
+    .message = _ccnxTestrigReporter_TextMessage,
+    .test = _ccnxTestrigReporter_TextTest,
+    .end = _ccnxTestrigReporter_WriteNothing
+};
+
+// JSON Lines
+
+static void
+_ccnxTestrigReporter_JSONMessage(FILE *fp, const char *message)
+{
+    fputs("{\"type\":\"message\",\"message\":", fp);
+    _ccnxTestrigReporter_WriteJSONString(fp, message);
+    fputs("}\n", fp);
+}
+
+static void
+_ccnxTestrigReporter_JSONTest(FILE *fp, const CCNxTestrigReporterTest *test)
+{
+    fputs("{\"type\":\"test\",\"test\":", fp);
+    _ccnxTestrigReporter_WriteJSONString(fp, test->testCase);
+    fprintf(fp, ",\"verdict\":\"%s\"", test->passed ? "pass" : "fail");
+
+    if (test->failedStep > 0) {
+        fprintf(fp, ",\"step\":%zu", test->failedStep);
+    } else {
+        fputs(",\"step\":null", fp);
+    }
+
+    fputs(",\"reason\":", fp);
+    if (test->reason != NULL && !test->passed) {
+        _ccnxTestrigReporter_WriteJSONString(fp, test->reason);
+    } else {
+        fputs("null", fp);
+    }
+
+    fprintf(fp, ",\"duration_us\":%.1f,\"packets_sent\":%llu,\"packets_received\":%llu,\"memory_bytes\":%zu",
+            test->duration / 1000.0, (unsigned long long) test->packetsSent, (unsigned long long) test->packetsReceived,
+            test->memoryUsage);
+
+    if (_ccnxTestrigReporter_HasLatency(test)) {
+        const CCNxTestrigHistogram *latency = test->latency;
+        fprintf(fp, ",\"latency_us\":{\"n\":%llu,\"p50\":%.1f,\"p90\":%.1f,\"p99\":%.1f,\"p99_9\":%.1f,\"max\":%.1f}",
+                (unsigned long long) ccnxTestrigHistogram_GetCount(latency),
+                ccnxTestrigHistogram_GetValueAtPercentile(latency, 50.0) / 1000.0,
+                ccnxTestrigHistogram_GetValueAtPercentile(latency, 90.0) / 1000.0,
+                ccnxTestrigHistogram_GetValueAtPercentile(latency, 99.0) / 1000.0,
+                ccnxTestrigHistogram_GetValueAtPercentile(latency, 99.9) / 1000.0,
+                ccnxTestrigHistogram_GetMax(latency) / 1000.0);
+    } else {
+        fputs(",\"latency_us\":null", fp);
+    }
+
+    fputs("}\n", fp);
+}
+
+static const _CCNxTestrigReporterBackend _ccnxTestrigReporter_JSONLines = {
+    .begin = _ccnxTestrigReporter_WriteNothing,
+    .message = _ccnxTestrigReporter_JSONMessage,
+    .test = _ccnxTestrigReporter_JSONTest,
+    .end = _ccnxTestrigReporter_WriteNothing
+};
+
+// JUnit XML
+
+static void
+_ccnxTestrigReporter_JUnitBegin(FILE *fp)
+{
+    // The totals would have to be known before the first test case is written, so they are
+    // left for the consumer to count, as the JUnit tools allow.
+    fputs("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuite name=\"ccnxTestrig\">\n", fp);
+}
+
+static void
+_ccnxTestrigReporter_JUnitMessage(FILE *fp, const char *message)
+{
+    // A suite has no place for output between its test cases, so messages are kept as comments,
+    // which must not contain "--".
+    fputs("  <!-- ", fp);
+    for (const char *c = message; *c != '\0'; c++) {
+        fputc(*c, fp);
+        if (*c == '-' && c[1] == '-') {
+            fputc(' ', fp);
+        }
+    }
+    fputs(" -->\n", fp);
+}
+
+static void
+_ccnxTestrigReporter_JUnitTest(FILE *fp, const CCNxTestrigReporterTest *test)
+{
+    fputs("  <testcase classname=\"ccnxTestrig\" name=\"", fp);
+    _ccnxTestrigReporter_WriteXMLText(fp, test->testCase);
+    fprintf(fp, "\" time=\"%.6f\">\n", test->duration / 1000000000.0);
+
+    if (!test->passed) {
+        fputs("    <failure message=\"", fp);
+        _ccnxTestrigReporter_WriteXMLText(fp, test->reason != NULL ? test->reason : "");
+        if (test->failedStep > 0) {
+            fprintf(fp, "\">Failed at step %zu</failure>\n", test->failedStep);
+        } else {
+            fputs("\"/>\n", fp);
+        }
+    }
+
+    fprintf(fp, "    <system-out>sent %llu packets, received %llu packets, held %zu bytes",
+            (unsigned long long) test->packetsSent, (unsigned long long) test->packetsReceived, test->memoryUsage);
+    if (_ccnxTestrigReporter_HasLatency(test)) {
+        char *summary = ccnxTestrigHistogram_ToString(test->latency);
+        fprintf(fp, ", latency %s", summary);
+        free(summary);
+    }
+    fputs("</system-out>\n  </testcase>\n", fp);
+}
+
+static void
+_ccnxTestrigReporter_JUnitEnd(FILE *fp)
+{
+    fputs("</testsuite>\n", fp);
+}
+
+static const _CCNxTestrigReporterBackend _ccnxTestrigReporter_JUnit = {
+    .begin = _ccnxTestrigReporter_JUnitBegin,
+    .message = _ccnxTestrigReporter_JUnitMessage,
+    .test = _ccnxTestrigReporter_JUnitTest,
+    .end = _ccnxTestrigReporter_JUnitEnd
 };
 
+static const _CCNxTestrigReporterBackend *
+_ccnxTestrigReporter_GetBackend(CCNxTestrigReporterFormat format)
+{
+    switch (format) {
+        case CCNxTestrigReporterFormat_Text:
+            return &_ccnxTestrigReporter_Text;
+        case CCNxTestrigReporterFormat_JSONLines:
+            return &_ccnxTestrigReporter_JSONLines;
+        case CCNxTestrigReporterFormat_JUnit:
+            return &_ccnxTestrigReporter_JUnit;
+        default:
+            return NULL;
+    }
+}
+
 static bool
 _ccnxTestrigReporter_Destructor(CCNxTestrigReporter **reporterPtr)
 {
     CCNxTestrigReporter *reporter = *reporterPtr;
+
+    ccnxTestrigReporter_Close(reporter);
+    if (reporter->next != NULL) {
+        ccnxTestrigReporter_Release(&reporter->next);
+    }
+    free(reporter->buffer);
+    pthread_mutex_destroy(&reporter->mutex);
+
     return true;
 }
 
@@ -78,18 +348,119 @@ parcObject_Override(
 	CCNxTestrigReporter, PARCObject,
 	.destructor = (PARCObjectDestructor *) _ccnxTestrigReporter_Destructor);
 
-CCNxTestrigReporter *
-ccnxTestrigReporter_Create(FILE *fout)
+static CCNxTestrigReporter *
+_ccnxTestrigReporter_Create(FILE *fout, const _CCNxTestrigReporterBackend *backend)
 {
     CCNxTestrigReporter *reporter = parcObject_CreateInstance(CCNxTestrigReporter);
     if (reporter != NULL) {
         reporter->fp = fout;
+        reporter->backend = backend;
+        reporter->ownsFile = false;
+        reporter->buffer = NULL;
+        reporter->closed = false;
+        reporter->next = NULL;
+        pthread_mutex_init(&reporter->mutex, NULL);
+        reporter->backend->begin(reporter->fp);
+    }
+    return reporter;
+}
+
+CCNxTestrigReporter *
+ccnxTestrigReporter_Create(FILE *fout)
+{
+    return _ccnxTestrigReporter_Create(fout, &_ccnxTestrigReporter_Text);
+}
+
+CCNxTestrigReporter *
+ccnxTestrigReporter_Open(const char *path, CCNxTestrigReporterFormat format)
+{
+    const _CCNxTestrigReporterBackend *backend = _ccnxTestrigReporter_GetBackend(format);
+    if (backend == NULL) {
+        return NULL;
+    }
+
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        perror("fopen() failed");
+        return NULL;
+    }
+
+    char *buffer = malloc(REPORT_BUFFER_SIZE);
+    if (buffer != NULL) {
+        setvbuf(fp, buffer, _IOFBF, REPORT_BUFFER_SIZE);
     }
+
+    CCNxTestrigReporter *reporter = _ccnxTestrigReporter_Create(fp, backend);
+    if (reporter == NULL) {
+        fclose(fp);
+        free(buffer);
+        return NULL;
+    }
+    reporter->ownsFile = true;
+    reporter->buffer = buffer;
     return reporter;
 }
 
+CCNxTestrigReporterFormat
+ccnxTestrigReporter_ParseFormat(const char *name)
+{
+    if (strcmp(name, "text") == 0) {
+        return CCNxTestrigReporterFormat_Text;
+    } else if (strcmp(name, "jsonl") == 0) {
+        return CCNxTestrigReporterFormat_JSONLines;
+    } else if (strcmp(name, "junit") == 0) {
+        return CCNxTestrigReporterFormat_JUnit;
+    }
+    return CCNxTestrigReporterFormat_Invalid;
+}
+
+void
+ccnxTestrigReporter_Attach(CCNxTestrigReporter *reporter, CCNxTestrigReporter *other)
+{
+    while (reporter->next != NULL) {
+        reporter = reporter->next;
+    }
+    reporter->next = ccnxTestrigReporter_Acquire(other);
+}
+
 void
 ccnxTestrigReporter_Report(CCNxTestrigReporter *reporter, char *message)
 {
-    fprintf(reporter->fp, "%s\n", message);
+    for (; reporter != NULL; reporter = reporter->next) {
+        pthread_mutex_lock(&reporter->mutex);
+        if (!reporter->closed) {
+            reporter->backend->message(reporter->fp, message);
+        }
+        pthread_mutex_unlock(&reporter->mutex);
+    }
+}
+
+void
+ccnxTestrigReporter_ReportTest(CCNxTestrigReporter *reporter, const CCNxTestrigReporterTest *test)
+{
+    for (; reporter != NULL; reporter = reporter->next) {
+        pthread_mutex_lock(&reporter->mutex);
+        if (!reporter->closed) {
+            reporter->backend->test(reporter->fp, test);
+        }
+        pthread_mutex_unlock(&reporter->mutex);
+    }
+}
+
+void
+ccnxTestrigReporter_Close(CCNxTestrigReporter *reporter)
+{
+    for (; reporter != NULL; reporter = reporter->next) {
+        pthread_mutex_lock(&reporter->mutex);
+        if (!reporter->closed) {
+            reporter->backend->end(reporter->fp);
+            if (reporter->ownsFile) {
+                fclose(reporter->fp);
+            } else {
+                fflush(reporter->fp);
+            }
+            reporter->closed = true;
+        }
+        pthread_mutex_unlock(&reporter->mutex);
+    }
 }
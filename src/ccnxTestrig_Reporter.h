@@ -59,10 +59,55 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ccnxTestrig_Histogram.h"
 
 struct ccnx_testrig_reporter;
 typedef struct ccnx_testrig_reporter CCNxTestrigReporter;
 
+/**
+ * The format a `CCNxTestrigReporter` writes its records in.
+ */
+typedef enum {
+    // One line of text per record, for people.
+    CCNxTestrigReporterFormat_Text = 0,
+
+    // One JSON object per line per record.
+    CCNxTestrigReporterFormat_JSONLines = 1,
+
+    // A JUnit XML test suite, with one test case per test.
+    CCNxTestrigReporterFormat_JUnit = 2,
+    CCNxTestrigReporterFormat_Invalid = 3
+} CCNxTestrigReporterFormat;
+
+/**
+ * The outcome of one test, as reported by `ccnxTestrigReporter_ReportTest`.
+ */
+typedef struct {
+    const char *testCase;
+    bool passed;
+
+    // The step the test failed at, counting from 1, or 0 if it did not fail at a step.
+    size_t failedStep;
+
+    // The reason for the failure, or NULL if the test passed.
+    const char *reason;
+
+    // The time it took to run the test, in nanoseconds.
+    uint64_t duration;
+
+    uint64_t packetsSent;
+    uint64_t packetsReceived;
+
+    // The latencies of the packets the test received, or NULL if none were measured.
+    const CCNxTestrigHistogram *latency;
+
+    // The number of bytes the result of the test held.
+    size_t memoryUsage;
+} CCNxTestrigReporterTest;
+
 /**
  * Create a `CCNxTestrigReporter` that logs to the given FILE.
  *
@@ -79,6 +124,102 @@ typedef struct ccnx_testrig_reporter CCNxTestrigReporter;
  */
 CCNxTestrigReporter *ccnxTestrigReporter_Create(FILE *fout);
 
+/**
+ * Create a `CCNxTestrigReporter` that writes its records to the given file, in the given format.
+ *
+ * The file is written through a large buffer, and every record is written as soon as it is
+ * reported, so nothing is held back until the end of the run. A JUnit report is not complete
+ * until the reporter is closed.
+ *
+ * @param [in] path The name of the file, which is created or truncated.
+ * @param [in] format The format of the records.
+ *
+ * @return A newly allocated `CCNxTestrigReporter`, or NULL if the file could not be created.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigReporter *reporter = ccnxTestrigReporter_Open("results.jsonl", CCNxTestrigReporterFormat_JSONLines);
+ *
+ *     ccnxTestrigReporter_Close(reporter);
+ *     ccnxTestrigReporter_Release(&reporter);
+ * }
+ * @endcode
+ */
+CCNxTestrigReporter *ccnxTestrigReporter_Open(const char *path, CCNxTestrigReporterFormat format);
+
+/**
+ * Increase the number of references to a `CCNxTestrigReporter` instance.
+ *
+ * @param [in] reporter A `CCNxTestrigReporter` instance.
+ *
+ * @return The same value as @p reporter.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigReporter *handle = ccnxTestrigReporter_Acquire(reporter);
+ *
+ *     ccnxTestrigReporter_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigReporter *ccnxTestrigReporter_Acquire(const CCNxTestrigReporter *reporter);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigReporter` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The last release closes the reporter, if it was not closed already.
+ *
+ * @param [in,out] reporterPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigReporter *reporter = ccnxTestrigReporter_Create(stdout);
+ *
+ *     ccnxTestrigReporter_Release(&reporter);
+ * }
+ * @endcode
+ */
+void ccnxTestrigReporter_Release(CCNxTestrigReporter **reporterPtr);
+
+/**
+ * Parse the name of a report format: "text", "jsonl" or "junit".
+ *
+ * @param [in] name The name of the format.
+ *
+ * @return The format, or `CCNxTestrigReporterFormat_Invalid` if the name is not known.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigReporterFormat format = ccnxTestrigReporter_ParseFormat("junit");
+ * }
+ * @endcode
+ */
+CCNxTestrigReporterFormat ccnxTestrigReporter_ParseFormat(const char *name);
+
+/**
+ * Have a second reporter receive everything reported to this one.
+ *
+ * This is how a machine-readable report is written alongside the text on the console.
+ *
+ * @param [in] reporter A `CCNxTestrigReporter` instance.
+ * @param [in] other The `CCNxTestrigReporter` to forward to, which is acquired.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigReporter *junit = ccnxTestrigReporter_Open("results.xml", CCNxTestrigReporterFormat_JUnit);
+ *
+ *     ccnxTestrigReporter_Attach(ccnxTestrig_GetReporter(rig), junit);
+ * }
+ * @endcode
+ */
+void ccnxTestrigReporter_Attach(CCNxTestrigReporter *reporter, CCNxTestrigReporter *other);
+
 /**
  * Report a message.
  *
@@ -95,4 +236,44 @@ CCNxTestrigReporter *ccnxTestrigReporter_Create(FILE *fout);
  * @endcode
  */
 void ccnxTestrigReporter_Report(CCNxTestrigReporter *reporter, char *message);
+
+/**
+ * Report the outcome of a test.
+ *
+ * The record is written immediately, so the reporter keeps nothing of the test.
+ * Records may be reported from several threads.
+ *
+ * @param [in] reporter A `CCNxTestrigReporter` instance.
+ * @param [in] test The outcome of the test.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigReporterTest test = {
+ *         .testCase = "FIBTest_BasicInterest_1a",
+ *         .passed = true,
+ *         .duration = ccnxTestrig_GetTime() - startTime
+ *     };
+ *
+ *     ccnxTestrigReporter_ReportTest(reporter, &test);
+ * }
+ * @endcode
+ */
+void ccnxTestrigReporter_ReportTest(CCNxTestrigReporter *reporter, const CCNxTestrigReporterTest *test);
+
+/**
+ * Finish the report and flush it to its file.
+ *
+ * Attached reporters are closed as well. Nothing is written by a reporter after it is closed.
+ *
+ * @param [in] reporter A `CCNxTestrigReporter` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigReporter_Close(reporter);
+ * }
+ * @endcode
+ */
+void ccnxTestrigReporter_Close(CCNxTestrigReporter *reporter);
 #endif // ccnxTestrigReporter
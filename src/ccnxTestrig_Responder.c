@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <parc/algol/parc_Object.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/common/ccnx_ContentObject.h>
+
+#include "ccnxTestrig_Responder.h"
+#include "ccnxTestrig_BufferPool.h"
+#include "ccnxTestrig_PacketUtility.h"
+
+// The number of packets read from, and written to, the link at once.
+#define RESPONDER_BATCH_SIZE 32
+
+// The number of milliseconds the responder waits for Interests before checking whether it was stopped.
+#define RESPONDER_INTERVAL 50
+
+// Room left in each pooled response for the Name copied from the Interest.
+#define RESPONDER_NAME_ROOM 1024
+
+#define RESPONDER_POOL_CAPACITY 256
+
+// The fixed header packet type of an Interest.
+#define PACKET_TYPE_INTEREST 0
+
+struct ccnx_testrig_responder {
+    CCNxTestrigLink *link;
+
+    // The encoded template Content Object, split around its Name TLV.
+    PARCBuffer *template;
+    size_t messageOffset;
+    size_t nameOffset;
+    size_t nameLength;
+
+    CCNxTestrigBufferPool *responsePool;
+
+    pthread_t thread;
+    bool running;
+    bool stopRequested;
+
+    uint64_t interestCount;
+    uint64_t responseCount;
+};
+
+static bool
+_ccnxTestrigResponder_Destructor(CCNxTestrigResponder **responderPtr)
+{
+    CCNxTestrigResponder *responder = *responderPtr;
+
+    if (responder->responsePool != NULL) {
+        ccnxTestrigBufferPool_Release(&responder->responsePool);
+    }
+    parcBuffer_Release(&responder->template);
+    ccnxTestrigLink_Release(&responder->link);
+
+    return true;
+}
+
+parcObject_ImplementAcquire(ccnxTestrigResponder, CCNxTestrigResponder);
+parcObject_ImplementRelease(ccnxTestrigResponder, CCNxTestrigResponder);
+
+parcObject_Override(
+	CCNxTestrigResponder, PARCObject,
+	.destructor = (PARCObjectDestructor *) _ccnxTestrigResponder_Destructor);
+
+static PARCBuffer *
+_ccnxTestrigResponder_EncodeTemplate(size_t payloadSize)
+{
+    // The placeholder name is replaced by the name of each Interest.
+    CCNxName *name = ccnxName_CreateFromCString("ccnx:/template");
+    PARCBuffer *payload = parcBuffer_Allocate(payloadSize);
+    CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+
+    PARCBuffer *template = ccnxTestrigPacketUtility_EncodePacket(content);
+
+    ccnxContentObject_Release(&content);
+    parcBuffer_Release(&payload);
+    ccnxName_Release(&name);
+
+    return template;
+}
+
+CCNxTestrigResponder *
+ccnxTestrigResponder_Create(CCNxTestrigLink *link, size_t payloadSize)
+{
+    CCNxTestrigResponder *responder = parcObject_CreateInstance(CCNxTestrigResponder);
+
+    if (responder != NULL) {
+        responder->link = ccnxTestrigLink_Acquire(link);
+        responder->template = _ccnxTestrigResponder_EncodeTemplate(payloadSize);
+        responder->responsePool = NULL;
+        responder->running = false;
+        responder->stopRequested = false;
+        responder->interestCount = 0;
+        responder->responseCount = 0;
+
+        size_t templateLength = parcBuffer_Remaining(responder->template);
+        if (!ccnxTestrigPacketUtility_FindWireName(parcBuffer_Overlay(responder->template, 0), templateLength,
+                                                   &responder->messageOffset, &responder->nameOffset, &responder->nameLength)) {
+            fprintf(stderr, "Error: the template Content Object has no Name\n");
+            ccnxTestrigResponder_Release(&responder);
+            return NULL;
+        }
+
+        size_t responseCapacity = templateLength - responder->nameLength + RESPONDER_NAME_ROOM;
+        responder->responsePool = ccnxTestrigBufferPool_Create(RESPONDER_POOL_CAPACITY, responseCapacity);
+    }
+
+    return responder;
+}
+
+static void
+_writeUint16(uint8_t *bytes, size_t value)
+{
+    bytes[0] = (uint8_t) (value >> 8);
+    bytes[1] = (uint8_t) value;
+}
+
+static size_t
+_readUint16(const uint8_t *bytes)
+{
+    return ((size_t) bytes[0] << 8) | bytes[1];
+}
+
+static bool
+_ccnxTestrigResponder_IsInterest(PARCBuffer *packet)
+{
+    return parcBuffer_Remaining(packet) >= 8 && ((const uint8_t *) parcBuffer_Overlay(packet, 0))[1] == PACKET_TYPE_INTEREST;
+}
+
+/**
+ * Build the Content Object answering the given Interest, or return NULL if the Interest is malformed.
+ */
+static PARCBuffer *
+_ccnxTestrigResponder_Answer(CCNxTestrigResponder *responder, PARCBuffer *packet)
+{
+    const uint8_t *interest = parcBuffer_Overlay(packet, 0);
+    size_t interestLength = parcBuffer_Remaining(packet);
+
+    size_t messageOffset, nameOffset, nameLength;
+    if (!ccnxTestrigPacketUtility_FindWireName(interest, interestLength, &messageOffset, &nameOffset, &nameLength)) {
+        return NULL;
+    }
+
+    const uint8_t *template = parcBuffer_Overlay(responder->template, 0);
+    size_t templateLength = parcBuffer_Remaining(responder->template);
+    size_t responseLength = templateLength - responder->nameLength + nameLength;
+    if (responseLength > 0xFFFF) {
+        return NULL;
+    }
+
+    PARCBuffer *response = ccnxTestrigBufferPool_Get(responder->responsePool);
+    if (parcBuffer_Capacity(response) < responseLength) {
+        parcBuffer_Release(&response);
+        response = parcBuffer_Allocate(responseLength);
+    }
+
+    // Template up to its Name, the Interest's Name, then the rest of the template.
+    uint8_t *bytes = parcBuffer_Overlay(response, 0);
+    size_t tailOffset = responder->nameOffset + responder->nameLength;
+    memcpy(bytes, template, responder->nameOffset);
+    memcpy(bytes + responder->nameOffset, interest + nameOffset, nameLength);
+    memcpy(bytes + responder->nameOffset + nameLength, template + tailOffset, templateLength - tailOffset);
+
+    size_t messageLength = _readUint16(template + responder->messageOffset + 2) - responder->nameLength + nameLength;
+    _writeUint16(bytes + 2, responseLength);
+    _writeUint16(bytes + responder->messageOffset + 2, messageLength);
+
+    parcBuffer_SetLimit(response, responseLength);
+    return response;
+}
+
+static void *
+_ccnxTestrigResponder_Run(void *arg)
+{
+    CCNxTestrigResponder *responder = arg;
+    PARCBuffer *received[RESPONDER_BATCH_SIZE];
+    PARCBuffer *responses[RESPONDER_BATCH_SIZE];
+
+    while (!__atomic_load_n(&responder->stopRequested, __ATOMIC_ACQUIRE)) {
+        size_t count = ccnxTestrigLink_ReceiveBatch(responder->link, received, NULL, RESPONDER_BATCH_SIZE, RESPONDER_INTERVAL);
+
+        size_t numberOfInterests = 0;
+        size_t numberOfResponses = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (_ccnxTestrigResponder_IsInterest(received[i])) {
+                numberOfInterests++;
+                PARCBuffer *response = _ccnxTestrigResponder_Answer(responder, received[i]);
+                if (response != NULL) {
+                    responses[numberOfResponses++] = response;
+                }
+            }
+            parcBuffer_Release(&received[i]);
+        }
+
+        size_t sent = 0;
+        if (numberOfResponses > 0) {
+            sent = ccnxTestrigLink_SendBatch(responder->link, responses, numberOfResponses);
+            for (size_t i = 0; i < numberOfResponses; i++) {
+                parcBuffer_Release(&responses[i]);
+            }
+        }
+
+        __atomic_add_fetch(&responder->interestCount, numberOfInterests, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&responder->responseCount, sent, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+bool
+ccnxTestrigResponder_Start(CCNxTestrigResponder *responder)
+{
+    if (responder->running) {
+        return true;
+    }
+
+    responder->stopRequested = false;
+    if (pthread_create(&responder->thread, NULL, _ccnxTestrigResponder_Run, responder) != 0) {
+        perror("Unable to start the responder");
+        return false;
+    }
+    responder->running = true;
+    return true;
+}
+
+void
+ccnxTestrigResponder_Stop(CCNxTestrigResponder *responder)
+{
+    if (!responder->running) {
+        return;
+    }
+
+    __atomic_store_n(&responder->stopRequested, true, __ATOMIC_RELEASE);
+    pthread_join(responder->thread, NULL);
+    responder->running = false;
+}
+
+uint64_t
+ccnxTestrigResponder_GetInterestCount(const CCNxTestrigResponder *responder)
+{
+    return __atomic_load_n(&responder->interestCount, __ATOMIC_RELAXED);
+}
+
+uint64_t
+ccnxTestrigResponder_GetResponseCount(const CCNxTestrigResponder *responder)
+{
+    return __atomic_load_n(&responder->responseCount, __ATOMIC_RELAXED);
+}
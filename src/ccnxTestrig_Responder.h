@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_Responder_h
+#define ccnxTestrig_Responder_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ccnxTestrig_Link.h"
+
+struct ccnx_testrig_responder;
+typedef struct ccnx_testrig_responder CCNxTestrigResponder;
+
+/**
+ * Create a `CCNxTestrigResponder` that answers every Interest received on a link.
+ *
+ * A Content Object with a payload of @p payloadSize bytes is encoded once as a template.
+ * Each answer is that template with the Name of the Interest copied in, so Interests are
+ * answered without decoding or encoding them and without going through a script.
+ *
+ * @param [in] link The producer-side link to answer on.
+ * @param [in] payloadSize The number of payload bytes in each Content Object.
+ *
+ * @return A newly allocated `CCNxTestrigResponder` that must be freed by `ccnxTestrigResponder_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigResponder *responder = ccnxTestrigResponder_Create(ccnxTestrig_GetLinkByID(rig, CCNxTestrigLinkID_LinkB), 1024);
+ *
+ *     ccnxTestrigResponder_Release(&responder);
+ * }
+ * @endcode
+ */
+CCNxTestrigResponder *ccnxTestrigResponder_Create(CCNxTestrigLink *link, size_t payloadSize);
+
+/**
+ * Increase the number of references to a `CCNxTestrigResponder` instance.
+ *
+ * @param [in] responder A `CCNxTestrigResponder` instance.
+ *
+ * @return The same value as @p responder.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigResponder *handle = ccnxTestrigResponder_Acquire(responder);
+ *
+ *     ccnxTestrigResponder_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigResponder *ccnxTestrigResponder_Acquire(const CCNxTestrigResponder *responder);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigResponder` instance,
+ * decrementing the reference count for the instance.
+ *
+ * The responder must be stopped before the last reference is released.
+ *
+ * @param [in,out] responderPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigResponder *responder = ccnxTestrigResponder_Create(link, 1024);
+ *
+ *     ccnxTestrigResponder_Release(&responder);
+ * }
+ * @endcode
+ */
+void ccnxTestrigResponder_Release(CCNxTestrigResponder **responderPtr);
+
+/**
+ * Start answering Interests on a background thread.
+ *
+ * While it runs, the responder is the only reader of its link.
+ *
+ * @param [in] responder A `CCNxTestrigResponder` instance.
+ *
+ * @return true if the responder thread was started.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigResponder *responder = ccnxTestrigResponder_Create(link, 1024);
+ *     ccnxTestrigResponder_Start(responder);
+ * }
+ * @endcode
+ */
+bool ccnxTestrigResponder_Start(CCNxTestrigResponder *responder);
+
+/**
+ * Stop the responder thread and wait for it to exit.
+ *
+ * @param [in] responder A `CCNxTestrigResponder` instance.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigResponder_Start(responder);
+ *     ...
+ *     ccnxTestrigResponder_Stop(responder);
+ * }
+ * @endcode
+ */
+void ccnxTestrigResponder_Stop(CCNxTestrigResponder *responder);
+
+/**
+ * Retrieve the number of Interests the responder has received.
+ *
+ * The count may be read while the responder is running.
+ *
+ * @param [in] responder A `CCNxTestrigResponder` instance.
+ *
+ * @return The number of Interests received on the link.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t interests = ccnxTestrigResponder_GetInterestCount(responder);
+ * }
+ * @endcode
+ */
+uint64_t ccnxTestrigResponder_GetInterestCount(const CCNxTestrigResponder *responder);
+
+/**
+ * Retrieve the number of Content Objects the responder has sent.
+ *
+ * The count may be read while the responder is running.
+ *
+ * @param [in] responder A `CCNxTestrigResponder` instance.
+ *
+ * @return The number of Interests that were answered.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t responses = ccnxTestrigResponder_GetResponseCount(responder);
+ * }
+ * @endcode
+ */
+uint64_t ccnxTestrigResponder_GetResponseCount(const CCNxTestrigResponder *responder);
+#endif // ccnxTestrig_Responder_h
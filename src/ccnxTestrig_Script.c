@@ -55,8 +55,10 @@
 #include "ccnxTestrig_SuiteTestResult.h"
 #include "ccnxTestrig_Script.h"
 #include "ccnxTestrig_PacketUtility.h"
+#include "ccnxTestrig_Log.h"
 
 #include <parc/algol/parc_LinkedList.h>
+#include <parc/algol/parc_Memory.h>
 
 #include <ccnx/common/ccnx_Name.h>
 #include <ccnx/common/ccnx_Interest.h>
@@ -66,9 +68,15 @@
 #include <ccnx/transport/common/transport_MetaMessage.h>
 #include <ccnx/transport/common/transport_Message.h>
 
+// The number of milliseconds a receive step waits for packets on its links.
+#define RECEIVE_TIMEOUT 1000
+
 struct ccnx_testrig_script {
     char *testCase;
     PARCLinkedList *steps;
+
+    // Compiled by the first execution, and dropped whenever a step is added.
+    CCNxTestrigScriptPlan *plan;
 };
 
 static bool
@@ -78,6 +86,9 @@ _ccnxTestrigScript_Destructor(CCNxTestrigScript **resultPtr)
 
     parcMemory_Deallocate(&result->testCase);
     parcLinkedList_Release(&result->steps);
+    if (result->plan != NULL) {
+        ccnxTestrigScriptPlan_Release(&result->plan);
+    }
 
     return true;
 }
@@ -89,28 +100,48 @@ parcObject_Override(
 	CCNxTestrigScript, PARCObject,
 	.destructor = (PARCObjectDestructor *) _ccnxTestrigScript_Destructor);
 
+typedef enum {
+    _CCNxTestrigScriptOperation_Send,
+    _CCNxTestrigScriptOperation_ReceiveOne,
+    _CCNxTestrigScriptOperation_ReceiveAll,
+    _CCNxTestrigScriptOperation_ReceiveNone
+} _CCNxTestrigScriptOperation;
+
 struct ccnx_testrig_script_step {
     int stepIndex;
+    _CCNxTestrigScriptOperation operation;
+
+    // The packet a send step sends, or the template it is instantiated from.
     CCNxTlvDictionary *packet;
+    CCNxTestrigPacketTemplate *template;
 
-    // Step link information
+    // The link a send step sends on, or the links a receive step reads. A respond step has
+    // none: it sends on the link its reference received on.
     PARCBitVector *linkVector;
 
-    // Execute function pointer
-    CCNxTestrigSuiteTestResult *(*execute)(CCNxTestrigScriptStep *, CCNxTestrigSuiteTestResult *, CCNxTestrig *);
-
-    // Execute parameters
+    // The step that sent the packet a receive step expects, or the receive step a respond step answers.
     CCNxTestrigScriptStep *reference;
-
-    // Result parameters
-    PARCBitVector *receivedLinkVector;
 };
 
+// A step holds a reference to the step it refers to, which its destructor releases.
+void ccnxTestrigScriptStep_Release(CCNxTestrigScriptStep **stepPtr);
+
 static bool
 _ccnxTestrigScriptStep_Destructor(CCNxTestrigScriptStep **resultPtr)
 {
     CCNxTestrigScriptStep *step = *resultPtr;
-    parcBitVector_Release(&step->linkVector);
+    if (step->packet != NULL) {
+        ccnxTlvDictionary_Release(&step->packet);
+    }
+    if (step->template != NULL) {
+        ccnxTestrigPacketTemplate_Release(&step->template);
+    }
+    if (step->linkVector != NULL) {
+        parcBitVector_Release(&step->linkVector);
+    }
+    if (step->reference != NULL) {
+        ccnxTestrigScriptStep_Release(&step->reference);
+    }
     return true;
 }
 
@@ -121,95 +152,291 @@ parcObject_Override(
 	CCNxTestrigScriptStep, PARCObject,
 	.destructor = (PARCObjectDestructor *) _ccnxTestrigScriptStep_Destructor);
 
-static CCNxTestrigSuiteTestResult *
-_ccnxTestrigScript_ExecuteSendStep(CCNxTestrigScriptStep *step, CCNxTestrigSuiteTestResult *result, CCNxTestrig *rig)
-{
-    PARCBuffer *packetBuffer = ccnxTestrigPacketUtility_EncodePacket(step->packet);
-    unsigned linkMask = parcBitVector_NextBitSet(step->linkVector, 0);
-    ccnxTestrigLink_Send(ccnxTestrig_GetLinkByID(rig, linkMask), packetBuffer);
-    ccnxTestrigSuiteTestResult_LogPacket(result, packetBuffer);
-    return result;
-}
+// A link set of a compiled plan: bit n of word n / 64 is set for link n. Every set of a plan has
+// the plan's linkWords words, enough for the highest link the script uses.
+typedef uint64_t _CCNxTestrigScriptLinkSet;
 
-static CCNxTestrigSuiteTestResult *
-_ccnxTestrigScript_ExecuteReceiveAllStep(CCNxTestrigScriptStep *step, CCNxTestrigSuiteTestResult *result, CCNxTestrig *rig)
+// A compiled step. Links point into the plan's link sets, and the reference is the index of another
+// step of the same plan.
+typedef struct {
+    _CCNxTestrigScriptOperation operation;
+    _CCNxTestrigScriptLinkSet *links;
+    int reference;
+
+    CCNxTlvDictionary *packet;
+    PARCBuffer *wireFormat;
+    CCNxTestrigPacketTemplate *template;
+} _CCNxTestrigScriptPlanStep;
+
+// A plan is not changed once it is compiled. Everything an execution changes is in its own
+// _CCNxTestrigScriptExecution, so a plan can be executed by several threads at once.
+struct ccnx_testrig_script_plan {
+    char *testCase;
+
+    size_t numberOfSteps;
+    _CCNxTestrigScriptPlanStep *steps;
+
+    // Every template step of an execution shares one suffix, as long as the longest template needs.
+    size_t suffixLength;
+
+    // The highest link the script uses, and the words of each link set.
+    CCNxTestrigLinkID highestLink;
+    size_t linkWords;
+
+    // The links of each step, allocated together when the plan is compiled.
+    _CCNxTestrigScriptLinkSet *linkSets;
+};
+
+// What one execution of a plan records about a step.
+typedef struct {
+    PARCBuffer *templatePacket;
+    _CCNxTestrigScriptLinkSet *receivedLinks;
+    CCNxTestrigLinkID sentLink;
+    uint64_t sendTime;
+} _CCNxTestrigScriptExecutionStep;
+
+// The state of one execution of a plan, which lives for the duration of ccnxTestrigScriptPlan_Execute.
+typedef struct {
+    const CCNxTestrigScriptPlan *plan;
+    CCNxTestrig *rig;
+    _CCNxTestrigScriptExecutionStep *steps;
+    char *suffix;
+
+    // The received links of each step, followed by a set of pending links for the receive steps.
+    _CCNxTestrigScriptLinkSet *linkSets;
+    _CCNxTestrigScriptLinkSet *pendingLinks;
+
+    // Passes a step's link set to the rig's receive calls without allocating a vector each time.
+    PARCBitVector *receiveLinks;
+} _CCNxTestrigScriptExecution;
+
+static bool
+_ccnxTestrigScriptPlan_Destructor(CCNxTestrigScriptPlan **planPtr)
 {
-    bool succeeded = true;
-    int currentBit = -1;
-    for (size_t i = 0; i < parcBitVector_NumberOfBitsSet(step->linkVector); i++) {
-        currentBit = parcBitVector_NextBitSet(step->linkVector, currentBit + 1);
+    CCNxTestrigScriptPlan *plan = *planPtr;
 
-        CCNxTestrigLink *link = ccnxTestrig_GetLinkByID(rig, currentBit);
-        PARCBuffer *receiveBuffer = ccnxTestrigLink_ReceiveWithTimeout(link, 1000);
-        if (receiveBuffer == NULL) {
-            ccnxTestrigSuiteTestResult_SetFail(result, "Failed to receive a message in the allotted time.");
-            return result;
+    for (size_t i = 0; i < plan->numberOfSteps; i++) {
+        _CCNxTestrigScriptPlanStep *step = &plan->steps[i];
+        if (step->packet != NULL) {
+            ccnxTlvDictionary_Release(&step->packet);
+        }
+        if (step->wireFormat != NULL) {
+            parcBuffer_Release(&step->wireFormat);
+        }
+        if (step->template != NULL) {
+            ccnxTestrigPacketTemplate_Release(&step->template);
         }
+    }
+    free(plan->steps);
+    free(plan->linkSets);
+    free(plan->testCase);
 
-        parcBitVector_Set(step->receivedLinkVector, currentBit);
+    return true;
+}
 
-        CCNxTlvDictionary *referencedMessage = (step->reference)->packet;
-        CCNxMetaMessage *reconstructedMessage = ccnxMetaMessage_CreateFromWireFormatBuffer(receiveBuffer);
+parcObject_ImplementAcquire(ccnxTestrigScriptPlan, CCNxTestrigScriptPlan);
+parcObject_ImplementRelease(ccnxTestrigScriptPlan, CCNxTestrigScriptPlan);
 
-        // Check that the message types are equal
-        if (!(ccnxMetaMessage_IsInterest(reconstructedMessage) == ccnxTlvDictionary_IsInterest(referencedMessage))) {
-            ccnxTestrigSuiteTestResult_SetFail(result, "The received message type does not match the sent message type (INTEREST)");
-            return result;
-        }
-        if (!(ccnxMetaMessage_IsContentObject(reconstructedMessage) == ccnxTlvDictionary_IsContentObject(referencedMessage))) {
-            ccnxTestrigSuiteTestResult_SetFail(result, "The received message type does not match the sent message type (CONTENT)");
-            return result;
+parcObject_Override(
+	CCNxTestrigScriptPlan, PARCObject,
+	.destructor = (PARCObjectDestructor *) _ccnxTestrigScriptPlan_Destructor);
+
+static void
+_ccnxTestrigScriptLinkSet_Add(_CCNxTestrigScriptLinkSet *set, CCNxTestrigLinkID id)
+{
+    set[id / 64] |= 1ULL << (id % 64);
+}
+
+static void
+_ccnxTestrigScriptLinkSet_Remove(_CCNxTestrigScriptLinkSet *set, CCNxTestrigLinkID id)
+{
+    set[id / 64] &= ~(1ULL << (id % 64));
+}
+
+/**
+ * Return the lowest link of the set, or CCNxTestrigLinkID_NULL if the set is empty.
+ */
+static CCNxTestrigLinkID
+_ccnxTestrigScriptPlan_FirstLink(const CCNxTestrigScriptPlan *plan, const _CCNxTestrigScriptLinkSet *set)
+{
+    for (size_t word = 0; word < plan->linkWords; word++) {
+        if (set[word] != 0) {
+            return word * 64 + __builtin_ctzll(set[word]);
         }
-        if (!(ccnxMetaMessage_IsManifest(reconstructedMessage) == ccnxTlvDictionary_IsManifest(referencedMessage))) {
-            ccnxTestrigSuiteTestResult_SetFail(result, "The received message type does not match the sent message type (MANIFEST)");
-            return result;
+    }
+    return CCNxTestrigLinkID_NULL;
+}
+
+static PARCBitVector *
+_ccnxTestrigScriptExecution_LinkVector(_CCNxTestrigScriptExecution *execution, const _CCNxTestrigScriptLinkSet *set)
+{
+    parcBitVector_Reset(execution->receiveLinks);
+    for (size_t word = 0; word < execution->plan->linkWords; word++) {
+        for (uint64_t bits = set[word]; bits != 0; bits &= bits - 1) {
+            parcBitVector_Set(execution->receiveLinks, word * 64 + __builtin_ctzll(bits));
         }
+    }
+    return execution->receiveLinks;
+}
 
-        result = ccnxTestrigPacketUtility_IsValidPacketPair(referencedMessage, reconstructedMessage, result);
+/**
+ * Return the packet the step sends in this execution, either its template instantiated with the
+ * execution's suffix or its plain packet encoded by the compiler.
+ */
+static PARCBuffer *
+_ccnxTestrigScriptExecution_GetPacket(const _CCNxTestrigScriptExecution *execution, size_t index)
+{
+    const _CCNxTestrigScriptPlanStep *step = &execution->plan->steps[index];
+    return (step->template != NULL) ? execution->steps[index].templatePacket : step->wireFormat;
+}
+
+static CCNxTestrigSuiteTestResult *
+_ccnxTestrigScriptExecution_SendStep(_CCNxTestrigScriptExecution *execution, size_t index, CCNxTestrigSuiteTestResult *result)
+{
+    // A respond step answers on the link its reference received the packet on.
+    const _CCNxTestrigScriptPlanStep *step = &execution->plan->steps[index];
+    const _CCNxTestrigScriptLinkSet *links = (step->reference >= 0) ? execution->steps[step->reference].receivedLinks : step->links;
+    CCNxTestrigLinkID sentLink = _ccnxTestrigScriptPlan_FirstLink(execution->plan, links);
+    if (sentLink == CCNxTestrigLinkID_NULL) {
+        ccnxTestrigSuiteTestResult_SetFail(result, "There is no link to respond on.");
+        return result;
     }
 
+    PARCBuffer *packetBuffer = _ccnxTestrigScriptExecution_GetPacket(execution, index);
+    CCNxTestrigLink *link = ccnxTestrig_GetLinkByID(execution->rig, sentLink);
+    execution->steps[index].sentLink = sentLink;
+    execution->steps[index].sendTime = ccnxTestrigLink_GetTime(link);
+    ccnxTestrigLink_Send(link, packetBuffer);
+    ccnxTestrigSuiteTestResult_LogPacket(result, sentLink, packetBuffer);
+    ccnxTestrigSuiteTestResult_CountPackets(result, 1, 0);
     return result;
 }
 
+/**
+ * Return the packet the step sent, decoding it if it was made from a template.
+ */
+static CCNxTlvDictionary *
+_ccnxTestrigScriptExecution_AcquireSentPacket(const _CCNxTestrigScriptExecution *execution, size_t index)
+{
+    const _CCNxTestrigScriptPlanStep *step = &execution->plan->steps[index];
+    if (step->template == NULL) {
+        return ccnxTlvDictionary_Acquire(step->packet);
+    }
+
+    PARCBuffer *packet = parcBuffer_Duplicate(execution->steps[index].templatePacket);
+    CCNxTlvDictionary *message = ccnxMetaMessage_CreateFromWireFormatBuffer(packet);
+    parcBuffer_Release(&packet);
+    return message;
+}
+
 static CCNxTestrigSuiteTestResult *
-_ccnxTestrigScript_ExecuteReceiveOneStep(CCNxTestrigScriptStep *step, CCNxTestrigSuiteTestResult *result, CCNxTestrig *rig)
+_ccnxTestrigScriptExecution_ValidateReceivedPacket(_CCNxTestrigScriptExecution *execution, size_t index, PARCBuffer *receiveBuffer, CCNxTestrigSuiteTestResult *result)
 {
-    bool succeeded = false;
-    bool failedAfterReceive = false;
-    int currentBit = -1;
-    for (size_t i = 0; i < parcBitVector_NumberOfBitsSet(step->linkVector); i++) {
-        currentBit = parcBitVector_NextBitSet(step->linkVector, currentBit + 1);
+    ccnxTestrigSuiteTestResult_CountPackets(result, 0, 1);
 
-        CCNxTestrigLink *link = ccnxTestrig_GetLinkByID(rig, currentBit);
-        PARCBuffer *receiveBuffer = ccnxTestrigLink_ReceiveWithTimeout(link, 1000);
-        if (receiveBuffer == NULL) {
-            continue;
-        }
+    // A packet that was forwarded untouched is valid without decoding either packet.
+    int sendStep = execution->plan->steps[index].reference;
+    PARCBuffer *sentBuffer = _ccnxTestrigScriptExecution_GetPacket(execution, sendStep);
+    if (sentBuffer != NULL && ccnxTestrigPacketUtility_IsForwardedCopy(sentBuffer, receiveBuffer)) {
+        return result;
+    }
+    ccnxTestrigLog_Debug("The received packet differs from the sent one, decoding both");
+
+    CCNxTlvDictionary *referencedMessage = _ccnxTestrigScriptExecution_AcquireSentPacket(execution, sendStep);
+    CCNxMetaMessage *reconstructedMessage = ccnxMetaMessage_CreateFromWireFormatBuffer(receiveBuffer);
+
+    // Check that the message types are equal
+    if (!(ccnxMetaMessage_IsInterest(reconstructedMessage) == ccnxTlvDictionary_IsInterest(referencedMessage))) {
+        ccnxTestrigSuiteTestResult_SetFail(result, "The received message type does not match the sent message type (INTEREST)");
+    } else if (!(ccnxMetaMessage_IsContentObject(reconstructedMessage) == ccnxTlvDictionary_IsContentObject(referencedMessage))) {
+        ccnxTestrigSuiteTestResult_SetFail(result, "The received message type does not match the sent message type (CONTENT)");
+    } else if (!(ccnxMetaMessage_IsManifest(reconstructedMessage) == ccnxTlvDictionary_IsManifest(referencedMessage))) {
+        ccnxTestrigSuiteTestResult_SetFail(result, "The received message type does not match the sent message type (MANIFEST)");
+    } else {
+        result = ccnxTestrigPacketUtility_IsValidPacketPair(referencedMessage, reconstructedMessage, result);
+    }
 
-        parcBitVector_Set(step->receivedLinkVector, currentBit);
+    ccnxMetaMessage_Release(&reconstructedMessage);
+    ccnxTlvDictionary_Release(&referencedMessage);
+    return result;
+}
 
-        CCNxTlvDictionary *referencedMessage = (step->reference)->packet;
-        CCNxMetaMessage *reconstructedMessage = ccnxMetaMessage_CreateFromWireFormatBuffer(receiveBuffer);
+static void
+_ccnxTestrigScriptExecution_RecordLatency(_CCNxTestrigScriptExecution *execution, size_t index, CCNxTestrigSuiteTestResult *result, CCNxTestrigLinkID linkID)
+{
+    // Both times come from the links, so the latency leaves out the rig's wakeup and decoding.
+    uint64_t receiveTime = ccnxTestrig_GetReceiveTime(execution->rig);
+    const _CCNxTestrigScriptExecutionStep *sendStep = &execution->steps[execution->plan->steps[index].reference];
+    if (sendStep->sendTime != 0 && receiveTime >= sendStep->sendTime) {
+        ccnxTestrigSuiteTestResult_RecordLatency(result, sendStep->sentLink, linkID, receiveTime - sendStep->sendTime);
+    }
+}
 
-        // Check that the message types are equal
-        if (!(ccnxMetaMessage_IsInterest(reconstructedMessage) == ccnxTlvDictionary_IsInterest(referencedMessage))) {
-            ccnxTestrigSuiteTestResult_SetFail(result, "The received message type does not match the sent message type (INTEREST)");
-            return result;
-        }
-        if (!(ccnxMetaMessage_IsContentObject(reconstructedMessage) == ccnxTlvDictionary_IsContentObject(referencedMessage))) {
-            ccnxTestrigSuiteTestResult_SetFail(result, "The received message type does not match the sent message type (CONTENT)");
-            return result;
+static CCNxTestrigSuiteTestResult *
+_ccnxTestrigScriptExecution_ReceiveAllStep(_CCNxTestrigScriptExecution *execution, size_t index, CCNxTestrigSuiteTestResult *result)
+{
+    // All links share one deadline, and each link is read until it has produced one packet.
+    uint64_t deadline = ccnxTestrig_GetDeadline(RECEIVE_TIMEOUT);
+    const CCNxTestrigScriptPlan *plan = execution->plan;
+    _CCNxTestrigScriptLinkSet *pendingLinks = execution->pendingLinks;
+    memcpy(pendingLinks, plan->steps[index].links, plan->linkWords * sizeof(_CCNxTestrigScriptLinkSet));
+
+    while (_ccnxTestrigScriptPlan_FirstLink(plan, pendingLinks) != CCNxTestrigLinkID_NULL) {
+        CCNxTestrigLinkID linkID;
+        PARCBuffer *receiveBuffer = ccnxTestrig_ReceiveFromLinks(execution->rig, _ccnxTestrigScriptExecution_LinkVector(execution, pendingLinks), deadline, &linkID);
+        if (receiveBuffer == NULL) {
+            ccnxTestrigSuiteTestResult_SetFail(result, "Failed to receive a message in the allotted time.");
+            break;
         }
-        if (!(ccnxMetaMessage_IsManifest(reconstructedMessage) == ccnxTlvDictionary_IsManifest(referencedMessage))) {
-            ccnxTestrigSuiteTestResult_SetFail(result, "The received message type does not match the sent message type (MANIFEST)");
-            return result;
+
+        _ccnxTestrigScriptExecution_RecordLatency(execution, index, result, linkID);
+        _ccnxTestrigScriptLinkSet_Remove(pendingLinks, linkID);
+        _ccnxTestrigScriptLinkSet_Add(execution->steps[index].receivedLinks, linkID);
+
+        result = _ccnxTestrigScriptExecution_ValidateReceivedPacket(execution, index, receiveBuffer, result);
+        parcBuffer_Release(&receiveBuffer);
+        if (ccnxTestrigSuiteTestResult_IsFailure(result)) {
+            break;
         }
+    }
 
-        result = ccnxTestrigPacketUtility_IsValidPacketPair(referencedMessage, reconstructedMessage, result);
+    return result;
+}
+
+static CCNxTestrigSuiteTestResult *
+_ccnxTestrigScriptExecution_ReceiveOneStep(_CCNxTestrigScriptExecution *execution, size_t index, CCNxTestrigSuiteTestResult *result)
+{
+    bool succeeded = false;
+    bool failedAfterReceive = false;
+    const CCNxTestrigScriptPlan *plan = execution->plan;
+    _CCNxTestrigScriptLinkSet *pendingLinks = execution->pendingLinks;
+    memcpy(pendingLinks, plan->steps[index].links, plan->linkWords * sizeof(_CCNxTestrigScriptLinkSet));
+
+    // Wait for the first packet on any of the links. Once it has arrived, the remaining
+    // links only get one quiescence window to deliver their copies, so that copies sent
+    // together but read a little apart are still collected.
+    uint64_t deadline = ccnxTestrig_GetDeadline(RECEIVE_TIMEOUT);
+    CCNxTestrigLinkID linkID;
+    PARCBuffer *receiveBuffer = ccnxTestrig_ReceiveFromLinks(execution->rig, _ccnxTestrigScriptExecution_LinkVector(execution, pendingLinks), deadline, &linkID);
+    if (receiveBuffer != NULL) {
+        deadline = ccnxTestrig_GetDeadline(ccnxTestrig_GetQuiescence(execution->rig));
+    }
+    while (receiveBuffer != NULL) {
+        _ccnxTestrigScriptExecution_RecordLatency(execution, index, result, linkID);
+        _ccnxTestrigScriptLinkSet_Remove(pendingLinks, linkID);
+        _ccnxTestrigScriptLinkSet_Add(execution->steps[index].receivedLinks, linkID);
+
+        result = _ccnxTestrigScriptExecution_ValidateReceivedPacket(execution, index, receiveBuffer, result);
+        parcBuffer_Release(&receiveBuffer);
         if (!ccnxTestrigSuiteTestResult_IsFailure(result)) {
             succeeded = true;
         } else {
             failedAfterReceive = true;
+            break;
+        }
+
+        if (_ccnxTestrigScriptPlan_FirstLink(plan, pendingLinks) != CCNxTestrigLinkID_NULL) {
+            receiveBuffer = ccnxTestrig_ReceiveFromLinks(execution->rig, _ccnxTestrigScriptExecution_LinkVector(execution, pendingLinks), deadline, &linkID);
         }
     }
 
@@ -221,103 +448,75 @@ _ccnxTestrigScript_ExecuteReceiveOneStep(CCNxTestrigScriptStep *step, CCNxTestri
 }
 
 static CCNxTestrigSuiteTestResult *
-_ccnxTestrigScript_ExecuteReceiveNoneStep(CCNxTestrigScriptStep *step, CCNxTestrigSuiteTestResult *result, CCNxTestrig *rig)
+_ccnxTestrigScriptExecution_ReceiveNoneStep(_CCNxTestrigScriptExecution *execution, size_t index, CCNxTestrigSuiteTestResult *result)
 {
-    bool succeeded = false;
-    int currentBit = -1;
-    for (size_t i = 0; i < parcBitVector_NumberOfBitsSet(step->linkVector); i++) {
-        currentBit = parcBitVector_NextBitSet(step->linkVector, currentBit + 1);
-
-        PARCBuffer *receiveBuffer = ccnxTestrigLink_ReceiveWithTimeout(ccnxTestrig_GetLinkByID(rig, currentBit), 1000);
-        if (receiveBuffer != NULL) {
-            parcBitVector_Set(step->receivedLinkVector, currentBit);
-            ccnxTestrigSuiteTestResult_SetFail(result, "Received a message when we expected not to.");
-            break;
-        }
+    CCNxTestrigLinkID linkID;
+    PARCBitVector *links = _ccnxTestrigScriptExecution_LinkVector(execution, execution->plan->steps[index].links);
+    PARCBuffer *receiveBuffer = ccnxTestrig_ReceiveFromLinks(execution->rig, links, ccnxTestrig_GetDeadline(RECEIVE_TIMEOUT), &linkID);
+    if (receiveBuffer != NULL) {
+        _ccnxTestrigScriptLinkSet_Add(execution->steps[index].receivedLinks, linkID);
+        ccnxTestrigSuiteTestResult_CountPackets(result, 0, 1);
+        ccnxTestrigSuiteTestResult_SetFail(result, "Received a message when we expected not to.");
+        parcBuffer_Release(&receiveBuffer);
     }
     return result;
 }
 
 static CCNxTestrigSuiteTestResult *
-_ccnxTestrigScript_ExecuteStep(CCNxTestrigScriptStep *step, CCNxTestrigSuiteTestResult *result, CCNxTestrig *rig)
-{
-    return step->execute(step, result, rig);
-}
-
-static CCNxTestrigScriptStep *
-_ccnxTestrigScriptStep_CreateSendStep(int index, CCNxTestrigLinkID linkId, CCNxTlvDictionary *messageDictionary)
+_ccnxTestrigScriptExecution_ExecuteStep(_CCNxTestrigScriptExecution *execution, size_t index, CCNxTestrigSuiteTestResult *result)
 {
-    CCNxTestrigScriptStep *step = parcObject_CreateInstance(CCNxTestrigScriptStep);
-    if (step != NULL) {
-        step->stepIndex = index;
-        step->packet = ccnxTlvDictionary_Acquire(messageDictionary);
-        step->reference = NULL;
-        step->execute = _ccnxTestrigScript_ExecuteSendStep;
-
-        step->receivedLinkVector = parcBitVector_Create();
-        step->linkVector = parcBitVector_Create();
-        parcBitVector_Set(step->linkVector, linkId);
+    switch (execution->plan->steps[index].operation) {
+        case _CCNxTestrigScriptOperation_Send:
+            return _ccnxTestrigScriptExecution_SendStep(execution, index, result);
+        case _CCNxTestrigScriptOperation_ReceiveOne:
+            return _ccnxTestrigScriptExecution_ReceiveOneStep(execution, index, result);
+        case _CCNxTestrigScriptOperation_ReceiveAll:
+            return _ccnxTestrigScriptExecution_ReceiveAllStep(execution, index, result);
+        case _CCNxTestrigScriptOperation_ReceiveNone:
+            return _ccnxTestrigScriptExecution_ReceiveNoneStep(execution, index, result);
     }
-    return step;
+    return result;
 }
 
 static CCNxTestrigScriptStep *
-_ccnxTestrigScriptStep_CreateRespondStep(int index, CCNxTestrigScriptStep *reference, CCNxTlvDictionary *packet)
+_ccnxTestrigScriptStep_Create(int index, _CCNxTestrigScriptOperation operation, CCNxTestrigScriptStep *reference,
+                              CCNxTlvDictionary *packet, CCNxTestrigPacketTemplate *template, PARCBitVector *linkVector)
 {
     CCNxTestrigScriptStep *step = parcObject_CreateInstance(CCNxTestrigScriptStep);
     if (step != NULL) {
         step->stepIndex = index;
-        step->packet = ccnxTlvDictionary_Acquire(packet);
-        step->reference = NULL;
-        step->execute = _ccnxTestrigScript_ExecuteSendStep;
-        step->receivedLinkVector = parcBitVector_Create();
-        step->linkVector = parcBitVector_Acquire(reference->receivedLinkVector);
+        step->operation = operation;
+        step->packet = (packet != NULL) ? ccnxTlvDictionary_Acquire(packet) : NULL;
+        step->template = (template != NULL) ? ccnxTestrigPacketTemplate_Acquire(template) : NULL;
+        step->linkVector = (linkVector != NULL) ? parcBitVector_Acquire(linkVector) : NULL;
+        step->reference = (reference != NULL) ? ccnxTestrigScriptStep_Acquire(reference) : NULL;
     }
     return step;
 }
 
 static CCNxTestrigScriptStep *
-_ccnxTestrigScriptStep_CreateReceive(int index, CCNxTestrigScriptStep *reference, PARCBitVector *linkVector)
+_ccnxTestrigScript_AppendStep(CCNxTestrigScript *script, _CCNxTestrigScriptOperation operation, CCNxTestrigScriptStep *reference,
+                              CCNxTlvDictionary *packet, CCNxTestrigPacketTemplate *template, PARCBitVector *linkVector)
 {
-    CCNxTestrigScriptStep *step = parcObject_CreateInstance(CCNxTestrigScriptStep);
-    if (step != NULL) {
-        step->stepIndex = index;
-        step->packet = NULL;
-        step->reference = ccnxTestrigScriptStep_Acquire(reference);
-
-        step->linkVector = parcBitVector_Acquire(linkVector);
-        step->receivedLinkVector = parcBitVector_Create();
+    if (script->plan != NULL) {
+        ccnxTestrigScriptPlan_Release(&script->plan);
     }
-    return step;
-}
 
-static CCNxTestrigScriptStep *
-_ccnxTestrigScriptStep_CreateReceiveAllStep(int index, CCNxTestrigScriptStep *reference, PARCBitVector *linkVector)
-{
-    CCNxTestrigScriptStep *step = _ccnxTestrigScriptStep_CreateReceive(index, reference, linkVector);
-    if (step != NULL) {
-        step->execute = _ccnxTestrigScript_ExecuteReceiveAllStep;
-    }
+    size_t index = parcLinkedList_Size(script->steps);
+    CCNxTestrigScriptStep *step = _ccnxTestrigScriptStep_Create(index, operation, reference, packet, template, linkVector);
+    parcLinkedList_Append(script->steps, step);
     return step;
 }
 
 static CCNxTestrigScriptStep *
-_ccnxTestrigScriptStep_CreateReceiveNoneStep(int index, CCNxTestrigScriptStep *reference, PARCBitVector *linkVector)
+_ccnxTestrigScript_AppendSendStep(CCNxTestrigScript *script, CCNxTestrigLinkID linkId, CCNxTlvDictionary *packet, CCNxTestrigPacketTemplate *template)
 {
-    CCNxTestrigScriptStep *step = _ccnxTestrigScriptStep_CreateReceive(index, reference, linkVector);
-    if (step != NULL) {
-        step->execute = _ccnxTestrigScript_ExecuteReceiveNoneStep;
-    }
-    return step;
-}
+    PARCBitVector *linkVector = parcBitVector_Create();
+    parcBitVector_Set(linkVector, linkId);
 
-static CCNxTestrigScriptStep *
-_ccnxTestrigScriptStep_CreateReceiveOneStep(int index, CCNxTestrigScriptStep *reference, PARCBitVector *linkVector)
-{
-    CCNxTestrigScriptStep *step = _ccnxTestrigScriptStep_CreateReceive(index, reference, linkVector);
-    if (step != NULL) {
-        step->execute = _ccnxTestrigScript_ExecuteReceiveOneStep;
-    }
+    CCNxTestrigScriptStep *step = _ccnxTestrigScript_AppendStep(script, _CCNxTestrigScriptOperation_Send, NULL, packet, template, linkVector);
+
+    parcBitVector_Release(&linkVector);
     return step;
 }
 
@@ -330,73 +529,270 @@ ccnxTestrigScript_Create(char *testCase)
         result->testCase = malloc(strlen(testCase));
         strcpy(result->testCase, testCase);
         result->steps = parcLinkedList_Create();
+        result->plan = NULL;
     }
 
     return result;
 }
 
+const char *
+ccnxTestrigScript_GetTestCase(const CCNxTestrigScript *script)
+{
+    return script->testCase;
+}
+
 CCNxTestrigScriptStep *
 ccnxTestrigScript_AddSendStep(CCNxTestrigScript *script, CCNxTlvDictionary *messageDictionary, CCNxTestrigLinkID linkId)
 {
-    size_t index = parcLinkedList_Size(script->steps);
-    CCNxTestrigScriptStep *step = _ccnxTestrigScriptStep_CreateSendStep(index, linkId, messageDictionary);
-    parcLinkedList_Append(script->steps, step);
-    return step;
+    return _ccnxTestrigScript_AppendSendStep(script, linkId, messageDictionary, NULL);
 }
 
 CCNxTestrigScriptStep *
 ccnxTestrigScript_AddRespondStep(CCNxTestrigScript *script, CCNxTestrigScriptStep *step, CCNxTlvDictionary *packet)
 {
-    size_t index = parcLinkedList_Size(script->steps);
-    CCNxTestrigScriptStep *newStep = _ccnxTestrigScriptStep_CreateRespondStep(index, step, packet);
-    parcLinkedList_Append(script->steps, newStep);
-    return newStep;
+    return _ccnxTestrigScript_AppendStep(script, _CCNxTestrigScriptOperation_Send, step, packet, NULL, NULL);
+}
+
+CCNxTestrigScriptStep *
+ccnxTestrigScript_AddTemplateSendStep(CCNxTestrigScript *script, CCNxTestrigPacketTemplate *template, CCNxTestrigLinkID linkId)
+{
+    return _ccnxTestrigScript_AppendSendStep(script, linkId, NULL, template);
+}
+
+CCNxTestrigScriptStep *
+ccnxTestrigScript_AddTemplateRespondStep(CCNxTestrigScript *script, CCNxTestrigScriptStep *step, CCNxTestrigPacketTemplate *template)
+{
+    return _ccnxTestrigScript_AppendStep(script, _CCNxTestrigScriptOperation_Send, step, NULL, template, NULL);
 }
 
 CCNxTestrigScriptStep *
 ccnxTestrigScript_AddReceiveOneStep(CCNxTestrigScript *script, CCNxTestrigScriptStep *step, PARCBitVector *linkVector)
 {
-    size_t index = parcLinkedList_Size(script->steps);
-    CCNxTestrigScriptStep *newStep = _ccnxTestrigScriptStep_CreateReceiveOneStep(index, step, linkVector);
-    parcLinkedList_Append(script->steps, newStep);
-    return newStep;
+    return _ccnxTestrigScript_AppendStep(script, _CCNxTestrigScriptOperation_ReceiveOne, step, NULL, NULL, linkVector);
 }
 
 CCNxTestrigScriptStep *
 ccnxTestrigScript_AddReceiveNoneStep(CCNxTestrigScript *script, CCNxTestrigScriptStep *step, PARCBitVector *linkVector)
 {
-    size_t index = parcLinkedList_Size(script->steps);
-    CCNxTestrigScriptStep *newStep = _ccnxTestrigScriptStep_CreateReceiveNoneStep(index, step, linkVector);
-    parcLinkedList_Append(script->steps, newStep);
-    return newStep;
+    return _ccnxTestrigScript_AppendStep(script, _CCNxTestrigScriptOperation_ReceiveNone, step, NULL, NULL, linkVector);
 }
 
 CCNxTestrigScriptStep *
 ccnxTestrigScript_AddReceiveAllStep(CCNxTestrigScript *script, CCNxTestrigScriptStep *step, PARCBitVector *linkVector)
 {
-    size_t index = parcLinkedList_Size(script->steps);
-    CCNxTestrigScriptStep *newStep = _ccnxTestrigScriptStep_CreateReceiveAllStep(index, step, linkVector);
-    parcLinkedList_Append(script->steps, newStep);
-    return newStep;
+    return _ccnxTestrigScript_AppendStep(script, _CCNxTestrigScriptOperation_ReceiveAll, step, NULL, NULL, linkVector);
+}
+
+/**
+ * Check that a send step has something to send, and that a step only refers to an earlier step of
+ * the same script, of the kind its operation needs.
+ */
+static bool
+_ccnxTestrigScript_CheckStep(CCNxTestrigScriptStep **steps, size_t index)
+{
+    CCNxTestrigScriptStep *step = steps[index];
+    CCNxTestrigScriptStep *reference = step->reference;
+
+    if (step->operation == _CCNxTestrigScriptOperation_Send && step->packet == NULL && step->template == NULL) {
+        return false;
+    }
+    if (reference == NULL) {
+        // Only a plain send step and a receive none step can stand on their own.
+        return step->operation == _CCNxTestrigScriptOperation_ReceiveNone
+               || (step->operation == _CCNxTestrigScriptOperation_Send && step->linkVector != NULL);
+    }
+    if (reference->stepIndex < 0 || (size_t) reference->stepIndex >= index || steps[reference->stepIndex] != reference) {
+        return false;
+    }
+
+    // A respond step answers a receive step, and a receive step expects the packet of a send step.
+    if (step->operation == _CCNxTestrigScriptOperation_Send) {
+        return reference->operation != _CCNxTestrigScriptOperation_Send;
+    }
+    return reference->operation == _CCNxTestrigScriptOperation_Send;
+}
+
+CCNxTestrigScriptPlan *
+ccnxTestrigScript_Compile(CCNxTestrigScript *script, const CCNxTestrig *rig)
+{
+    size_t numberOfSteps = parcLinkedList_Size(script->steps);
+    CCNxTestrigScriptStep **steps = malloc(numberOfSteps * sizeof(CCNxTestrigScriptStep *));
+
+    PARCIterator *iterator = parcLinkedList_CreateIterator(script->steps);
+    for (size_t i = 0; parcIterator_HasNext(iterator); i++) {
+        steps[i] = parcIterator_Next(iterator);
+    }
+    parcIterator_Release(&iterator);
+
+    CCNxTestrigLinkID highestLink = CCNxTestrigLinkID_NULL;
+    for (size_t i = 0; i < numberOfSteps; i++) {
+        if (!_ccnxTestrigScript_CheckStep(steps, i)) {
+            fprintf(stderr, "Error: step %zu of %s is incomplete or refers to a step it cannot follow\n", i + 1, script->testCase);
+            free(steps);
+            return NULL;
+        }
+        if (steps[i]->linkVector != NULL) {
+            for (int id = parcBitVector_NextBitSet(steps[i]->linkVector, 0); id >= 0; id = parcBitVector_NextBitSet(steps[i]->linkVector, id + 1)) {
+                if (id > (int) highestLink) {
+                    highestLink = id;
+                }
+            }
+        }
+    }
+
+    // Every link a step names must exist, so that executions never look up a missing link.
+    if (highestLink > ccnxTestrig_GetNumberOfLinks(rig)) {
+        char name[CCNX_TESTRIG_LINK_NAME_LENGTH];
+        fprintf(stderr, "Error: %s uses link %s, but the rig has %zu links\n", script->testCase, ccnxTestrig_FormatLinkName(highestLink, name), ccnxTestrig_GetNumberOfLinks(rig));
+        free(steps);
+        return NULL;
+    }
+
+    CCNxTestrigScriptPlan *plan = parcObject_CreateInstance(CCNxTestrigScriptPlan);
+    if (plan == NULL) {
+        free(steps);
+        return NULL;
+    }
+
+    plan->testCase = strdup(script->testCase);
+    plan->numberOfSteps = numberOfSteps;
+    plan->steps = calloc(numberOfSteps, sizeof(_CCNxTestrigScriptPlanStep));
+    plan->suffixLength = 0;
+    plan->highestLink = highestLink;
+
+    plan->linkWords = plan->highestLink / 64 + 1;
+    plan->linkSets = calloc(numberOfSteps * plan->linkWords, sizeof(_CCNxTestrigScriptLinkSet));
+
+    for (size_t i = 0; i < numberOfSteps; i++) {
+        CCNxTestrigScriptStep *step = steps[i];
+        _CCNxTestrigScriptPlanStep *compiled = &plan->steps[i];
+
+        compiled->operation = step->operation;
+        compiled->links = &plan->linkSets[i * plan->linkWords];
+        if (step->linkVector != NULL) {
+            for (int id = parcBitVector_NextBitSet(step->linkVector, 0); id >= 0; id = parcBitVector_NextBitSet(step->linkVector, id + 1)) {
+                _ccnxTestrigScriptLinkSet_Add(compiled->links, id);
+            }
+        }
+        compiled->reference = (step->reference != NULL) ? step->reference->stepIndex : -1;
+
+        // Plain packets are encoded once here rather than on every execution.
+        if (step->packet != NULL) {
+            compiled->packet = ccnxTlvDictionary_Acquire(step->packet);
+            compiled->wireFormat = ccnxTestrigPacketUtility_EncodePacket(step->packet);
+        }
+        if (step->template != NULL) {
+            compiled->template = ccnxTestrigPacketTemplate_Acquire(step->template);
+            if (ccnxTestrigPacketTemplate_GetSuffixLength(step->template) > plan->suffixLength) {
+                plan->suffixLength = ccnxTestrigPacketTemplate_GetSuffixLength(step->template);
+            }
+        }
+    }
+
+    free(steps);
+    return plan;
+}
+
+/**
+ * Start an execution of the plan: patch a fresh suffix into the template steps, and claim the names of the
+ * packets we send, so that the forwarded packets are delivered to us when the rig is shared with other scripts.
+ */
+static void
+_ccnxTestrigScriptExecution_Start(_CCNxTestrigScriptExecution *execution, const CCNxTestrigScriptPlan *plan, CCNxTestrig *rig)
+{
+    execution->plan = plan;
+    execution->rig = rig;
+    execution->steps = calloc(plan->numberOfSteps, sizeof(_CCNxTestrigScriptExecutionStep));
+    execution->suffix = malloc(plan->suffixLength + 1);
+    execution->linkSets = calloc((plan->numberOfSteps + 1) * plan->linkWords, sizeof(_CCNxTestrigScriptLinkSet));
+    execution->pendingLinks = &execution->linkSets[plan->numberOfSteps * plan->linkWords];
+    execution->receiveLinks = parcBitVector_Create();
+
+    ccnxTestrigNameGenerator_NextSuffix(ccnxTestrig_GetNameGenerator(rig), execution->suffix, plan->suffixLength);
+
+    for (size_t i = 0; i < plan->numberOfSteps; i++) {
+        const _CCNxTestrigScriptPlanStep *step = &plan->steps[i];
+        execution->steps[i].receivedLinks = &execution->linkSets[i * plan->linkWords];
+
+        if (step->template != NULL) {
+            execution->steps[i].templatePacket = ccnxTestrigPacketTemplate_Instantiate(step->template, (const uint8_t *) execution->suffix);
+
+            // Shorter suffixes are a prefix of the shared one.
+            size_t suffixLength = ccnxTestrigPacketTemplate_GetSuffixLength(step->template);
+            char saved = execution->suffix[suffixLength];
+            execution->suffix[suffixLength] = '\0';
+            CCNxName *name = ccnxTestrigPacketTemplate_CreateName(step->template, execution->suffix);
+            execution->suffix[suffixLength] = saved;
+
+            ccnxTestrig_ClaimName(rig, name);
+            ccnxName_Release(&name);
+        } else if (step->packet != NULL) {
+            ccnxTestrig_ClaimName(rig, ccnxTestrigPacketUtility_GetName(step->packet));
+        }
+    }
+}
+
+static void
+_ccnxTestrigScriptExecution_Finish(_CCNxTestrigScriptExecution *execution)
+{
+    for (size_t i = 0; i < execution->plan->numberOfSteps; i++) {
+        if (execution->steps[i].templatePacket != NULL) {
+            parcBuffer_Release(&execution->steps[i].templatePacket);
+        }
+    }
+    free(execution->steps);
+    free(execution->suffix);
+    free(execution->linkSets);
+    parcBitVector_Release(&execution->receiveLinks);
 }
 
 CCNxTestrigSuiteTestResult *
-ccnxTestrigScript_Execute(CCNxTestrigScript *script, CCNxTestrig *rig)
+ccnxTestrigScriptPlan_Execute(const CCNxTestrigScriptPlan *plan, CCNxTestrig *rig)
 {
-    int numSteps = parcLinkedList_Size(script->steps);
-    CCNxTestrigSuiteTestResult *result = ccnxTestrigSuiteTestResult_Create(script->testCase);
+    uint64_t startTime = ccnxTestrig_GetTime();
+    CCNxTestrigSuiteTestResult *result = ccnxTestrigSuiteTestResult_Create(plan->testCase);
+    ccnxTestrigSuiteTestResult_SetPacketLog(result, ccnxTestrig_GetPacketLogCapacity(rig), ccnxTestrig_GetPacketLogSpill(rig));
+
+    _CCNxTestrigScriptExecution execution;
+    _ccnxTestrigScriptExecution_Start(&execution, plan, rig);
 
-    for (int i = 1; i <= numSteps; i++) {
-        printf(">> Executing step %d\n", i);
-        CCNxTestrigScriptStep *step = parcLinkedList_GetAtIndex(script->steps, i - 1);
-        result = _ccnxTestrigScript_ExecuteStep(step, result, rig);
+    for (size_t i = 1; i <= plan->numberOfSteps; i++) {
+        ccnxTestrigLog_Debug(">> Executing step %zu", i);
+        result = _ccnxTestrigScriptExecution_ExecuteStep(&execution, i - 1, result);
 
         // If the last step failed, stop the test and return the failure.
         if (ccnxTestrigSuiteTestResult_IsFailure(result)) {
-            printf(">> **** Failed at step %d\n", i);
+            ccnxTestrigLog_Info(">> **** Failed at step %zu", i);
+            ccnxTestrigSuiteTestResult_SetFailedStep(result, i);
+            break;
+        }
+    }
+
+    _ccnxTestrigScriptExecution_Finish(&execution);
+    ccnxTestrigSuiteTestResult_SetDuration(result, ccnxTestrig_GetTime() - startTime);
+    return ccnxTestrigSuiteTestResult_IsFailure(result) ? result : ccnxTestrigSuiteTestResult_SetPass(result);
+}
+
+CCNxTestrigSuiteTestResult *
+ccnxTestrigScript_Execute(CCNxTestrigScript *script, CCNxTestrig *rig)
+{
+    // The first execution compiles the script. Should two threads race to do it, the plan of
+    // the loser is dropped in favor of the one that was published first.
+    CCNxTestrigScriptPlan *plan = __atomic_load_n(&script->plan, __ATOMIC_ACQUIRE);
+    if (plan == NULL) {
+        plan = ccnxTestrigScript_Compile(script, rig);
+        if (plan == NULL) {
+            CCNxTestrigSuiteTestResult *result = ccnxTestrigSuiteTestResult_Create(script->testCase);
+            ccnxTestrigSuiteTestResult_SetFail(result, "The script could not be compiled.");
             return result;
         }
+
+        CCNxTestrigScriptPlan *published = NULL;
+        if (!__atomic_compare_exchange_n(&script->plan, &published, plan, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            ccnxTestrigScriptPlan_Release(&plan);
+            plan = published;
+        }
     }
 
-    return ccnxTestrigSuiteTestResult_SetPass(result);
+    return ccnxTestrigScriptPlan_Execute(plan, rig);
 }
@@ -57,6 +57,7 @@
 
 #include "ccnxTestrig_SuiteTestResult.h"
 #include "ccnxTestrig.h"
+#include "ccnxTestrig_PacketTemplate.h"
 
 #include <ccnx/common/ccnx_Interest.h>
 #include <ccnx/common/ccnx_ContentObject.h>
@@ -69,6 +70,9 @@ typedef struct ccnx_testrig_script CCNxTestrigScript;
 struct ccnx_testrig_script_step;
 typedef struct ccnx_testrig_script_step CCNxTestrigScriptStep;
 
+struct ccnx_testrig_script_plan;
+typedef struct ccnx_testrig_script_plan CCNxTestrigScriptPlan;
+
 /**
  * Create an empty test script for the given test case.
  *
@@ -83,6 +87,57 @@ typedef struct ccnx_testrig_script_step CCNxTestrigScriptStep;
  */
 CCNxTestrigScript *ccnxTestrigScript_Create(char *testCase);
 
+/**
+ * Increase the number of references to a `CCNxTestrigScript` instance.
+ *
+ * @param [in] script A `CCNxTestrigScript` instance.
+ *
+ * @return The same value as @p script.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigScript *handle = ccnxTestrigScript_Acquire(script);
+ *
+ *     ccnxTestrigScript_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigScript *ccnxTestrigScript_Acquire(const CCNxTestrigScript *script);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigScript` instance,
+ * decrementing the reference count for the instance.
+ *
+ * @param [in,out] scriptPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigScript *script = ccnxTestrigScript_Create("test case");
+ *
+ *     ccnxTestrigScript_Release(&script);
+ * }
+ * @endcode
+ */
+void ccnxTestrigScript_Release(CCNxTestrigScript **scriptPtr);
+
+/**
+ * Retrieve the name of the test case the script was created for.
+ *
+ * @param [in] script A `CCNxTestrigScript` instance.
+ *
+ * @return The test case name, which remains owned by the script.
+ *
+ * Example:
+ * @code
+ * {
+ *     printf("Running %s\n", ccnxTestrigScript_GetTestCase(script));
+ * }
+ * @endcode
+ */
+const char *ccnxTestrigScript_GetTestCase(const CCNxTestrigScript *script);
+
 /**
  * Add a "send step" to the test case. When executed, this will send the specified
  * packet to the specified link.
@@ -121,7 +176,7 @@ CCNxTestrigScriptStep *ccnxTestrigScript_AddSendStep(CCNxTestrigScript *script,
  *     CCNxTestrigScript *script = ccnxTestrigScript_Create("test case");
  *
  *     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
- *     CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+ *     CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
  *
  *     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddRespondStep(script, step2, content);
  * }
@@ -129,6 +184,51 @@ CCNxTestrigScriptStep *ccnxTestrigScript_AddSendStep(CCNxTestrigScript *script,
  */
 CCNxTestrigScriptStep *ccnxTestrigScript_AddRespondStep(CCNxTestrigScript *script, CCNxTestrigScriptStep *step, CCNxTlvDictionary *packet);
 
+/**
+ * Add a "send step" that sends a packet produced from a template.
+ *
+ * Every execution of the script draws one new name suffix, which all of its template
+ * steps share. An Interest and a Content Object made from the same name therefore still
+ * match after their suffixes have been replaced.
+ *
+ * @param [in] script A `CCNxTestrigScript` instance.
+ * @param [in] template The `CCNxTestrigPacketTemplate` to send from.
+ * @param [in] linkId The link to which the packet should be sent.
+ *
+ * @return The `CCNxTestrigScriptStep` instance that refers to this step.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigPacketTemplate *template = ccnxTestrig_GetPacketTemplate(rig, "interest/b");
+ *     CCNxTestrigScriptStep *sendStep = ccnxTestrigScript_AddTemplateSendStep(script, template, CCNxTestrigLinkID_LinkA);
+ * }
+ * @endcode
+ */
+CCNxTestrigScriptStep *ccnxTestrigScript_AddTemplateSendStep(CCNxTestrigScript *script, CCNxTestrigPacketTemplate *template, CCNxTestrigLinkID linkId);
+
+/**
+ * Add a "respond step" that sends a packet produced from a template to the links that
+ * received packets in the referenced step.
+ *
+ * @param [in] script A `CCNxTestrigScript` instance.
+ * @param [in] step The referenced `CCNxTestrigScriptStep` instance.
+ * @param [in] template The `CCNxTestrigPacketTemplate` to send from.
+ *
+ * @return The `CCNxTestrigScriptStep` instance that refers to this step.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddTemplateSendStep(script, interestTemplate, CCNxTestrigLinkID_LinkA);
+ *     CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
+ *
+ *     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddTemplateRespondStep(script, step2, contentTemplate);
+ * }
+ * @endcode
+ */
+CCNxTestrigScriptStep *ccnxTestrigScript_AddTemplateRespondStep(CCNxTestrigScript *script, CCNxTestrigScriptStep *step, CCNxTestrigPacketTemplate *template);
+
 /**
  * Add a "receive one step" to the test case. When executed, this step will receive a packet
  * from one of the specified links and verify that it matches that which was sent in the
@@ -146,7 +246,7 @@ CCNxTestrigScriptStep *ccnxTestrigScript_AddRespondStep(CCNxTestrigScript *scrip
  *     CCNxTestrigScript *script = ccnxTestrigScript_Create("test case");
  *     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
  *
- *     CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC));
+ *     CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC, CCNxTestrigLinkID_NULL));
  * }
  * @endcode
  */
@@ -169,7 +269,7 @@ CCNxTestrigScriptStep *ccnxTestrigScript_AddReceiveOneStep(CCNxTestrigScript *sc
  *     CCNxTestrigScript *script = ccnxTestrigScript_Create("test case");
  *     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
  *
- *     CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveNoneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_LinkC));
+ *     CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveNoneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_LinkC, CCNxTestrigLinkID_NULL));
  * }
  * @endcode
  */
@@ -193,7 +293,7 @@ CCNxTestrigScriptStep *ccnxTestrigScript_AddReceiveNoneStep(CCNxTestrigScript *s
  *     CCNxTestrigScript *script = ccnxTestrigScript_Create("test case");
  *     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
  *
- *     CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveNoneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC));
+ *     CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveNoneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC, CCNxTestrigLinkID_NULL));
  * }
  * @endcode
  */
@@ -202,6 +302,10 @@ CCNxTestrigScriptStep *ccnxTestrigScript_AddReceiveAllStep(CCNxTestrigScript *sc
 /**
  * Execute the test script and return the result.
  *
+ * The script is compiled by its first execution, and the plan is kept for the later ones
+ * until a step is added to the script. Later executions must therefore be on the same rig,
+ * or a view of it.
+ *
  * @param [in] script A `CCNxTestrigScript` instance.
  * @param [in] rig A `CCNxTestrig` instance.
  *
@@ -219,4 +323,90 @@ CCNxTestrigScriptStep *ccnxTestrigScript_AddReceiveAllStep(CCNxTestrigScript *sc
  * @endcode
  */
 CCNxTestrigSuiteTestResult *ccnxTestrigScript_Execute(CCNxTestrigScript *script, CCNxTestrig *rig);
+
+/**
+ * Compile a script into a plan that can be executed any number of times on the given rig.
+ *
+ * The plan holds the steps in a contiguous array, with their links as bitmasks and their
+ * references resolved to step indices. Plain packets are encoded once, here. Later changes
+ * to the script do not affect the plan.
+ *
+ * @param [in] script A `CCNxTestrigScript` instance.
+ * @param [in] rig The `CCNxTestrig`, or a view of it, that the plan will be executed on.
+ *
+ * @retval A newly allocated `CCNxTestrigScriptPlan` that must be freed by `ccnxTestrigScriptPlan_Release`.
+ * @retval NULL if a step has nothing to send, refers to a later step, a step of another script or a step of the wrong kind,
+ *         or names a link beyond the links of @p rig. The reason is printed.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigScriptPlan *plan = ccnxTestrigScript_Compile(script, rig);
+ *
+ *     ccnxTestrigScriptPlan_Release(&plan);
+ * }
+ * @endcode
+ */
+CCNxTestrigScriptPlan *ccnxTestrigScript_Compile(CCNxTestrigScript *script, const CCNxTestrig *rig);
+
+/**
+ * Increase the number of references to a `CCNxTestrigScriptPlan` instance.
+ *
+ * @param [in] plan A `CCNxTestrigScriptPlan` instance.
+ *
+ * @return The same value as @p plan.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigScriptPlan *handle = ccnxTestrigScriptPlan_Acquire(plan);
+ *
+ *     ccnxTestrigScriptPlan_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigScriptPlan *ccnxTestrigScriptPlan_Acquire(const CCNxTestrigScriptPlan *plan);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigScriptPlan` instance,
+ * decrementing the reference count for the instance.
+ *
+ * @param [in,out] planPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigScriptPlan *plan = ccnxTestrigScript_Compile(script, rig);
+ *
+ *     ccnxTestrigScriptPlan_Release(&plan);
+ * }
+ * @endcode
+ */
+void ccnxTestrigScriptPlan_Release(CCNxTestrigScriptPlan **planPtr);
+
+/**
+ * Execute a compiled plan against the given `CCNxTestrig` and return the result.
+ *
+ * Each execution draws a new suffix for the template steps and keeps its state apart from the
+ * plan, which it does not change. A plan can therefore be executed repeatedly, and by several
+ * threads at once.
+ *
+ * @param [in] plan A `CCNxTestrigScriptPlan` instance.
+ * @param [in] rig The `CCNxTestrig` the plan was compiled for, or a view of it.
+ *
+ * @return A new `CCNxTestrigSuiteTestResult` that must be released by `ccnxTestrigSuiteTestResult_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigScriptPlan *plan = ccnxTestrigScript_Compile(script, rig);
+ *     for (int i = 0; i < 1000; i++) {
+ *         CCNxTestrigSuiteTestResult *result = ccnxTestrigScriptPlan_Execute(plan, rig);
+ *         ccnxTestrigSuiteTestResult_Release(&result);
+ *     }
+ *     ccnxTestrigScriptPlan_Release(&plan);
+ * }
+ * @endcode
+ */
+CCNxTestrigSuiteTestResult *ccnxTestrigScriptPlan_Execute(const CCNxTestrigScriptPlan *plan, CCNxTestrig *rig);
 #endif
@@ -0,0 +1,794 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/common/ccnx_Interest.h>
+#include <ccnx/common/ccnx_ContentObject.h>
+
+#include "ccnxTestrig_ScriptLoader.h"
+#include "ccnxTestrig_PacketTemplate.h"
+
+#define PLAN_MAGIC "CTRPLAN"
+#define PLAN_VERSION 2
+
+#define SCRIPT_EXTENSION ".script"
+
+// The placeholder for the suffix that each execution patches into the packet names.
+#define SUFFIX_LENGTH 32
+
+#define INTEREST_LIFETIME 1000
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+typedef enum {
+    _CCNxTestrigPlanPacket_Interest,
+    _CCNxTestrigPlanPacket_ContentObject
+} _CCNxTestrigPlanPacketKind;
+
+typedef enum {
+    _CCNxTestrigPlanStep_Send,
+    _CCNxTestrigPlanStep_Respond,
+    _CCNxTestrigPlanStep_ReceiveOne,
+    _CCNxTestrigPlanStep_ReceiveAll,
+    _CCNxTestrigPlanStep_ReceiveNone
+} _CCNxTestrigPlanStepOperation;
+
+// A cached plan is this header, the packet records, the step records, the link table and then the
+// string table. Strings are referred to by their offset in the table, and each step names its links
+// by a range of the link table.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t numberOfPackets;
+    uint32_t numberOfSteps;
+    uint32_t stringsLength;
+    uint32_t testCase;
+    uint32_t numberOfLinks;
+    uint64_t sourceHash;
+} _CCNxTestrigPlanHeader;
+
+typedef struct {
+    uint32_t kind;
+    uint32_t payloadSize;
+    uint32_t label;
+    uint32_t prefix;
+} _CCNxTestrigPlanPacket;
+
+typedef struct {
+    uint32_t operation;
+    int32_t reference;
+    int32_t packet;
+    uint32_t links;
+    uint32_t numberOfLinks;
+} _CCNxTestrigPlanStep;
+
+// A parsed script, either built by the parser or pointing into a mapped plan file.
+typedef struct {
+    _CCNxTestrigPlanHeader header;
+    const _CCNxTestrigPlanPacket *packets;
+    const _CCNxTestrigPlanStep *steps;
+    const uint32_t *links;
+    const char *strings;
+} _CCNxTestrigPlanImage;
+
+typedef struct {
+    const char *path;
+    int line;
+    size_t rigLinks;
+    bool hasTestCase;
+    uint32_t testCase;
+
+    _CCNxTestrigPlanPacket *packets;
+    size_t numberOfPackets;
+
+    _CCNxTestrigPlanStep *steps;
+    char **stepLabels;
+    size_t numberOfSteps;
+
+    uint32_t *links;
+    size_t numberOfLinks;
+
+    char *strings;
+    size_t stringsLength;
+} _CCNxTestrigScriptParser;
+
+static uint64_t
+_ccnxTestrigScriptLoader_Hash(const uint8_t *bytes, size_t length)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static void
+_ccnxTestrigScriptParser_Error(_CCNxTestrigScriptParser *parser, const char *reason, const char *token)
+{
+    fprintf(stderr, "Error: %s:%d: %s%s%s\n", parser->path, parser->line, reason, token != NULL ? ": " : "", token != NULL ? token : "");
+}
+
+static uint32_t
+_ccnxTestrigScriptParser_AddString(_CCNxTestrigScriptParser *parser, const char *string)
+{
+    size_t length = strlen(string) + 1;
+    uint32_t offset = parser->stringsLength;
+    parser->strings = realloc(parser->strings, parser->stringsLength + length);
+    memcpy(parser->strings + offset, string, length);
+    parser->stringsLength += length;
+    return offset;
+}
+
+static int
+_ccnxTestrigScriptParser_FindPacket(_CCNxTestrigScriptParser *parser, const char *label)
+{
+    for (size_t i = 0; i < parser->numberOfPackets; i++) {
+        if (strcmp(parser->strings + parser->packets[i].label, label) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int
+_ccnxTestrigScriptParser_FindStep(_CCNxTestrigScriptParser *parser, const char *label)
+{
+    for (size_t i = 0; i < parser->numberOfSteps; i++) {
+        if (strcmp(parser->stepLabels[i], label) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Append a link to the links of the step being parsed, which are the last ones of the link table.
+ */
+static bool
+_ccnxTestrigScriptParser_ParseLink(_CCNxTestrigScriptParser *parser, const char *token, _CCNxTestrigPlanStep *step)
+{
+    CCNxTestrigLinkID id = ccnxTestrig_ParseLinkName(token);
+    if (id == CCNxTestrigLinkID_NULL) {
+        _ccnxTestrigScriptParser_Error(parser, "unknown link", token);
+        return false;
+    }
+    if (id > parser->rigLinks) {
+        _ccnxTestrigScriptParser_Error(parser, "the rig does not have link", token);
+        return false;
+    }
+
+    for (uint32_t i = step->links; i < step->links + step->numberOfLinks; i++) {
+        if (parser->links[i] == id) {
+            return true;
+        }
+    }
+    parser->links = realloc(parser->links, (parser->numberOfLinks + 1) * sizeof(uint32_t));
+    parser->links[parser->numberOfLinks++] = id;
+    step->numberOfLinks++;
+    return true;
+}
+
+static bool
+_ccnxTestrigScriptParser_ParsePacket(_CCNxTestrigScriptParser *parser, _CCNxTestrigPlanPacketKind kind, char **tokens, size_t count)
+{
+    if (count < 3 || count > 4 || (kind == _CCNxTestrigPlanPacket_Interest && count != 3)) {
+        _ccnxTestrigScriptParser_Error(parser, "wrong number of arguments", tokens[0]);
+        return false;
+    }
+    if (_ccnxTestrigScriptParser_FindPacket(parser, tokens[1]) >= 0) {
+        _ccnxTestrigScriptParser_Error(parser, "packet declared twice", tokens[1]);
+        return false;
+    }
+
+    _CCNxTestrigPlanPacket packet;
+    packet.kind = kind;
+    packet.payloadSize = 0;
+    if (count == 4) {
+        char *end;
+        unsigned long payloadSize = strtoul(tokens[3], &end, 10);
+        if (*end != '\0' || payloadSize > UINT16_MAX) {
+            _ccnxTestrigScriptParser_Error(parser, "invalid payload size", tokens[3]);
+            return false;
+        }
+        packet.payloadSize = payloadSize;
+    }
+    packet.label = _ccnxTestrigScriptParser_AddString(parser, tokens[1]);
+    packet.prefix = _ccnxTestrigScriptParser_AddString(parser, tokens[2]);
+
+    parser->packets = realloc(parser->packets, (parser->numberOfPackets + 1) * sizeof(_CCNxTestrigPlanPacket));
+    parser->packets[parser->numberOfPackets++] = packet;
+    return true;
+}
+
+static bool
+_ccnxTestrigScriptParser_ParseStep(_CCNxTestrigScriptParser *parser, _CCNxTestrigPlanStepOperation operation, char **tokens, size_t count)
+{
+    if (count < 4 || ((operation == _CCNxTestrigPlanStep_Send || operation == _CCNxTestrigPlanStep_Respond) && count != 4)) {
+        _ccnxTestrigScriptParser_Error(parser, "wrong number of arguments", tokens[0]);
+        return false;
+    }
+    if (_ccnxTestrigScriptParser_FindStep(parser, tokens[1]) >= 0) {
+        _ccnxTestrigScriptParser_Error(parser, "step declared twice", tokens[1]);
+        return false;
+    }
+
+    _CCNxTestrigPlanStep step = { .operation = operation, .reference = -1, .packet = -1, .links = parser->numberOfLinks, .numberOfLinks = 0 };
+    switch (operation) {
+        case _CCNxTestrigPlanStep_Send:
+            step.packet = _ccnxTestrigScriptParser_FindPacket(parser, tokens[2]);
+            if (step.packet < 0) {
+                _ccnxTestrigScriptParser_Error(parser, "unknown packet", tokens[2]);
+                return false;
+            }
+            if (!_ccnxTestrigScriptParser_ParseLink(parser, tokens[3], &step)) {
+                return false;
+            }
+            break;
+        case _CCNxTestrigPlanStep_Respond:
+            step.reference = _ccnxTestrigScriptParser_FindStep(parser, tokens[2]);
+            step.packet = _ccnxTestrigScriptParser_FindPacket(parser, tokens[3]);
+            if (step.reference < 0) {
+                _ccnxTestrigScriptParser_Error(parser, "unknown step", tokens[2]);
+                return false;
+            }
+            if (step.packet < 0) {
+                _ccnxTestrigScriptParser_Error(parser, "unknown packet", tokens[3]);
+                return false;
+            }
+            break;
+        default:
+            step.reference = _ccnxTestrigScriptParser_FindStep(parser, tokens[2]);
+            if (step.reference < 0) {
+                _ccnxTestrigScriptParser_Error(parser, "unknown step", tokens[2]);
+                return false;
+            }
+            for (size_t i = 3; i < count; i++) {
+                if (!_ccnxTestrigScriptParser_ParseLink(parser, tokens[i], &step)) {
+                    return false;
+                }
+            }
+            break;
+    }
+
+    parser->steps = realloc(parser->steps, (parser->numberOfSteps + 1) * sizeof(_CCNxTestrigPlanStep));
+    parser->stepLabels = realloc(parser->stepLabels, (parser->numberOfSteps + 1) * sizeof(char *));
+    parser->steps[parser->numberOfSteps] = step;
+    parser->stepLabels[parser->numberOfSteps] = strdup(tokens[1]);
+    parser->numberOfSteps++;
+    return true;
+}
+
+static bool
+_ccnxTestrigScriptParser_ParseTokens(_CCNxTestrigScriptParser *parser, char **tokens, size_t count)
+{
+    if (count == 0) {
+        return true;
+    } else if (strcmp(tokens[0], "test") == 0) {
+        if (count != 2 || parser->hasTestCase) {
+            _ccnxTestrigScriptParser_Error(parser, "a script names one test case", NULL);
+            return false;
+        }
+        parser->testCase = _ccnxTestrigScriptParser_AddString(parser, tokens[1]);
+        parser->hasTestCase = true;
+        return true;
+    } else if (strcmp(tokens[0], "interest") == 0) {
+        return _ccnxTestrigScriptParser_ParsePacket(parser, _CCNxTestrigPlanPacket_Interest, tokens, count);
+    } else if (strcmp(tokens[0], "content") == 0) {
+        return _ccnxTestrigScriptParser_ParsePacket(parser, _CCNxTestrigPlanPacket_ContentObject, tokens, count);
+    } else if (strcmp(tokens[0], "send") == 0) {
+        return _ccnxTestrigScriptParser_ParseStep(parser, _CCNxTestrigPlanStep_Send, tokens, count);
+    } else if (strcmp(tokens[0], "respond") == 0) {
+        return _ccnxTestrigScriptParser_ParseStep(parser, _CCNxTestrigPlanStep_Respond, tokens, count);
+    } else if (strcmp(tokens[0], "receive-one") == 0) {
+        return _ccnxTestrigScriptParser_ParseStep(parser, _CCNxTestrigPlanStep_ReceiveOne, tokens, count);
+    } else if (strcmp(tokens[0], "receive-all") == 0) {
+        return _ccnxTestrigScriptParser_ParseStep(parser, _CCNxTestrigPlanStep_ReceiveAll, tokens, count);
+    } else if (strcmp(tokens[0], "receive-none") == 0) {
+        return _ccnxTestrigScriptParser_ParseStep(parser, _CCNxTestrigPlanStep_ReceiveNone, tokens, count);
+    }
+
+    _ccnxTestrigScriptParser_Error(parser, "unknown declaration", tokens[0]);
+    return false;
+}
+
+static bool
+_ccnxTestrigScriptParser_ParseLine(_CCNxTestrigScriptParser *parser, char *line)
+{
+    char *comment = strchr(line, '#');
+    if (comment != NULL) {
+        *comment = '\0';
+    }
+
+    // Every token but the last is followed by a separator, so this is enough for any line.
+    char **tokens = malloc((strlen(line) / 2 + 1) * sizeof(char *));
+    size_t count = 0;
+    char *save = NULL;
+    for (char *token = strtok_r(line, " \t\r", &save); token != NULL; token = strtok_r(NULL, " \t\r", &save)) {
+        tokens[count++] = token;
+    }
+
+    bool parsed = _ccnxTestrigScriptParser_ParseTokens(parser, tokens, count);
+    free(tokens);
+    return parsed;
+}
+
+static void
+_ccnxTestrigScriptParser_Clear(_CCNxTestrigScriptParser *parser)
+{
+    for (size_t i = 0; i < parser->numberOfSteps; i++) {
+        free(parser->stepLabels[i]);
+    }
+    free(parser->stepLabels);
+    free(parser->steps);
+    free(parser->links);
+    free(parser->packets);
+    free(parser->strings);
+}
+
+/**
+ * Parse the script text into the parser's records, which the image then points to.
+ */
+static bool
+_ccnxTestrigScriptParser_Parse(_CCNxTestrigScriptParser *parser, const char *text, size_t length, uint64_t hash, _CCNxTestrigPlanImage *image)
+{
+    char *copy = strndup(text, length);
+    bool ok = true;
+
+    char *line = copy;
+    while (ok && line != NULL) {
+        char *next = strchr(line, '\n');
+        if (next != NULL) {
+            *next++ = '\0';
+        }
+        parser->line++;
+        ok = _ccnxTestrigScriptParser_ParseLine(parser, line);
+        line = next;
+    }
+    free(copy);
+
+    if (ok && !parser->hasTestCase) {
+        _ccnxTestrigScriptParser_Error(parser, "the script does not name its test case", NULL);
+        ok = false;
+    }
+    if (!ok) {
+        return false;
+    }
+
+    memset(&image->header, 0, sizeof(image->header));
+    memcpy(image->header.magic, PLAN_MAGIC, sizeof(PLAN_MAGIC));
+    image->header.version = PLAN_VERSION;
+    image->header.numberOfPackets = parser->numberOfPackets;
+    image->header.numberOfSteps = parser->numberOfSteps;
+    image->header.stringsLength = parser->stringsLength;
+    image->header.testCase = parser->testCase;
+    image->header.numberOfLinks = parser->numberOfLinks;
+    image->header.sourceHash = hash;
+    image->packets = parser->packets;
+    image->steps = parser->steps;
+    image->links = parser->links;
+    image->strings = parser->strings;
+    return true;
+}
+
+static size_t
+_ccnxTestrigScriptLoader_ImageSize(const _CCNxTestrigPlanHeader *header)
+{
+    return sizeof(_CCNxTestrigPlanHeader)
+           + (size_t) header->numberOfPackets * sizeof(_CCNxTestrigPlanPacket)
+           + (size_t) header->numberOfSteps * sizeof(_CCNxTestrigPlanStep)
+           + (size_t) header->numberOfLinks * sizeof(uint32_t)
+           + header->stringsLength;
+}
+
+/**
+ * Check every offset and index of a mapped plan, so that a damaged cache file is rebuilt instead of trusted.
+ * A plan that names links the rig does not have is parsed again too, so that the error is reported.
+ */
+static bool
+_ccnxTestrigScriptLoader_MapImage(const uint8_t *bytes, size_t length, uint64_t hash, size_t rigLinks, _CCNxTestrigPlanImage *image)
+{
+    if (length < sizeof(_CCNxTestrigPlanHeader)) {
+        return false;
+    }
+    memcpy(&image->header, bytes, sizeof(_CCNxTestrigPlanHeader));
+
+    const _CCNxTestrigPlanHeader *header = &image->header;
+    if (memcmp(header->magic, PLAN_MAGIC, sizeof(PLAN_MAGIC)) != 0 || header->version != PLAN_VERSION
+        || header->sourceHash != hash || _ccnxTestrigScriptLoader_ImageSize(header) != length) {
+        return false;
+    }
+
+    image->packets = (const _CCNxTestrigPlanPacket *) (bytes + sizeof(_CCNxTestrigPlanHeader));
+    image->steps = (const _CCNxTestrigPlanStep *) (image->packets + header->numberOfPackets);
+    image->links = (const uint32_t *) (image->steps + header->numberOfSteps);
+    image->strings = (const char *) (image->links + header->numberOfLinks);
+
+    if (header->stringsLength == 0 || image->strings[header->stringsLength - 1] != '\0' || header->testCase >= header->stringsLength) {
+        return false;
+    }
+    for (uint32_t i = 0; i < header->numberOfPackets; i++) {
+        const _CCNxTestrigPlanPacket *packet = &image->packets[i];
+        if (packet->kind > _CCNxTestrigPlanPacket_ContentObject || packet->label >= header->stringsLength || packet->prefix >= header->stringsLength) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->numberOfSteps; i++) {
+        const _CCNxTestrigPlanStep *step = &image->steps[i];
+        bool sends = step->operation == _CCNxTestrigPlanStep_Send || step->operation == _CCNxTestrigPlanStep_Respond;
+        if (step->operation > _CCNxTestrigPlanStep_ReceiveNone || step->reference >= (int32_t) i
+            || step->packet >= (int32_t) header->numberOfPackets || (sends && step->packet < 0)
+            || (step->operation != _CCNxTestrigPlanStep_Send && step->reference < 0)
+            || (step->operation != _CCNxTestrigPlanStep_Respond && step->numberOfLinks == 0)
+            || step->links > header->numberOfLinks || step->numberOfLinks > header->numberOfLinks - step->links) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->numberOfLinks; i++) {
+        if (image->links[i] == CCNxTestrigLinkID_NULL || image->links[i] > rigLinks) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static char *
+_ccnxTestrigScriptLoader_CachePath(const char *cacheDirectory, uint64_t hash)
+{
+    char *path = NULL;
+    asprintf(&path, "%s/%016" PRIx64 ".plan", cacheDirectory, hash);
+    return path;
+}
+
+/**
+ * Create the cache directory if needed, and check that it is a directory that only we can write.
+ * Anyone who could write there could make us run their plans, or have our plans written through
+ * a link of theirs, so a directory that fails the check is not used at all.
+ */
+static bool
+_ccnxTestrigScriptLoader_OpenCache(const char *cacheDirectory)
+{
+    if (mkdir(cacheDirectory, 0700) < 0 && errno == ENOENT) {
+        // The parent is missing too, as ~/.cache may be on a new account.
+        char *parent = strdup(cacheDirectory);
+        char *separator = strrchr(parent, '/');
+        if (separator != NULL && separator != parent) {
+            *separator = '\0';
+            mkdir(parent, 0700);
+        }
+        free(parent);
+        mkdir(cacheDirectory, 0700);
+    }
+
+    struct stat status;
+    if (lstat(cacheDirectory, &status) < 0) {
+        fprintf(stderr, "Warning: not caching plans, unable to create %s: %s\n", cacheDirectory, strerror(errno));
+        return false;
+    }
+    if (!S_ISDIR(status.st_mode) || status.st_uid != geteuid() || (status.st_mode & (S_IRWXG | S_IRWXO)) != 0) {
+        fprintf(stderr, "Warning: not caching plans, %s is not a directory that only this user can access\n", cacheDirectory);
+        return false;
+    }
+    return true;
+}
+
+static void
+_ccnxTestrigScriptLoader_WriteCache(const char *cacheDirectory, const _CCNxTestrigPlanImage *image)
+{
+    // Write a temporary file and rename it, so that a concurrent run never maps a partial plan.
+    char *path = _ccnxTestrigScriptLoader_CachePath(cacheDirectory, image->header.sourceHash);
+    char *temporary = NULL;
+    asprintf(&temporary, "%s.XXXXXX", path);
+
+    int descriptor = mkstemp(temporary);
+    FILE *file = (descriptor >= 0) ? fdopen(descriptor, "wb") : NULL;
+    if (file == NULL && descriptor >= 0) {
+        close(descriptor);
+        unlink(temporary);
+    }
+    if (file != NULL) {
+        const _CCNxTestrigPlanHeader *header = &image->header;
+        bool written = fwrite(header, sizeof(*header), 1, file) == 1
+                       && fwrite(image->packets, sizeof(_CCNxTestrigPlanPacket), header->numberOfPackets, file) == header->numberOfPackets
+                       && fwrite(image->steps, sizeof(_CCNxTestrigPlanStep), header->numberOfSteps, file) == header->numberOfSteps
+                       && fwrite(image->links, sizeof(uint32_t), header->numberOfLinks, file) == header->numberOfLinks
+                       && fwrite(image->strings, 1, header->stringsLength, file) == header->stringsLength;
+        if (fclose(file) == 0 && written) {
+            rename(temporary, path);
+        }
+        unlink(temporary);
+    }
+
+    free(temporary);
+    free(path);
+}
+
+static CCNxTestrigPacketTemplate *
+_ccnxTestrigScriptLoader_CreateTemplate(const _CCNxTestrigPlanImage *image, const _CCNxTestrigPlanPacket *record)
+{
+    char placeholder[SUFFIX_LENGTH + 1];
+    memset(placeholder, '0', SUFFIX_LENGTH);
+    placeholder[SUFFIX_LENGTH] = '\0';
+
+    CCNxName *prefix = ccnxName_CreateFromCString(image->strings + record->prefix);
+    if (prefix == NULL) {
+        fprintf(stderr, "Error: invalid name prefix: %s\n", image->strings + record->prefix);
+        return NULL;
+    }
+    CCNxName *name = ccnxName_ComposeNAME(prefix, placeholder);
+
+    CCNxTlvDictionary *packet;
+    if (record->kind == _CCNxTestrigPlanPacket_Interest) {
+        packet = ccnxInterest_Create(name, INTEREST_LIFETIME, NULL, NULL);
+    } else {
+        PARCBuffer *payload = parcBuffer_Allocate(record->payloadSize);
+        packet = ccnxContentObject_CreateWithNameAndPayload(name, payload);
+        parcBuffer_Release(&payload);
+    }
+
+    CCNxTestrigPacketTemplate *template = ccnxTestrigPacketTemplate_Create(image->strings + record->label, packet);
+
+    ccnxTlvDictionary_Release(&packet);
+    ccnxName_Release(&name);
+    ccnxName_Release(&prefix);
+    return template;
+}
+
+static PARCBitVector *
+_ccnxTestrigScriptLoader_LinkVector(const _CCNxTestrigPlanImage *image, const _CCNxTestrigPlanStep *record)
+{
+    PARCBitVector *vector = parcBitVector_Create();
+    for (uint32_t i = record->links; i < record->links + record->numberOfLinks; i++) {
+        parcBitVector_Set(vector, image->links[i]);
+    }
+    return vector;
+}
+
+/**
+ * Build the script from a parsed or mapped image through the same calls a compiled-in script uses.
+ */
+static CCNxTestrigScript *
+_ccnxTestrigScriptLoader_Build(const _CCNxTestrigPlanImage *image)
+{
+    const _CCNxTestrigPlanHeader *header = &image->header;
+    CCNxTestrigPacketTemplate **templates = calloc(header->numberOfPackets, sizeof(CCNxTestrigPacketTemplate *));
+    CCNxTestrigScriptStep **steps = calloc(header->numberOfSteps, sizeof(CCNxTestrigScriptStep *));
+    CCNxTestrigScript *script = ccnxTestrigScript_Create((char *) image->strings + header->testCase);
+
+    for (uint32_t i = 0; script != NULL && i < header->numberOfPackets; i++) {
+        templates[i] = _ccnxTestrigScriptLoader_CreateTemplate(image, &image->packets[i]);
+        if (templates[i] == NULL) {
+            ccnxTestrigScript_Release(&script);
+        }
+    }
+
+    for (uint32_t i = 0; script != NULL && i < header->numberOfSteps; i++) {
+        const _CCNxTestrigPlanStep *record = &image->steps[i];
+        CCNxTestrigScriptStep *reference = record->reference >= 0 ? steps[record->reference] : NULL;
+        CCNxTestrigPacketTemplate *template = record->packet >= 0 ? templates[record->packet] : NULL;
+        PARCBitVector *linkVector = _ccnxTestrigScriptLoader_LinkVector(image, record);
+
+        switch (record->operation) {
+            case _CCNxTestrigPlanStep_Send:
+                steps[i] = ccnxTestrigScript_AddTemplateSendStep(script, template, parcBitVector_NextBitSet(linkVector, 0));
+                break;
+            case _CCNxTestrigPlanStep_Respond:
+                steps[i] = ccnxTestrigScript_AddTemplateRespondStep(script, reference, template);
+                break;
+            case _CCNxTestrigPlanStep_ReceiveOne:
+                steps[i] = ccnxTestrigScript_AddReceiveOneStep(script, reference, linkVector);
+                break;
+            case _CCNxTestrigPlanStep_ReceiveAll:
+                steps[i] = ccnxTestrigScript_AddReceiveAllStep(script, reference, linkVector);
+                break;
+            case _CCNxTestrigPlanStep_ReceiveNone:
+                steps[i] = ccnxTestrigScript_AddReceiveNoneStep(script, reference, linkVector);
+                break;
+        }
+        parcBitVector_Release(&linkVector);
+    }
+
+    for (uint32_t i = 0; i < header->numberOfPackets; i++) {
+        if (templates[i] != NULL) {
+            ccnxTestrigPacketTemplate_Release(&templates[i]);
+        }
+    }
+    free(templates);
+    free(steps);
+
+    return script;
+}
+
+static CCNxTestrigScript *
+_ccnxTestrigScriptLoader_Load(const char *path, const char *cacheDirectory, size_t numberOfLinks)
+{
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) {
+        fprintf(stderr, "Error: unable to open %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) < 0 || status.st_size == 0) {
+        fprintf(stderr, "Error: %s is empty or unreadable\n", path);
+        close(descriptor);
+        return NULL;
+    }
+    size_t length = status.st_size;
+    const uint8_t *text = mmap(NULL, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (text == MAP_FAILED) {
+        fprintf(stderr, "Error: unable to map %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+
+    uint64_t hash = _ccnxTestrigScriptLoader_Hash(text, length);
+    CCNxTestrigScript *script = NULL;
+    _CCNxTestrigPlanImage image;
+
+    // Use the cached plan if there is a valid one for this exact text.
+    if (cacheDirectory != NULL) {
+        char *cachePath = _ccnxTestrigScriptLoader_CachePath(cacheDirectory, hash);
+        int planDescriptor = open(cachePath, O_RDONLY | O_NOFOLLOW);
+        free(cachePath);
+
+        if (planDescriptor >= 0) {
+            struct stat planStatus;
+            if (fstat(planDescriptor, &planStatus) == 0 && planStatus.st_size > 0) {
+                const uint8_t *plan = mmap(NULL, planStatus.st_size, PROT_READ, MAP_PRIVATE, planDescriptor, 0);
+                if (plan != MAP_FAILED) {
+                    if (_ccnxTestrigScriptLoader_MapImage(plan, planStatus.st_size, hash, numberOfLinks, &image)) {
+                        script = _ccnxTestrigScriptLoader_Build(&image);
+                    }
+                    munmap((void *) plan, planStatus.st_size);
+                }
+            }
+            close(planDescriptor);
+        }
+    }
+
+    if (script == NULL) {
+        _CCNxTestrigScriptParser parser;
+        memset(&parser, 0, sizeof(parser));
+        parser.path = path;
+        parser.rigLinks = numberOfLinks;
+
+        if (_ccnxTestrigScriptParser_Parse(&parser, (const char *) text, length, hash, &image)) {
+            script = _ccnxTestrigScriptLoader_Build(&image);
+            if (script != NULL && cacheDirectory != NULL) {
+                _ccnxTestrigScriptLoader_WriteCache(cacheDirectory, &image);
+            }
+        }
+        _ccnxTestrigScriptParser_Clear(&parser);
+    }
+
+    munmap((void *) text, length);
+    return script;
+}
+
+CCNxTestrigScript *
+ccnxTestrigScriptLoader_Load(const char *path, const char *cacheDirectory, size_t numberOfLinks)
+{
+    if (cacheDirectory != NULL && !_ccnxTestrigScriptLoader_OpenCache(cacheDirectory)) {
+        cacheDirectory = NULL;
+    }
+    return _ccnxTestrigScriptLoader_Load(path, cacheDirectory, numberOfLinks);
+}
+
+static int
+_ccnxTestrigScriptLoader_CompareNames(const void *a, const void *b)
+{
+    return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+PARCLinkedList *
+ccnxTestrigScriptLoader_LoadAll(const char *path, const char *cacheDirectory, size_t numberOfLinks)
+{
+    PARCLinkedList *scripts = parcLinkedList_Create();
+    if (cacheDirectory != NULL && !_ccnxTestrigScriptLoader_OpenCache(cacheDirectory)) {
+        cacheDirectory = NULL;
+    }
+
+    struct stat status;
+    if (stat(path, &status) == 0 && !S_ISDIR(status.st_mode)) {
+        CCNxTestrigScript *script = _ccnxTestrigScriptLoader_Load(path, cacheDirectory, numberOfLinks);
+        if (script != NULL) {
+            parcLinkedList_Append(scripts, script);
+            ccnxTestrigScript_Release(&script);
+        }
+        return scripts;
+    }
+
+    DIR *directory = opendir(path);
+    if (directory == NULL) {
+        fprintf(stderr, "Error: unable to open %s: %s\n", path, strerror(errno));
+        return scripts;
+    }
+
+    char **names = NULL;
+    size_t numberOfNames = 0;
+    for (struct dirent *entry = readdir(directory); entry != NULL; entry = readdir(directory)) {
+        size_t length = strlen(entry->d_name);
+        if (length > strlen(SCRIPT_EXTENSION) && strcmp(entry->d_name + length - strlen(SCRIPT_EXTENSION), SCRIPT_EXTENSION) == 0) {
+            names = realloc(names, (numberOfNames + 1) * sizeof(char *));
+            asprintf(&names[numberOfNames++], "%s/%s", path, entry->d_name);
+        }
+    }
+    closedir(directory);
+
+    // Load in name order, so that the scripts run in the same order on every host.
+    qsort(names, numberOfNames, sizeof(char *), _ccnxTestrigScriptLoader_CompareNames);
+    for (size_t i = 0; i < numberOfNames; i++) {
+        CCNxTestrigScript *script = _ccnxTestrigScriptLoader_Load(names[i], cacheDirectory, numberOfLinks);
+        if (script != NULL) {
+            parcLinkedList_Append(scripts, script);
+            ccnxTestrigScript_Release(&script);
+        }
+        free(names[i]);
+    }
+    free(names);
+
+    return scripts;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_ScriptLoader_h
+#define ccnxTestrig_ScriptLoader_h
+
+#include <parc/algol/parc_LinkedList.h>
+
+#include "ccnxTestrig_Script.h"
+
+/**
+ * Load a test script written in the text script format.
+ *
+ * A script file is a sequence of lines, each holding one declaration. Everything after a
+ * '#' is a comment. Links are named by their letter, starting at A, and a script that names
+ * a link beyond @p numberOfLinks is rejected.
+ *
+ * ~~~
+ * test <test case name>
+ * interest <packet> <name prefix>
+ * content <packet> <name prefix> [<payload bytes>]
+ * send <step> <packet> <link>
+ * respond <step> <receive step> <packet>
+ * receive-one <step> <send step> <link> [<link> ...]
+ * receive-all <step> <send step> <link> [<link> ...]
+ * receive-none <step> <send step> <link> [<link> ...]
+ * ~~~
+ *
+ * Every packet is sent from a template whose name is the prefix followed by a suffix that
+ * is drawn anew for each execution and shared by all of the packets of the script, so an
+ * Interest and a Content Object with the same prefix always match.
+ *
+ * Parsed scripts are cached in @p cacheDirectory as binary plans named by the hash of the
+ * script text. A cached plan is mapped into memory and used instead of parsing the text again.
+ * The directory is created with mode 0700 if it is missing, and it is not used, with a
+ * warning, unless it is a directory that belongs to the user and that no one else can access.
+ *
+ * @param [in] path The path of the script file.
+ * @param [in] cacheDirectory The directory holding the cached plans, or NULL to parse without caching.
+ * @param [in] numberOfLinks The number of links of the rig the script will run on.
+ *
+ * @retval A new `CCNxTestrigScript` that must be released by `ccnxTestrigScript_Release`.
+ * @retval NULL if the file could not be read or is not a valid script. The reason is printed.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigScript *script = ccnxTestrigScriptLoader_Load("scripts/basic_interest.script", planCache, ccnxTestrig_GetNumberOfLinks(rig));
+ *
+ *     ccnxTestrigScript_Release(&script);
+ * }
+ * @endcode
+ */
+CCNxTestrigScript *ccnxTestrigScriptLoader_Load(const char *path, const char *cacheDirectory, size_t numberOfLinks);
+
+/**
+ * Load a script file, or every file ending in ".script" in a directory, in name order.
+ *
+ * Files that fail to load are reported and skipped. The cache directory is checked once, as
+ * by `ccnxTestrigScriptLoader_Load`.
+ *
+ * @param [in] path The path of a script file or of a directory of script files.
+ * @param [in] cacheDirectory The directory holding the cached plans, or NULL to parse without caching.
+ * @param [in] numberOfLinks The number of links of the rig the script will run on.
+ *
+ * @return A new list of `CCNxTestrigScript` instances that must be released by `parcLinkedList_Release`.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCLinkedList *scripts = ccnxTestrigScriptLoader_LoadAll("scripts", planCache, ccnxTestrig_GetNumberOfLinks(rig));
+ *
+ *     parcLinkedList_Release(&scripts);
+ * }
+ * @endcode
+ */
+PARCLinkedList *ccnxTestrigScriptLoader_LoadAll(const char *path, const char *cacheDirectory, size_t numberOfLinks);
+#endif // ccnxTestrig_ScriptLoader_h
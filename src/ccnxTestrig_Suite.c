@@ -69,48 +69,30 @@
 
 #include <ccnx/common/validation/ccnxValidation_CRC32C.h>
 
-#include <parc/security/parc_SecureRandom.h>
-
 #include "ccnxTestrig.h"
 #include "ccnxTestrig_Suite.h"
 #include "ccnxTestrig_SuiteTestResult.h"
 #include "ccnxTestrig_Script.h"
 #include "ccnxTestrig_PacketUtility.h"
+#include "ccnxTestrig_Dispatcher.h"
+#include "ccnxTestrig_Log.h"
 
-static CCNxName *
-_createRandomName(char *prefix)
-{
-    CCNxName *name = ccnxName_CreateFromCString(prefix);
-
-    PARCSecureRandom *random = parcSecureRandom_Create();
-    PARCBuffer *suffixBytes = parcBuffer_Allocate(16);
-    parcSecureRandom_NextBytes(random, suffixBytes);
-    parcBuffer_Flip(suffixBytes);
-    char *suffix = parcBuffer_ToHexString(suffixBytes);
-    parcBuffer_Release(&suffixBytes);
-
-    CCNxName *full = ccnxName_ComposeNAME(name, suffix);
-    parcMemory_Deallocate(&suffix);
-    ccnxName_Release(&name);
-    parcSecureRandom_Release(&random);
-
-    return full;
-}
+#include <pthread.h>
 
 static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_FIBTest_BasicInterest_1a(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the protocol messages
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     CCNxInterest *interest = ccnxInterest_Create(testName, 1000, NULL, NULL);
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddRespondStep(script, step2, content);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -126,7 +108,7 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_FIBTest_BasicInterest_1b(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/c");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/c");
     assertNotNull(testName, "The name must not be NULL");
 
     // Create the protocol messages
@@ -136,9 +118,9 @@ ccnxTestrigSuite_FIBTest_BasicInterest_1b(CCNxTestrig *rig, char *testCaseName)
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkC);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -156,16 +138,16 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTest_1(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     CCNxInterest *interest = ccnxInterest_Create(testName, 1000, NULL, NULL);
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -183,16 +165,16 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTest_2(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     CCNxInterest *interest = ccnxInterest_Create(testName, 1000, NULL, NULL);
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxManifest *manifest = ccnxManifest_Create(testName);
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, manifest, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -210,16 +192,16 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTest_3(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/bc");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/bc");
     CCNxInterest *interest = ccnxInterest_Create(testName, 1000, NULL, NULL);
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_LinkC));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_LinkC, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddRespondStep(script, step2, content);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -237,17 +219,17 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTest_4(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/ab");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/ab");
     CCNxInterest *interest = ccnxInterest_Create(testName, 1000, NULL, NULL);
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2a = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
-    CCNxTestrigScriptStep *step2b = ccnxTestrigScript_AddReceiveNoneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step2a = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
+    CCNxTestrigScriptStep *step2b = ccnxTestrigScript_AddReceiveNoneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddRespondStep(script, step2a, content);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -265,7 +247,7 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTest_5(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/c");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/c");
     CCNxInterest *interest = ccnxInterest_Create(testName, 1000, NULL, NULL);
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
@@ -273,10 +255,10 @@ ccnxTestrigSuite_ContentObjectTest_5(CCNxTestrig *rig, char *testCaseName)
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1a = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
     CCNxTestrigScriptStep *step1b = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step2a = ccnxTestrigScript_AddReceiveOneStep(script, step1a, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC));
-    CCNxTestrigScriptStep *step2b = ccnxTestrigScript_AddReceiveNoneStep(script, step1a, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC));
+    CCNxTestrigScriptStep *step2a = ccnxTestrigScript_AddReceiveOneStep(script, step1a, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC, CCNxTestrigLinkID_NULL));
+    CCNxTestrigScriptStep *step2b = ccnxTestrigScript_AddReceiveNoneStep(script, step1a, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddRespondStep(script, step2a, content);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveAllStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveAllStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -294,19 +276,19 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTest_6(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/c");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/c");
     CCNxInterest *interest = ccnxInterest_Create(testName, 1000, NULL, NULL);
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1a = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2a = ccnxTestrigScript_AddReceiveOneStep(script, step1a, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC));
+    CCNxTestrigScriptStep *step2a = ccnxTestrigScript_AddReceiveOneStep(script, step1a, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step1b = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2b = ccnxTestrigScript_AddReceiveOneStep(script, step1a, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC));
+    CCNxTestrigScriptStep *step2b = ccnxTestrigScript_AddReceiveOneStep(script, step1a, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkC, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddRespondStep(script, step2b, content);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveAllStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveAllStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -325,16 +307,16 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTestErrors_1(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     CCNxInterest *interest = ccnxInterest_Create(testName, 1000, NULL, NULL);
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -354,16 +336,16 @@ ccnxTestrigSuite_ContentObjectTestErrors_2(CCNxTestrig *rig, char *testCaseName)
     CCNxTestrigSuiteTestResult *testCase = ccnxTestrigSuiteTestResult_Create(testCaseName);
 
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     CCNxInterest *interest = ccnxInterest_Create(testName, 1000, NULL, NULL);
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkC);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -383,18 +365,18 @@ ccnxTestrigSuite_ContentObjectTestErrors_3(CCNxTestrig *rig, char *testCaseName)
     CCNxTestrigSuiteTestResult *testCase = ccnxTestrigSuiteTestResult_Create(testCaseName);
 
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     CCNxInterest *interest = ccnxInterest_Create(testName, 1000, NULL, NULL);
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step5 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step6 = ccnxTestrigScript_AddReceiveNoneStep(script, step5, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step6 = ccnxTestrigScript_AddReceiveNoneStep(script, step5, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -412,7 +394,7 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTestRestrictions_1(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
     PARCBuffer *hash = ccnxTestrigPacketUtility_ComputeMessageHash(content);
@@ -421,9 +403,9 @@ ccnxTestrigSuite_ContentObjectTestRestrictions_1(CCNxTestrig *rig, char *testCas
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -441,7 +423,7 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTestRestrictions_2(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
@@ -459,9 +441,9 @@ ccnxTestrigSuite_ContentObjectTestRestrictions_2(CCNxTestrig *rig, char *testCas
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -479,7 +461,7 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTestRestrictions_3(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
@@ -498,9 +480,9 @@ ccnxTestrigSuite_ContentObjectTestRestrictions_3(CCNxTestrig *rig, char *testCas
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -518,7 +500,7 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTestRestrictions_4(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithPayload(testPayload);
     PARCBuffer *hash = ccnxTestrigPacketUtility_ComputeMessageHash(content);
@@ -527,9 +509,9 @@ ccnxTestrigSuite_ContentObjectTestRestrictions_4(CCNxTestrig *rig, char *testCas
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveOneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -547,7 +529,7 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTestRestrictionErrors_1(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
@@ -556,9 +538,9 @@ ccnxTestrigSuite_ContentObjectTestRestrictionErrors_1(CCNxTestrig *rig, char *te
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -576,7 +558,7 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTestRestrictionErrors_2(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
@@ -596,9 +578,9 @@ ccnxTestrigSuite_ContentObjectTestRestrictionErrors_2(CCNxTestrig *rig, char *te
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -616,7 +598,7 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTestRestrictionErrors_3(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithNameAndPayload(testName, testPayload);
 
@@ -626,9 +608,9 @@ ccnxTestrigSuite_ContentObjectTestRestrictionErrors_3(CCNxTestrig *rig, char *te
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -646,7 +628,7 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTestRestrictionErrors_4(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithPayload(testPayload);
 
@@ -664,9 +646,9 @@ ccnxTestrigSuite_ContentObjectTestRestrictionErrors_4(CCNxTestrig *rig, char *te
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -684,7 +666,7 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTestRestrictionErrors_5(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithPayload(testPayload);
 
@@ -704,9 +686,9 @@ ccnxTestrigSuite_ContentObjectTestRestrictionErrors_5(CCNxTestrig *rig, char *te
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -724,7 +706,7 @@ static CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_ContentObjectTestRestrictionErrors_6(CCNxTestrig *rig, char *testCaseName)
 {
     // Create the test packets
-    CCNxName *testName = _createRandomName("ccnx:/test/b");
+    CCNxName *testName = ccnxTestrigNameGenerator_CreateName(ccnxTestrig_GetNameGenerator(rig), "ccnx:/test/b");
     PARCBuffer *testPayload = parcBuffer_Allocate(1024);
     CCNxContentObject *content = ccnxContentObject_CreateWithPayload(testPayload);
 
@@ -745,9 +727,9 @@ ccnxTestrigSuite_ContentObjectTestRestrictionErrors_6(CCNxTestrig *rig, char *te
 
     CCNxTestrigScript *script = ccnxTestrigScript_Create(testCaseName);
     CCNxTestrigScriptStep *step1 = ccnxTestrigScript_AddSendStep(script, interest, CCNxTestrigLinkID_LinkA);
-    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB));
+    CCNxTestrigScriptStep *step2 = ccnxTestrigScript_AddReceiveOneStep(script, step1, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkB, CCNxTestrigLinkID_NULL));
     CCNxTestrigScriptStep *step3 = ccnxTestrigScript_AddSendStep(script, content, CCNxTestrigLinkID_LinkB);
-    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA));
+    CCNxTestrigScriptStep *step4 = ccnxTestrigScript_AddReceiveNoneStep(script, step3, ccnxTestrig_GetLinkVector(rig, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_NULL));
 
     CCNxTestrigSuiteTestResult *testCaseResult = ccnxTestrigScript_Execute(script, rig);
 
@@ -784,6 +766,19 @@ static char *_testCaseNames[CCNxTestrigSuiteTest_LastEntry] = {
     "CCNxTestrigSuiteTest_ContentObjectRestrictionErrors_6",
 };
 
+// Tests that depend on link state shared by every packet, such as PIT aggregation or a second
+// answer to a consumed Interest, or whose packets are nameless and so cannot be demultiplexed.
+// These are never run concurrently with other tests.
+static bool _testCaseRequiresExclusiveLinks[CCNxTestrigSuiteTest_LastEntry] = {
+    [CCNxTestrigSuiteTest_ContentObjectTest_5] = true,
+    [CCNxTestrigSuiteTest_ContentObjectTest_6] = true,
+    [CCNxTestrigSuiteTest_ContentObjectErrors_3] = true,
+    [CCNxTestrigSuiteTest_ContentObjectRestrictions_4] = true,
+    [CCNxTestrigSuiteTest_ContentObjectRestrictionErrors_4] = true,
+    [CCNxTestrigSuiteTest_ContentObjectRestrictionErrors_5] = true,
+    [CCNxTestrigSuiteTest_ContentObjectRestrictionErrors_6] = true,
+};
+
 CCNxTestrigSuiteTestResult *
 ccnxTestrigSuite_RunTest(CCNxTestrig *rig, CCNxTestrigSuiteTest test)
 {
@@ -861,26 +856,237 @@ ccnxTestrigSuite_RunTest(CCNxTestrig *rig, CCNxTestrigSuiteTest test)
     return result;
 }
 
-PARCLinkedList *
+static void
+_ccnxTestrigSuite_ReportDiscardedPackets(CCNxTestrig *rig, const char *testCaseName)
+{
+    CCNxTestrigReporter *reporter = ccnxTestrig_GetReporter(rig);
+    for (CCNxTestrigLinkID id = CCNxTestrigLinkID_LinkA; id <= ccnxTestrig_GetNumberOfLinks(rig); id++) {
+        size_t discarded = ccnxTestrig_GetDiscardedPacketCount(rig, id);
+        if (discarded > 0) {
+            char name[CCNX_TESTRIG_LINK_NAME_LENGTH];
+            char *message = NULL;
+            asprintf(&message, "Test %s left %zu stale packet(s) on link %s", testCaseName, discarded, ccnxTestrig_FormatLinkName(id, name));
+            ccnxTestrigReporter_Report(reporter, message);
+            free(message);
+        }
+    }
+}
+
+static void
+_ccnxTestrigSuite_DrainLinks(CCNxTestrig *rig, CCNxTestrigSuiteTest test)
+{
+    // Drain the pipes, and report any traffic the test left behind
+    if (ccnxTestrig_DrainLinks(rig) > 0) {
+        _ccnxTestrigSuite_ReportDiscardedPackets(rig, _testCaseNames[test]);
+    }
+}
+
+/**
+ * What is kept of the results as they are reported: the number of failures, the memory held by
+ * the largest result, and the latencies of every pair of links merged across the tests, in
+ * histograms indexed by [from * stride + to].
+ */
+typedef struct {
+    size_t failures;
+    size_t largestResult;
+    size_t stride;
+    CCNxTestrigHistogram **latency;
+} _CCNxTestrigSuiteSummary;
+
+static void
+_ccnxTestrigSuiteSummary_Init(_CCNxTestrigSuiteSummary *summary, CCNxTestrig *rig)
+{
+    summary->failures = 0;
+    summary->largestResult = 0;
+    summary->stride = ccnxTestrig_GetNumberOfLinks(rig) + 1;
+    summary->latency = calloc(summary->stride * summary->stride, sizeof(CCNxTestrigHistogram *));
+}
+
+static void
+_ccnxTestrigSuite_SaveResult(_CCNxTestrigSuiteSummary *summary, CCNxTestrigSuiteTestResult *result, CCNxTestrigReporter *reporter)
+{
+    // A test that could not be run has no result, and counts as a failure.
+    if (result == NULL) {
+        summary->failures++;
+        return;
+    }
+
+    ccnxTestrigSuiteTestResult_Report(result, reporter);
+    if (ccnxTestrigSuiteTestResult_IsFailure(result)) {
+        summary->failures++;
+    }
+
+    size_t memoryUsage = ccnxTestrigSuiteTestResult_GetMemoryUsage(result);
+    if (memoryUsage > summary->largestResult) {
+        summary->largestResult = memoryUsage;
+    }
+
+    for (size_t j = 0; j < ccnxTestrigSuiteTestResult_GetLinkPairCount(result); j++) {
+        CCNxTestrigLinkID from, to;
+        const CCNxTestrigHistogram *pairLatency = ccnxTestrigSuiteTestResult_GetLinkPairLatency(result, j, &from, &to);
+        if (from >= summary->stride || to >= summary->stride) {
+            continue;
+        }
+        CCNxTestrigHistogram **pair = &summary->latency[from * summary->stride + to];
+        if (*pair == NULL) {
+            *pair = ccnxTestrigHistogram_Create();
+        }
+        ccnxTestrigHistogram_Merge(*pair, pairLatency);
+    }
+
+    // The result has been reported, so nothing of it is kept.
+    ccnxTestrigSuiteTestResult_Release(&result);
+}
+
+/**
+ * Report the latencies of each pair of links and the size of the largest result, free the summary,
+ * and return the number of failures.
+ */
+static size_t
+_ccnxTestrigSuite_ReportSummary(_CCNxTestrigSuiteSummary *summary, CCNxTestrigReporter *reporter)
+{
+    size_t stride = summary->stride;
+    for (CCNxTestrigLinkID from = CCNxTestrigLinkID_LinkA; from < stride; from++) {
+        for (CCNxTestrigLinkID to = CCNxTestrigLinkID_LinkA; to < stride; to++) {
+            CCNxTestrigHistogram **pair = &summary->latency[from * stride + to];
+            if (*pair != NULL) {
+                char fromName[CCNX_TESTRIG_LINK_NAME_LENGTH];
+                char toName[CCNX_TESTRIG_LINK_NAME_LENGTH];
+                char *histogram = ccnxTestrigHistogram_ToString(*pair);
+                char *message = NULL;
+                asprintf(&message, "Latency from link %s to link %s: %s",
+                         ccnxTestrig_FormatLinkName(from, fromName), ccnxTestrig_FormatLinkName(to, toName), histogram);
+                ccnxTestrigReporter_Report(reporter, message);
+                free(message);
+                free(histogram);
+                ccnxTestrigHistogram_Release(pair);
+            }
+        }
+    }
+    free(summary->latency);
+
+    char *message = NULL;
+    asprintf(&message, "The largest test result held %zu bytes", summary->largestResult);
+    ccnxTestrigReporter_Report(reporter, message);
+    free(message);
+
+    return summary->failures;
+}
+
+size_t
 ccnxTestrigSuite_RunAll(CCNxTestrig *rig)
 {
-    PARCLinkedList *resultList = parcLinkedList_Create();
+    _CCNxTestrigSuiteSummary summary;
+    _ccnxTestrigSuiteSummary_Init(&summary, rig);
     CCNxTestrigReporter *reporter = ccnxTestrig_GetReporter(rig);
 
     for (int i = 0; i < CCNxTestrigSuiteTest_LastEntry; i++) {
-        printf("Running test %d\n", i);
+        ccnxTestrigLog_Info("Running test %d", i);
         CCNxTestrigSuiteTestResult *result = ccnxTestrigSuite_RunTest(rig, i);
-        if (result != NULL) {
-            ccnxTestrigSuiteTestResult_Report(result, reporter);
+        _ccnxTestrigSuite_SaveResult(&summary, result, reporter);
+        _ccnxTestrigSuite_DrainLinks(rig, i);
+    }
+
+    return _ccnxTestrigSuite_ReportSummary(&summary, reporter);
+}
+
+size_t
+ccnxTestrigSuite_RunScripts(CCNxTestrig *rig, PARCLinkedList *scripts)
+{
+    _CCNxTestrigSuiteSummary summary;
+    _ccnxTestrigSuiteSummary_Init(&summary, rig);
+    CCNxTestrigReporter *reporter = ccnxTestrig_GetReporter(rig);
+
+    for (size_t i = 0; i < parcLinkedList_Size(scripts); i++) {
+        CCNxTestrigScript *script = parcLinkedList_GetAtIndex(scripts, i);
+        ccnxTestrigLog_Info("Running script %s", ccnxTestrigScript_GetTestCase(script));
+        CCNxTestrigSuiteTestResult *result = ccnxTestrigScript_Execute(script, rig);
+        _ccnxTestrigSuite_SaveResult(&summary, result, reporter);
+        if (ccnxTestrig_DrainLinks(rig) > 0) {
+            _ccnxTestrigSuite_ReportDiscardedPackets(rig, ccnxTestrigScript_GetTestCase(script));
+        }
+    }
+
+    return _ccnxTestrigSuite_ReportSummary(&summary, reporter);
+}
+
+typedef struct {
+    pthread_t thread;
+    CCNxTestrig *view;
+    CCNxTestrigSuiteTest test;
+    CCNxTestrigSuiteTestResult *result;
+} _CCNxTestrigSuiteConcurrentTest;
+
+static void *
+_ccnxTestrigSuite_RunConcurrentTest(void *arg)
+{
+    _CCNxTestrigSuiteConcurrentTest *context = arg;
+    context->result = ccnxTestrigSuite_RunTest(context->view, context->test);
+    return NULL;
+}
+
+size_t
+ccnxTestrigSuite_RunAllConcurrently(CCNxTestrig *rig)
+{
+    CCNxTestrigSuiteTestResult *results[CCNxTestrigSuiteTest_LastEntry] = { NULL };
+    _CCNxTestrigSuiteConcurrentTest contexts[CCNxTestrigSuiteTest_LastEntry];
+    bool started[CCNxTestrigSuiteTest_LastEntry] = { false };
+
+    // Every test that can share the links runs on its own thread, against its own view of the rig.
+    // The dispatcher routes each received packet to the view that claimed its name.
+    CCNxTestrigDispatcher *dispatcher = ccnxTestrigDispatcher_Create(rig);
+    ccnxTestrigDispatcher_Start(dispatcher);
+
+    for (int i = 0; i < CCNxTestrigSuiteTest_LastEntry; i++) {
+        if (_testCaseRequiresExclusiveLinks[i]) {
+            continue;
         }
 
-        // Save the result
-        parcLinkedList_Append(resultList, result);
-        ccnxTestrigSuiteTestResult_Release(&result);
+        ccnxTestrigLog_Info("Starting test %d", i);
+        contexts[i].view = ccnxTestrig_CreateView(rig, dispatcher);
+        contexts[i].test = i;
+        contexts[i].result = NULL;
+        if (pthread_create(&contexts[i].thread, NULL, _ccnxTestrigSuite_RunConcurrentTest, &contexts[i]) == 0) {
+            started[i] = true;
+        } else {
+            perror("pthread_create() failed");
+            ccnxTestrig_Release(&contexts[i].view);
+        }
+    }
 
-        // Flush the pipes
-        ccnxTestrig_FlushLinks(rig);
+    for (int i = 0; i < CCNxTestrigSuiteTest_LastEntry; i++) {
+        if (started[i]) {
+            pthread_join(contexts[i].thread, NULL);
+            results[i] = contexts[i].result;
+            ccnxTestrig_Release(&contexts[i].view);
+        }
+    }
+
+    ccnxTestrigDispatcher_Stop(dispatcher);
+    size_t unclaimed = ccnxTestrigDispatcher_GetDiscardedPacketCount(dispatcher);
+    if (unclaimed > 0) {
+        char *message = NULL;
+        asprintf(&message, "Concurrent tests discarded %zu packet(s) that were unclaimed or found their mailbox full", unclaimed);
+        ccnxTestrigReporter_Report(ccnxTestrig_GetReporter(rig), message);
+        free(message);
+    }
+    ccnxTestrigDispatcher_Release(&dispatcher);
+    ccnxTestrig_DrainLinks(rig);
+
+    // Tests that need the links to themselves, and any test that could not be started, run one at a time.
+    for (int i = 0; i < CCNxTestrigSuiteTest_LastEntry; i++) {
+        if (!started[i]) {
+            ccnxTestrigLog_Info("Running test %d", i);
+            results[i] = ccnxTestrigSuite_RunTest(rig, i);
+            _ccnxTestrigSuite_DrainLinks(rig, i);
+        }
+    }
+
+    _CCNxTestrigSuiteSummary summary;
+    _ccnxTestrigSuiteSummary_Init(&summary, rig);
+    for (int i = 0; i < CCNxTestrigSuiteTest_LastEntry; i++) {
+        _ccnxTestrigSuite_SaveResult(&summary, results[i], ccnxTestrig_GetReporter(rig));
     }
 
-    return resultList;
+    return _ccnxTestrigSuite_ReportSummary(&summary, ccnxTestrig_GetReporter(rig));
 }
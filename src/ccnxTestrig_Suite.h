@@ -86,9 +86,10 @@ typedef enum {
 } CCNxTestrigSuiteTest;
 
 /**
- * Run all of the test cases and return the results in a list.
+ * Run all of the test cases and return the number that failed.
  *
- * Each element of the resultant list will be of type `CCNxTestrigSuiteTestResult`.
+ * Each result is reported to the rig's reporter as soon as its test finishes, and is then
+ * released, so a run keeps only the latencies of each pair of links, which are reported at the end.
  *
  * @param [in] rig The `CCNxTestrig` to use for the tests.
  *
@@ -97,11 +98,52 @@ typedef enum {
  * {
  *     CCNxTestrig *rig = ...
  *
- *     PARCLinkedList *list = ccnxTestrigSuite_RunAll(rig);
+ *     size_t failures = ccnxTestrigSuite_RunAll(rig);
  * }
  * @endcode
  */
-PARCLinkedList *ccnxTestrigSuite_RunAll(CCNxTestrig *rig);
+size_t ccnxTestrigSuite_RunAll(CCNxTestrig *rig);
+
+/**
+ * Run all of the test cases concurrently and return the number that failed.
+ *
+ * Every test that can share the links with other tests is started on its own thread.
+ * Packets received on the links are routed to the test that sent a packet with the same
+ * name. Tests that need exclusive use of the links are run one at a time afterwards.
+ * The results are reported in test order once every test has finished.
+ *
+ * @param [in] rig The `CCNxTestrig` to use for the tests.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrig *rig = ...
+ *
+ *     size_t failures = ccnxTestrigSuite_RunAllConcurrently(rig);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigSuite_RunAllConcurrently(CCNxTestrig *rig);
+
+/**
+ * Run the given scripts one at a time, in order, and return the number that failed.
+ *
+ * The links are drained after each script, as they are between the built-in test cases, and
+ * each result is reported as the script finishes, as by `ccnxTestrigSuite_RunAll`.
+ *
+ * @param [in] rig The `CCNxTestrig` to use for the scripts.
+ * @param [in] scripts A list of `CCNxTestrigScript` instances, such as loaded by `ccnxTestrigScriptLoader_LoadAll`.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCLinkedList *scripts = ccnxTestrigScriptLoader_LoadAll("scripts", NULL);
+ *
+ *     size_t failures = ccnxTestrigSuite_RunScripts(rig, scripts);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigSuite_RunScripts(CCNxTestrig *rig, PARCLinkedList *scripts);
 
 /**
  * Run a single test case and return the result.
@@ -54,13 +54,38 @@
  */
 #include "ccnxTestrig_SuiteTestResult.h"
 
-#include <parc/algol/parc_LinkedList.h>
+typedef struct {
+    CCNxTestrigLinkID link;
+    PARCBuffer *packet;
+} _CCNxTestrigLoggedPacket;
+
+typedef struct {
+    CCNxTestrigLinkID sendLink;
+    CCNxTestrigLinkID receiveLink;
+    CCNxTestrigHistogram *latency;
+} _CCNxTestrigLinkPairLatency;
 
 struct ccnx_testrig_testresult {
     char *testCase;
-    PARCLinkedList *packetList;
+
+    // The last packetLogCapacity packets sent, oldest first from loggedPackets % packetLogCapacity.
+    // Older packets are recorded in spill, if there is one, as they are pushed out.
+    _CCNxTestrigLoggedPacket *packetLog;
+    size_t packetLogCapacity;
+    size_t loggedPackets;
+    CCNxTestrigCapture *spill;
     bool passed;
     char *reason;
+
+    // The step the test failed at, counting from 1, or 0.
+    size_t failedStep;
+    uint64_t duration;
+    uint64_t packetsSent;
+    uint64_t packetsReceived;
+
+    CCNxTestrigHistogram *latency;
+    _CCNxTestrigLinkPairLatency *linkPairs;
+    size_t numberOfLinkPairs;
 };
 
 static bool
@@ -68,10 +93,23 @@ _ccnxTestrigSuiteTestResult_Destructor(CCNxTestrigSuiteTestResult **resultPtr)
 {
     CCNxTestrigSuiteTestResult *result = *resultPtr;
 
-    if (result->packetList != NULL) {
-        parcLinkedList_Release(&(result->packetList));
+    size_t held = result->loggedPackets < result->packetLogCapacity ? result->loggedPackets : result->packetLogCapacity;
+    for (size_t i = 0; i < held; i++) {
+        parcBuffer_Release(&result->packetLog[i].packet);
+    }
+    free(result->packetLog);
+    if (result->spill != NULL) {
+        ccnxTestrigCapture_Release(&result->spill);
     }
 
+    ccnxTestrigHistogram_Release(&result->latency);
+    for (size_t i = 0; i < result->numberOfLinkPairs; i++) {
+        ccnxTestrigHistogram_Release(&result->linkPairs[i].latency);
+    }
+    free(result->linkPairs);
+    free(result->reason);
+    free(result->testCase);
+
     return true;
 }
 
@@ -89,9 +127,19 @@ ccnxTestrigSuiteTestResult_Create(char *testCase)
 
     if (result != NULL) {
         result->passed = true;
-        result->testCase = malloc(strlen(testCase));
-        strcpy(result->testCase, testCase);
-        result->packetList = parcLinkedList_Create();
+        result->reason = NULL;
+        result->failedStep = 0;
+        result->duration = 0;
+        result->packetsSent = 0;
+        result->packetsReceived = 0;
+        result->testCase = strdup(testCase);
+        result->packetLog = NULL;
+        result->packetLogCapacity = CCNX_TESTRIG_DEFAULT_PACKET_LOG_CAPACITY;
+        result->loggedPackets = 0;
+        result->spill = NULL;
+        result->latency = ccnxTestrigHistogram_Create();
+        result->linkPairs = NULL;
+        result->numberOfLinkPairs = 0;
     }
 
     return result;
@@ -107,48 +155,186 @@ ccnxTestrigSuiteTestResult_SetPass(CCNxTestrigSuiteTestResult *testCase)
 CCNxTestrigSuiteTestResult *
 ccnxTestrigSuiteTestResult_SetFail(CCNxTestrigSuiteTestResult *testCase, char *reason)
 {
-    testCase->reason = malloc(strlen(reason));
-    strcpy(testCase->reason, reason);
+    free(testCase->reason);
+    testCase->reason = strdup(reason);
     testCase->passed = false;
     return testCase;
 }
 
-static void
-_ccnxTestrigSuiteTestResult_Failed(CCNxTestrigSuiteTestResult *result, CCNxTestrigReporter *reporter)
+void
+ccnxTestrigSuiteTestResult_Report(CCNxTestrigSuiteTestResult *result, CCNxTestrigReporter *reporter)
 {
-    char *message = NULL;
-    asprintf(&message, "Test %s FAIL: %s", result->testCase, result->reason);
-    ccnxTestrigReporter_Report(reporter, message);
-    free(message);
+    CCNxTestrigReporterTest test = {
+        .testCase = result->testCase,
+        .passed = result->passed,
+        .failedStep = result->passed ? 0 : result->failedStep,
+        .reason = result->passed ? NULL : result->reason,
+        .duration = result->duration,
+        .packetsSent = result->packetsSent,
+        .packetsReceived = result->packetsReceived,
+        .latency = result->latency,
+        .memoryUsage = ccnxTestrigSuiteTestResult_GetMemoryUsage(result)
+    };
+    ccnxTestrigReporter_ReportTest(reporter, &test);
 }
 
-static void
-_ccnxTestrigSuiteTestResult_Passed(CCNxTestrigSuiteTestResult *result, CCNxTestrigReporter *reporter)
+bool
+ccnxTestrigSuiteTestResult_IsFailure(CCNxTestrigSuiteTestResult *testCase)
 {
-    char *message = NULL;
-    asprintf(&message, "Test %s PASS", result->testCase);
-    ccnxTestrigReporter_Report(reporter, message);
-    free(message);
+    return !testCase->passed;
 }
 
 void
-ccnxTestrigSuiteTestResult_Report(CCNxTestrigSuiteTestResult *result, CCNxTestrigReporter *reporter)
+ccnxTestrigSuiteTestResult_SetPacketLog(CCNxTestrigSuiteTestResult *testCase, size_t capacity, CCNxTestrigCapture *spill)
 {
-    if (result->passed) {
-        _ccnxTestrigSuiteTestResult_Passed(result, reporter);
-    } else {
-        _ccnxTestrigSuiteTestResult_Failed(result, reporter);
+    // The log is allocated by the first packet, so it can only be sized before then.
+    if (testCase->loggedPackets > 0) {
+        return;
     }
+
+    testCase->packetLogCapacity = capacity;
+    if (testCase->spill != NULL) {
+        ccnxTestrigCapture_Release(&testCase->spill);
+    }
+    testCase->spill = spill == NULL ? NULL : ccnxTestrigCapture_Acquire(spill);
 }
 
-bool
-ccnxTestrigSuiteTestResult_IsFailure(CCNxTestrigSuiteTestResult *testCase)
+void
+ccnxTestrigSuiteTestResult_LogPacket(CCNxTestrigSuiteTestResult *testCase, CCNxTestrigLinkID link, PARCBuffer *packet)
 {
-    return !testCase->passed;
+    if (testCase->packetLogCapacity == 0) {
+        if (testCase->spill != NULL) {
+            ccnxTestrigCapture_Record(testCase->spill, link - CCNxTestrigLinkID_LinkA, CCNxTestrigCaptureDirection_Outbound, packet);
+        }
+        return;
+    }
+
+    if (testCase->packetLog == NULL) {
+        testCase->packetLog = malloc(testCase->packetLogCapacity * sizeof(_CCNxTestrigLoggedPacket));
+        if (testCase->packetLog == NULL) {
+            testCase->packetLogCapacity = 0;
+            return;
+        }
+    }
+
+    _CCNxTestrigLoggedPacket *entry = &testCase->packetLog[testCase->loggedPackets % testCase->packetLogCapacity];
+    if (testCase->loggedPackets >= testCase->packetLogCapacity) {
+        if (testCase->spill != NULL) {
+            ccnxTestrigCapture_Record(testCase->spill, entry->link - CCNxTestrigLinkID_LinkA, CCNxTestrigCaptureDirection_Outbound, entry->packet);
+        }
+        parcBuffer_Release(&entry->packet);
+    }
+
+    entry->link = link;
+    entry->packet = parcBuffer_Acquire(packet);
+    testCase->loggedPackets++;
+}
+
+size_t
+ccnxTestrigSuiteTestResult_GetLoggedPacketCount(const CCNxTestrigSuiteTestResult *testCase)
+{
+    return testCase->loggedPackets < testCase->packetLogCapacity ? testCase->loggedPackets : testCase->packetLogCapacity;
+}
+
+PARCBuffer *
+ccnxTestrigSuiteTestResult_GetLoggedPacket(const CCNxTestrigSuiteTestResult *testCase, size_t index, CCNxTestrigLinkID *link)
+{
+    size_t oldest = testCase->loggedPackets - ccnxTestrigSuiteTestResult_GetLoggedPacketCount(testCase);
+    const _CCNxTestrigLoggedPacket *entry = &testCase->packetLog[(oldest + index) % testCase->packetLogCapacity];
+    *link = entry->link;
+    return entry->packet;
+}
+
+size_t
+ccnxTestrigSuiteTestResult_GetMemoryUsage(const CCNxTestrigSuiteTestResult *testCase)
+{
+    size_t usage = sizeof(CCNxTestrigSuiteTestResult) + strlen(testCase->testCase) + 1;
+    if (testCase->reason != NULL) {
+        usage += strlen(testCase->reason) + 1;
+    }
+
+    // The packets are shared with the script that sent them, but a logged packet is kept alive by the log.
+    if (testCase->packetLog != NULL) {
+        usage += testCase->packetLogCapacity * sizeof(_CCNxTestrigLoggedPacket);
+        for (size_t i = 0; i < ccnxTestrigSuiteTestResult_GetLoggedPacketCount(testCase); i++) {
+            usage += parcBuffer_Capacity(testCase->packetLog[i].packet);
+        }
+    }
+
+    usage += ccnxTestrigHistogram_GetMemoryUsage(testCase->latency);
+    usage += testCase->numberOfLinkPairs * sizeof(_CCNxTestrigLinkPairLatency);
+    for (size_t i = 0; i < testCase->numberOfLinkPairs; i++) {
+        usage += ccnxTestrigHistogram_GetMemoryUsage(testCase->linkPairs[i].latency);
+    }
+
+    return usage;
 }
 
 void
-ccnxTestrigSuiteTestResult_LogPacket(CCNxTestrigSuiteTestResult *testCase, PARCBuffer *packet)
+ccnxTestrigSuiteTestResult_SetFailedStep(CCNxTestrigSuiteTestResult *testCase, size_t step)
+{
+    testCase->failedStep = step;
+}
+
+void
+ccnxTestrigSuiteTestResult_SetDuration(CCNxTestrigSuiteTestResult *testCase, uint64_t duration)
+{
+    testCase->duration = duration;
+}
+
+void
+ccnxTestrigSuiteTestResult_CountPackets(CCNxTestrigSuiteTestResult *testCase, uint64_t sent, uint64_t received)
+{
+    testCase->packetsSent += sent;
+    testCase->packetsReceived += received;
+}
+
+void
+ccnxTestrigSuiteTestResult_RecordLatency(CCNxTestrigSuiteTestResult *testCase, CCNxTestrigLinkID sendLink,
+                                         CCNxTestrigLinkID receiveLink, uint64_t latency)
+{
+    ccnxTestrigHistogram_Record(testCase->latency, latency);
+
+    // A test touches only a handful of link pairs, so a linear search is all that is needed.
+    for (size_t i = 0; i < testCase->numberOfLinkPairs; i++) {
+        _CCNxTestrigLinkPairLatency *pair = &testCase->linkPairs[i];
+        if (pair->sendLink == sendLink && pair->receiveLink == receiveLink) {
+            ccnxTestrigHistogram_Record(pair->latency, latency);
+            return;
+        }
+    }
+
+    _CCNxTestrigLinkPairLatency *pairs = realloc(testCase->linkPairs, (testCase->numberOfLinkPairs + 1) * sizeof(_CCNxTestrigLinkPairLatency));
+    if (pairs == NULL) {
+        return;
+    }
+    testCase->linkPairs = pairs;
+
+    _CCNxTestrigLinkPairLatency *pair = &testCase->linkPairs[testCase->numberOfLinkPairs++];
+    pair->sendLink = sendLink;
+    pair->receiveLink = receiveLink;
+    pair->latency = ccnxTestrigHistogram_Create();
+    ccnxTestrigHistogram_Record(pair->latency, latency);
+}
+
+const CCNxTestrigHistogram *
+ccnxTestrigSuiteTestResult_GetLatency(const CCNxTestrigSuiteTestResult *testCase)
+{
+    return testCase->latency;
+}
+
+size_t
+ccnxTestrigSuiteTestResult_GetLinkPairCount(const CCNxTestrigSuiteTestResult *testCase)
+{
+    return testCase->numberOfLinkPairs;
+}
+
+const CCNxTestrigHistogram *
+ccnxTestrigSuiteTestResult_GetLinkPairLatency(const CCNxTestrigSuiteTestResult *testCase, size_t index,
+                                              CCNxTestrigLinkID *sendLink, CCNxTestrigLinkID *receiveLink)
 {
-    parcLinkedList_Append(testCase->packetList, packet);
+    const _CCNxTestrigLinkPairLatency *pair = &testCase->linkPairs[index];
+    *sendLink = pair->sendLink;
+    *receiveLink = pair->receiveLink;
+    return pair->latency;
 }
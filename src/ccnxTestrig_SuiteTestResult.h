@@ -55,10 +55,15 @@
 #ifndef ccnx_testrig_suitetestresult_h
 #define ccnx_testrig_suitetestresult_h
 
+#include "ccnxTestrig.h"
 #include "ccnxTestrig_Reporter.h"
+#include "ccnxTestrig_Histogram.h"
 
 #include <parc/algol/parc_Buffer.h>
 
+// The number of sent packets a result keeps for diagnosis, unless told otherwise.
+#define CCNX_TESTRIG_DEFAULT_PACKET_LOG_CAPACITY 16
+
 struct ccnx_testrig_testresult;
 typedef struct ccnx_testrig_testresult CCNxTestrigSuiteTestResult;
 
@@ -178,11 +183,35 @@ CCNxTestrigSuiteTestResult *ccnxTestrigSuiteTestResult_SetFail(CCNxTestrigSuiteT
 bool ccnxTestrigSuiteTestResult_IsFailure(CCNxTestrigSuiteTestResult *testCase);
 
 /**
- * Log a packet to this test case. This will accumulate the packet so that it can
- * later be retrieved for debugging purposes.
+ * Size the packet log of this test case, and have the packets it no longer holds recorded in a capture.
+ *
+ * The log holds the last `CCNX_TESTRIG_DEFAULT_PACKET_LOG_CAPACITY` packets unless it is sized
+ * before the first packet is logged.
  *
  * @param [in] testCase The `CCNxTestrigSuiteTestResult` to be amended.
- * @param [in] packet A wire-encoded packet in a `PARCBuffer`.
+ * @param [in] capacity The number of packets to hold, or 0 to hold none.
+ * @param [in] spill A started `CCNxTestrigCapture`, with an interface per link, or NULL to drop the older packets.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigSuiteTestResult *result = ccnxTestrigSuiteTestResult_Create("hard test");
+ *     ccnxTestrigSuiteTestResult_SetPacketLog(result, 64, NULL);
+ * }
+ * @endcode
+ */
+void ccnxTestrigSuiteTestResult_SetPacketLog(CCNxTestrigSuiteTestResult *testCase, size_t capacity, CCNxTestrigCapture *spill);
+
+/**
+ * Log a packet sent by this test case, so that it can later be retrieved for debugging purposes.
+ *
+ * The log is a ring of a fixed number of packets, so a test holds the same memory however
+ * many packets it sends. Logging the packet that does not fit pushes out the oldest packet,
+ * which is recorded in the spill capture, if there is one.
+ *
+ * @param [in] testCase The `CCNxTestrigSuiteTestResult` to be amended.
+ * @param [in] link The link on which the packet was sent.
+ * @param [in] packet A wire-encoded packet in a `PARCBuffer`, which is acquired, not copied.
  *
  * Example:
  * @code
@@ -190,25 +219,203 @@ bool ccnxTestrigSuiteTestResult_IsFailure(CCNxTestrigSuiteTestResult *testCase);
  *     CCNxTestrigSuiteTestResult *result = ccnxTestrigSuiteTestResult_Create("hard test");
  *     ...
  *     PARCBuffer *packet = ...
- *     ccnxTestrigSuiteTestResult_LogPacket(result, packet);
+ *     ccnxTestrigSuiteTestResult_LogPacket(result, CCNxTestrigLinkID_LinkA, packet);
+ * }
+ * @endcode
+ */
+void ccnxTestrigSuiteTestResult_LogPacket(CCNxTestrigSuiteTestResult *testCase, CCNxTestrigLinkID link, PARCBuffer *packet);
+
+/**
+ * Retrieve the number of packets the log holds.
+ *
+ * @param [in] testCase A `CCNxTestrigSuiteTestResult` instance.
+ *
+ * @return The number of packets, at most the capacity of the log.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t count = ccnxTestrigSuiteTestResult_GetLoggedPacketCount(result);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigSuiteTestResult_GetLoggedPacketCount(const CCNxTestrigSuiteTestResult *testCase);
+
+/**
+ * Retrieve a packet from the log, counting from the oldest one it holds.
+ *
+ * @param [in] testCase A `CCNxTestrigSuiteTestResult` instance.
+ * @param [in] index The index, less than `ccnxTestrigSuiteTestResult_GetLoggedPacketCount`.
+ * @param [out] link The link on which the packet was sent.
+ *
+ * @return The packet, which remains owned by the result.
+ *
+ * Example:
+ * @code
+ * {
+ *     for (size_t i = 0; i < ccnxTestrigSuiteTestResult_GetLoggedPacketCount(result); i++) {
+ *         CCNxTestrigLinkID link;
+ *         PARCBuffer *packet = ccnxTestrigSuiteTestResult_GetLoggedPacket(result, i, &link);
+ *     }
+ * }
+ * @endcode
+ */
+PARCBuffer *ccnxTestrigSuiteTestResult_GetLoggedPacket(const CCNxTestrigSuiteTestResult *testCase, size_t index, CCNxTestrigLinkID *link);
+
+/**
+ * Retrieve the number of bytes the result holds, including the packets in its log and its histograms.
+ *
+ * @param [in] testCase A `CCNxTestrigSuiteTestResult` instance.
+ *
+ * @return The number of bytes.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t bytes = ccnxTestrigSuiteTestResult_GetMemoryUsage(result);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigSuiteTestResult_GetMemoryUsage(const CCNxTestrigSuiteTestResult *testCase);
+
+/**
+ * Record the step at which the test failed.
+ *
+ * @param [in] testCase The `CCNxTestrigSuiteTestResult` to be amended.
+ * @param [in] step The step, counting from 1.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (ccnxTestrigSuiteTestResult_IsFailure(result)) {
+ *         ccnxTestrigSuiteTestResult_SetFailedStep(result, step);
+ *     }
  * }
  * @endcode
  */
-void ccnxTestrigSuiteTestResult_LogPacket(CCNxTestrigSuiteTestResult *testCase, PARCBuffer *packet);
+void ccnxTestrigSuiteTestResult_SetFailedStep(CCNxTestrigSuiteTestResult *testCase, size_t step);
+
+/**
+ * Record the time it took to run the test.
+ *
+ * @param [in] testCase The `CCNxTestrigSuiteTestResult` to be amended.
+ * @param [in] duration The time, in nanoseconds.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigSuiteTestResult_SetDuration(result, ccnxTestrig_GetTime() - startTime);
+ * }
+ * @endcode
+ */
+void ccnxTestrigSuiteTestResult_SetDuration(CCNxTestrigSuiteTestResult *testCase, uint64_t duration);
+
+/**
+ * Add to the number of packets the test sent and received.
+ *
+ * @param [in] testCase The `CCNxTestrigSuiteTestResult` to be amended.
+ * @param [in] sent The number of packets sent.
+ * @param [in] received The number of packets received.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigSuiteTestResult_CountPackets(result, 1, 0);
+ * }
+ * @endcode
+ */
+void ccnxTestrigSuiteTestResult_CountPackets(CCNxTestrigSuiteTestResult *testCase, uint64_t sent, uint64_t received);
+
+/**
+ * Record the forwarding latency of a packet that was sent on one link and received on another.
+ *
+ * The latency is added to the histogram of the whole test and to the histogram of the link pair.
+ *
+ * @param [in] testCase The `CCNxTestrigSuiteTestResult` to be amended.
+ * @param [in] sendLink The link on which the packet was sent.
+ * @param [in] receiveLink The link on which the packet was received.
+ * @param [in] latency The time between the send and the receive, in nanoseconds.
+ *
+ * Example:
+ * @code
+ * {
+ *     ccnxTestrigSuiteTestResult_RecordLatency(result, CCNxTestrigLinkID_LinkA, CCNxTestrigLinkID_LinkC, receiveTime - sendTime);
+ * }
+ * @endcode
+ */
+void ccnxTestrigSuiteTestResult_RecordLatency(CCNxTestrigSuiteTestResult *testCase, CCNxTestrigLinkID sendLink,
+                                              CCNxTestrigLinkID receiveLink, uint64_t latency);
+
+/**
+ * Retrieve the histogram of every latency recorded in the test.
+ *
+ * @param [in] testCase A `CCNxTestrigSuiteTestResult` instance.
+ *
+ * @return The latency histogram, which remains owned by the result.
+ *
+ * Example:
+ * @code
+ * {
+ *     const CCNxTestrigHistogram *latency = ccnxTestrigSuiteTestResult_GetLatency(result);
+ * }
+ * @endcode
+ */
+const CCNxTestrigHistogram *ccnxTestrigSuiteTestResult_GetLatency(const CCNxTestrigSuiteTestResult *testCase);
+
+/**
+ * Retrieve the number of link pairs for which latencies were recorded.
+ *
+ * @param [in] testCase A `CCNxTestrigSuiteTestResult` instance.
+ *
+ * @return The number of link pairs.
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t numberOfPairs = ccnxTestrigSuiteTestResult_GetLinkPairCount(result);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigSuiteTestResult_GetLinkPairCount(const CCNxTestrigSuiteTestResult *testCase);
+
+/**
+ * Retrieve the latency histogram of one link pair.
+ *
+ * @param [in] testCase A `CCNxTestrigSuiteTestResult` instance.
+ * @param [in] index The index of the link pair, less than `ccnxTestrigSuiteTestResult_GetLinkPairCount`.
+ * @param [out] sendLink Set to the link on which the packets were sent.
+ * @param [out] receiveLink Set to the link on which the packets were received.
+ *
+ * @return The latency histogram of the pair, which remains owned by the result.
+ *
+ * Example:
+ * @code
+ * {
+ *     for (size_t i = 0; i < ccnxTestrigSuiteTestResult_GetLinkPairCount(result); i++) {
+ *         CCNxTestrigLinkID from, to;
+ *         const CCNxTestrigHistogram *latency = ccnxTestrigSuiteTestResult_GetLinkPairLatency(result, i, &from, &to);
+ *     }
+ * }
+ * @endcode
+ */
+const CCNxTestrigHistogram *ccnxTestrigSuiteTestResult_GetLinkPairLatency(const CCNxTestrigSuiteTestResult *testCase, size_t index,
+                                                                          CCNxTestrigLinkID *sendLink, CCNxTestrigLinkID *receiveLink);
 
 /**
  * Report a `CCNxTestrigSuiteTestResult` instance.
  *
+ * The verdict, failed step, reason, duration, packet counts and latency of the test are
+ * reported as one record, which the reporter writes in its format.
+ *
  * @param [in] testCase The `CCNxTestrigSuiteTestResult` to be reported.
  * @param [in] reporter A `CCNxTestrigReporter` instance.
  *
  * Example:
  * @code
  * {
- *     CCNxTestrigSuiteTestResult *result = ccnxTestrigSuiteTestResult_Create("hard test");
- *     ...
- *     PARCBuffer *packet = ...
- *     ccnxTestrigSuiteTestResult_LogPacket(result, packet);
+ *     CCNxTestrigSuiteTestResult *result = ccnxTestrigScript_Execute(script, rig);
+ *
+ *     ccnxTestrigSuiteTestResult_Report(result, ccnxTestrig_GetReporter(rig));
  * }
  * @endcode
  */
@@ -0,0 +1,726 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#include <parc/algol/parc_Object.h>
+
+#include "ccnxTestrig_URing.h"
+
+// Provided receive buffers. A power of two, as the kernel requires of a buffer ring.
+#define RECEIVE_BUFFERS 256
+#define RECEIVE_BUFFER_GROUP 0
+
+// Sends queued per submission; larger batches are submitted in several rounds.
+#define SEND_ENTRIES 256
+
+// Milliseconds the submission polling thread spins before it goes to sleep.
+#define SUBMISSION_POLLING_IDLE 50
+
+// Nanoseconds a sender on a polled ring spins for its completions before it waits in the kernel.
+#define SEND_SPIN_TIME 100000
+
+// The socket is the only registered file of each ring.
+#define FIXED_SOCKET 0
+
+#define RECEIVE_USER_DATA UINT64_MAX
+#define CANCEL_USER_DATA (UINT64_MAX - 1)
+
+/**
+ * The memory shared with the kernel for one ring, and the addresses of its indices within it.
+ */
+typedef struct {
+    int descriptor;
+    bool polling;
+
+    void *submissionMemory;
+    size_t submissionMemorySize;
+    void *completionMemory;
+    size_t completionMemorySize;
+    struct io_uring_sqe *entries;
+    size_t entriesSize;
+
+    unsigned *submissionHead;
+    unsigned *submissionTail;
+    unsigned *submissionFlags;
+    unsigned submissionMask;
+    unsigned *submissionArray;
+
+    unsigned *completionHead;
+    unsigned *completionTail;
+    unsigned completionMask;
+    struct io_uring_cqe *completions;
+} _CCNxTestrigURingQueue;
+
+/**
+ * A receive completion whose buffer has not been copied out yet.
+ */
+typedef struct {
+    uint16_t bufferID;
+    uint32_t length;
+} _CCNxTestrigURingDatagram;
+
+struct ccnx_testrig_uring {
+    int socket;
+    size_t bufferSize;
+
+    _CCNxTestrigURingQueue receiveQueue;
+    struct msghdr receiveMessage;
+
+    // The provided buffers and the ring that hands them to the kernel.
+    uint8_t *buffers;
+    size_t bufferStride;
+    struct io_uring_buf_ring *bufferRing;
+    size_t bufferRingSize;
+
+    // Reaped datagrams, oldest at pendingStart. Each holds a distinct buffer, so RECEIVE_BUFFERS entries suffice.
+    _CCNxTestrigURingDatagram pending[RECEIVE_BUFFERS];
+    size_t pendingStart;
+    size_t pendingCount;
+
+    // Whether the multishot receive is armed. It stops when it runs out of buffers, and is
+    // rearmed once half of them are back, rather than failing again on every call.
+    bool receiving;
+
+    pthread_mutex_t sendLock;
+    _CCNxTestrigURingQueue sendQueue;
+    struct msghdr sendMessages[SEND_ENTRIES];
+    struct iovec sendVectors[SEND_ENTRIES];
+    struct sockaddr_in sendTarget;
+};
+
+static int
+_ccnxTestrigURing_Setup(unsigned entries, struct io_uring_params *params)
+{
+    return (int) syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int
+_ccnxTestrigURing_Enter(int descriptor, unsigned toSubmit, unsigned minComplete, unsigned flags, void *argument, size_t argumentSize)
+{
+    return (int) syscall(__NR_io_uring_enter, descriptor, toSubmit, minComplete, flags, argument, argumentSize);
+}
+
+static int
+_ccnxTestrigURing_Register(int descriptor, unsigned opcode, void *argument, unsigned count)
+{
+    return (int) syscall(__NR_io_uring_register, descriptor, opcode, argument, count);
+}
+
+static uint64_t
+_ccnxTestrigURing_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void
+_ccnxTestrigURingQueue_Destroy(_CCNxTestrigURingQueue *queue)
+{
+    if (queue->entries != NULL) {
+        munmap(queue->entries, queue->entriesSize);
+    }
+    if (queue->completionMemory != NULL && queue->completionMemory != queue->submissionMemory) {
+        munmap(queue->completionMemory, queue->completionMemorySize);
+    }
+    if (queue->submissionMemory != NULL) {
+        munmap(queue->submissionMemory, queue->submissionMemorySize);
+    }
+    if (queue->descriptor >= 0) {
+        close(queue->descriptor);
+    }
+    memset(queue, 0, sizeof(*queue));
+    queue->descriptor = -1;
+}
+
+/**
+ * Set up a ring, map it, and register the socket as its fixed file.
+ */
+static bool
+_ccnxTestrigURingQueue_Init(_CCNxTestrigURingQueue *queue, unsigned entries, unsigned completionEntries, bool polling, int socket)
+{
+    memset(queue, 0, sizeof(*queue));
+    queue->polling = polling;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = completionEntries;
+    if (polling) {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = SUBMISSION_POLLING_IDLE;
+    }
+
+    queue->descriptor = _ccnxTestrigURing_Setup(entries, &params);
+    if (queue->descriptor < 0) {
+        perror("io_uring_setup() failed");
+        return false;
+    }
+
+    queue->submissionMemorySize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    queue->completionMemorySize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMapping && queue->completionMemorySize > queue->submissionMemorySize) {
+        queue->submissionMemorySize = queue->completionMemorySize;
+    }
+
+    queue->submissionMemory = mmap(NULL, queue->submissionMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                   queue->descriptor, IORING_OFF_SQ_RING);
+    if (queue->submissionMemory == MAP_FAILED) {
+        queue->submissionMemory = NULL;
+        perror("mmap() of the submission ring failed");
+        _ccnxTestrigURingQueue_Destroy(queue);
+        return false;
+    }
+    if (singleMapping) {
+        queue->completionMemory = queue->submissionMemory;
+    } else {
+        queue->completionMemory = mmap(NULL, queue->completionMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                       queue->descriptor, IORING_OFF_CQ_RING);
+        if (queue->completionMemory == MAP_FAILED) {
+            queue->completionMemory = NULL;
+            perror("mmap() of the completion ring failed");
+            _ccnxTestrigURingQueue_Destroy(queue);
+            return false;
+        }
+    }
+    queue->entriesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    queue->entries = mmap(NULL, queue->entriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          queue->descriptor, IORING_OFF_SQES);
+    if (queue->entries == MAP_FAILED) {
+        queue->entries = NULL;
+        perror("mmap() of the submission entries failed");
+        _ccnxTestrigURingQueue_Destroy(queue);
+        return false;
+    }
+
+    uint8_t *submission = queue->submissionMemory;
+    queue->submissionHead = (unsigned *) (submission + params.sq_off.head);
+    queue->submissionTail = (unsigned *) (submission + params.sq_off.tail);
+    queue->submissionFlags = (unsigned *) (submission + params.sq_off.flags);
+    queue->submissionMask = *(unsigned *) (submission + params.sq_off.ring_mask);
+    queue->submissionArray = (unsigned *) (submission + params.sq_off.array);
+
+    uint8_t *completion = queue->completionMemory;
+    queue->completionHead = (unsigned *) (completion + params.cq_off.head);
+    queue->completionTail = (unsigned *) (completion + params.cq_off.tail);
+    queue->completionMask = *(unsigned *) (completion + params.cq_off.ring_mask);
+    queue->completions = (struct io_uring_cqe *) (completion + params.cq_off.cqes);
+
+    // Entry i always sits in slot i of the indirection array.
+    for (unsigned i = 0; i < params.sq_entries; i++) {
+        queue->submissionArray[i] = i;
+    }
+
+    if (_ccnxTestrigURing_Register(queue->descriptor, IORING_REGISTER_FILES, &socket, 1) < 0) {
+        perror("Registering the socket with io_uring failed");
+        _ccnxTestrigURingQueue_Destroy(queue);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Claim the next submission entry, which is published by `_ccnxTestrigURingQueue_Publish`.
+ */
+static struct io_uring_sqe *
+_ccnxTestrigURingQueue_NextEntry(_CCNxTestrigURingQueue *queue, unsigned index)
+{
+    struct io_uring_sqe *entry = &queue->entries[index & queue->submissionMask];
+    memset(entry, 0, sizeof(*entry));
+    return entry;
+}
+
+/**
+ * Make the claimed entries visible to the kernel, and submit them unless a polling thread picks them up.
+ */
+static bool
+_ccnxTestrigURingQueue_Publish(_CCNxTestrigURingQueue *queue, unsigned tail, unsigned count, unsigned minComplete, uint64_t *systemCalls)
+{
+    __atomic_store_n(queue->submissionTail, tail, __ATOMIC_RELEASE);
+
+    unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    if (queue->polling) {
+        // The tail store must be visible before the polling thread's sleep flag is read.
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if ((__atomic_load_n(queue->submissionFlags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP) == 0) {
+            return true;
+        }
+        flags = IORING_ENTER_SQ_WAKEUP;
+        count = 0;
+        minComplete = 0;
+    }
+
+    (*systemCalls)++;
+    while (_ccnxTestrigURing_Enter(queue->descriptor, count, minComplete, flags, NULL, 0) < 0) {
+        if (errno != EINTR) {
+            perror("io_uring_enter() failed");
+            return false;
+        }
+    }
+    return true;
+}
+
+static void
+_ccnxTestrigURing_ArmReceive(CCNxTestrigURing *ring, uint64_t *systemCalls)
+{
+    _CCNxTestrigURingQueue *queue = &ring->receiveQueue;
+    unsigned tail = *queue->submissionTail;
+
+    struct io_uring_sqe *entry = _ccnxTestrigURingQueue_NextEntry(queue, tail);
+    entry->opcode = IORING_OP_RECVMSG;
+    entry->fd = FIXED_SOCKET;
+    entry->flags = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+    entry->ioprio = IORING_RECV_MULTISHOT;
+    entry->addr = (uintptr_t) &ring->receiveMessage;
+    entry->len = 1;
+    entry->buf_group = RECEIVE_BUFFER_GROUP;
+    entry->user_data = RECEIVE_USER_DATA;
+
+    ring->receiving = _ccnxTestrigURingQueue_Publish(queue, tail + 1, 1, 0, systemCalls);
+}
+
+static void
+_ccnxTestrigURing_ProvideBuffer(CCNxTestrigURing *ring, uint16_t bufferID)
+{
+    unsigned short tail = ring->bufferRing->tail;
+    struct io_uring_buf *buffer = &ring->bufferRing->bufs[tail & (RECEIVE_BUFFERS - 1)];
+    buffer->addr = (uintptr_t) (ring->buffers + (size_t) bufferID * ring->bufferStride);
+    buffer->len = (uint32_t) ring->bufferStride;
+    buffer->bid = bufferID;
+    __atomic_store_n(&ring->bufferRing->tail, (unsigned short) (tail + 1), __ATOMIC_RELEASE);
+}
+
+/**
+ * Move the receive completions to the pending datagrams, and rearm the receive if it stopped
+ * and enough buffers are free.
+ *
+ * The multishot receive stops when it runs out of provided buffers or fails.
+ */
+static void
+_ccnxTestrigURing_Reap(CCNxTestrigURing *ring, uint64_t *systemCalls)
+{
+    _CCNxTestrigURingQueue *queue = &ring->receiveQueue;
+    unsigned head = *queue->completionHead;
+    unsigned tail = __atomic_load_n(queue->completionTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+        struct io_uring_cqe *completion = &queue->completions[head & queue->completionMask];
+        if (completion->user_data != RECEIVE_USER_DATA) {
+            continue;
+        }
+        if ((completion->flags & IORING_CQE_F_MORE) == 0) {
+            ring->receiving = false;
+        }
+        if ((completion->flags & IORING_CQE_F_BUFFER) != 0) {
+            uint16_t bufferID = (uint16_t) (completion->flags >> IORING_CQE_BUFFER_SHIFT);
+            if (completion->res >= 0) {
+                _CCNxTestrigURingDatagram *datagram = &ring->pending[(ring->pendingStart + ring->pendingCount) % RECEIVE_BUFFERS];
+                datagram->bufferID = bufferID;
+                datagram->length = (uint32_t) completion->res;
+                ring->pendingCount++;
+            } else {
+                _ccnxTestrigURing_ProvideBuffer(ring, bufferID);
+            }
+        } else if (completion->res < 0 && completion->res != -ENOBUFS) {
+            errno = -completion->res;
+            perror("io_uring receive failed");
+        }
+    }
+    __atomic_store_n(queue->completionHead, head, __ATOMIC_RELEASE);
+
+    if (!ring->receiving && ring->pendingCount <= RECEIVE_BUFFERS / 2) {
+        _ccnxTestrigURing_ArmReceive(ring, systemCalls);
+    }
+}
+
+/**
+ * Cancel the armed receive and wait until the kernel lets go of it, so its buffers can be freed.
+ *
+ * Closing the ring would cancel it too, but asynchronously, while a datagram may still land in a buffer.
+ */
+static void
+_ccnxTestrigURing_CancelReceive(CCNxTestrigURing *ring)
+{
+    _CCNxTestrigURingQueue *queue = &ring->receiveQueue;
+    unsigned tail = *queue->submissionTail;
+
+    struct io_uring_sqe *entry = _ccnxTestrigURingQueue_NextEntry(queue, tail);
+    entry->opcode = IORING_OP_ASYNC_CANCEL;
+    entry->addr = RECEIVE_USER_DATA;
+    entry->user_data = CANCEL_USER_DATA;
+
+    uint64_t systemCalls = 0;
+    if (!_ccnxTestrigURingQueue_Publish(queue, tail + 1, 1, 1, &systemCalls)) {
+        return;
+    }
+
+    for (;;) {
+        unsigned head = *queue->completionHead;
+        unsigned completionTail = __atomic_load_n(queue->completionTail, __ATOMIC_ACQUIRE);
+        bool cancelled = false;
+        for (; head != completionTail && !cancelled; head++) {
+            cancelled = queue->completions[head & queue->completionMask].user_data == CANCEL_USER_DATA;
+        }
+        __atomic_store_n(queue->completionHead, head, __ATOMIC_RELEASE);
+        if (cancelled) {
+            return;
+        }
+        if (_ccnxTestrigURing_Enter(queue->descriptor, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR) {
+            perror("io_uring_enter() failed");
+            return;
+        }
+    }
+}
+
+static bool
+_ccnxTestrigURing_Destructor(CCNxTestrigURing **ringPtr)
+{
+    CCNxTestrigURing *ring = *ringPtr;
+
+    if (ring->receiveQueue.descriptor >= 0) {
+        _ccnxTestrigURing_CancelReceive(ring);
+    }
+    _ccnxTestrigURingQueue_Destroy(&ring->receiveQueue);
+    _ccnxTestrigURingQueue_Destroy(&ring->sendQueue);
+    if (ring->bufferRing != NULL) {
+        munmap(ring->bufferRing, ring->bufferRingSize);
+    }
+    free(ring->buffers);
+    pthread_mutex_destroy(&ring->sendLock);
+
+    return true;
+}
+
+parcObject_ImplementAcquire(ccnxTestrigURing, CCNxTestrigURing);
+parcObject_ImplementRelease(ccnxTestrigURing, CCNxTestrigURing);
+
+parcObject_Override(
+	CCNxTestrigURing, PARCObject,
+	.destructor = (PARCObjectDestructor *) _ccnxTestrigURing_Destructor);
+
+CCNxTestrigURing *
+ccnxTestrigURing_Create(int socket, size_t bufferSize)
+{
+    CCNxTestrigURing *ring = parcObject_CreateInstance(CCNxTestrigURing);
+    if (ring == NULL) {
+        return NULL;
+    }
+
+    ring->socket = socket;
+    ring->bufferSize = bufferSize;
+    memset(&ring->receiveQueue, 0, sizeof(ring->receiveQueue));
+    ring->receiveQueue.descriptor = -1;
+    memset(&ring->sendQueue, 0, sizeof(ring->sendQueue));
+    ring->sendQueue.descriptor = -1;
+    ring->buffers = NULL;
+    ring->bufferRing = NULL;
+    ring->pendingStart = 0;
+    ring->pendingCount = 0;
+    ring->receiving = false;
+    pthread_mutex_init(&ring->sendLock, NULL);
+
+    // Each buffer starts with the recvmsg header, the source address and room for a timestamp, followed by the datagram.
+    memset(&ring->receiveMessage, 0, sizeof(ring->receiveMessage));
+    ring->receiveMessage.msg_namelen = sizeof(struct sockaddr_in);
+    ring->receiveMessage.msg_controllen = CMSG_SPACE(sizeof(struct timespec));
+    ring->bufferStride = sizeof(struct io_uring_recvmsg_out) + ring->receiveMessage.msg_namelen + ring->receiveMessage.msg_controllen + bufferSize;
+
+    // Every provided buffer can complete before the receiver catches up, so the completion ring holds them all.
+    if (!_ccnxTestrigURingQueue_Init(&ring->receiveQueue, 4, 2 * RECEIVE_BUFFERS, false, socket)
+        || !_ccnxTestrigURingQueue_Init(&ring->sendQueue, SEND_ENTRIES, SEND_ENTRIES, false, socket)) {
+        ccnxTestrigURing_Release(&ring);
+        return NULL;
+    }
+
+    ring->buffers = malloc(RECEIVE_BUFFERS * ring->bufferStride);
+    ring->bufferRingSize = RECEIVE_BUFFERS * sizeof(struct io_uring_buf);
+    ring->bufferRing = mmap(NULL, ring->bufferRingSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (ring->bufferRing == MAP_FAILED) {
+        ring->bufferRing = NULL;
+        perror("mmap() of the buffer ring failed");
+        ccnxTestrigURing_Release(&ring);
+        return NULL;
+    }
+
+    struct io_uring_buf_reg registration;
+    memset(&registration, 0, sizeof(registration));
+    registration.ring_addr = (uintptr_t) ring->bufferRing;
+    registration.ring_entries = RECEIVE_BUFFERS;
+    registration.bgid = RECEIVE_BUFFER_GROUP;
+    if (_ccnxTestrigURing_Register(ring->receiveQueue.descriptor, IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+        perror("Registering the receive buffers with io_uring failed");
+        ccnxTestrigURing_Release(&ring);
+        return NULL;
+    }
+
+    for (uint16_t i = 0; i < RECEIVE_BUFFERS; i++) {
+        _ccnxTestrigURing_ProvideBuffer(ring, i);
+    }
+
+    uint64_t systemCalls = 0;
+    _ccnxTestrigURing_ArmReceive(ring, &systemCalls);
+
+    return ring;
+}
+
+bool
+ccnxTestrigURing_SetSubmissionPolling(CCNxTestrigURing *ring, bool enabled)
+{
+    pthread_mutex_lock(&ring->sendLock);
+    _ccnxTestrigURingQueue_Destroy(&ring->sendQueue);
+    bool result = _ccnxTestrigURingQueue_Init(&ring->sendQueue, SEND_ENTRIES, SEND_ENTRIES, enabled, ring->socket);
+    if (!result && enabled) {
+        _ccnxTestrigURingQueue_Init(&ring->sendQueue, SEND_ENTRIES, SEND_ENTRIES, false, ring->socket);
+    }
+    pthread_mutex_unlock(&ring->sendLock);
+    return result;
+}
+
+int
+ccnxTestrigURing_GetDescriptor(const CCNxTestrigURing *ring)
+{
+    return ring->receiveQueue.descriptor;
+}
+
+bool
+ccnxTestrigURing_HasPendingDatagram(const CCNxTestrigURing *ring)
+{
+    return ring->pendingCount > 0;
+}
+
+/**
+ * Find the SCM_TIMESTAMPNS control message of a received datagram, which sits between its source address and its payload.
+ */
+static uint64_t
+_ccnxTestrigURing_GetKernelTime(const CCNxTestrigURing *ring, uint8_t *buffer)
+{
+    struct io_uring_recvmsg_out *header = (struct io_uring_recvmsg_out *) buffer;
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_control = buffer + sizeof(*header) + ring->receiveMessage.msg_namelen;
+    message.msg_controllen = header->controllen;
+
+    for (struct cmsghdr *control = CMSG_FIRSTHDR(&message); control != NULL; control = CMSG_NXTHDR(&message, control)) {
+        if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPNS) {
+            struct timespec stamp;
+            memcpy(&stamp, CMSG_DATA(control), sizeof(stamp));
+            return (uint64_t) stamp.tv_sec * 1000000000ULL + stamp.tv_nsec;
+        }
+    }
+    return 0;
+}
+
+ssize_t
+ccnxTestrigURing_Receive(CCNxTestrigURing *ring, uint8_t *data, size_t capacity, struct sockaddr_in *source, uint64_t *kernelTime,
+                         int timeout, uint64_t *systemCalls)
+{
+    _ccnxTestrigURing_Reap(ring, systemCalls);
+
+    // A completion that carries no datagram, such as the end of a multishot receive, does not end the wait.
+    uint64_t deadline = timeout < 0 ? 0 : _ccnxTestrigURing_Now() + (uint64_t) timeout * 1000000ULL;
+    while (ring->pendingCount == 0 && timeout != 0) {
+        struct __kernel_timespec timespec;
+        struct io_uring_getevents_arg argument;
+        memset(&argument, 0, sizeof(argument));
+        unsigned flags = IORING_ENTER_GETEVENTS;
+        if (timeout > 0) {
+            uint64_t now = _ccnxTestrigURing_Now();
+            if (now >= deadline) {
+                break;
+            }
+            timespec.tv_sec = (deadline - now) / 1000000000ULL;
+            timespec.tv_nsec = (deadline - now) % 1000000000ULL;
+            argument.ts = (uintptr_t) &timespec;
+            flags |= IORING_ENTER_EXT_ARG;
+        }
+
+        (*systemCalls)++;
+        if (_ccnxTestrigURing_Enter(ring->receiveQueue.descriptor, 0, 1, flags, timeout > 0 ? &argument : NULL, timeout > 0 ? sizeof(argument) : 0) < 0) {
+            if (errno == ETIME) {
+                break;
+            } else if (errno != EINTR) {
+                perror("io_uring_enter() failed");
+                break;
+            }
+        }
+        _ccnxTestrigURing_Reap(ring, systemCalls);
+    }
+
+    if (ring->pendingCount == 0) {
+        return -1;
+    }
+
+    _CCNxTestrigURingDatagram *datagram = &ring->pending[ring->pendingStart];
+    ring->pendingStart = (ring->pendingStart + 1) % RECEIVE_BUFFERS;
+    ring->pendingCount--;
+
+    uint8_t *buffer = ring->buffers + (size_t) datagram->bufferID * ring->bufferStride;
+    struct io_uring_recvmsg_out *header = (struct io_uring_recvmsg_out *) buffer;
+    if (header->namelen >= sizeof(struct sockaddr_in)) {
+        memcpy(source, buffer + sizeof(*header), sizeof(struct sockaddr_in));
+    }
+
+    // The completion gives what the buffer holds; a truncated datagram reports its full length in the header.
+    size_t offset = sizeof(*header) + ring->receiveMessage.msg_namelen + ring->receiveMessage.msg_controllen;
+    size_t length = datagram->length > offset ? datagram->length - offset : 0;
+    if (length > header->payloadlen) {
+        length = header->payloadlen;
+    }
+    if (length > capacity) {
+        length = capacity;
+    }
+    memcpy(data, buffer + offset, length);
+    *kernelTime = _ccnxTestrigURing_GetKernelTime(ring, buffer);
+
+    _ccnxTestrigURing_ProvideBuffer(ring, datagram->bufferID);
+    return (ssize_t) length;
+}
+
+/**
+ * Wait for a number of send completions and count the successful ones.
+ */
+static size_t
+_ccnxTestrigURing_CompleteSends(CCNxTestrigURing *ring, unsigned count, uint64_t *systemCalls)
+{
+    _CCNxTestrigURingQueue *queue = &ring->sendQueue;
+    size_t sent = 0;
+    uint64_t spinDeadline = queue->polling ? _ccnxTestrigURing_Now() + SEND_SPIN_TIME : 0;
+
+    while (count > 0) {
+        unsigned head = *queue->completionHead;
+        unsigned tail = __atomic_load_n(queue->completionTail, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            // A polled ring is spun on for a while, as sleeping in the kernel costs as much as a submission.
+            if (queue->polling && _ccnxTestrigURing_Now() < spinDeadline) {
+                continue;
+            }
+            (*systemCalls)++;
+            if (_ccnxTestrigURing_Enter(queue->descriptor, 0, count, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR) {
+                perror("io_uring_enter() failed");
+                break;
+            }
+            continue;
+        }
+
+        for (; head != tail && count > 0; head++, count--) {
+            struct io_uring_cqe *completion = &queue->completions[head & queue->completionMask];
+            if (completion->res >= 0) {
+                sent++;
+            } else if (completion->res != -ECANCELED) {
+                errno = -completion->res;
+                perror("io_uring send failed");
+            }
+        }
+        __atomic_store_n(queue->completionHead, head, __ATOMIC_RELEASE);
+    }
+
+    return sent;
+}
+
+size_t
+ccnxTestrigURing_SendBatch(CCNxTestrigURing *ring, PARCBuffer **buffers, size_t count, const struct sockaddr_in *target, uint64_t *systemCalls)
+{
+    pthread_mutex_lock(&ring->sendLock);
+    _CCNxTestrigURingQueue *queue = &ring->sendQueue;
+    ring->sendTarget = *target;
+
+    size_t numSent = 0;
+    while (queue->descriptor >= 0 && numSent < count) {
+        unsigned batch = (unsigned) (count - numSent > SEND_ENTRIES ? SEND_ENTRIES : count - numSent);
+        unsigned tail = *queue->submissionTail;
+
+        for (unsigned i = 0; i < batch; i++) {
+            PARCBuffer *buffer = buffers[numSent + i];
+            ring->sendVectors[i].iov_base = parcBuffer_Overlay(buffer, 0);
+            ring->sendVectors[i].iov_len = parcBuffer_Remaining(buffer);
+            memset(&ring->sendMessages[i], 0, sizeof(ring->sendMessages[i]));
+            ring->sendMessages[i].msg_name = &ring->sendTarget;
+            ring->sendMessages[i].msg_namelen = sizeof(ring->sendTarget);
+            ring->sendMessages[i].msg_iov = &ring->sendVectors[i];
+            ring->sendMessages[i].msg_iovlen = 1;
+
+            struct io_uring_sqe *entry = _ccnxTestrigURingQueue_NextEntry(queue, tail + i);
+            entry->opcode = IORING_OP_SENDMSG;
+            entry->fd = FIXED_SOCKET;
+            entry->flags = IOSQE_FIXED_FILE | (i + 1 < batch ? IOSQE_IO_LINK : 0);
+            entry->addr = (uintptr_t) &ring->sendMessages[i];
+            entry->len = 1;
+            entry->user_data = i;
+        }
+
+        // Without polling one call submits the batch and waits for it.
+        if (!_ccnxTestrigURingQueue_Publish(queue, tail + batch, batch, batch, systemCalls)) {
+            break;
+        }
+        size_t sent = _ccnxTestrigURing_CompleteSends(ring, batch, systemCalls);
+        numSent += sent;
+        if (sent < batch) {
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&ring->sendLock);
+    return numSent;
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+#ifndef ccnxTestrig_URing_h
+#define ccnxTestrig_URing_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include <parc/algol/parc_Buffer.h>
+
+struct ccnx_testrig_uring;
+typedef struct ccnx_testrig_uring CCNxTestrigURing;
+
+/**
+ * Create a `CCNxTestrigURing` that moves the datagrams of a UDP socket through io_uring.
+ *
+ * Two rings are set up, each with the socket registered as a fixed file. The receive ring keeps a
+ * multishot recvmsg armed on a ring of provided buffers registered with the kernel, so datagrams
+ * are received without a system call per packet; its descriptor becomes readable when a datagram
+ * has been received. The send ring submits a batch of sends with one system call, or with none
+ * once submission polling is enabled.
+ *
+ * Receiving and sending may happen on different threads. Sends from several threads are serialized.
+ *
+ * @param [in] socket A bound UDP socket, which remains owned by the caller.
+ * @param [in] bufferSize The largest datagram that is received whole.
+ *
+ * @return A newly allocated `CCNxTestrigURing` that must be freed by `ccnxTestrigURing_Release`.
+ * @return NULL if io_uring, or one of the features above, is not available.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigURing *ring = ccnxTestrigURing_Create(socket, 4096);
+ *
+ *     ccnxTestrigURing_Release(&ring);
+ * }
+ * @endcode
+ */
+CCNxTestrigURing *ccnxTestrigURing_Create(int socket, size_t bufferSize);
+
+/**
+ * Increase the number of references to a `CCNxTestrigURing` instance.
+ *
+ * @param [in] ring A `CCNxTestrigURing` instance.
+ *
+ * @return The same value as @p ring.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigURing *handle = ccnxTestrigURing_Acquire(ring);
+ *
+ *     ccnxTestrigURing_Release(&handle);
+ * }
+ * @endcode
+ */
+CCNxTestrigURing *ccnxTestrigURing_Acquire(const CCNxTestrigURing *ring);
+
+/**
+ * Release a previously acquired reference to the given `CCNxTestrigURing` instance,
+ * decrementing the reference count for the instance.
+ *
+ * When the last reference is released the rings are torn down, which cancels the armed receive.
+ *
+ * @param [in,out] ringPtr A pointer to a pointer to the instance to release.
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTestrigURing *ring = ccnxTestrigURing_Create(socket, 4096);
+ *
+ *     ccnxTestrigURing_Release(&ring);
+ * }
+ * @endcode
+ */
+void ccnxTestrigURing_Release(CCNxTestrigURing **ringPtr);
+
+/**
+ * Enable or disable submission polling on the send ring.
+ *
+ * With polling, a kernel thread picks up the sends as soon as they are queued, so a busy sender
+ * makes no system calls at all. The thread sleeps after a short idle period and is woken by the
+ * next send. The send ring is recreated, so no send may be in progress.
+ *
+ * @param [in] ring A `CCNxTestrigURing` instance.
+ * @param [in] enabled Whether a kernel thread polls the send ring.
+ *
+ * @return true if the send ring was recreated as requested, false if polling could not be enabled, in which
+ *         case the ring sends without it.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (!ccnxTestrigURing_SetSubmissionPolling(ring, true)) {
+ *         fprintf(stderr, "Submission polling is not available\n");
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxTestrigURing_SetSubmissionPolling(CCNxTestrigURing *ring, bool enabled);
+
+/**
+ * Retrieve the descriptor of the receive ring, which is readable while received datagrams are waiting to be reaped.
+ *
+ * Datagrams that were reaped while waiting for sends do not keep the descriptor readable, so
+ * `ccnxTestrigURing_HasPendingDatagram` must be checked as well before waiting on it.
+ *
+ * @param [in] ring A `CCNxTestrigURing` instance.
+ *
+ * @return The descriptor of the receive ring.
+ *
+ * Example:
+ * @code
+ * {
+ *     struct pollfd fd = { .fd = ccnxTestrigURing_GetDescriptor(ring), .events = POLLIN };
+ *     poll(&fd, 1, 1000);
+ * }
+ * @endcode
+ */
+int ccnxTestrigURing_GetDescriptor(const CCNxTestrigURing *ring);
+
+/**
+ * Determine whether a received datagram has been reaped from the receive ring but not yet returned.
+ *
+ * @param [in] ring A `CCNxTestrigURing` instance.
+ *
+ * @return true if `ccnxTestrigURing_Receive` would return a datagram without waiting.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (ccnxTestrigURing_HasPendingDatagram(ring)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxTestrigURing_HasPendingDatagram(const CCNxTestrigURing *ring);
+
+/**
+ * Receive one datagram, copying it out of its provided buffer, which is then handed back to the kernel.
+ *
+ * @param [in] ring A `CCNxTestrigURing` instance.
+ * @param [out] data Where the datagram is copied.
+ * @param [in] capacity The number of bytes available at @p data. Longer datagrams are truncated.
+ * @param [out] source Set to the address the datagram came from.
+ * @param [out] kernelTime Set to the kernel receive timestamp in nanoseconds on the realtime clock,
+ *                         or 0 if the socket does not have SO_TIMESTAMPNS enabled.
+ * @param [in] timeout The number of milliseconds to wait for a datagram, or -1 to wait forever.
+ * @param [out] systemCalls Incremented by the number of system calls made.
+ *
+ * @return The number of bytes copied to @p data, or -1 if no datagram arrived in time.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint8_t data[4096];
+ *     struct sockaddr_in source;
+ *     uint64_t kernelTime;
+ *     uint64_t systemCalls = 0;
+ *     ssize_t length = ccnxTestrigURing_Receive(ring, data, sizeof(data), &source, &kernelTime, 1000, &systemCalls);
+ * }
+ * @endcode
+ */
+ssize_t ccnxTestrigURing_Receive(CCNxTestrigURing *ring, uint8_t *data, size_t capacity, struct sockaddr_in *source, uint64_t *kernelTime,
+                                 int timeout, uint64_t *systemCalls);
+
+/**
+ * Send each buffer as one datagram to the target, in order, and wait until the kernel has taken them.
+ *
+ * The sends of a batch are linked, so they leave in order, and a failed send cancels those behind it.
+ *
+ * @param [in] ring A `CCNxTestrigURing` instance.
+ * @param [in] buffers The datagrams, from position zero to their limit.
+ * @param [in] count The number of buffers.
+ * @param [in] target The destination of the datagrams.
+ * @param [out] systemCalls Incremented by the number of system calls made.
+ *
+ * @return The number of datagrams sent, counted from the first.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t systemCalls = 0;
+ *     size_t sent = ccnxTestrigURing_SendBatch(ring, buffers, count, &target, &systemCalls);
+ * }
+ * @endcode
+ */
+size_t ccnxTestrigURing_SendBatch(CCNxTestrigURing *ring, PARCBuffer **buffers, size_t count, const struct sockaddr_in *target, uint64_t *systemCalls);
+#endif // ccnxTestrig_URing_h
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+// Include the file being tested, so that its static functions are visible to the test cases.
+#include "../src/ccnxTestrig_Histogram.c"
+
+#include <inttypes.h>
+
+#include <LongBow/unit-test.h>
+
+LONGBOW_TEST_RUNNER(ccnxTestrig_Histogram)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(ccnxTestrig_Histogram)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(ccnxTestrig_Histogram)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigHistogram_Create);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigHistogram_GetValueAtPercentile_Exact);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigHistogram_GetValueAtPercentile_Large);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigHistogram_GetValueAtPercentile_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigHistogram_Record_BeyondMax);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigHistogram_Merge);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    CCNxTestrigHistogram *histogram = ccnxTestrigHistogram_Create();
+    longBowTestCase_SetClipBoardData(testCase, histogram);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    CCNxTestrigHistogram *histogram = longBowTestCase_GetClipBoardData(testCase);
+    ccnxTestrigHistogram_Release(&histogram);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigHistogram_Create)
+{
+    CCNxTestrigHistogram *histogram = longBowTestCase_GetClipBoardData(testCase);
+
+    assertTrue(ccnxTestrigHistogram_GetCount(histogram) == 0, "Expected an empty histogram");
+    assertTrue(ccnxTestrigHistogram_GetMax(histogram) == 0, "Expected no maximum");
+    assertTrue(ccnxTestrigHistogram_GetMemoryUsage(histogram) == sizeof(CCNxTestrigHistogram), "Expected a fixed size");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigHistogram_GetValueAtPercentile_Exact)
+{
+    CCNxTestrigHistogram *histogram = longBowTestCase_GetClipBoardData(testCase);
+
+    // Values below the sub-bucket count have a bucket each, so percentiles are exact.
+    for (uint64_t value = 1; value <= 100; value++) {
+        ccnxTestrigHistogram_Record(histogram, value);
+    }
+
+    assertTrue(ccnxTestrigHistogram_GetCount(histogram) == 100, "Expected 100 values, got %" PRIu64, ccnxTestrigHistogram_GetCount(histogram));
+    assertTrue(ccnxTestrigHistogram_GetValueAtPercentile(histogram, 0.0) == 1, "Expected the lowest value at the 0th percentile");
+    assertTrue(ccnxTestrigHistogram_GetValueAtPercentile(histogram, 50.0) == 50, "Expected 50 at the median, got %" PRIu64,
+               ccnxTestrigHistogram_GetValueAtPercentile(histogram, 50.0));
+    assertTrue(ccnxTestrigHistogram_GetValueAtPercentile(histogram, 99.0) == 99, "Expected 99 at the 99th percentile, got %" PRIu64,
+               ccnxTestrigHistogram_GetValueAtPercentile(histogram, 99.0));
+    assertTrue(ccnxTestrigHistogram_GetValueAtPercentile(histogram, 100.0) == 100, "Expected the highest value at the 100th percentile");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigHistogram_GetValueAtPercentile_Large)
+{
+    CCNxTestrigHistogram *histogram = longBowTestCase_GetClipBoardData(testCase);
+
+    // Nine fast values and one slow one: the median is within a sub-bucket of the fast value,
+    // and the top percentile is the slow value itself, not the top of its sub-bucket.
+    for (int i = 0; i < 9; i++) {
+        ccnxTestrigHistogram_Record(histogram, 10000);
+    }
+    ccnxTestrigHistogram_Record(histogram, 5000001);
+
+    uint64_t median = ccnxTestrigHistogram_GetValueAtPercentile(histogram, 50.0);
+    assertTrue(median >= 10000 && median - 10000 <= 10000 / SUB_BUCKET_HALF_COUNT,
+               "Expected the median within 1/64 of 10000, got %" PRIu64, median);
+    assertTrue(ccnxTestrigHistogram_GetValueAtPercentile(histogram, 100.0) == 5000001, "Expected the maximum at the 100th percentile, got %" PRIu64,
+               ccnxTestrigHistogram_GetValueAtPercentile(histogram, 100.0));
+    assertTrue(ccnxTestrigHistogram_GetMax(histogram) == 5000001, "Expected the maximum to be kept exactly");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigHistogram_GetValueAtPercentile_Empty)
+{
+    CCNxTestrigHistogram *histogram = longBowTestCase_GetClipBoardData(testCase);
+
+    assertTrue(ccnxTestrigHistogram_GetValueAtPercentile(histogram, 50.0) == 0, "Expected 0 for an empty histogram");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigHistogram_Record_BeyondMax)
+{
+    CCNxTestrigHistogram *histogram = longBowTestCase_GetClipBoardData(testCase);
+
+    ccnxTestrigHistogram_Record(histogram, UINT64_MAX);
+
+    assertTrue(ccnxTestrigHistogram_GetCount(histogram) == 1, "Expected the value to be counted");
+    assertTrue(ccnxTestrigHistogram_GetMax(histogram) == MAX_VALUE, "Expected the value to be clamped to %llu", MAX_VALUE);
+    assertTrue(histogram->counts[COUNTS_LENGTH - 1] == 1, "Expected the value in the last bucket");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigHistogram_Merge)
+{
+    CCNxTestrigHistogram *histogram = longBowTestCase_GetClipBoardData(testCase);
+    CCNxTestrigHistogram *other = ccnxTestrigHistogram_Create();
+
+    ccnxTestrigHistogram_Record(histogram, 10);
+    ccnxTestrigHistogram_Record(other, 20);
+    ccnxTestrigHistogram_Record(other, 3000);
+    ccnxTestrigHistogram_Merge(histogram, other);
+
+    assertTrue(ccnxTestrigHistogram_GetCount(histogram) == 3, "Expected the counts to be added");
+    assertTrue(ccnxTestrigHistogram_GetMax(histogram) == 3000, "Expected the larger maximum");
+    assertTrue(ccnxTestrigHistogram_GetValueAtPercentile(histogram, 50.0) == 20, "Expected the median from the other histogram");
+    assertTrue(ccnxTestrigHistogram_GetCount(other) == 2, "Expected the other histogram to be unchanged");
+
+    ccnxTestrigHistogram_Release(&other);
+}
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _ccnxTestrigHistogram_IndexOf_Linear);
+    LONGBOW_RUN_TEST_CASE(Local, _ccnxTestrigHistogram_IndexOf_BucketBoundaries);
+    LONGBOW_RUN_TEST_CASE(Local, _ccnxTestrigHistogram_HighestEquivalentValue);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Local, _ccnxTestrigHistogram_IndexOf_Linear)
+{
+    for (uint64_t value = 0; value < SUB_BUCKET_COUNT; value++) {
+        assertTrue(_ccnxTestrigHistogram_IndexOf(value) == value, "Expected value %" PRIu64 " at its own index", value);
+    }
+}
+
+LONGBOW_TEST_CASE(Local, _ccnxTestrigHistogram_IndexOf_BucketBoundaries)
+{
+    // Each power of two from the sub-bucket count up starts a bucket of half as many sub-buckets, twice as wide.
+    assertTrue(_ccnxTestrigHistogram_IndexOf(128) == 128, "Expected 128 to start the second bucket");
+    assertTrue(_ccnxTestrigHistogram_IndexOf(129) == 128, "Expected 129 to share the sub-bucket of 128");
+    assertTrue(_ccnxTestrigHistogram_IndexOf(130) == 129, "Expected 130 in the next sub-bucket");
+    assertTrue(_ccnxTestrigHistogram_IndexOf(255) == 191, "Expected 255 to end the second bucket");
+    assertTrue(_ccnxTestrigHistogram_IndexOf(256) == 192, "Expected 256 to start the third bucket");
+    assertTrue(_ccnxTestrigHistogram_IndexOf(MAX_VALUE) == COUNTS_LENGTH - 1, "Expected the largest value in the last sub-bucket");
+}
+
+LONGBOW_TEST_CASE(Local, _ccnxTestrigHistogram_HighestEquivalentValue)
+{
+    // Every value maps to a sub-bucket whose highest value is at most 1/64 above it.
+    for (uint64_t value = 1; value <= MAX_VALUE; value = value * 3 + 1) {
+        uint64_t highest = _ccnxTestrigHistogram_HighestEquivalentValue(_ccnxTestrigHistogram_IndexOf(value));
+        assertTrue(highest >= value, "Expected the sub-bucket of %" PRIu64 " to reach it, it ends at %" PRIu64, value, highest);
+        assertTrue(highest - value <= value / SUB_BUCKET_HALF_COUNT, "Expected the sub-bucket of %" PRIu64 " to end within 1/64, it ends at %" PRIu64, value, highest);
+        assertTrue(_ccnxTestrigHistogram_IndexOf(highest) == _ccnxTestrigHistogram_IndexOf(value), "Expected %" PRIu64 " in the same sub-bucket as %" PRIu64, highest, value);
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(ccnxTestrig_Histogram);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+// Include the file being tested, so that its static functions are visible to the test cases.
+#include "../src/ccnxTestrig_PacketUtility.c"
+
+#include <LongBow/unit-test.h>
+
+// An Interest for ccnx:/abc with a 4-byte payload: the fixed header, then the message TLV
+// holding the Name (offset 12) and the payload (offset 23).
+static const uint8_t _interest[] = {
+    0x01, PACKET_TYPE_INTEREST, 0x00, 31, 32, 0x00, 0x00, FIXED_HEADER_LENGTH,
+    0x00, 0x01, 0x00, 19,
+    0x00, 0x00, 0x00, 7,
+    0x00, 0x01, 0x00, 3, 'a', 'b', 'c',
+    0x00, 0x01, 0x00, 4, 'd', 'a', 't', 'a'
+};
+
+/**
+ * Return true if the received bytes are a forwarded copy of the sent bytes.
+ */
+static bool
+_isForwardedCopy(const uint8_t *sent, size_t sentLength, const uint8_t *received, size_t receivedLength)
+{
+    PARCBuffer *sentBuffer = parcBuffer_Wrap((void *) sent, sentLength, 0, sentLength);
+    PARCBuffer *receivedBuffer = parcBuffer_Wrap((void *) received, receivedLength, 0, receivedLength);
+
+    bool result = ccnxTestrigPacketUtility_IsForwardedCopy(sentBuffer, receivedBuffer);
+
+    parcBuffer_Release(&sentBuffer);
+    parcBuffer_Release(&receivedBuffer);
+    return result;
+}
+
+/**
+ * Return true if the wire diff finds a divergence between the sent and received bytes.
+ */
+static bool
+_diffWire(const uint8_t *sent, size_t sentLength, const uint8_t *received, size_t receivedLength, CCNxTestrigWireDiff *diff)
+{
+    PARCBuffer *sentBuffer = parcBuffer_Wrap((void *) sent, sentLength, 0, sentLength);
+    PARCBuffer *receivedBuffer = parcBuffer_Wrap((void *) received, receivedLength, 0, receivedLength);
+
+    bool result = ccnxTestrigPacketUtility_DiffWire(sentBuffer, receivedBuffer, diff);
+
+    parcBuffer_Release(&sentBuffer);
+    parcBuffer_Release(&receivedBuffer);
+    return result;
+}
+
+LONGBOW_TEST_RUNNER(ccnxTestrig_PacketUtility)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(ccnxTestrig_PacketUtility)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(ccnxTestrig_PacketUtility)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigPacketUtility_IsForwardedCopy);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigPacketUtility_IsForwardedCopy_HopLimitNotDecremented);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigPacketUtility_IsForwardedCopy_ContentObject);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigPacketUtility_IsForwardedCopy_Different);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigPacketUtility_IsForwardedCopy_Short);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_Identical);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_Payload);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_NameSegment);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_PacketType);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_BadLength);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_MissingTlv);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_PerHopHeaders);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigPacketUtility_IsForwardedCopy)
+{
+    uint8_t received[sizeof(_interest)];
+    memcpy(received, _interest, sizeof(_interest));
+    received[4]--;
+
+    assertTrue(_isForwardedCopy(_interest, sizeof(_interest), received, sizeof(received)),
+               "Expected an Interest with its hop limit decremented to be a forwarded copy");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigPacketUtility_IsForwardedCopy_HopLimitNotDecremented)
+{
+    assertFalse(_isForwardedCopy(_interest, sizeof(_interest), _interest, sizeof(_interest)),
+                "Expected an Interest whose hop limit was not decremented not to be a forwarded copy");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigPacketUtility_IsForwardedCopy_ContentObject)
+{
+    // Only Interests carry a hop limit the forwarder must decrement, and the return code and
+    // reserved bytes are not compared.
+    uint8_t sent[sizeof(_interest)];
+    memcpy(sent, _interest, sizeof(_interest));
+    sent[1] = PACKET_TYPE_INTEREST + 1;
+
+    uint8_t received[sizeof(_interest)];
+    memcpy(received, sent, sizeof(sent));
+    received[4] = 0;
+    received[5] = 1;
+    received[6] = 0xFF;
+
+    assertTrue(_isForwardedCopy(sent, sizeof(sent), received, sizeof(received)),
+               "Expected a Content Object with a different hop limit and reserved bytes to be a forwarded copy");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigPacketUtility_IsForwardedCopy_Different)
+{
+    uint8_t received[sizeof(_interest)];
+    memcpy(received, _interest, sizeof(_interest));
+    received[4]--;
+    received[sizeof(received) - 1] = 'A';
+
+    assertFalse(_isForwardedCopy(_interest, sizeof(_interest), received, sizeof(received)),
+                "Expected a different payload not to be a forwarded copy");
+    assertFalse(_isForwardedCopy(_interest, sizeof(_interest), received, sizeof(received) - 1),
+                "Expected a different length not to be a forwarded copy");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigPacketUtility_IsForwardedCopy_Short)
+{
+    assertFalse(_isForwardedCopy(_interest, 4, _interest, 4), "Expected packets shorter than the fixed header not to be compared");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_Identical)
+{
+    CCNxTestrigWireDiff diff;
+    assertFalse(_diffWire(_interest, sizeof(_interest), _interest, sizeof(_interest), &diff), "Expected identical packets not to diverge");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_Payload)
+{
+    uint8_t received[sizeof(_interest)];
+    memcpy(received, _interest, sizeof(_interest));
+    received[29] = 'T';
+
+    CCNxTestrigWireDiff diff;
+    assertTrue(_diffWire(_interest, sizeof(_interest), received, sizeof(received), &diff), "Expected a different payload to diverge");
+    assertTrue(diff.offset == 29, "Expected the offset of the changed byte, got %zu", diff.offset);
+    assertTrue(diff.depth == 2, "Expected the message and payload in the path, got depth %zu", diff.depth);
+    assertTrue(diff.path[0] == TLV_MESSAGE_INTEREST && diff.path[1] == TLV_PAYLOAD, "Expected the path to the payload");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_NameSegment)
+{
+    uint8_t received[sizeof(_interest)];
+    memcpy(received, _interest, sizeof(_interest));
+    received[21] = 'B';
+
+    CCNxTestrigWireDiff diff;
+    assertTrue(_diffWire(_interest, sizeof(_interest), received, sizeof(received), &diff), "Expected a different name to diverge");
+    assertTrue(diff.offset == 21, "Expected the offset of the changed byte, got %zu", diff.offset);
+    assertTrue(diff.depth == 3, "Expected the message, name and segment in the path, got depth %zu", diff.depth);
+    assertTrue(diff.path[1] == TLV_NAME && diff.path[2] == 0x0001, "Expected the path into the Name");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_PacketType)
+{
+    uint8_t received[sizeof(_interest)];
+    memcpy(received, _interest, sizeof(_interest));
+    received[1] = PACKET_TYPE_INTEREST + 1;
+
+    CCNxTestrigWireDiff diff;
+    assertTrue(_diffWire(_interest, sizeof(_interest), received, sizeof(received), &diff), "Expected a different packet type to diverge");
+    assertTrue(diff.offset == 1 && diff.depth == 0, "Expected the packet type byte, got offset %zu", diff.offset);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_BadLength)
+{
+    // A packet length beyond the received bytes is not trusted.
+    uint8_t received[sizeof(_interest)];
+    memcpy(received, _interest, sizeof(_interest));
+    received[3] = 200;
+
+    CCNxTestrigWireDiff diff;
+    assertTrue(_diffWire(_interest, sizeof(_interest), received, sizeof(received), &diff), "Expected a bad packet length to diverge");
+    assertTrue(diff.offset == 2, "Expected the packet length field, got offset %zu", diff.offset);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_MissingTlv)
+{
+    // The received Interest has lost its payload.
+    uint8_t received[23];
+    memcpy(received, _interest, sizeof(received));
+    received[3] = sizeof(received);
+    received[11] = 11;
+
+    CCNxTestrigWireDiff diff;
+    assertTrue(_diffWire(_interest, sizeof(_interest), received, sizeof(received), &diff), "Expected a missing TLV to diverge");
+    assertTrue(diff.offset == 23, "Expected the end of the received message, got offset %zu", diff.offset);
+    assertTrue(diff.depth == 2 && diff.path[1] == TLV_PAYLOAD, "Expected the sent payload in the path");
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigPacketUtility_DiffWire_PerHopHeaders)
+{
+    // A forwarder may add per-hop headers; only the message is compared.
+    uint8_t received[sizeof(_interest) + 8];
+    memcpy(received, _interest, FIXED_HEADER_LENGTH);
+    received[3] = sizeof(received);
+    received[7] = FIXED_HEADER_LENGTH + 8;
+
+    const uint8_t perHopHeader[] = { 0x00, 0x01, 0x00, 4, 0x00, 0x00, 0x10, 0x00 };
+    memcpy(received + FIXED_HEADER_LENGTH, perHopHeader, sizeof(perHopHeader));
+    memcpy(received + FIXED_HEADER_LENGTH + 8, _interest + FIXED_HEADER_LENGTH, sizeof(_interest) - FIXED_HEADER_LENGTH);
+
+    CCNxTestrigWireDiff diff;
+    assertFalse(_diffWire(_interest, sizeof(_interest), received, sizeof(received), &diff), "Expected per-hop headers to be skipped");
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(ccnxTestrig_PacketUtility);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
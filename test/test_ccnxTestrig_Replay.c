@@ -0,0 +1,492 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+// Include the file being tested, so that its static functions are visible to the test cases.
+#include "../src/ccnxTestrig_Replay.c"
+
+#include <LongBow/unit-test.h>
+
+typedef struct {
+    uint8_t bytes[512];
+    size_t length;
+    bool swapped;
+} _TestCapture;
+
+static void
+_put8(_TestCapture *capture, uint8_t value)
+{
+    capture->bytes[capture->length++] = value;
+}
+
+static void
+_put16(_TestCapture *capture, uint16_t value)
+{
+    value = capture->swapped ? __builtin_bswap16(value) : value;
+    memcpy(capture->bytes + capture->length, &value, sizeof(value));
+    capture->length += sizeof(value);
+}
+
+static void
+_put32(_TestCapture *capture, uint32_t value)
+{
+    value = capture->swapped ? __builtin_bswap32(value) : value;
+    memcpy(capture->bytes + capture->length, &value, sizeof(value));
+    capture->length += sizeof(value);
+}
+
+static void
+_putPcapHeader(_TestCapture *capture, uint32_t magic, uint32_t linkType)
+{
+    _put32(capture, magic);
+    _put16(capture, 2);
+    _put16(capture, 4);
+    _put32(capture, 0);
+    _put32(capture, 0);
+    _put32(capture, 65535);
+    _put32(capture, linkType);
+}
+
+static void
+_putPcapRecord(_TestCapture *capture, uint32_t seconds, uint32_t fraction, const char *data)
+{
+    _put32(capture, seconds);
+    _put32(capture, fraction);
+    _put32(capture, (uint32_t) strlen(data));
+    _put32(capture, (uint32_t) strlen(data));
+    memcpy(capture->bytes + capture->length, data, strlen(data));
+    capture->length += strlen(data);
+}
+
+static void
+_putPcapngSection(_TestCapture *capture)
+{
+    _put32(capture, PCAPNG_SECTION_HEADER_BLOCK);
+    _put32(capture, 28);
+    _put32(capture, PCAPNG_BYTE_ORDER_MAGIC);
+    _put16(capture, 1);
+    _put16(capture, 0);
+    _put32(capture, 0xFFFFFFFF);
+    _put32(capture, 0xFFFFFFFF);
+    _put32(capture, 28);
+}
+
+static void
+_putPcapngInterface(_TestCapture *capture, uint16_t linkType, uint8_t resolution)
+{
+    _put32(capture, PCAPNG_INTERFACE_DESCRIPTION_BLOCK);
+    _put32(capture, 32);
+    _put16(capture, linkType);
+    _put16(capture, 0);
+    _put32(capture, 65535);
+    _put16(capture, PCAPNG_OPTION_IF_TSRESOL);
+    _put16(capture, 1);
+    _put8(capture, resolution);
+    _put8(capture, 0);
+    _put8(capture, 0);
+    _put8(capture, 0);
+    _put32(capture, 0);
+    _put32(capture, 32);
+}
+
+static void
+_putPcapngPacket(_TestCapture *capture, uint32_t interface, uint64_t ticks, const char *data)
+{
+    uint32_t padded = (uint32_t) ((strlen(data) + 3) & ~3U);
+
+    _put32(capture, PCAPNG_ENHANCED_PACKET_BLOCK);
+    _put32(capture, 32 + padded);
+    _put32(capture, interface);
+    _put32(capture, (uint32_t) (ticks >> 32));
+    _put32(capture, (uint32_t) ticks);
+    _put32(capture, (uint32_t) strlen(data));
+    _put32(capture, (uint32_t) strlen(data));
+    memset(capture->bytes + capture->length, 0, padded);
+    memcpy(capture->bytes + capture->length, data, strlen(data));
+    capture->length += padded;
+    _put32(capture, 32 + padded);
+}
+
+/**
+ * Write the capture to the fixture's temporary file and open a reader on it.
+ */
+static bool
+_open(const LongBowTestCase *testCase, const _TestCapture *capture, _CCNxTestrigReplayReader *reader)
+{
+    const char *path = longBowTestCase_GetClipBoardData(testCase);
+
+    int fd = open(path, O_WRONLY | O_TRUNC);
+    assertTrue(fd >= 0, "Expected to open %s", path);
+    assertTrue(write(fd, capture->bytes, capture->length) == (ssize_t) capture->length, "Expected to write %s", path);
+    close(fd);
+
+    return _ccnxTestrigReplayReader_Open(reader, path);
+}
+
+/**
+ * An Ethernet frame carrying a 4-byte payload in UDP over IPv4, with a VLAN tag.
+ */
+static size_t
+_ethernetFrame(uint8_t *frame, uint8_t protocol, bool fragment)
+{
+    memset(frame, 0, 64);
+
+    frame[12] = 0x81;
+    frame[13] = 0x00;
+    frame[16] = 0x08;
+    frame[17] = 0x00;
+
+    uint8_t *ip = frame + 18;
+    ip[0] = 0x45;
+    ip[3] = 20 + 8 + 4;
+    ip[6] = 0x40;
+    ip[7] = fragment ? 1 : 0;
+    ip[9] = protocol;
+
+    uint8_t *udp = ip + 20;
+    udp[5] = 8 + 4;
+    memcpy(udp + 8, "ccnx", 4);
+
+    return 18 + 20 + 8 + 4;
+}
+
+LONGBOW_TEST_RUNNER(ccnxTestrig_Replay)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Reader);
+    LONGBOW_RUN_TEST_FIXTURE(Payload);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(ccnxTestrig_Replay)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(ccnxTestrig_Replay)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Reader)
+{
+    LONGBOW_RUN_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcap);
+    LONGBOW_RUN_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcap_Swapped);
+    LONGBOW_RUN_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcap_Truncated);
+    LONGBOW_RUN_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcap_ShortHeader);
+    LONGBOW_RUN_TEST_CASE(Reader, _ccnxTestrigReplayReader_Open_NotACapture);
+    LONGBOW_RUN_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcapng);
+    LONGBOW_RUN_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcapng_BeyondEnd);
+    LONGBOW_RUN_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcapng_UnknownInterface);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Reader)
+{
+    char *path = strdup("/tmp/test_ccnxTestrig_Replay.XXXXXX");
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        free(path);
+        return LONGBOW_STATUS_SETUP_FAILED;
+    }
+    close(fd);
+
+    longBowTestCase_SetClipBoardData(testCase, path);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Reader)
+{
+    char *path = longBowTestCase_GetClipBoardData(testCase);
+    unlink(path);
+    free(path);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcap)
+{
+    _TestCapture capture = { .length = 0, .swapped = false };
+    _putPcapHeader(&capture, PCAP_MAGIC_MICROSECONDS, LINKTYPE_USER0);
+    _putPcapRecord(&capture, 2, 500, "abcd");
+    _putPcapRecord(&capture, 3, 0, "ef");
+
+    _CCNxTestrigReplayReader reader;
+    assertTrue(_open(testCase, &capture, &reader), "Expected a pcap file to open");
+    assertTrue(reader.interfaces[0].linkType == LINKTYPE_USER0, "Expected the link type of the file header");
+
+    _CCNxTestrigReplayPacket packet;
+    assertTrue(_ccnxTestrigReplayReader_Next(&reader, &packet), "Expected a first packet");
+    assertTrue(packet.timestamp == 2 * NSEC_PER_SEC + 500000, "Expected microseconds, got %" PRIu64, packet.timestamp);
+    assertTrue(packet.capturedLength == 4 && memcmp(packet.data, "abcd", 4) == 0, "Expected the first record's data");
+
+    assertTrue(_ccnxTestrigReplayReader_Next(&reader, &packet), "Expected a second packet");
+    assertTrue(packet.timestamp == 3 * NSEC_PER_SEC, "Expected 3 seconds, got %" PRIu64, packet.timestamp);
+    assertTrue(packet.capturedLength == 2, "Expected the second record's length");
+
+    assertFalse(_ccnxTestrigReplayReader_Next(&reader, &packet), "Expected the end of the file");
+    assertFalse(reader.malformed, "Expected a well-formed file");
+    _ccnxTestrigReplayReader_Close(&reader);
+}
+
+LONGBOW_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcap_Swapped)
+{
+    // A file written on a host of the other byte order, with nanosecond timestamps.
+    _TestCapture capture = { .length = 0, .swapped = true };
+    _putPcapHeader(&capture, PCAP_MAGIC_NANOSECONDS, LINKTYPE_ETHERNET);
+    _putPcapRecord(&capture, 1, 7, "abcd");
+
+    _CCNxTestrigReplayReader reader;
+    assertTrue(_open(testCase, &capture, &reader), "Expected a swapped pcap file to open");
+    assertTrue(reader.swapped, "Expected the byte order to be detected");
+    assertTrue(reader.interfaces[0].linkType == LINKTYPE_ETHERNET, "Expected the link type of the file header");
+
+    _CCNxTestrigReplayPacket packet;
+    assertTrue(_ccnxTestrigReplayReader_Next(&reader, &packet), "Expected a packet");
+    assertTrue(packet.timestamp == NSEC_PER_SEC + 7, "Expected nanoseconds, got %" PRIu64, packet.timestamp);
+    assertTrue(packet.capturedLength == 4, "Expected the record's length, got %zu", packet.capturedLength);
+    _ccnxTestrigReplayReader_Close(&reader);
+}
+
+LONGBOW_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcap_Truncated)
+{
+    // The record claims more data than the file holds.
+    _TestCapture capture = { .length = 0, .swapped = false };
+    _putPcapHeader(&capture, PCAP_MAGIC_MICROSECONDS, LINKTYPE_USER0);
+    _putPcapRecord(&capture, 1, 0, "abcd");
+    capture.length -= 1;
+
+    _CCNxTestrigReplayReader reader;
+    assertTrue(_open(testCase, &capture, &reader), "Expected a pcap file to open");
+
+    _CCNxTestrigReplayPacket packet;
+    assertFalse(_ccnxTestrigReplayReader_Next(&reader, &packet), "Expected no packet");
+    assertTrue(reader.malformed, "Expected a truncated record to be reported");
+    _ccnxTestrigReplayReader_Close(&reader);
+}
+
+LONGBOW_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcap_ShortHeader)
+{
+    // A capture cut off inside a record header ends the file without an error.
+    _TestCapture capture = { .length = 0, .swapped = false };
+    _putPcapHeader(&capture, PCAP_MAGIC_MICROSECONDS, LINKTYPE_USER0);
+    _putPcapRecord(&capture, 1, 0, "abcd");
+    _put32(&capture, 2);
+
+    _CCNxTestrigReplayReader reader;
+    assertTrue(_open(testCase, &capture, &reader), "Expected a pcap file to open");
+
+    _CCNxTestrigReplayPacket packet;
+    assertTrue(_ccnxTestrigReplayReader_Next(&reader, &packet), "Expected the complete record");
+    assertFalse(_ccnxTestrigReplayReader_Next(&reader, &packet), "Expected the end of the file");
+    assertFalse(reader.malformed, "Expected a short trailing header not to be reported");
+    _ccnxTestrigReplayReader_Close(&reader);
+}
+
+LONGBOW_TEST_CASE(Reader, _ccnxTestrigReplayReader_Open_NotACapture)
+{
+    _TestCapture capture = { .length = 0, .swapped = false };
+    _put32(&capture, PCAP_MAGIC_MICROSECONDS);
+
+    _CCNxTestrigReplayReader reader;
+    assertFalse(_open(testCase, &capture, &reader), "Expected a file shorter than a pcap header to be refused");
+
+    capture.length = 0;
+    _putPcapHeader(&capture, 0x12345678, LINKTYPE_USER0);
+    assertFalse(_open(testCase, &capture, &reader), "Expected an unknown magic number to be refused");
+}
+
+LONGBOW_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcapng)
+{
+    _TestCapture capture = { .length = 0, .swapped = false };
+    _putPcapngSection(&capture);
+    _putPcapngInterface(&capture, LINKTYPE_USER0, 9);
+    _putPcapngPacket(&capture, 0, 5 * NSEC_PER_SEC + 7, "abcde");
+
+    _CCNxTestrigReplayReader reader;
+    assertTrue(_open(testCase, &capture, &reader), "Expected a pcapng file to open");
+    assertTrue(reader.pcapng, "Expected the section header to be recognised");
+
+    _CCNxTestrigReplayPacket packet;
+    assertTrue(_ccnxTestrigReplayReader_Next(&reader, &packet), "Expected a packet");
+    assertTrue(reader.numberOfInterfaces == 1, "Expected one interface, got %zu", reader.numberOfInterfaces);
+    assertTrue(reader.interfaces[0].linkType == LINKTYPE_USER0, "Expected the interface's link type");
+    assertTrue(packet.interface == 0, "Expected the first interface");
+    assertTrue(packet.timestamp == 5 * NSEC_PER_SEC + 7, "Expected nanoseconds from if_tsresol, got %" PRIu64, packet.timestamp);
+    assertTrue(packet.capturedLength == 5 && memcmp(packet.data, "abcde", 5) == 0, "Expected the packet's data");
+
+    assertFalse(_ccnxTestrigReplayReader_Next(&reader, &packet), "Expected the end of the file");
+    assertFalse(reader.malformed, "Expected a well-formed file");
+    _ccnxTestrigReplayReader_Close(&reader);
+}
+
+LONGBOW_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcapng_BeyondEnd)
+{
+    // The last block claims to run past the end of the file.
+    _TestCapture capture = { .length = 0, .swapped = false };
+    _putPcapngSection(&capture);
+    _putPcapngInterface(&capture, LINKTYPE_USER0, 6);
+    _putPcapngPacket(&capture, 0, 1, "abcd");
+    capture.length -= 4;
+
+    _CCNxTestrigReplayReader reader;
+    assertTrue(_open(testCase, &capture, &reader), "Expected a pcapng file to open");
+
+    _CCNxTestrigReplayPacket packet;
+    assertFalse(_ccnxTestrigReplayReader_Next(&reader, &packet), "Expected no packet");
+    assertTrue(reader.malformed, "Expected a block beyond the end of the file to be reported");
+    _ccnxTestrigReplayReader_Close(&reader);
+}
+
+LONGBOW_TEST_CASE(Reader, _ccnxTestrigReplayReader_NextPcapng_UnknownInterface)
+{
+    // A packet on an interface the section has not described keeps the previous timestamp.
+    _TestCapture capture = { .length = 0, .swapped = false };
+    _putPcapngSection(&capture);
+    _putPcapngInterface(&capture, LINKTYPE_USER0, 6);
+    _putPcapngPacket(&capture, 0, 3000000, "abcd");
+    _putPcapngPacket(&capture, 4, 9000000, "efgh");
+
+    _CCNxTestrigReplayReader reader;
+    assertTrue(_open(testCase, &capture, &reader), "Expected a pcapng file to open");
+
+    _CCNxTestrigReplayPacket packet;
+    assertTrue(_ccnxTestrigReplayReader_Next(&reader, &packet), "Expected a first packet");
+    assertTrue(packet.timestamp == 3 * NSEC_PER_SEC, "Expected microseconds, got %" PRIu64, packet.timestamp);
+
+    assertTrue(_ccnxTestrigReplayReader_Next(&reader, &packet), "Expected a second packet");
+    assertTrue(packet.interface == 4, "Expected the interface of the block, got %u", packet.interface);
+    assertTrue(packet.timestamp == 3 * NSEC_PER_SEC, "Expected the previous timestamp, got %" PRIu64, packet.timestamp);
+    _ccnxTestrigReplayReader_Close(&reader);
+}
+
+LONGBOW_TEST_FIXTURE(Payload)
+{
+    LONGBOW_RUN_TEST_CASE(Payload, _ccnxTestrigReplay_Payload_User0);
+    LONGBOW_RUN_TEST_CASE(Payload, _ccnxTestrigReplay_Payload_Ethernet);
+    LONGBOW_RUN_TEST_CASE(Payload, _ccnxTestrigReplay_Payload_Fragment);
+    LONGBOW_RUN_TEST_CASE(Payload, _ccnxTestrigReplay_Payload_NotUDP);
+    LONGBOW_RUN_TEST_CASE(Payload, _ccnxTestrigReplay_Payload_Short);
+    LONGBOW_RUN_TEST_CASE(Payload, _ccnxTestrigReplay_Payload_UnknownLinkType);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Payload)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Payload)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Payload, _ccnxTestrigReplay_Payload_User0)
+{
+    const uint8_t frame[] = { 1, 0, 0, 8 };
+    size_t payloadLength = 0;
+
+    const uint8_t *payload = _ccnxTestrigReplay_Payload(LINKTYPE_USER0, frame, sizeof(frame), &payloadLength);
+    assertTrue(payload == frame && payloadLength == sizeof(frame), "Expected the whole frame");
+}
+
+LONGBOW_TEST_CASE(Payload, _ccnxTestrigReplay_Payload_Ethernet)
+{
+    uint8_t frame[64];
+    size_t length = _ethernetFrame(frame, IPPROTO_UDP_NUMBER, false);
+    size_t payloadLength = 0;
+
+    const uint8_t *payload = _ccnxTestrigReplay_Payload(LINKTYPE_ETHERNET, frame, length, &payloadLength);
+    assertNotNull(payload, "Expected the UDP payload behind the VLAN tag");
+    assertTrue(payloadLength == 4 && memcmp(payload, "ccnx", 4) == 0, "Expected the 4-byte payload, got %zu bytes", payloadLength);
+}
+
+LONGBOW_TEST_CASE(Payload, _ccnxTestrigReplay_Payload_Fragment)
+{
+    uint8_t frame[64];
+    size_t length = _ethernetFrame(frame, IPPROTO_UDP_NUMBER, true);
+    size_t payloadLength = 0;
+
+    assertNull(_ccnxTestrigReplay_Payload(LINKTYPE_ETHERNET, frame, length, &payloadLength), "Expected a fragment to be skipped");
+}
+
+LONGBOW_TEST_CASE(Payload, _ccnxTestrigReplay_Payload_NotUDP)
+{
+    uint8_t frame[64];
+    size_t length = _ethernetFrame(frame, 6, false);
+    size_t payloadLength = 0;
+
+    assertNull(_ccnxTestrigReplay_Payload(LINKTYPE_ETHERNET, frame, length, &payloadLength), "Expected TCP to be skipped");
+}
+
+LONGBOW_TEST_CASE(Payload, _ccnxTestrigReplay_Payload_Short)
+{
+    const uint8_t frame[16] = { 0 };
+    size_t payloadLength = 0;
+
+    assertNull(_ccnxTestrigReplay_Payload(LINKTYPE_NULL, frame, 3, &payloadLength), "Expected a frame shorter than the address family to be skipped");
+    assertNull(_ccnxTestrigReplay_Payload(LINKTYPE_LINUX_SLL, frame, 15, &payloadLength), "Expected a frame shorter than the cooked header to be skipped");
+    assertNull(_ccnxTestrigReplay_Payload(LINKTYPE_ETHERNET, frame, 13, &payloadLength), "Expected a frame shorter than the Ethernet header to be skipped");
+}
+
+LONGBOW_TEST_CASE(Payload, _ccnxTestrigReplay_Payload_UnknownLinkType)
+{
+    const uint8_t frame[4] = { 0 };
+    size_t payloadLength = 0;
+
+    assertNull(_ccnxTestrigReplay_Payload(12345, frame, sizeof(frame), &payloadLength), "Expected an unknown link type to be skipped");
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(ccnxTestrig_Replay);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2016, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+// Include the file being tested, so that its static functions are visible to the test cases.
+#include "../src/ccnxTestrig_ScriptLoader.c"
+
+#include <LongBow/unit-test.h>
+
+#define TEST_RIG_LINKS 3
+
+static const char _validScript[] =
+    "# A content object answering an Interest\n"
+    "test FIBTest_BasicInterest_1b\n"
+    "\n"
+    "interest request ccnx:/test/c\n"
+    "content answer ccnx:/test/c 1024\n"
+    "\n"
+    "send s1 request A\n"
+    "receive-all r1 s1 C B C   # C is named twice\n"
+    "respond s2 r1 answer\n"
+    "receive-one r2 s2 A\n";
+
+/**
+ * Parse the text into a fresh parser, as the loader does, and return whether it was accepted.
+ */
+static bool
+_parse(_CCNxTestrigScriptParser *parser, const char *text, _CCNxTestrigPlanImage *image)
+{
+    memset(parser, 0, sizeof(*parser));
+    parser->path = "test.script";
+    parser->rigLinks = TEST_RIG_LINKS;
+    return _ccnxTestrigScriptParser_Parse(parser, text, strlen(text), _ccnxTestrigScriptLoader_Hash((const uint8_t *) text, strlen(text)), image);
+}
+
+static bool
+_parseAndClear(const char *text)
+{
+    _CCNxTestrigScriptParser parser;
+    _CCNxTestrigPlanImage image;
+    bool parsed = _parse(&parser, text, &image);
+    _ccnxTestrigScriptParser_Clear(&parser);
+    return parsed;
+}
+
+/**
+ * Lay the image out as the cache file is written.
+ */
+static uint8_t *
+_serialize(const _CCNxTestrigPlanImage *image, size_t *length)
+{
+    const _CCNxTestrigPlanHeader *header = &image->header;
+    *length = _ccnxTestrigScriptLoader_ImageSize(header);
+    uint8_t *bytes = malloc(*length);
+
+    uint8_t *cursor = bytes;
+    memcpy(cursor, header, sizeof(*header));
+    cursor += sizeof(*header);
+    memcpy(cursor, image->packets, header->numberOfPackets * sizeof(_CCNxTestrigPlanPacket));
+    cursor += header->numberOfPackets * sizeof(_CCNxTestrigPlanPacket);
+    memcpy(cursor, image->steps, header->numberOfSteps * sizeof(_CCNxTestrigPlanStep));
+    cursor += header->numberOfSteps * sizeof(_CCNxTestrigPlanStep);
+    memcpy(cursor, image->links, header->numberOfLinks * sizeof(uint32_t));
+    cursor += header->numberOfLinks * sizeof(uint32_t);
+    memcpy(cursor, image->strings, header->stringsLength);
+    return bytes;
+}
+
+LONGBOW_TEST_RUNNER(ccnxTestrig_ScriptLoader)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Parser);
+    LONGBOW_RUN_TEST_FIXTURE(Plan);
+}
+
+LONGBOW_TEST_RUNNER_SETUP(ccnxTestrig_ScriptLoader)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_RUNNER_TEARDOWN(ccnxTestrig_ScriptLoader)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, ccnxTestrigScriptLoader_Load_Missing);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxTestrigScriptLoader_Load_Missing)
+{
+    CCNxTestrigScript *script = ccnxTestrigScriptLoader_Load("/nonexistent/test.script", NULL, TEST_RIG_LINKS);
+    assertNull(script, "Expected no script from a missing file");
+}
+
+LONGBOW_TEST_FIXTURE(Parser)
+{
+    LONGBOW_RUN_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse);
+    LONGBOW_RUN_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_NoTestCase);
+    LONGBOW_RUN_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_UnknownDeclaration);
+    LONGBOW_RUN_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_UnknownPacket);
+    LONGBOW_RUN_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_UnknownStep);
+    LONGBOW_RUN_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_DeclaredTwice);
+    LONGBOW_RUN_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_WrongArguments);
+    LONGBOW_RUN_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_InvalidPayloadSize);
+    LONGBOW_RUN_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_LinkBeyondRig);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Parser)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Parser)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse)
+{
+    _CCNxTestrigScriptParser parser;
+    _CCNxTestrigPlanImage image;
+    assertTrue(_parse(&parser, _validScript, &image), "Expected the script to parse");
+
+    assertTrue(strcmp(image.strings + image.header.testCase, "FIBTest_BasicInterest_1b") == 0, "Expected the test case name");
+    assertTrue(image.header.numberOfPackets == 2, "Expected 2 packets, got %u", image.header.numberOfPackets);
+    assertTrue(image.packets[0].kind == _CCNxTestrigPlanPacket_Interest, "Expected an Interest first");
+    assertTrue(image.packets[1].kind == _CCNxTestrigPlanPacket_ContentObject, "Expected a Content Object second");
+    assertTrue(image.packets[1].payloadSize == 1024, "Expected a 1024 byte payload, got %u", image.packets[1].payloadSize);
+    assertTrue(strcmp(image.strings + image.packets[1].prefix, "ccnx:/test/c") == 0, "Expected the name prefix");
+
+    assertTrue(image.header.numberOfSteps == 4, "Expected 4 steps, got %u", image.header.numberOfSteps);
+    const _CCNxTestrigPlanStep *send = &image.steps[0];
+    assertTrue(send->operation == _CCNxTestrigPlanStep_Send && send->packet == 0 && send->reference == -1, "Expected a plain send of the Interest");
+    assertTrue(send->numberOfLinks == 1 && image.links[send->links] == CCNxTestrigLinkID_LinkA, "Expected the send on link A");
+
+    const _CCNxTestrigPlanStep *receive = &image.steps[1];
+    assertTrue(receive->operation == _CCNxTestrigPlanStep_ReceiveAll && receive->reference == 0, "Expected a receive-all of step 1");
+    assertTrue(receive->numberOfLinks == 2, "Expected the repeated link to be named once, got %u links", receive->numberOfLinks);
+    assertTrue(image.links[receive->links] == CCNxTestrigLinkID_LinkC && image.links[receive->links + 1] == CCNxTestrigLinkID_LinkB,
+               "Expected links C and B in the order they were named");
+
+    const _CCNxTestrigPlanStep *respond = &image.steps[2];
+    assertTrue(respond->operation == _CCNxTestrigPlanStep_Respond && respond->reference == 1 && respond->packet == 1,
+               "Expected a response to step 2 with the Content Object");
+    assertTrue(respond->numberOfLinks == 0, "Expected a respond step to have no links of its own");
+
+    _ccnxTestrigScriptParser_Clear(&parser);
+}
+
+LONGBOW_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_NoTestCase)
+{
+    assertFalse(_parseAndClear("interest request ccnx:/test/c\nsend s1 request A\n"), "Expected a script without a test case to be rejected");
+    assertFalse(_parseAndClear("test one\ntest two\n"), "Expected a script with two test cases to be rejected");
+}
+
+LONGBOW_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_UnknownDeclaration)
+{
+    assertFalse(_parseAndClear("test t\nforward s1 request A\n"), "Expected an unknown declaration to be rejected");
+}
+
+LONGBOW_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_UnknownPacket)
+{
+    assertFalse(_parseAndClear("test t\nsend s1 request A\n"), "Expected a send of an undeclared packet to be rejected");
+}
+
+LONGBOW_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_UnknownStep)
+{
+    // Steps may only refer to the steps before them.
+    assertFalse(_parseAndClear("test t\ninterest request ccnx:/a\nreceive-one r1 s1 B\nsend s1 request A\n"),
+                "Expected a reference to a later step to be rejected");
+}
+
+LONGBOW_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_DeclaredTwice)
+{
+    assertFalse(_parseAndClear("test t\ninterest request ccnx:/a\ninterest request ccnx:/b\n"), "Expected a packet declared twice to be rejected");
+    assertFalse(_parseAndClear("test t\ninterest request ccnx:/a\nsend s1 request A\nsend s1 request B\n"), "Expected a step declared twice to be rejected");
+}
+
+LONGBOW_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_WrongArguments)
+{
+    assertFalse(_parseAndClear("test t\ninterest request ccnx:/a 100\n"), "Expected an Interest with a payload to be rejected");
+    assertFalse(_parseAndClear("test t\ninterest request ccnx:/a\nsend s1 request A B\n"), "Expected a send on two links to be rejected");
+    assertFalse(_parseAndClear("test t\ninterest request ccnx:/a\nsend s1 request A\nreceive-one r1 s1\n"), "Expected a receive without links to be rejected");
+}
+
+LONGBOW_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_InvalidPayloadSize)
+{
+    assertFalse(_parseAndClear("test t\ncontent answer ccnx:/a 70000\n"), "Expected a payload beyond 65535 bytes to be rejected");
+    assertFalse(_parseAndClear("test t\ncontent answer ccnx:/a 10k\n"), "Expected a payload size that is not a number to be rejected");
+}
+
+LONGBOW_TEST_CASE(Parser, _ccnxTestrigScriptParser_Parse_LinkBeyondRig)
+{
+    assertFalse(_parseAndClear("test t\ninterest request ccnx:/a\nsend s1 request D\n"), "Expected a link beyond the rig to be rejected");
+    assertFalse(_parseAndClear("test t\ninterest request ccnx:/a\nsend s1 request a\n"), "Expected a link name that is not upper case to be rejected");
+}
+
+LONGBOW_TEST_FIXTURE(Plan)
+{
+    LONGBOW_RUN_TEST_CASE(Plan, _ccnxTestrigScriptLoader_MapImage);
+    LONGBOW_RUN_TEST_CASE(Plan, _ccnxTestrigScriptLoader_MapImage_Stale);
+    LONGBOW_RUN_TEST_CASE(Plan, _ccnxTestrigScriptLoader_MapImage_Truncated);
+    LONGBOW_RUN_TEST_CASE(Plan, _ccnxTestrigScriptLoader_MapImage_ForwardReference);
+    LONGBOW_RUN_TEST_CASE(Plan, _ccnxTestrigScriptLoader_MapImage_UnknownOperation);
+    LONGBOW_RUN_TEST_CASE(Plan, _ccnxTestrigScriptLoader_MapImage_LinkBeyondRig);
+    LONGBOW_RUN_TEST_CASE(Plan, _ccnxTestrigScriptLoader_OpenCache);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Plan)
+{
+    _CCNxTestrigScriptParser *parser = calloc(1, sizeof(_CCNxTestrigScriptParser));
+    longBowTestCase_SetClipBoardData(testCase, parser);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Plan)
+{
+    _CCNxTestrigScriptParser *parser = longBowTestCase_GetClipBoardData(testCase);
+    _ccnxTestrigScriptParser_Clear(parser);
+    free(parser);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/**
+ * Parse the valid script and lay its plan out as the cache file is written.
+ */
+static uint8_t *
+_serializeValidPlan(_CCNxTestrigScriptParser *parser, size_t *length, uint64_t *hash)
+{
+    _CCNxTestrigPlanImage image;
+    _parse(parser, _validScript, &image);
+    *hash = image.header.sourceHash;
+    return _serialize(&image, length);
+}
+
+static _CCNxTestrigPlanStep *
+_stepOf(uint8_t *bytes, size_t index)
+{
+    _CCNxTestrigPlanHeader *header = (_CCNxTestrigPlanHeader *) bytes;
+    return (_CCNxTestrigPlanStep *) (bytes + sizeof(*header) + header->numberOfPackets * sizeof(_CCNxTestrigPlanPacket)) + index;
+}
+
+LONGBOW_TEST_CASE(Plan, _ccnxTestrigScriptLoader_MapImage)
+{
+    _CCNxTestrigScriptParser *parser = longBowTestCase_GetClipBoardData(testCase);
+
+    size_t length;
+    uint64_t hash;
+    uint8_t *bytes = _serializeValidPlan(parser, &length, &hash);
+
+    _CCNxTestrigPlanImage mapped;
+    assertTrue(_ccnxTestrigScriptLoader_MapImage(bytes, length, hash, TEST_RIG_LINKS, &mapped), "Expected the plan to map");
+    assertTrue(mapped.header.numberOfSteps == 4 && mapped.header.numberOfPackets == 2, "Expected the records of the script");
+    assertTrue(strcmp(mapped.strings + mapped.header.testCase, "FIBTest_BasicInterest_1b") == 0, "Expected the test case name");
+    assertTrue(mapped.steps[2].reference == 1 && mapped.links[mapped.steps[1].links + 1] == CCNxTestrigLinkID_LinkB, "Expected the steps of the script");
+
+    free(bytes);
+}
+
+LONGBOW_TEST_CASE(Plan, _ccnxTestrigScriptLoader_MapImage_Stale)
+{
+    _CCNxTestrigScriptParser *parser = longBowTestCase_GetClipBoardData(testCase);
+
+    size_t length;
+    uint64_t hash;
+    uint8_t *bytes = _serializeValidPlan(parser, &length, &hash);
+
+    _CCNxTestrigPlanImage mapped;
+    assertFalse(_ccnxTestrigScriptLoader_MapImage(bytes, length, hash + 1, TEST_RIG_LINKS, &mapped), "Expected a plan of other text to be refused");
+
+    ((_CCNxTestrigPlanHeader *) bytes)->version = PLAN_VERSION + 1;
+    assertFalse(_ccnxTestrigScriptLoader_MapImage(bytes, length, hash, TEST_RIG_LINKS, &mapped), "Expected a plan of another version to be refused");
+
+    free(bytes);
+}
+
+LONGBOW_TEST_CASE(Plan, _ccnxTestrigScriptLoader_MapImage_Truncated)
+{
+    _CCNxTestrigScriptParser *parser = longBowTestCase_GetClipBoardData(testCase);
+
+    size_t length;
+    uint64_t hash;
+    uint8_t *bytes = _serializeValidPlan(parser, &length, &hash);
+
+    _CCNxTestrigPlanImage mapped;
+    assertFalse(_ccnxTestrigScriptLoader_MapImage(bytes, length - 1, hash, TEST_RIG_LINKS, &mapped), "Expected a truncated plan to be refused");
+    assertFalse(_ccnxTestrigScriptLoader_MapImage(bytes, sizeof(_CCNxTestrigPlanHeader) - 1, hash, TEST_RIG_LINKS, &mapped), "Expected a partial header to be refused");
+
+    // The string table must end its last string.
+    bytes[length - 1] = 'x';
+    assertFalse(_ccnxTestrigScriptLoader_MapImage(bytes, length, hash, TEST_RIG_LINKS, &mapped), "Expected an unterminated string table to be refused");
+
+    free(bytes);
+}
+
+LONGBOW_TEST_CASE(Plan, _ccnxTestrigScriptLoader_MapImage_ForwardReference)
+{
+    _CCNxTestrigScriptParser *parser = longBowTestCase_GetClipBoardData(testCase);
+
+    size_t length;
+    uint64_t hash;
+    uint8_t *bytes = _serializeValidPlan(parser, &length, &hash);
+
+    _CCNxTestrigPlanImage mapped;
+    _stepOf(bytes, 1)->reference = 1;
+    assertFalse(_ccnxTestrigScriptLoader_MapImage(bytes, length, hash, TEST_RIG_LINKS, &mapped), "Expected a step referring to itself to be refused");
+
+    _stepOf(bytes, 1)->reference = 0;
+    _stepOf(bytes, 1)->numberOfLinks = 0;
+    assertFalse(_ccnxTestrigScriptLoader_MapImage(bytes, length, hash, TEST_RIG_LINKS, &mapped), "Expected a receive step without links to be refused");
+
+    free(bytes);
+}
+
+LONGBOW_TEST_CASE(Plan, _ccnxTestrigScriptLoader_MapImage_UnknownOperation)
+{
+    _CCNxTestrigScriptParser *parser = longBowTestCase_GetClipBoardData(testCase);
+
+    size_t length;
+    uint64_t hash;
+    uint8_t *bytes = _serializeValidPlan(parser, &length, &hash);
+
+    _CCNxTestrigPlanImage mapped;
+    _stepOf(bytes, 3)->operation = _CCNxTestrigPlanStep_ReceiveNone + 1;
+    assertFalse(_ccnxTestrigScriptLoader_MapImage(bytes, length, hash, TEST_RIG_LINKS, &mapped), "Expected an unknown step kind to be refused");
+
+    _stepOf(bytes, 3)->operation = _CCNxTestrigPlanStep_Send;
+    _stepOf(bytes, 3)->packet = -1;
+    assertFalse(_ccnxTestrigScriptLoader_MapImage(bytes, length, hash, TEST_RIG_LINKS, &mapped), "Expected a send step without a packet to be refused");
+
+    free(bytes);
+}
+
+LONGBOW_TEST_CASE(Plan, _ccnxTestrigScriptLoader_MapImage_LinkBeyondRig)
+{
+    _CCNxTestrigScriptParser *parser = longBowTestCase_GetClipBoardData(testCase);
+
+    size_t length;
+    uint64_t hash;
+    uint8_t *bytes = _serializeValidPlan(parser, &length, &hash);
+
+    // The script names link C, so a rig of two links must parse it again to report the error.
+    _CCNxTestrigPlanImage mapped;
+    assertFalse(_ccnxTestrigScriptLoader_MapImage(bytes, length, hash, 2, &mapped), "Expected a plan naming a missing link to be refused");
+
+    free(bytes);
+}
+
+LONGBOW_TEST_CASE(Plan, _ccnxTestrigScriptLoader_OpenCache)
+{
+    // A cache directory that others can write to is refused, rather than trusted.
+    char directory[] = "/tmp/test_ccnxTestrig_ScriptLoader.XXXXXX";
+    assertNotNull(mkdtemp(directory), "Expected a temporary directory");
+    chmod(directory, 0777);
+    assertFalse(_ccnxTestrigScriptLoader_OpenCache(directory), "Expected a world-writable cache directory to be refused");
+
+    chmod(directory, 0700);
+    assertTrue(_ccnxTestrigScriptLoader_OpenCache(directory), "Expected a private cache directory to be used");
+
+    char *link = NULL;
+    asprintf(&link, "%s.link", directory);
+    symlink(directory, link);
+    assertFalse(_ccnxTestrigScriptLoader_OpenCache(link), "Expected a symbolic link to be refused");
+
+    unlink(link);
+    free(link);
+    rmdir(directory);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(ccnxTestrig_ScriptLoader);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}